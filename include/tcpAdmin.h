@@ -0,0 +1,61 @@
+#ifndef TCP_ADMIN_H
+#define TCP_ADMIN_H
+
+#include <stddef.h>
+
+/**
+ * @brief   관리 인터페이스 기본 Unix 도메인 소켓 경로
+ * @details '@'로 시작하는 경로는 리눅스 추상 네임스페이스 소켓으로 생성됩니다.
+ */
+#define TCP_ADMIN_DEFAULT_PATH "/tmp/tcpServer.admin"
+
+/**
+ * @brief   관리 요청 최대 길이 (바이트)
+ */
+#define TCP_ADMIN_REQUEST_SIZE 1024
+
+/**
+ * @brief 관리 인터페이스 서버를 시작합니다.
+ *
+ * @details 별도 스레드에서 Unix 도메인 소켓(과 선택적으로 127.0.0.1 HTTP 포트)으로 요청을 받습니다.
+ *          메트릭 스냅샷과 잠금 없는 연결 테이블만 읽으므로 메시지 경로의 뮤텍스를 잡지 않습니다.
+ *
+ *          Unix 소켓에는 한 줄 명령을 보냅니다.
+ *          - metrics      : Prometheus 텍스트 형식 메트릭
+ *          - conns        : 연결 목록과 연결별 카운터, 마지막 TCP_INFO 표본
+ *          - queues       : 연결별 송신 큐 깊이
+ *          - drop <연결ID> : 연결 강제 종료
+ *          - limits       : 연결별/Client ID별 수신 전송률 제한 목록
+ *          - limit conn <바이트/s> <메시지/s>           : 모든 연결의 연결별 제한 변경 (0은 제한 없음)
+ *          - limit id <Client ID> <바이트/s> <메시지/s> : Client ID별 제한 변경 (0 0이면 해제)
+ *          - admission    : 과부하 판단 기준과 현재 스케줄링 지연, 송신 큐 바이트, 활성 연결 수
+ *          - admission <지연 ms> <큐 바이트> <연결 수>   : 과부하 판단 기준 변경 (0은 보지 않음)
+ *          HTTP는 같은 명령을 GET /metrics, /conns, /queues, /drop?id=<연결ID>, /limits,
+ *          /limit/conn/<바이트/s>/<메시지/s>, /limit/id/<Client ID>/<바이트/s>/<메시지/s>, /admission,
+ *          /admission/<지연 ms>/<큐 바이트>/<연결 수> 로 제공합니다.
+ *
+ * @param kpchUnixPath Unix 도메인 소켓 경로 (NULL이면 사용하지 않음)
+ * @param iHttpPort HTTP 포트 (0이면 사용하지 않음)
+ *
+ * @return 성공 시 0, 실패 시 -1을 반환합니다.
+ */
+int startTcpAdminServer(const char*, int);
+
+/**
+ * @brief 관리 인터페이스 서버를 중지하고 소켓을 정리합니다.
+ */
+void stopTcpAdminServer(void);
+
+/**
+ * @brief 관리 명령을 처리하여 응답 문자열을 만듭니다.
+ *
+ * @details 반환된 문자열은 호출자가 free() 해야 합니다.
+ *
+ * @param kpchCommand 명령 문자열 (예: "metrics", "drop 3")
+ * @param piStatus 처리 결과 (200: 성공, 400: 잘못된 명령, 404: 대상 없음). NULL 가능
+ *
+ * @return 응답 문자열. 메모리 할당 실패 시 NULL을 반환합니다.
+ */
+char *handleTcpAdminCommand(const char*, int*);
+
+#endif
@@ -0,0 +1,151 @@
+#ifndef TCP_ADMISSION_H
+#define TCP_ADMISSION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief   스케줄링 지연을 재는 주기 (ms)
+ */
+#define TCP_ADMISSION_LAG_INTERVAL_MS 50
+
+/**
+ * @brief 과부하 판단 기준
+ */
+typedef struct {
+    uint64_t u64MaxLagNs;           /**< 스케줄링 지연 상한 (ns, 0이면 보지 않음) */
+    uint64_t u64MaxQueuedBytes;     /**< 모든 연결의 송신 큐에 쌓인 바이트 상한 (0이면 보지 않음) */
+    uint32_t u32MaxConns;           /**< 활성 연결 수 상한 (0이면 보지 않음) */
+} TCP_ADMISSION_LIMIT;
+
+/**
+ * @brief 거절 이유 (TCP_INST_BUSY 프레임 DATA 1바이트)
+ */
+typedef enum {
+    TCP_BUSY_NONE = 0,              /**< 과부하 아님 */
+    TCP_BUSY_LAG = 1,               /**< 스케줄링 지연이 상한을 넘음 */
+    TCP_BUSY_QUEUED = 2,            /**< 송신 큐에 쌓인 바이트가 상한을 넘음 */
+    TCP_BUSY_CONNS = 3,             /**< 활성 연결 수가 상한에 닿음 */
+    TCP_BUSY_DRAINING = 4           /**< 서버가 종료 중 */
+} TCP_BUSY_REASON;
+
+/**
+ * @brief 과부하 판단 기준을 바꿉니다. 모든 스레드에서 호출할 수 있습니다.
+ *
+ * @param kpstLimit 판단 기준
+ */
+void setTcpAdmissionLimit(const TCP_ADMISSION_LIMIT*);
+
+/**
+ * @brief 과부하 판단 기준을 얻습니다.
+ *
+ * @param pstLimit 판단 기준
+ */
+void getTcpAdmissionLimit(TCP_ADMISSION_LIMIT*);
+
+/**
+ * @brief 송신 큐에 쌓인 바이트 수를 더하거나 뺍니다.
+ *
+ * @param i64Bytes 더할 바이트 수 (꺼낸 경우 음수)
+ */
+void addTcpQueuedBytes(int64_t);
+
+/**
+ * @brief 모든 연결의 송신 큐에 쌓인 바이트 수를 얻습니다.
+ *
+ * @return 바이트 수
+ */
+uint64_t getTcpQueuedBytes(void);
+
+/**
+ * @brief 활성 연결 수를 더하거나 뺍니다.
+ *
+ * @param i32Conns 더할 연결 수 (해제한 경우 음수)
+ */
+void addTcpAdmittedConns(int32_t);
+
+/**
+ * @brief 활성 연결 수를 얻습니다.
+ *
+ * @return 연결 수
+ */
+uint32_t getTcpAdmittedConns(void);
+
+/**
+ * @brief 스케줄링 지연 표본을 기록합니다.
+ *
+ * @details 지연이 늘면 바로 따라가고, 줄면 표본마다 차이의 1/4씩 천천히 내려가
+ *          잠깐 조용해진 틈에 과부하 판단이 풀렸다 잠겼다 하지 않게 합니다.
+ *
+ * @param u64LagNs 예정 시각보다 늦게 깨어난 시간 (ns)
+ */
+void recordTcpLoopLag(uint64_t);
+
+/**
+ * @brief 현재 스케줄링 지연 추정값을 얻습니다.
+ *
+ * @return 지연 (ns)
+ */
+uint64_t getTcpLoopLag(void);
+
+/**
+ * @brief 스케줄링 지연을 재는 스레드를 시작합니다.
+ *
+ * @details 스레드는 주기마다 잠들었다 깨어나며 예정보다 늦게 깨어난 시간을 기록합니다.
+ *          연결마다 스레드가 있는 서버에는 공유 이벤트 루프가 없으므로, 실행 대기 중인 스레드가 많아
+ *          CPU를 늦게 얻는 정도를 이벤트 루프 지연 대신 사용합니다. 한 번만 호출합니다.
+ *
+ * @param u32IntervalMs 측정 주기 (ms)
+ *
+ * @return 성공 시 0, 실패 시 -1
+ */
+int startTcpLagMonitor(uint32_t);
+
+/**
+ * @brief 서버 종료(드레인) 기한을 설정합니다.
+ *
+ * @details 기한을 설정하면 새 연결과 요청은 모두 TCP_BUSY_DRAINING으로 거절됩니다.
+ *          연결 스레드는 새 요청을 읽지 않고 송신 큐를 보낸 뒤 닫으며, 기한이 지나면 남은 연결은 강제로 닫힙니다.
+ *
+ * @param u64DeadlineNs 기한 (getTcpMonotonicNs() 기준 ns, 0이면 종료 중 아님)
+ */
+void setTcpDrainDeadline(uint64_t);
+
+/**
+ * @brief 서버 종료 기한을 얻습니다.
+ *
+ * @return 기한 (ns). 종료 중이 아니면 0
+ */
+uint64_t getTcpDrainDeadline(void);
+
+/**
+ * @brief 서버가 종료 중인지 확인합니다.
+ *
+ * @return 종료 기한이 설정되어 있으면 true
+ */
+bool isTcpDraining(void);
+
+/**
+ * @brief 새 연결을 받아도 되는지 판단합니다.
+ *
+ * @return 받아도 되면 TCP_BUSY_NONE, 아니면 거절 이유
+ */
+TCP_BUSY_REASON admitTcpConnection(void);
+
+/**
+ * @brief 낮은 우선순위 요청을 처리해도 되는지 판단합니다. 연결 수는 보지 않습니다.
+ *
+ * @return 처리해도 되면 TCP_BUSY_NONE, 아니면 거절 이유
+ */
+TCP_BUSY_REASON admitTcpRequest(void);
+
+/**
+ * @brief 거절 이유 이름을 반환합니다.
+ *
+ * @param eReason 거절 이유
+ *
+ * @return 이름 ("lag", "queued", "conns", "draining", 알 수 없으면 "none")
+ */
+const char *getTcpBusyReasonName(TCP_BUSY_REASON);
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef TCP_BUDGET_H
+#define TCP_BUDGET_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief   기본 차례당 바이트 예산
+ */
+#define TCP_READ_BUDGET_DEFAULT_BYTES (16 * 1024)
+
+/**
+ * @brief   기본 차례당 최대 프레임 수
+ */
+#define TCP_READ_BUDGET_DEFAULT_FRAMES 64
+
+/**
+ * @brief 연결 하나가 한 차례에 처리할 수 있는 양 (read 예산)
+ */
+typedef struct {
+    uint32_t u32Bytes;              /**< 차례마다 더하는 바이트 크레딧 */
+    uint32_t u32Frames;             /**< 한 차례에 처리할 최대 프레임 수 (0이면 제한 없음) */
+} TCP_READ_BUDGET;
+
+/**
+ * @brief 연결 하나의 read 예산 크레딧
+ *
+ * @details 차례마다 예산만큼 바이트 크레딧을 더하고, 프레임을 처리할 때마다 그 길이를 뺍니다.
+ *          다음 프레임이 남은 크레딧보다 크면 차례를 마치고, 남은 크레딧은 다음 차례로 이어집니다.
+ *          따라서 예산보다 큰 프레임도 몇 차례 뒤에는 처리됩니다.
+ *          처리할 것이 없어 차례를 마치면 크레딧을 버려서, 쉬던 연결이 크레딧을 쌓아 한꺼번에 쓰지 못하게 합니다.
+ *          연결 사이의 차례 순서는 정하지 않습니다. 차례를 마친 스레드가 CPU를 내놓으면 커널 스케줄러가 고릅니다.
+ */
+typedef struct {
+    int64_t i64Deficit;             /**< 남은 바이트 크레딧 */
+    uint32_t u32Frames;             /**< 이번 차례에 남은 프레임 수 */
+    bool bFrameLimited;             /**< 프레임 수를 제한하는 차례인지 여부 */
+} TCP_READ_CREDIT;
+
+/**
+ * @brief 새 차례를 시작하며 예산만큼 크레딧을 더합니다.
+ *
+ * @param pstCredit 연결 크레딧
+ * @param kpstBudget 차례당 예산
+ */
+void startTcpReadTurn(TCP_READ_CREDIT*, const TCP_READ_BUDGET*);
+
+/**
+ * @brief 이번 차례에 프레임 하나를 처리할 수 있으면 크레딧을 뺍니다.
+ *
+ * @param pstCredit 연결 크레딧
+ * @param u32Bytes 프레임 길이 (바이트)
+ *
+ * @return 처리할 수 있으면 true, 다음 차례로 미뤄야 하면 false
+ */
+bool takeTcpReadCredit(TCP_READ_CREDIT*, uint32_t);
+
+/**
+ * @brief 처리할 것이 없어진 연결의 크레딧을 버립니다.
+ *
+ * @param pstCredit 연결 크레딧
+ */
+void resetTcpReadCredit(TCP_READ_CREDIT*);
+
+#endif
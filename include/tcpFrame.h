@@ -0,0 +1,257 @@
+#ifndef TCP_FRAME_H
+#define TCP_FRAME_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief   프레임 시작을 나타내는 매직 값 (Header 앞 2바이트)
+ */
+#define TCP_FRAME_MAGIC 0xA55A
+
+/**
+ * @brief   프레임 형식 버전 (Header 세 번째 바이트)
+ */
+#define TCP_FRAME_VERSION 1
+
+/**
+ * @brief   Header(4) + Client ID(1) + Instruction(1) + Data Length(2)
+ */
+#define TCP_FRAME_HEADER_SIZE 8
+
+/**
+ * @brief   CRC 크기 (바이트)
+ */
+#define TCP_FRAME_CRC_SIZE 2
+
+/**
+ * @brief   DATA 최대 길이 (Data Length 필드가 2바이트)
+ */
+#define TCP_FRAME_MAX_DATA 0xFFFF
+
+/**
+ * @brief   프레임 최대 크기
+ */
+#define TCP_FRAME_MAX_SIZE (TCP_FRAME_HEADER_SIZE + TCP_FRAME_MAX_DATA + TCP_FRAME_CRC_SIZE)
+
+/**
+ * @brief   Flags: DATA 앞 4바이트가 요청/응답을 짝짓는 Correlation ID (빅엔디언)
+ * @details 서버는 프레임을 그대로 돌려보내므로 ID도 함께 돌아옵니다.
+ *          한 연결에서 여러 요청을 동시에 보내고 응답 순서와 관계없이 짝지을 때 사용합니다.
+ */
+#define TCP_FRAME_FLAG_CORR_ID 0x01
+
+/**
+ * @brief   Correlation ID 크기 (바이트)
+ */
+#define TCP_FRAME_CORR_ID_SIZE 4
+
+/**
+ * @brief   Flags: DATA가 LZ4 블록으로 압축됨
+ * @details 압축 DATA는 [원래 DATA 길이(2, 빅엔디언) | LZ4 블록] 이며, CRC는 압축된 바이트에 대해 계산합니다.
+ *          기능 협상(TCP_INST_CAPS)에서 TCP_FRAME_CAP_LZ4에 합의한 연결에서만 보낼 수 있습니다.
+ *          Correlation ID 프레임과 함께 쓰지 않습니다.
+ */
+#define TCP_FRAME_FLAG_LZ4 0x02
+
+/**
+ * @brief   압축 DATA 앞의 원래 길이 필드 크기 (바이트)
+ */
+#define TCP_FRAME_LZ4_LEN_SIZE 2
+
+/**
+ * @brief   기본 압축 임계값 (바이트). 이보다 짧은 DATA는 압축해도 이득이 적어 그대로 보냅니다.
+ */
+#define TCP_FRAME_COMPRESS_THRESHOLD 256
+
+/**
+ * @brief   기능 비트 (TCP_INST_CAPS DATA): LZ4 압축 프레임을 주고받을 수 있음
+ */
+#define TCP_FRAME_CAP_LZ4 0x01
+
+/**
+ * @brief Instruction 값
+ */
+typedef enum {
+    TCP_INST_DATA = 0x01,           /**< 일반 데이터. 서버는 보낸 클라이언트에게 그대로 돌려보냅니다. */
+    TCP_INST_HEARTBEAT = 0x02,      /**< 연결 확인. 서버는 그대로 돌려보냅니다. */
+    TCP_INST_SHM_OFFER = 0x03,      /**< 공유 메모리 전송 제안 (tcpShm.h). 서버는 DATA 1바이트(0: 수락, 그 외 errno)로 응답합니다. */
+    TCP_INST_CAPS = 0x04,           /**< 연결 기능 협상. DATA 1바이트 기능 비트(TCP_FRAME_CAP_*). 서버는 함께 쓸 기능 비트로 응답합니다. */
+    TCP_INST_BUSY = 0x05,           /**< 서버 과부하 (서버 → 클라이언트). DATA 1바이트 거절 이유(tcpAdmission.h의 TCP_BUSY_*). */
+    TCP_INST_SHUTDOWN = 0x06        /**< 서버 종료 (서버 → 클라이언트). DATA 없음. 앞서 받은 요청의 응답을 모두 보낸 뒤 마지막으로 보내고 연결을 닫습니다. */
+} TCP_INSTRUCTION;
+
+/**
+ * @brief 우선순위 등급 (값이 작을수록 먼저 처리)
+ *
+ * @details 연결 확인과 협상 같은 제어 프레임은 대량 DATA 뒤에서 기다리지 않도록 따로 처리합니다.
+ *          등급 안에서는 받은 순서를 지킵니다.
+ */
+typedef enum {
+    TCP_FRAME_PRIO_CONTROL = 0,     /**< HEARTBEAT, SHM_OFFER, CAPS, BUSY, SHUTDOWN */
+    TCP_FRAME_PRIO_BULK,            /**< DATA와 알 수 없는 Instruction */
+    TCP_FRAME_PRIO_COUNT
+} TCP_FRAME_PRIO;
+
+/**
+ * @brief 디코딩된 프레임 헤더
+ *
+ * @details 와이어 형식 (다중 바이트 값은 빅엔디언)
+ *          | Magic(2) | Version(1) | Flags(1) | Client ID(1) | Instruction(1) | Data Length(2) | DATA | CRC(2) |
+ *          CRC는 Magic부터 DATA 끝까지에 대한 CRC-16/CCITT-FALSE 입니다.
+ */
+typedef struct {
+    uint8_t u8Version;              /**< 프레임 형식 버전 */
+    uint8_t u8Flags;                /**< 프레임 플래그 */
+    uint8_t u8ClientId;             /**< 클라이언트 ID */
+    uint8_t u8Instruction;          /**< Instruction */
+    uint16_t u16DataLen;            /**< DATA 길이 */
+} TCP_FRAME_HEADER;
+
+/**
+ * @brief CRC-16/CCITT-FALSE 값을 계산합니다.
+ *
+ * @param kpu8Data 데이터
+ * @param uiLen 데이터 길이
+ * @param u16Crc 시작 값 (처음 계산 시 0xFFFF, 이어서 계산 시 이전 결과)
+ *
+ * @return CRC 값
+ */
+uint16_t calcTcpFrameCrc(const uint8_t*, size_t, uint16_t);
+
+/**
+ * @brief 프레임을 인코딩합니다.
+ *
+ * @param pu8Out 프레임을 저장할 버퍼
+ * @param uiOutSize 버퍼 크기 (DATA 길이 + TCP_FRAME_HEADER_SIZE + TCP_FRAME_CRC_SIZE 이상)
+ * @param u8ClientId 클라이언트 ID
+ * @param u8Instruction Instruction
+ * @param kpvData DATA (길이가 0이면 NULL 가능)
+ * @param uiDataLen DATA 길이 (TCP_FRAME_MAX_DATA 이하)
+ *
+ * @return 인코딩된 프레임 길이. 버퍼가 작거나 DATA가 너무 길면 -1을 반환합니다.
+ */
+int encodeTcpFrame(uint8_t*, size_t, uint8_t, uint8_t, const void*, size_t);
+
+/**
+ * @brief Correlation ID를 붙인 프레임을 인코딩합니다.
+ *
+ * @details Flags에 TCP_FRAME_FLAG_CORR_ID를 설정하고 DATA 앞에 ID를 붙입니다.
+ *
+ * @param pu8Out 프레임을 저장할 버퍼
+ * @param uiOutSize 버퍼 크기 (DATA 길이 + TCP_FRAME_CORR_ID_SIZE + TCP_FRAME_HEADER_SIZE + TCP_FRAME_CRC_SIZE 이상)
+ * @param u8ClientId 클라이언트 ID
+ * @param u8Instruction Instruction
+ * @param u32CorrId Correlation ID
+ * @param kpvData DATA (길이가 0이면 NULL 가능)
+ * @param uiDataLen DATA 길이 (TCP_FRAME_MAX_DATA - TCP_FRAME_CORR_ID_SIZE 이하)
+ *
+ * @return 인코딩된 프레임 길이. 버퍼가 작거나 DATA가 너무 길면 -1을 반환합니다.
+ */
+int encodeTcpCorrFrame(uint8_t*, size_t, uint8_t, uint8_t, uint32_t, const void*, size_t);
+
+/**
+ * @brief DATA를 LZ4로 압축한 프레임을 인코딩합니다.
+ *
+ * @details DATA가 임계값 이상이고 압축하여 줄어들면 TCP_FRAME_FLAG_LZ4 프레임을, 아니면 일반 프레임을 만듭니다.
+ *          상대와 TCP_FRAME_CAP_LZ4에 합의한 연결에서만 사용합니다.
+ *
+ * @param pu8Out 프레임을 저장할 버퍼 (DATA와 겹치면 안 됨)
+ * @param uiOutSize 버퍼 크기 (DATA 길이 + TCP_FRAME_HEADER_SIZE + TCP_FRAME_CRC_SIZE 이상)
+ * @param u8ClientId 클라이언트 ID
+ * @param u8Instruction Instruction
+ * @param kpvData DATA (길이가 0이면 NULL 가능)
+ * @param uiDataLen DATA 길이 (TCP_FRAME_MAX_DATA 이하)
+ * @param uiThreshold 압축을 시도할 최소 DATA 길이 (보통 TCP_FRAME_COMPRESS_THRESHOLD)
+ *
+ * @return 인코딩된 프레임 길이. 버퍼가 작거나 DATA가 너무 길면 -1을 반환합니다.
+ */
+int encodeTcpLz4Frame(uint8_t*, size_t, uint8_t, uint8_t, const void*, size_t, size_t);
+
+/**
+ * @brief 디코딩된 프레임의 원래 DATA를 얻습니다. 압축 프레임이면 풀어서 돌려줍니다.
+ *
+ * @param kpstHeader 디코딩된 헤더
+ * @param kpu8Data DATA 시작 위치
+ * @param pu8Scratch 압축을 풀 버퍼 (TCP_FRAME_MAX_DATA 바이트면 항상 충분)
+ * @param uiScratchSize 버퍼 크기
+ * @param ppu8Plain 원래 DATA 위치 (압축되지 않았으면 kpu8Data, 압축되었으면 pu8Scratch)
+ *
+ * @return 원래 DATA 길이. 압축 DATA가 손상되었거나 버퍼가 작으면 -1을 반환합니다.
+ */
+int getTcpFramePlainData(const TCP_FRAME_HEADER*, const uint8_t*, uint8_t*, size_t, const uint8_t**);
+
+/**
+ * @brief 디코딩된 프레임에서 Correlation ID를 꺼냅니다.
+ *
+ * @param kpstHeader 디코딩된 헤더
+ * @param kpu8Data DATA 시작 위치
+ * @param pu32CorrId Correlation ID
+ *
+ * @return ID가 있으면 true, 플래그가 없거나 DATA가 짧으면 false를 반환합니다.
+ *         ID 뒤의 실제 DATA는 kpu8Data + TCP_FRAME_CORR_ID_SIZE 부터입니다.
+ */
+bool getTcpFrameCorrId(const TCP_FRAME_HEADER*, const uint8_t*, uint32_t*);
+
+/**
+ * @brief 버퍼 앞부분에서 프레임 하나를 디코딩합니다.
+ *
+ * @param kpu8Buf 수신 버퍼
+ * @param uiLen 버퍼에 있는 데이터 길이
+ * @param pstHeader 디코딩된 헤더 (NULL 가능)
+ * @param ppu8Data DATA 시작 위치 (NULL 가능)
+ *
+ * @return 완성된 프레임 길이(>0), 데이터가 더 필요하면 0,
+ *         매직/버전/CRC가 맞지 않으면 -1을 반환합니다.
+ */
+int decodeTcpFrame(const uint8_t*, size_t, TCP_FRAME_HEADER*, const uint8_t**);
+
+/**
+ * @brief 버퍼 앞부분 프레임의 헤더만 확인합니다.
+ *
+ * @details CRC는 확인하지 않으므로 프레임 경계와 Instruction만 빠르게 알아볼 때 사용하고,
+ *          프레임을 처리하기 전에는 decodeTcpFrame()으로 검증합니다.
+ *
+ * @param kpu8Buf 수신 버퍼
+ * @param uiLen 버퍼에 있는 데이터 길이
+ * @param pstHeader 헤더 (NULL 가능)
+ *
+ * @return 완성된 프레임 길이(>0), 데이터가 더 필요하면 0, 매직/버전이 맞지 않으면 -1을 반환합니다.
+ */
+int peekTcpFrame(const uint8_t*, size_t, TCP_FRAME_HEADER*);
+
+/**
+ * @brief 버퍼 앞부분 프레임을 완성하는 데 더 필요한 바이트 수를 구합니다.
+ *
+ * @details 헤더가 다 오지 않았으면 가장 작은 프레임(헤더 + CRC)을 기준으로, 헤더가 있으면 Data Length로 계산합니다.
+ *          수신 측은 이 값을 SO_RCVLOWAT으로 주어 프레임이 완성될 때 한 번만 깨어날 수 있습니다.
+ *
+ * @param kpu8Buf 수신 버퍼
+ * @param uiLen 버퍼에 있는 데이터 길이
+ *
+ * @return 더 필요한 바이트 수. 프레임이 이미 완성되었으면 0, 매직/버전이 맞지 않으면 1 (재동기화는 받는 쪽이 처리)
+ */
+size_t getTcpFrameNeededBytes(const uint8_t*, size_t);
+
+/**
+ * @brief Instruction의 우선순위 등급을 구합니다.
+ *
+ * @param u8Instruction Instruction
+ *
+ * @return 우선순위 등급
+ */
+TCP_FRAME_PRIO getTcpFramePriority(uint8_t);
+
+/**
+ * @brief 잘못된 프레임 뒤에서 다음 매직 값 위치를 찾습니다.
+ *
+ * @param kpu8Buf 수신 버퍼
+ * @param uiLen 버퍼에 있는 데이터 길이
+ *
+ * @return 다음 프레임 후보의 시작 위치. 후보가 없으면 uiLen을 반환합니다.
+ *         (버퍼가 매직 첫 바이트로 끝나면 그 위치를 반환합니다.)
+ */
+size_t findTcpFrameStart(const uint8_t*, size_t);
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef TCP_LZ4_H
+#define TCP_LZ4_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief   한 번에 압축할 수 있는 최대 입력 길이 (프레임 DATA 최대 길이와 같음)
+ */
+#define TCP_LZ4_MAX_INPUT 0xFFFF
+
+/**
+ * @brief   압축 결과가 가질 수 있는 최대 길이 (압축되지 않는 입력의 최악의 경우)
+ */
+#define TCP_LZ4_BOUND(uiLen) ((uiLen) + (uiLen) / 255 + 16)
+
+/**
+ * @brief LZ4 블록 형식으로 압축합니다.
+ *
+ * @details 표준 LZ4 블록 형식(프레임 형식 아님)이므로 liblz4의 LZ4_decompress_safe()로도 풀 수 있습니다.
+ *          빠른 압축을 위해 4바이트 해시로 찾은 가장 최근 위치 하나만 비교하는 탐욕 매칭을 합니다.
+ *
+ * @param kpu8Src 원본 데이터
+ * @param uiSrcLen 원본 길이 (TCP_LZ4_MAX_INPUT 이하)
+ * @param pu8Dst 압축 결과를 저장할 버퍼 (원본과 겹치면 안 됨)
+ * @param uiDstCap 버퍼 크기. 결과가 이보다 크면 압축을 멈춥니다.
+ *
+ * @return 압축 길이. 버퍼에 들어가지 않으면 0, 입력이 너무 길면 -1을 반환합니다.
+ */
+int compressTcpLz4(const uint8_t*, size_t, uint8_t*, size_t);
+
+/**
+ * @brief LZ4 블록을 풉니다.
+ *
+ * @details 모든 길이와 거리를 검사하므로 손상되거나 악의적인 입력에도 버퍼 밖을 읽거나 쓰지 않습니다.
+ *
+ * @param kpu8Src 압축 데이터
+ * @param uiSrcLen 압축 길이
+ * @param pu8Dst 원본을 저장할 버퍼
+ * @param uiDstCap 버퍼 크기
+ *
+ * @return 원본 길이. 형식이 잘못되었거나 버퍼가 작으면 -1을 반환합니다.
+ */
+int decompressTcpLz4(const uint8_t*, size_t, uint8_t*, size_t);
+
+#endif
@@ -0,0 +1,376 @@
+#ifndef TCP_METRICS_H
+#define TCP_METRICS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+/**
+ * @brief   히스토그램 하위 버킷 비트 수
+ * @details 2의 거듭제곱 구간마다 2^TCP_HIST_SUB_BITS 개의 선형 버킷을 둡니다.
+ *          값의 상대 오차는 최대 1/2^TCP_HIST_SUB_BITS (약 3%) 입니다.
+ */
+#define TCP_HIST_SUB_BITS 5
+
+/**
+ * @brief   히스토그램이 구분할 수 있는 최대 값의 비트 수
+ * @details 나노초 단위 기준 2^36ns (약 68초) 이상의 값은 마지막 버킷에 기록됩니다.
+ */
+#define TCP_HIST_MAX_BITS 36
+
+/**
+ * @brief   히스토그램 버킷 개수
+ */
+#define TCP_HIST_BUCKETS ((TCP_HIST_MAX_BITS - TCP_HIST_SUB_BITS + 1) << TCP_HIST_SUB_BITS)
+
+/**
+ * @brief   연결 테이블 크기
+ * @details 관리 인터페이스에서 조회할 수 있는 최대 동시 연결 수입니다.
+ */
+#define TCP_CONN_TABLE_SIZE 1024
+
+/**
+ * @brief   연결 상대 주소 문자열 최대 길이
+ */
+#define TCP_PEER_NAME_LEN 64
+
+/**
+ * @brief 카운터 종류
+ *
+ * @details 모든 카운터는 단조 증가하며, 큐 깊이와 활성 연결 수 같은 게이지는
+ *          읽는 시점에 카운터 간의 차이로 계산합니다.
+ */
+typedef enum {
+    TCP_METRIC_BYTES_IN = 0,        /**< 수신 바이트 수 */
+    TCP_METRIC_BYTES_OUT,           /**< 송신 바이트 수 */
+    TCP_METRIC_MSGS_IN,             /**< 수신 메시지 수 */
+    TCP_METRIC_MSGS_OUT,            /**< 송신 메시지 수 */
+    TCP_METRIC_ENQUEUED,            /**< 송신 큐에 저장된 메시지 수 */
+    TCP_METRIC_DEQUEUED,            /**< 송신 큐에서 꺼낸 메시지 수 */
+    TCP_METRIC_DROPS,               /**< 송신되지 못하고 버려진 메시지 수 */
+    TCP_METRIC_ACCEPTS,             /**< 수락한 연결 수 */
+    TCP_METRIC_DISCONNECTS,         /**< 해제된 연결 수 */
+    TCP_METRIC_FRAME_ERRORS,        /**< 매직/CRC가 맞지 않아 건너뛴 프레임 수 */
+    TCP_METRIC_RECONNECT_ATTEMPTS,  /**< 클라이언트 재연결 시도 수 */
+    TCP_METRIC_RECONNECTS,          /**< 클라이언트 재연결 성공 수 */
+    TCP_METRIC_COMPRESSED_IN,       /**< 수신한 LZ4 압축 프레임 수 */
+    TCP_METRIC_THROTTLES,           /**< 전송률 제한으로 소켓 읽기를 멈춘 횟수 */
+    TCP_METRIC_REJECTS,             /**< 과부하로 받자마자 닫은 연결 수 */
+    TCP_METRIC_SHED,                /**< 과부하로 처리하지 않고 BUSY로 응답한 요청 수 */
+    TCP_METRIC_SHUTDOWNS,           /**< 종료 중 송신 큐를 모두 보내고 SHUTDOWN 프레임으로 닫은 연결 수 */
+    TCP_METRIC_DRAIN_TIMEOUTS,      /**< 종료 기한까지 송신 큐를 다 보내지 못해 강제로 닫은 연결 수 */
+    TCP_METRIC_ACCEPT_ERRORS,       /**< fd 부족 등으로 accept()가 실패하여 연결 받기를 잠시 멈춘 횟수 */
+    TCP_METRIC_BUFFER_TUNES,        /**< 대역폭 지연 곱에 맞춰 송수신 버퍼 크기를 바꾼 횟수 */
+    TCP_METRIC_SEND_WAITS,          /**< 커널에 보내지 않은 바이트가 기준(TCP_NOTSENT_LOWAT)을 넘어 송신을 기다린 횟수 */
+    TCP_METRIC_READS,               /**< 수신 스레드가 소켓을 읽은(깨어난) 횟수 */
+    TCP_METRIC_COUNT
+} TCP_METRIC_ID;
+
+/**
+ * @brief 히스토그램 종류
+ */
+typedef enum {
+    TCP_HIST_RECV_TO_SEND = 0,      /**< 수신 스레드 저장 시점부터 송신 스레드 write 완료까지의 지연 (ns) */
+    TCP_HIST_RECONNECT,             /**< 클라이언트가 연결 끊김을 감지한 뒤 재연결될 때까지의 시간 (ns) */
+    TCP_HIST_TCP_RTT,               /**< 연결별 TCP_INFO 표본의 평활 RTT (ns) */
+    TCP_HIST_TCP_BUSY,              /**< 표본 사이에 보낼 데이터가 있어 전송 중이던 시간 (ns) */
+    TCP_HIST_TCP_RWND_LIMITED,      /**< 표본 사이에 상대 수신 윈도에 막혀 보내지 못한 시간 (ns) */
+    TCP_HIST_TCP_SNDBUF_LIMITED,    /**< 표본 사이에 서버 송신 버퍼에 막혀 보내지 못한 시간 (ns) */
+    TCP_HIST_COUNT
+} TCP_HIST_ID;
+
+/**
+ * @brief 연결별 게이지 종류 (TCP_INFO 표본)
+ */
+typedef enum {
+    TCP_GAUGE_RTT_US = 0,           /**< 평활 RTT (us) */
+    TCP_GAUGE_RTTVAR_US,            /**< RTT 변동 (us) */
+    TCP_GAUGE_RETRANS,              /**< 누적 재전송 세그먼트 수 */
+    TCP_GAUGE_CWND,                 /**< 혼잡 윈도 (세그먼트) */
+    TCP_GAUGE_UNACKED,              /**< 확인 응답을 기다리는 세그먼트 수 */
+    TCP_GAUGE_DELIVERY_RATE,        /**< 최근 전달률 (바이트/초) */
+    TCP_GAUGE_BUSY_US,              /**< 누적 전송 중 시간 (us) */
+    TCP_GAUGE_RWND_LIMITED_US,      /**< 누적 수신 윈도 제한 시간 (us) */
+    TCP_GAUGE_SNDBUF_LIMITED_US,    /**< 누적 송신 버퍼 제한 시간 (us) */
+    TCP_GAUGE_COUNT
+} TCP_GAUGE_ID;
+
+/**
+ * @brief HDR 방식(로그-선형 버킷) 히스토그램
+ */
+typedef struct {
+    uint64_t au64Bucket[TCP_HIST_BUCKETS];  /**< 버킷별 기록 횟수 */
+    uint64_t u64Count;                      /**< 전체 기록 횟수 */
+    uint64_t u64Sum;                        /**< 기록된 값의 합 */
+    uint64_t u64Max;                        /**< 기록된 최대 값 */
+} TCP_HISTOGRAM;
+
+/**
+ * @brief 전체 메트릭의 특정 시점 스냅샷
+ */
+typedef struct {
+    uint64_t au64Counter[TCP_METRIC_COUNT]; /**< 카운터 합계 */
+    TCP_HISTOGRAM astHist[TCP_HIST_COUNT];  /**< 히스토그램 합계 */
+    struct timespec stTime;                 /**< 스냅샷 시각 (CLOCK_MONOTONIC) */
+} TCP_METRICS_SNAPSHOT;
+
+/**
+ * @brief 연결별 카운터
+ *
+ * @details 하나의 카운터는 하나의 스레드만 갱신해야 합니다. (수신 관련은 수신 스레드, 송신 관련은 송신 스레드)
+ *          읽는 쪽은 getTcpConnMetric()으로 원자적으로 읽습니다.
+ *          연결 테이블에 등록되면 관리 인터페이스가 잠금 없이 조회하므로, 등록 해제 후에도 메모리는 유지되어야 합니다.
+ *          등록 해제는 연결 ID와 소켓을 지우므로, 소유 스레드는 해제한 뒤에 소켓을 닫아야 합니다.
+ */
+typedef struct {
+    uint64_t au64Counter[TCP_METRIC_COUNT]; /**< 연결별 카운터 */
+    uint64_t u64ConnId;                     /**< 연결 ID (등록 시 부여, 0이면 미등록) */
+    int iSock;                              /**< 연결 소켓 파일 디스크립터 (다른 스레드는 lockTcpConnSock()으로만 사용) */
+    char achPeer[TCP_PEER_NAME_LEN];        /**< 상대 주소 ("IP:포트") */
+    uint64_t u64ConnectedNs;                /**< 연결 시각 (단조 시계, ns) */
+    uint64_t au64Gauge[TCP_GAUGE_COUNT];    /**< 마지막 TCP_INFO 표본 (표본을 뜨는 스레드만 갱신) */
+    uint64_t u64SampledNs;                  /**< 마지막 표본 시각 (단조 시계, ns, 0이면 표본 없음) */
+} TCP_CONN_METRICS;
+
+/**
+ * @brief 연결 테이블 순회 콜백
+ *
+ * @param kpstConn 연결별 카운터
+ * @param pvArg 사용자 인자
+ */
+typedef void (*TCP_CONN_VISITOR)(const TCP_CONN_METRICS*, void*);
+
+/**
+ * @brief 현재 스레드의 카운터를 증가시킵니다.
+ *
+ * @details 스레드별 샤드에만 기록하므로 공유 원자 연산이나 잠금이 필요하지 않습니다.
+ *          스레드가 처음 기록할 때 샤드가 등록되고, 스레드가 종료되면 합계에 병합됩니다.
+ *
+ * @param eId 카운터 종류
+ * @param u64Value 증가량
+ */
+void addTcpMetric(TCP_METRIC_ID, uint64_t);
+
+/**
+ * @brief 연결별 카운터와 현재 스레드의 카운터를 함께 증가시킵니다.
+ *
+ * @param pstConn 연결별 카운터 (NULL이면 스레드 카운터만 증가)
+ * @param eId 카운터 종류
+ * @param u64Value 증가량
+ */
+void addTcpConnMetric(TCP_CONN_METRICS*, TCP_METRIC_ID, uint64_t);
+
+/**
+ * @brief 연결별 카운터 값을 읽습니다.
+ *
+ * @param pstConn 연결별 카운터
+ * @param eId 카운터 종류
+ *
+ * @return 카운터 값
+ */
+uint64_t getTcpConnMetric(const TCP_CONN_METRICS*, TCP_METRIC_ID);
+
+/**
+ * @brief 연결별 게이지를 모두 바꾸고 표본 시각을 기록합니다.
+ *
+ * @details 연결마다 한 스레드만 호출해야 합니다. 읽는 쪽은 getTcpConnGauges()로 원자적으로 읽습니다.
+ *
+ * @param pstConn 연결별 카운터
+ * @param kau64Gauge TCP_GAUGE_COUNT개의 게이지 값
+ * @param u64SampledNs 표본 시각 (단조 시계, ns)
+ */
+void setTcpConnGauges(TCP_CONN_METRICS*, const uint64_t*, uint64_t);
+
+/**
+ * @brief 연결별 게이지를 읽습니다.
+ *
+ * @param kpstConn 연결별 카운터
+ * @param pu64Gauge TCP_GAUGE_COUNT개의 게이지 값을 저장할 배열
+ *
+ * @return 마지막 표본 시각 (ns). 아직 표본이 없으면 0
+ */
+uint64_t getTcpConnGauges(const TCP_CONN_METRICS*, uint64_t*);
+
+/**
+ * @brief 연결을 연결 테이블에 등록하고 연결 ID를 부여합니다.
+ *
+ * @details 카운터를 0으로 초기화한 뒤 식별 정보를 채우고 테이블에 게시합니다.
+ *          연결 수락 시 한 번만 호출되며, 메시지 경로에서는 호출하지 않습니다.
+ *
+ * @param pstConn 연결별 카운터
+ * @param iSock 연결 소켓 파일 디스크립터
+ * @param kpchPeer 상대 주소 문자열
+ *
+ * @return 부여된 연결 ID. 테이블이 가득 차도 ID는 부여되며 조회 대상에서만 빠집니다.
+ */
+uint64_t registerTcpConnMetrics(TCP_CONN_METRICS*, int, const char*);
+
+/**
+ * @brief 연결을 연결 테이블에서 제거합니다.
+ *
+ * @details lockTcpConnSock()으로 소켓을 쓰는 스레드가 있으면 끝나기를 기다린 뒤 연결 ID를 0, 소켓을 -1로 지웁니다.
+ *          반환 후에는 다른 스레드가 이 연결의 소켓을 쓰지 않으므로 소유 스레드가 소켓을 닫아도 됩니다.
+ *
+ * @param pstConn 연결별 카운터
+ */
+void unregisterTcpConnMetrics(TCP_CONN_METRICS*);
+
+/**
+ * @brief 다른 스레드가 연결 소켓에 시스템 호출을 하기 위해 소켓을 잠급니다.
+ *
+ * @details 성공하면 unlockTcpConnSock()을 부를 때까지 등록/해제가 기다리므로, 돌려받은 소켓 번호는
+ *          그동안 닫히거나 다른 연결에 재사용되지 않습니다. 잠근 동안에는 shutdown(), setsockopt() 같은 짧은
+ *          시스템 호출만 하고 막힐 수 있는 호출은 하지 않습니다. 소켓을 소유한 스레드는 이 함수를 쓰지 않습니다.
+ *
+ * @param kpstConn 연결별 카운터 (등록 해제된 뒤의 포인터여도 됩니다)
+ * @param u64ConnId 기대하는 연결 ID (0이면 등록된 연결이면 ID를 보지 않음)
+ *
+ * @return 소켓 파일 디스크립터. 등록 해제되었거나 연결 ID가 다르면 잠그지 않고 -1
+ */
+int lockTcpConnSock(const TCP_CONN_METRICS*, uint64_t);
+
+/**
+ * @brief lockTcpConnSock()으로 잠근 소켓을 풉니다.
+ */
+void unlockTcpConnSock(void);
+
+/**
+ * @brief 연결 테이블에 등록된 모든 연결을 순회합니다.
+ *
+ * @details 잠금 없이 테이블을 읽습니다. 순회 중 등록/해제되는 연결은 포함되지 않을 수 있습니다.
+ *
+ * @param pfnVisitor 연결마다 호출할 콜백
+ * @param pvArg 콜백에 전달할 사용자 인자
+ */
+void visitTcpConnMetrics(TCP_CONN_VISITOR, void*);
+
+/**
+ * @brief 연결의 송신 대기 메시지 수를 계산합니다. (저장 - 꺼냄 - 버림)
+ *
+ * @param kpstConn 연결별 카운터
+ *
+ * @return 큐 깊이
+ */
+uint64_t getTcpConnQueueDepth(const TCP_CONN_METRICS*);
+
+/**
+ * @brief 카운터 이름을 반환합니다. (예: "bytes_in")
+ *
+ * @param eId 카운터 종류
+ *
+ * @return 카운터 이름 문자열
+ */
+const char *getTcpMetricName(TCP_METRIC_ID);
+
+/**
+ * @brief 게이지 이름을 반환합니다. (예: "rtt_us")
+ *
+ * @param eId 게이지 종류
+ *
+ * @return 게이지 이름 문자열
+ */
+const char *getTcpGaugeName(TCP_GAUGE_ID);
+
+/**
+ * @brief 히스토그램 이름을 반환합니다. (예: "recv_to_send_latency")
+ *
+ * @param eId 히스토그램 종류
+ *
+ * @return 히스토그램 이름 문자열
+ */
+const char *getTcpHistogramName(TCP_HIST_ID);
+
+/**
+ * @brief 현재 스레드의 히스토그램에 값을 기록합니다.
+ *
+ * @param eId 히스토그램 종류
+ * @param u64Value 기록할 값
+ */
+void recordTcpHistogram(TCP_HIST_ID, uint64_t);
+
+/**
+ * @brief 모든 스레드의 메트릭을 합산한 스냅샷을 만듭니다.
+ *
+ * @param pstSnapshot 결과를 저장할 스냅샷
+ */
+void getTcpMetricsSnapshot(TCP_METRICS_SNAPSHOT*);
+
+/**
+ * @brief 히스토그램을 초기화합니다.
+ *
+ * @param pstHist 초기화할 히스토그램
+ */
+void resetTcpHistogram(TCP_HISTOGRAM*);
+
+/**
+ * @brief 히스토그램에 값을 기록합니다.
+ *
+ * @param pstHist 히스토그램
+ * @param u64Value 기록할 값
+ */
+void addTcpHistogramValue(TCP_HISTOGRAM*, uint64_t);
+
+/**
+ * @brief 히스토그램을 다른 히스토그램에 더합니다.
+ *
+ * @param pstDst 결과 히스토그램
+ * @param kpstSrc 더할 히스토그램
+ */
+void mergeTcpHistogram(TCP_HISTOGRAM*, const TCP_HISTOGRAM*);
+
+/**
+ * @brief 히스토그램의 백분위 값을 구합니다.
+ *
+ * @param kpstHist 히스토그램
+ * @param dPercentile 백분위 (0.0 ~ 100.0)
+ *
+ * @return 해당 백분위 버킷의 상한 값. 기록이 없으면 0을 반환합니다.
+ */
+uint64_t getTcpHistogramPercentile(const TCP_HISTOGRAM*, double);
+
+/**
+ * @brief 히스토그램 버킷에 기록될 수 있는 최대 값을 반환합니다.
+ *
+ * @param iIndex 버킷 인덱스 (0 ~ TCP_HIST_BUCKETS-1)
+ *
+ * @return 버킷 상한 값
+ */
+uint64_t getTcpHistogramBucketMax(int);
+
+/**
+ * @brief 현재 활성 연결 수를 계산합니다. (수락 - 해제)
+ *
+ * @param kpstSnapshot 스냅샷
+ *
+ * @return 활성 연결 수
+ */
+uint64_t getTcpActiveConnections(const TCP_METRICS_SNAPSHOT*);
+
+/**
+ * @brief 현재 송신 대기 중인 메시지 수를 계산합니다. (저장 - 꺼냄 - 버림)
+ *
+ * @param kpstSnapshot 스냅샷
+ *
+ * @return 큐 깊이
+ */
+uint64_t getTcpQueueDepth(const TCP_METRICS_SNAPSHOT*);
+
+/**
+ * @brief 두 스냅샷 사이의 초당 증가율을 계산합니다.
+ *
+ * @param kpstPrev 이전 스냅샷
+ * @param kpstCur 현재 스냅샷
+ * @param eId 카운터 종류
+ *
+ * @return 초당 증가량. 시간 차이가 없으면 0을 반환합니다.
+ */
+double getTcpMetricRate(const TCP_METRICS_SNAPSHOT*, const TCP_METRICS_SNAPSHOT*, TCP_METRIC_ID);
+
+/**
+ * @brief 단조 시계 기준 현재 시각을 나노초 단위로 반환합니다.
+ *
+ * @return 현재 시각 (ns)
+ */
+uint64_t getTcpMonotonicNs(void);
+
+#endif
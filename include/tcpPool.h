@@ -0,0 +1,117 @@
+#ifndef TCP_POOL_H
+#define TCP_POOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief   풀의 최대 연결 수
+ */
+#define TCP_POOL_MAX_CONNS 64
+
+/**
+ * @brief   연결당 최대 동시 요청 수 비트 수
+ * @details Correlation ID의 아래 비트는 대기 슬롯 번호, 위 비트는 재사용 세대입니다.
+ *          슬롯이 모두 차면 요청은 슬롯이 빌 때까지 기다립니다.
+ */
+#define TCP_POOL_SLOT_BITS 12
+
+/**
+ * @brief   연결당 최대 동시 요청 수
+ */
+#define TCP_POOL_MAX_INFLIGHT (1 << TCP_POOL_SLOT_BITS)
+
+/**
+ * @brief 지속 연결 풀 (구조는 tcpPool.c 내부)
+ */
+typedef struct TCP_POOL TCP_POOL;
+
+/**
+ * @brief 응답 콜백
+ *
+ * @details 연결의 수신 스레드에서 호출되므로 오래 걸리는 작업을 하지 않아야 합니다.
+ *          kpu8Data는 콜백이 끝나면 재사용되므로 필요하면 복사합니다.
+ *
+ * @param pvUser submitTcpPoolRequest()에 넘긴 사용자 포인터
+ * @param iStatus 0이면 응답 수신, 음수이면 -errno (연결 끊김: -ECONNRESET, 풀 해제: -ECANCELED)
+ * @param kpu8Data 응답 DATA (Correlation ID 제외). iStatus가 0이 아니면 NULL
+ * @param uiLen 응답 DATA 길이
+ */
+typedef void (*TCP_POOL_CALLBACK)(void *pvUser, int iStatus, const uint8_t *kpu8Data, size_t uiLen);
+
+/**
+ * @brief 서버에 지속 연결 여러 개를 열어 풀을 만듭니다.
+ *
+ * @details 연결마다 수신 스레드를 하나 두고, 응답은 Correlation ID로 요청과 짝지으므로
+ *          같은 연결에서 여러 요청을 동시에 보내고 순서와 관계없이 응답을 받을 수 있습니다.
+ *
+ * @param kpchHosts 호스트 이름 또는 쉼표로 구분한 주소 목록 (connectTcpClientSocket() 참고)
+ * @param iPort 서버의 포트 번호
+ * @param iConnCount 연결 수 (1 ~ TCP_POOL_MAX_CONNS)
+ * @param u8ClientId 프레임 Client ID
+ * @param iConnectTimeoutMs 연결별 연결 제한 시간 (ms)
+ *
+ * @return 생성된 풀. 연결을 하나도 열지 못하면 NULL을 반환합니다.
+ */
+TCP_POOL *createTcpPool(const char*, int, int, uint8_t, int);
+
+/**
+ * @brief 풀을 닫고 해제합니다.
+ *
+ * @details 연결을 모두 끊고, 응답을 받지 못한 요청의 콜백은 -ECANCELED로 호출됩니다.
+ *
+ * @param pstPool 풀
+ */
+void destroyTcpPool(TCP_POOL*);
+
+/**
+ * @brief 요청을 비동기로 보냅니다.
+ *
+ * @details 대기 요청이 가장 적은 살아 있는 연결을 고릅니다. 0을 반환하면 콜백은 정확히 한 번 호출되고,
+ *          -1을 반환하면 호출되지 않습니다.
+ *
+ * @param pstPool 풀
+ * @param u8Instruction Instruction
+ * @param kpvData 요청 DATA (길이가 0이면 NULL 가능)
+ * @param uiLen 요청 DATA 길이 (TCP_FRAME_MAX_DATA - TCP_FRAME_CORR_ID_SIZE 이하)
+ * @param pfnCallback 응답 콜백
+ * @param pvUser 콜백에 넘길 사용자 포인터
+ *
+ * @return 성공 시 0, 실패 시 -1을 반환하며 errno를 설정합니다. (살아 있는 연결이 없으면 ENOTCONN)
+ */
+int submitTcpPoolRequest(TCP_POOL*, uint8_t, const void*, size_t, TCP_POOL_CALLBACK, void*);
+
+/**
+ * @brief 요청을 보내고 응답을 기다립니다.
+ *
+ * @param pstPool 풀
+ * @param u8Instruction Instruction
+ * @param kpvData 요청 DATA
+ * @param uiLen 요청 DATA 길이
+ * @param pvOut 응답 DATA를 저장할 버퍼. 작으면 잘립니다.
+ * @param uiOutSize 버퍼 크기
+ * @param iTimeoutMs 응답 제한 시간 (ms). 0 이하이면 제한 없음
+ *
+ * @return 응답 DATA 길이 (잘리기 전). 실패 시 -1을 반환하며 errno를 설정합니다. (제한 시간 초과는 ETIMEDOUT)
+ */
+int callTcpPool(TCP_POOL*, uint8_t, const void*, size_t, void*, size_t, int);
+
+/**
+ * @brief 풀 전체에서 응답을 기다리는 요청 수를 반환합니다.
+ *
+ * @param pstPool 풀
+ *
+ * @return 대기 요청 수
+ */
+int getTcpPoolInflight(TCP_POOL*);
+
+/**
+ * @brief 살아 있는 연결 수를 반환합니다.
+ *
+ * @param pstPool 풀
+ *
+ * @return 연결 수
+ */
+int getTcpPoolLiveConns(TCP_POOL*);
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef TCP_PROBE_H
+#define TCP_PROBE_H
+
+/**
+ * @file tcpProbe.h
+ * @brief USDT(사용자 정적 트레이스포인트) 매크로
+ *
+ * @details <sys/sdt.h> (systemtap-sdt-dev) 가 있으면 DTRACE_PROBEn 으로 정적 트레이스포인트를 심습니다.
+ *          트레이서가 붙지 않은 상태에서는 nop 명령 하나만 남으므로 비용이 없고,
+ *          bpftrace 등으로 다시 컴파일하지 않고 확인할 수 있습니다.
+ *          헤더가 없거나 TCP_NO_SDT 가 정의되면 인자를 평가하지 않는 빈 매크로가 됩니다.
+ *
+ *          예) bpftrace -e 'usdt:./tcpServer:tcpServer:write_complete { @[arg0] = sum(arg1); }'
+ */
+
+#if !defined(TCP_NO_SDT) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define TCP_PROBE_ENABLED 1
+#endif
+#endif
+
+#ifdef TCP_PROBE_ENABLED
+#define TCP_PROBE1(provider, name, a1)              DTRACE_PROBE1(provider, name, a1)
+#define TCP_PROBE2(provider, name, a1, a2)          DTRACE_PROBE2(provider, name, a1, a2)
+#define TCP_PROBE3(provider, name, a1, a2, a3)      DTRACE_PROBE3(provider, name, a1, a2, a3)
+#else
+#define TCP_PROBE1(provider, name, a1)              do { if (0) { (void)(a1); } } while (0)
+#define TCP_PROBE2(provider, name, a1, a2)          do { if (0) { (void)(a1); (void)(a2); } } while (0)
+#define TCP_PROBE3(provider, name, a1, a2, a3)      do { if (0) { (void)(a1); (void)(a2); (void)(a3); } } while (0)
+#endif
+
+#endif
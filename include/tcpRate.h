@@ -0,0 +1,147 @@
+#ifndef TCP_RATE_H
+#define TCP_RATE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief   토큰 버킷이 한 번에 허용하는 최대 폭주 크기 (설정한 전송률의 몇 ms 분량인지)
+ */
+#define TCP_RATE_BURST_MS 100
+
+/**
+ * @brief   Client ID 개수 (프레임 Client ID 필드가 1바이트)
+ */
+#define TCP_RATE_CLIENT_IDS 256
+
+/**
+ * @brief 전송률 제한 값
+ */
+typedef struct {
+    uint64_t u64BytesPerSec;        /**< 초당 바이트 (0이면 제한 없음) */
+    uint64_t u64MsgsPerSec;         /**< 초당 메시지 (0이면 제한 없음) */
+} TCP_RATE_LIMIT;
+
+/**
+ * @brief 바이트와 메시지 두 가지를 함께 세는 토큰 버킷
+ *
+ * @details 토큰은 시간에 비례하여 채워지고 폭주 크기(TCP_RATE_BURST_MS 분량)를 넘지 않습니다.
+ *          사용량은 먼저 빼고 나중에 기다리는 방식이라 토큰이 음수(빚)가 될 수 있으며,
+ *          빚이 다 갚아질 때까지의 시간을 대기 시간으로 돌려줍니다. 잠금이 없으므로 한 스레드만 사용합니다.
+ */
+typedef struct {
+    TCP_RATE_LIMIT stLimit;         /**< 적용 중인 제한 */
+    double dByteTokens;             /**< 남은 바이트 토큰 */
+    double dMsgTokens;              /**< 남은 메시지 토큰 */
+    uint64_t u64LastNs;             /**< 마지막으로 토큰을 채운 시각 (단조 시계, ns) */
+} TCP_TOKEN_BUCKET;
+
+/**
+ * @brief 연결별 전송률 제한 상태
+ *
+ * @details 연결 기본 제한(setTcpConnRateLimit)이 바뀌면 다음 사용량을 셀 때 새 제한을 가져옵니다.
+ */
+typedef struct {
+    TCP_TOKEN_BUCKET stBucket;      /**< 연결 전용 버킷 (수신 스레드만 사용) */
+    uint32_t u32Version;            /**< 가져온 연결 기본 제한의 버전 */
+} TCP_CONN_RATE;
+
+/**
+ * @brief 토큰 버킷을 가득 찬 상태로 초기화합니다.
+ *
+ * @param pstBucket 토큰 버킷
+ * @param kpstLimit 제한 값
+ * @param u64NowNs 현재 시각 (단조 시계, ns)
+ */
+void initTcpTokenBucket(TCP_TOKEN_BUCKET*, const TCP_RATE_LIMIT*, uint64_t);
+
+/**
+ * @brief 토큰 버킷의 제한을 바꿉니다. 남은 빚은 유지하고, 남은 토큰은 새 폭주 크기로 자릅니다.
+ *
+ * @param pstBucket 토큰 버킷
+ * @param kpstLimit 새 제한 값
+ * @param u64NowNs 현재 시각 (단조 시계, ns)
+ */
+void setTcpTokenBucketLimit(TCP_TOKEN_BUCKET*, const TCP_RATE_LIMIT*, uint64_t);
+
+/**
+ * @brief 사용량을 토큰 버킷에서 빼고, 제한 안으로 돌아올 때까지 기다려야 할 시간을 구합니다.
+ *
+ * @param pstBucket 토큰 버킷
+ * @param u64Bytes 사용한 바이트 수
+ * @param u64Msgs 사용한 메시지 수
+ * @param u64NowNs 현재 시각 (단조 시계, ns)
+ *
+ * @return 기다려야 할 시간 (ns). 제한 안이면 0
+ */
+uint64_t takeTcpTokenBucket(TCP_TOKEN_BUCKET*, uint64_t, uint64_t, uint64_t);
+
+/**
+ * @brief 모든 연결에 적용할 연결별 기본 제한을 바꿉니다. 실행 중인 연결에도 바로 적용됩니다.
+ *
+ * @param kpstLimit 제한 값 (모두 0이면 제한 없음)
+ */
+void setTcpConnRateLimit(const TCP_RATE_LIMIT*);
+
+/**
+ * @brief 연결별 기본 제한을 얻습니다.
+ *
+ * @param pstLimit 제한 값을 저장할 구조체
+ */
+void getTcpConnRateLimit(TCP_RATE_LIMIT*);
+
+/**
+ * @brief Client ID 하나의 제한을 바꿉니다.
+ *
+ * @details 같은 Client ID를 쓰는 모든 연결이 한 버킷을 함께 씁니다.
+ *
+ * @param u8ClientId Client ID
+ * @param kpstLimit 제한 값 (모두 0이면 제한 없음)
+ */
+void setTcpClientIdRateLimit(uint8_t, const TCP_RATE_LIMIT*);
+
+/**
+ * @brief Client ID 하나의 제한을 얻습니다.
+ *
+ * @param u8ClientId Client ID
+ * @param pstLimit 제한 값을 저장할 구조체
+ *
+ * @return 제한이 있으면 true
+ */
+bool getTcpClientIdRateLimit(uint8_t, TCP_RATE_LIMIT*);
+
+/**
+ * @brief 연결별 제한 상태를 현재 연결 기본 제한으로 초기화합니다.
+ *
+ * @param pstRate 연결별 제한 상태
+ * @param u64NowNs 현재 시각 (단조 시계, ns)
+ */
+void initTcpConnRate(TCP_CONN_RATE*, uint64_t);
+
+/**
+ * @brief 연결의 사용량을 세고 기다려야 할 시간을 구합니다.
+ *
+ * @param pstRate 연결별 제한 상태
+ * @param u64Bytes 사용한 바이트 수
+ * @param u64Msgs 사용한 메시지 수
+ * @param u64NowNs 현재 시각 (단조 시계, ns)
+ *
+ * @return 기다려야 할 시간 (ns). 제한이 없거나 제한 안이면 0
+ */
+uint64_t takeTcpConnRate(TCP_CONN_RATE*, uint64_t, uint64_t, uint64_t);
+
+/**
+ * @brief Client ID의 사용량을 세고 기다려야 할 시간을 구합니다.
+ *
+ * @details 제한이 없는 Client ID는 잠금 없이 바로 0을 반환합니다.
+ *
+ * @param u8ClientId Client ID
+ * @param u64Bytes 사용한 바이트 수
+ * @param u64Msgs 사용한 메시지 수
+ * @param u64NowNs 현재 시각 (단조 시계, ns)
+ *
+ * @return 기다려야 할 시간 (ns). 제한이 없거나 제한 안이면 0
+ */
+uint64_t takeTcpClientIdRate(uint8_t, uint64_t, uint64_t, uint64_t);
+
+#endif
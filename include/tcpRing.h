@@ -0,0 +1,191 @@
+#ifndef TCP_RING_H
+#define TCP_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/uio.h>
+
+/**
+ * @brief   기본 링 버퍼 크기 (바이트)
+ */
+#define TCP_RING_DEFAULT_SIZE (256 * 1024)
+
+/**
+ * @brief 단일 생산자/단일 소비자(SPSC) 가변 길이 레코드 링 버퍼
+ *
+ * @details 레코드는 4바이트 길이와 데이터로 저장되며, 버퍼 끝에서는 둘로 나뉘어 저장됩니다.
+ *          생산자는 u64Tail만, 소비자는 u64Head만 갱신하므로 잠금이 필요하지 않습니다.
+ *          두 위치는 서로 다른 캐시 라인에 둡니다.
+ *          포인터를 담지 않으므로 프로세스 간 공유 메모리에 그대로 둘 수 있습니다. (initTcpRing())
+ */
+typedef struct {
+    uint64_t u64Head;               /**< 소비자 위치 (누적 바이트) */
+    uint8_t au8HeadPad[56];         /**< 캐시 라인 분리 */
+    uint64_t u64Tail;               /**< 생산자 위치 (누적 바이트) */
+    uint8_t au8TailPad[56];         /**< 캐시 라인 분리 */
+    uint32_t u32Capacity;           /**< 데이터 영역 크기 (2의 거듭제곱) */
+    uint32_t u32Mask;               /**< u32Capacity - 1 */
+    uint8_t au8Data[];              /**< 데이터 영역 */
+} TCP_RING;
+
+/**
+ * @brief 상대 프로세스와 공유하는 링의 한쪽 끝
+ *
+ * @details 공유 메모리에 둔 링은 머리(용량, 위치)와 레코드 길이를 상대가 언제든 바꿀 수 있습니다.
+ *          용량과 이쪽 위치는 붙을 때 이 구조체에 복사해 두고 이 값만 쓰며, 상대 위치와 레코드 길이는 읽을 때마다 검사합니다.
+ *          구조체는 이쪽 프로세스 메모리에 둡니다.
+ */
+typedef struct {
+    TCP_RING *pstRing;              /**< 공유 메모리의 링 */
+    uint32_t u32Capacity;           /**< 붙을 때 확인한 데이터 영역 크기 (2의 거듭제곱) */
+    uint64_t u64Pos;                /**< 이쪽 위치 (생산자면 tail, 소비자면 head) */
+} TCP_RING_END;
+
+/**
+ * @brief   popTcpRingEnd(), pushTcpRingEnd()가 상대가 링을 망가뜨린 것을 발견했을 때 반환하는 값
+ */
+#define TCP_RING_CORRUPT (-2)
+
+/**
+ * @brief 링 버퍼를 생성합니다.
+ *
+ * @param u32Capacity 데이터 영역 크기. 2의 거듭제곱으로 올림됩니다.
+ *
+ * @return 생성된 링 버퍼. 실패 시 NULL을 반환합니다.
+ */
+TCP_RING *createTcpRing(uint32_t);
+
+/**
+ * @brief 링 버퍼가 차지하는 전체 바이트 수를 구합니다. (헤더 + 올림된 데이터 영역)
+ *
+ * @param u32Capacity 데이터 영역 크기. 2의 거듭제곱으로 올림됩니다.
+ *
+ * @return initTcpRing()에 넘길 메모리 크기
+ */
+size_t getTcpRingFootprint(uint32_t);
+
+/**
+ * @brief 호출자가 준비한 메모리에 빈 링 버퍼를 만듭니다.
+ *
+ * @details 공유 메모리처럼 destroyTcpRing()으로 해제하지 않는 메모리에 링을 둘 때 사용합니다.
+ *          메모리는 getTcpRingFootprint() 바이트 이상이고 64바이트 정렬이어야 합니다.
+ *
+ * @param pvMem 링을 둘 메모리
+ * @param u32Capacity 데이터 영역 크기. 2의 거듭제곱으로 올림됩니다.
+ *
+ * @return pvMem을 링 버퍼로 본 포인터
+ */
+TCP_RING *initTcpRing(void*, uint32_t);
+
+/**
+ * @brief 링 버퍼를 해제합니다.
+ *
+ * @param pstRing 링 버퍼
+ */
+void destroyTcpRing(TCP_RING*);
+
+/**
+ * @brief 레코드 하나를 넣습니다. (생산자 전용)
+ *
+ * @param pstRing 링 버퍼
+ * @param kpvData 데이터
+ * @param u32Len 데이터 길이 (1 이상)
+ *
+ * @return 성공 시 true, 공간이 부족하면 false를 반환합니다.
+ */
+bool pushTcpRing(TCP_RING*, const void*, uint32_t);
+
+/**
+ * @brief 여러 조각을 이어 붙여 레코드 하나로 넣습니다. (생산자 전용)
+ *
+ * @param pstRing 링 버퍼
+ * @param kpstIov 데이터 조각 배열
+ * @param iIovCount 조각 수
+ *
+ * @return 성공 시 true, 공간이 부족하면 false를 반환합니다.
+ */
+bool pushTcpRingParts(TCP_RING*, const struct iovec*, int);
+
+/**
+ * @brief 레코드 하나를 꺼냅니다. (소비자 전용)
+ *
+ * @param pstRing 링 버퍼
+ * @param pvOut 레코드를 저장할 버퍼
+ * @param u32OutSize 버퍼 크기
+ *
+ * @return 레코드 길이. 비어 있으면 0, 버퍼가 작으면 레코드를 남겨 두고 -1을 반환합니다.
+ */
+int popTcpRing(TCP_RING*, void*, uint32_t);
+
+/**
+ * @brief 레코드 하나를 읽지 않고 버립니다. (소비자 전용)
+ *
+ * @param pstRing 링 버퍼
+ *
+ * @return 버린 레코드 길이. 비어 있으면 0을 반환합니다.
+ */
+int skipTcpRing(TCP_RING*);
+
+/**
+ * @brief 공유 링의 한쪽 끝을 엽니다.
+ *
+ * @param pstEnd 이쪽 끝 (이쪽 메모리)
+ * @param pstRing 공유 메모리의 링
+ * @param u32Capacity 링을 만든 쪽과 약속한 데이터 영역 크기 (2의 거듭제곱)
+ * @param bProducer 이쪽이 생산자이면 true, 소비자이면 false
+ */
+void openTcpRingEnd(TCP_RING_END*, TCP_RING*, uint32_t, bool);
+
+/**
+ * @brief 공유 링에 레코드 하나를 넣습니다. (생산자 끝 전용)
+ *
+ * @param pstEnd 생산자 끝
+ * @param kpvData 데이터
+ * @param u32Len 데이터 길이 (1 이상)
+ *
+ * @return 성공 시 1, 공간이 부족하면 0, 상대 위치가 맞지 않으면 TCP_RING_CORRUPT
+ */
+int pushTcpRingEnd(TCP_RING_END*, const void*, uint32_t);
+
+/**
+ * @brief 공유 링에서 레코드 하나를 꺼냅니다. (소비자 끝 전용)
+ *
+ * @details 레코드 길이가 쓰인 바이트나 용량을 넘으면 읽지 않고 TCP_RING_CORRUPT를 반환합니다.
+ *
+ * @param pstEnd 소비자 끝
+ * @param pvOut 레코드를 저장할 버퍼
+ * @param u32OutSize 버퍼 크기
+ *
+ * @return 레코드 길이. 비어 있으면 0, 버퍼가 작으면 레코드를 남겨 두고 -1, 망가졌으면 TCP_RING_CORRUPT
+ */
+int popTcpRingEnd(TCP_RING_END*, void*, uint32_t);
+
+/**
+ * @brief 공유 링의 사용 중인 바이트 수를 반환합니다.
+ *
+ * @param kpstEnd 이쪽 끝
+ *
+ * @return 사용 중인 바이트 수. 상대 위치가 맞지 않으면 용량보다 큰 값
+ */
+uint64_t getTcpRingEndUsed(const TCP_RING_END*);
+
+/**
+ * @brief 사용 중인 바이트 수를 반환합니다. (레코드 길이 필드 포함)
+ *
+ * @param kpstRing 링 버퍼
+ *
+ * @return 사용 중인 바이트 수
+ */
+uint32_t getTcpRingUsed(const TCP_RING*);
+
+/**
+ * @brief 링 버퍼가 비어 있는지 확인합니다.
+ *
+ * @param kpstRing 링 버퍼
+ *
+ * @return 비어 있으면 true
+ */
+bool isTcpRingEmpty(const TCP_RING*);
+
+#endif
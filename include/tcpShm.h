@@ -0,0 +1,149 @@
+#ifndef TCP_SHM_H
+#define TCP_SHM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief   공유 메모리 영역 식별 값 ("TSHM")
+ */
+#define TCP_SHM_MAGIC 0x5453484Du
+
+/**
+ * @brief   공유 메모리 영역 형식 버전
+ */
+#define TCP_SHM_VERSION 1
+
+/**
+ * @brief   방향별 기본 링 크기 (바이트)
+ */
+#define TCP_SHM_DEFAULT_RING_SIZE (1024 * 1024)
+
+/**
+ * @brief   방향별 최대 링 크기 (바이트)
+ */
+#define TCP_SHM_MAX_RING_SIZE (64 * 1024 * 1024)
+
+/**
+ * @brief   잠들기 전에 링을 다시 확인하는 횟수
+ * @details 상대가 바로 응답하는 경우 futex 시스템 호출 없이 이어받도록 잠깐 돌며 기다립니다.
+ *          CPU가 하나뿐인 환경에서는 돌지 않습니다.
+ */
+#define TCP_SHM_SPIN_COUNT 4000
+
+/**
+ * @brief 공유 메모리 링 전송 (구조는 tcpShm.c 내부)
+ *
+ * @details memfd로 만든 영역에 방향별 SPSC 링 두 개(클라이언트→서버, 서버→클라이언트)를 둡니다.
+ *          레코드 하나는 프레임 하나이며 형식은 소켓과 같습니다.
+ *          소비자는 링이 비었을 때만 futex로 잠들고, 생산자는 상대가 잠들어 있을 때만 깨우므로
+ *          부하가 이어지는 동안에는 시스템 호출 없이 메시지가 오갑니다.
+ *          한 방향의 송신과 수신은 각각 한 스레드에서만 호출해야 합니다.
+ */
+typedef struct TCP_SHM TCP_SHM;
+
+/**
+ * @brief 공유 메모리 영역을 만듭니다. (클라이언트 측)
+ *
+ * @param u32RingSize 방향별 링 크기. 2의 거듭제곱으로 올림됩니다. (TCP_SHM_MAX_RING_SIZE 이하)
+ *
+ * @return 생성된 전송. 실패 시 NULL을 반환하며 errno를 설정합니다.
+ */
+TCP_SHM *createTcpShm(uint32_t);
+
+/**
+ * @brief 상대가 넘긴 memfd를 매핑하여 전송에 붙습니다. (서버 측)
+ *
+ * @details 영역의 식별 값, 버전, 크기와 memfd의 크기 봉인(F_SEAL_SHRINK|F_SEAL_GROW)을 확인합니다.
+ *          링 크기는 이때 한 번만 읽어 두고, 이후 상대가 영역을 망가뜨리면 송수신이 EPROTO로 실패합니다.
+ *          성공하면 fd는 전송이 소유합니다.
+ *
+ * @param iMemFd 공유 메모리 fd
+ *
+ * @return 전송. 실패 시 NULL을 반환하며 errno를 설정합니다. (형식이 맞지 않거나 봉인이 없으면 EPROTO)
+ */
+TCP_SHM *attachTcpShm(int);
+
+/**
+ * @brief 전송을 닫았다고 표시하고 기다리는 쪽을 모두 깨웁니다.
+ *
+ * @details 양쪽 모두 이후 송신은 EPIPE로 실패하고, 수신은 남은 레코드를 다 읽은 뒤 EPIPE로 실패합니다.
+ *          다른 스레드가 전송을 쓰는 중에 호출해도 됩니다.
+ *
+ * @param pstShm 전송
+ */
+void closeTcpShm(TCP_SHM*);
+
+/**
+ * @brief 어느 쪽이든 전송을 닫았는지 확인합니다.
+ *
+ * @param kpstShm 전송
+ *
+ * @return 닫혔으면 true
+ */
+bool isTcpShmClosed(const TCP_SHM*);
+
+/**
+ * @brief 전송을 닫고 매핑과 fd를 해제합니다.
+ *
+ * @details 송수신 중인 스레드가 없을 때 호출합니다. 먼저 closeTcpShm()으로 깨운 뒤 스레드를 기다립니다.
+ *
+ * @param pstShm 전송
+ */
+void destroyTcpShm(TCP_SHM*);
+
+/**
+ * @brief 공유 메모리 fd를 반환합니다. (SCM_RIGHTS로 상대에게 넘길 때 사용)
+ *
+ * @param kpstShm 전송
+ *
+ * @return memfd
+ */
+int getTcpShmFd(const TCP_SHM*);
+
+/**
+ * @brief 레코드(프레임) 하나를 보냅니다.
+ *
+ * @param pstShm 전송
+ * @param kpvData 데이터
+ * @param u32Len 데이터 길이 (1 이상)
+ * @param iTimeoutMs 링이 가득 찼을 때 기다릴 시간 (ms). 음수이면 제한 없음, 0이면 기다리지 않음
+ *
+ * @return 성공 시 0, 실패 시 -1을 반환하며 errno를 설정합니다.
+ *         (닫힘 EPIPE, 시간 초과 EAGAIN, 링보다 큰 레코드 EMSGSIZE, 상대가 링을 망가뜨림 EPROTO)
+ */
+int sendTcpShm(TCP_SHM*, const void*, uint32_t, int);
+
+/**
+ * @brief 레코드(프레임) 하나를 받습니다.
+ *
+ * @param pstShm 전송
+ * @param pvOut 레코드를 저장할 버퍼
+ * @param u32OutSize 버퍼 크기
+ * @param iTimeoutMs 링이 비었을 때 기다릴 시간 (ms). 음수이면 제한 없음, 0이면 기다리지 않음
+ *
+ * @return 레코드 길이. 시간 초과면 0, 실패 시 -1을 반환하며 errno를 설정합니다.
+ *         (닫힘 EPIPE, 버퍼가 작으면 레코드를 남겨 두고 EMSGSIZE, 상대가 링을 망가뜨림 EPROTO)
+ */
+int recvTcpShm(TCP_SHM*, void*, uint32_t, int);
+
+/**
+ * @brief Unix 도메인 연결로 서버에 공유 메모리 전송을 제안하고 응답을 기다립니다. (클라이언트 측)
+ *
+ * @details 영역을 만들어 memfd를 TCP_INST_SHM_OFFER 프레임과 함께 SCM_RIGHTS로 보내고,
+ *          같은 Instruction의 응답 프레임(DATA 첫 바이트가 상태, 0이면 수락)을 기다립니다.
+ *          fd는 Unix 도메인 소켓으로만 넘길 수 있으므로 TCP 연결에서는 EOPNOTSUPP로 실패합니다.
+ *          응답을 기다리는 동안 소켓의 다른 응답은 버리므로, 다른 요청의 응답이 남아 있지 않을 때 호출합니다.
+ *          수락된 뒤에도 소켓 연결은 살아 있음을 알리는 용도로 유지하며, 소켓을 닫으면 서버가 전송을 정리합니다.
+ *
+ * @param iSock 서버에 연결된 Unix 도메인 소켓
+ * @param u8ClientId 프레임 Client ID
+ * @param u32RingSize 방향별 링 크기
+ * @param iTimeoutMs 응답 제한 시간 (ms)
+ *
+ * @return 수락된 전송. 실패 시 NULL을 반환하며 errno를 설정합니다. (서버 거절 시 서버가 보낸 오류 값)
+ */
+TCP_SHM *offerTcpShm(int, uint8_t, uint32_t, int);
+
+#endif
@@ -4,6 +4,8 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <netinet/tcp.h> // TCP_KEEPIDLE 등 TCP 옵션 정의
+#include <sys/socket.h>
+#include <stddef.h>
 
 /**
  * @brief   최대 클라이언트 수를 정의합니다.
@@ -23,20 +25,203 @@
  * @param iPort 서버가 연결을 수신할 포트 번호
  * @param iMaxClients 허용할 최대 클라이언트 수
  * 
- * @return 서버 소켓에 대한 파일 디스크립터를 반환.
+ * @return 서버 소켓에 대한 파일 디스크립터를 반환. 실패 시 -1을 반환하며 errno에 오류가 남습니다.
+ *
+ * @details createTcpServerSocketOn(NULL, iPort, iMaxClients)와 같습니다. (IPv4/IPv6 이중 스택 와일드카드)
  */
 int createTcpServerSocket(int, int);
 
+/**
+ * @brief 지정한 주소에 서버 소켓을 생성하고 필요한 옵션을 설정합니다.
+ *
+ * @details 바인드 주소가 IPv6이면 IPV6_V6ONLY를 끄므로 "::" 에서는 IPv4 연결도 함께 받습니다. (이중 스택)
+ *          IPv6를 쓸 수 없는 커널에서 와일드카드를 요청하면 0.0.0.0으로 대신합니다.
+ *          Keep-Alive 옵션은 주소 체계와 관계없이 같은 값으로 설정됩니다.
+ *
+ * @param kpchBindAddr 숫자 바인드 주소 ("::", "0.0.0.0", "127.0.0.1", "[::1]" 등). NULL, "" 또는 "*" 이면 "::"
+ * @param iPort 서버가 연결을 수신할 포트 번호 (0이면 임시 포트)
+ * @param iMaxClients listen() 대기열 길이
+ *
+ * @return 서버 소켓에 대한 파일 디스크립터를 반환. 실패 시 -1을 반환하며 errno에 오류가 남습니다.
+ *         (숫자 주소가 아니면 EINVAL, 포트 사용 중이면 EADDRINUSE 등. 만들던 소켓은 닫힙니다.)
+ */
+int createTcpServerSocketOn(const char*, int, int);
+
 /**
  * @brief 클라이언트 소켓을 생성하여 서버에 연결합니다.
  * 
- * @param kpchIp 서버의 IP 주소
+ * @param kpchIp 서버의 IPv4/IPv6 주소 또는 호스트 이름
  * @param iPort 서버의 포트 번호
  * 
  * @return 생성된 클라이언트 소켓 파일 디스크립터를 반환. 실패 시 -1을 반환합니다.
+ *
+ * @details 제한 시간 없이 connectTcpClientSocket()을 호출하므로 응답 없는 서버에는 SYN 재전송 동안 멈출 수 있습니다.
+ *          제한 시간이 필요하면 connectTcpClientSocket()을 직접 사용합니다.
  */
 int createTcpClientSocket(const char*, int);
 
+/**
+ * @brief 같은 호스트의 클라이언트를 위한 Unix 도메인 스트림 소켓을 생성하여 대기합니다.
+ *
+ * @details TCP 대기 소켓과 같은 프레임 형식과 서버 처리 경로를 쓰면서 루프백 TCP 스택 비용을 줄입니다.
+ *          파일 경로이면 이전 실행에서 남은 소켓 파일을 지우고 바인드합니다.
+ *
+ * @param kpchPath 소켓 경로. '@'로 시작하면 추상 네임스페이스 (파일을 만들지 않음)
+ * @param iMaxClients listen() 대기열 길이
+ *
+ * @return 서버 소켓에 대한 파일 디스크립터를 반환. 실패 시 -1을 반환하며 errno에 오류가 남습니다. (경로가 너무 길면 ENAMETOOLONG)
+ */
+int createTcpUnixServerSocket(const char*, int);
+
+/**
+ * @brief Unix 도메인 스트림 소켓으로 같은 호스트의 서버에 연결합니다.
+ *
+ * @param kpchPath 소켓 경로. '@'로 시작하면 추상 네임스페이스
+ *
+ * @return 연결된 소켓 파일 디스크립터. 실패 시 -1을 반환하며 errno에 오류가 남습니다.
+ */
+int createTcpUnixClientSocket(const char*);
+
+/**
+ * @brief   한 번에 넘길 수 있는 최대 소켓 fd 수를 정의합니다.
+ */
+#define TCP_SOCK_MAX_PASS_FDS 8
+
+/**
+ * @brief Unix 도메인 소켓으로 연결된 다른 프로세스에 fd들을 넘깁니다. (SCM_RIGHTS)
+ *
+ * @details 받는 프로세스는 같은 커널 소켓을 가리키는 새 fd를 얻습니다. 대기 소켓을 넘기면 대기열에 쌓인 연결과
+ *          이후 들어오는 연결을 받는 쪽에서도 accept()할 수 있으므로, 재시작 중에도 연결이 거절되지 않습니다.
+ *          보낸 쪽의 fd는 그대로 열려 있습니다.
+ *
+ * @param iSock 연결된 Unix 도메인 스트림 소켓
+ * @param kpiFds 넘길 fd 배열 (순서가 유지됩니다)
+ * @param iCount fd 수 (1 ~ TCP_SOCK_MAX_PASS_FDS)
+ *
+ * @return 성공 시 0, 실패 시 -1 (errno 설정)
+ */
+int sendTcpSocketFds(int, const int*, int);
+
+/**
+ * @brief sendTcpSocketFds()로 넘어온 fd들을 받습니다.
+ *
+ * @details 받은 fd에는 FD_CLOEXEC가 설정됩니다. 일부만 받았거나 보낸 수와 다르면 받은 fd를 모두 닫고 실패합니다.
+ *
+ * @param iSock 연결된 Unix 도메인 스트림 소켓
+ * @param piFds 받은 fd를 저장할 배열
+ * @param iMaxCount 배열 크기
+ * @param iTimeoutMs 기다릴 최대 시간 (ms). 0 이하이면 제한 없음
+ *
+ * @return 받은 fd 수. 실패 시 -1 (제한 시간 초과는 ETIMEDOUT, 형식 오류는 EPROTO)
+ */
+int recvTcpSocketFds(int, int*, int, int);
+
+/**
+ * @brief   소켓 주소 문자열의 최대 길이를 정의합니다. ("[IPv6]:포트" 또는 "unix:경로" 와 NUL 포함)
+ */
+#define TCP_SOCK_ADDR_STRLEN 112
+
+/**
+ * @brief 소켓 주소를 "IP:포트" 문자열로 바꿉니다.
+ *
+ * @details IPv6는 "[::1]:8080" 처럼 대괄호로 감쌉니다. 이중 스택 소켓으로 받은 IPv4 연결(::ffff:a.b.c.d)은 "a.b.c.d:포트" 로,
+ *          Unix 도메인 주소는 "unix:경로" (추상 네임스페이스는 "unix:@이름") 로 씁니다.
+ *
+ * @param kpstAddr 소켓 주소 (AF_INET, AF_INET6 또는 AF_UNIX)
+ * @param pchBuf 결과 버퍼 (TCP_SOCK_ADDR_STRLEN 이상 권장)
+ * @param uiBufSize 결과 버퍼 크기
+ *
+ * @return pchBuf
+ */
+const char *formatTcpSockAddr(const struct sockaddr*, char*, size_t);
+
+/**
+ * @brief 연결된 소켓의 상대 주소를 문자열로 바꿉니다.
+ *
+ * @details formatTcpSockAddr() 형식을 따르며, 이름 없는 Unix 도메인 클라이언트는 받은 쪽 대기 경로("unix:경로")로 씁니다.
+ *
+ * @param iSock 연결된 소켓 파일 디스크립터
+ * @param pchBuf 결과 버퍼
+ * @param uiBufSize 결과 버퍼 크기
+ *
+ * @return pchBuf
+ */
+const char *formatTcpPeerName(int, char*, size_t);
+
+/**
+ * @brief accept()용 예비 fd를 엽니다. (/dev/null)
+ *
+ * @details acceptTcpClientSocket()에 넘겨, fd가 모자랄 때 잠깐 풀어 쓸 자리를 미리 잡아 둡니다.
+ *
+ * @return 예비 fd. 실패 시 -1
+ */
+int openTcpReserveFd(void);
+
+/**
+ * @brief 대기 소켓에서 연결 하나를 받습니다. fd가 모자라면 대기열 맨 앞 연결을 받아 바로 닫습니다.
+ *
+ * @details EMFILE/ENFILE이면 예비 fd를 닫아 생긴 자리로 연결을 받고 즉시 닫은 뒤 예비 fd를 다시 엽니다.
+ *          받지 못한 연결이 대기열에 남아 select()가 계속 깨우는 헛돌기를 막고, 상대는 바로 실패를 알게 됩니다.
+ *          예비 fd를 다시 열지 못하면(다른 스레드가 자리를 가져감) *piReserveFd는 -1이 되며, 호출자가 나중에 다시 엽니다.
+ *
+ * @param iListenSock 대기 소켓
+ * @param piReserveFd openTcpReserveFd()로 연 예비 fd (NULL이거나 -1이면 예비 fd 없이 accept()와 같음)
+ *
+ * @return 받은 소켓. 실패 시 -1 (errno 설정. fd 부족으로 연결을 닫았으면 EMFILE 또는 ENFILE)
+ */
+int acceptTcpClientSocket(int, int*);
+
+/**
+ * @brief 소켓이 바인드된 로컬 포트 번호를 구합니다. (임시 포트 확인용)
+ *
+ * @param iSock 소켓 파일 디스크립터
+ *
+ * @return 포트 번호. 실패 시 -1
+ */
+int getTcpSocketPort(int);
+
+/**
+ * @brief   연결 시도 간격(ms)을 정의합니다.
+ * @details 앞선 연결 시도가 이 시간 안에 끝나지 않으면 다음 주소로 연결을 동시에 시작합니다. (RFC 8305 권장값)
+ */
+#define TCP_CONNECT_ATTEMPT_DELAY_MS 250
+
+/**
+ * @brief   한 번의 연결에서 시도할 최대 주소 수를 정의합니다.
+ */
+#define TCP_CONNECT_MAX_ADDRS 16
+
+/**
+ * @brief 호스트 이름 또는 주소 목록으로 비차단 연결을 시도하여 먼저 성공한 소켓을 반환합니다.
+ *
+ * @details 주소를 IPv6/IPv4가 번갈아 오도록 정렬한 뒤 TCP_CONNECT_ATTEMPT_DELAY_MS 간격으로
+ *          비차단 connect()를 겹쳐 시작하고(Happy Eyeballs), 가장 먼저 연결된 소켓을 남기고 나머지는 닫습니다.
+ *          시도가 실패하면 간격을 기다리지 않고 다음 주소를 바로 시도합니다.
+ *          반환된 소켓은 차단 모드로 되돌려집니다.
+ *
+ * @param kpchHosts 호스트 이름 또는 주소. 쉼표로 여러 개를 지정할 수 있습니다. (예: "server.local", "::1,127.0.0.1")
+ * @param iPort 서버의 포트 번호
+ * @param iTimeoutMs 전체 연결 제한 시간 (ms). 0 이하이면 제한 없음
+ *
+ * @return 연결된 소켓 파일 디스크립터. 실패 시 -1을 반환하며 errno에 마지막 오류가 남습니다. (제한 시간 초과는 ETIMEDOUT)
+ */
+int connectTcpClientSocket(const char*, int, int);
+
+/**
+ * @brief 재연결 대기 시간을 구합니다. (상한이 있는 지수 백오프 + full jitter)
+ *
+ * @details min(iMaxMs, iBaseMs * 2^iAttempt) 이하에서 균등하게 고릅니다.
+ *          여러 클라이언트가 같은 순간에 끊겨도 재연결 시각이 흩어지므로 서버에 연결이 몰리지 않습니다.
+ *
+ * @param iAttempt 연속 실패 횟수 (0부터)
+ * @param iBaseMs 첫 대기 상한 (ms)
+ * @param iMaxMs 대기 상한 (ms)
+ * @param puiSeed rand_r() 상태
+ *
+ * @return 대기 시간 (ms)
+ */
+int getTcpBackoffDelayMs(int, int, int, unsigned int*);
+
 /**
  * @brief 클라이언트 연결 해제 처리
  * 
@@ -62,7 +247,44 @@ void checkTcpClientConnections(int*, int);
  * @param iSock 소켓 파일 디스크립터
  * @param iRxSize 수신 버퍼 크기 (바이트 단위)
  * @param iTxSize 송신 버퍼 크기 (바이트 단위)
+ *
+ * @return 성공 시 0, 실패 시 -1 (errno 설정)
+ */
+int setTcpSocketBufferSize(int, int, int);
+
+/**
+ * @brief   기본 TCP_NOTSENT_LOWAT (커널에 남겨 둘 아직 보내지 않은 바이트 상한)
+ *
+ * @details 16KB는 제어 프레임 지연이 가장 짧지만, MSS가 큰 loopback에서는 작은 세그먼트가 늘어 처리량이 줄어듭니다.
+ *          (BM_TcpNotSentLowat* 벤치마크 참고)
+ */
+#define TCP_SOCK_DEFAULT_NOTSENT_LOWAT (128 * 1024)
+
+/**
+ * @brief 커널 송신 버퍼에 쌓일 아직 보내지 않은 바이트의 기준을 설정합니다. (TCP_NOTSENT_LOWAT)
+ *
+ * @details 보내지 않은 바이트가 기준보다 적을 때만 소켓이 쓰기 가능(POLLOUT)으로 보이므로,
+ *          송신 버퍼가 커도 나머지 데이터는 사용자 공간 큐에 남아 우선순위를 바꿀 수 있습니다.
+ *
+ * @param iSock TCP 소켓 파일 디스크립터
+ * @param iBytes 기준 바이트 수
+ *
+ * @return 성공 시 0, 실패 시 -1 (errno 설정)
+ */
+int setTcpNotSentLowat(int, int);
+
+/**
+ * @brief 소켓이 쓰기 가능해질 때까지 기다립니다.
+ *
+ * @details TCP_NOTSENT_LOWAT을 설정한 소켓은 보내지 않은 바이트가 기준 아래로 내려가야 깨어납니다.
+ *          바로 쓸 수 없으면 기다리기 전에 Nagle 알고리즘이 붙잡고 있는 데이터를 내보내(TCP_NODELAY를 잠깐 켬)
+ *          지연 ACK를 기다리며 멈추지 않게 합니다. 상대가 끊거나 소켓이 shutdown() 되면 바로 1을 반환하여, 이어지는 send()가 오류를 알립니다.
+ *
+ * @param iSock 소켓 파일 디스크립터
+ * @param iTimeoutMs 제한 시간 (ms, 0이면 확인만, 음수면 무한)
+ *
+ * @return 쓰기 가능하면 1, 제한 시간이 지나면 0, 실패 시 -1 (errno 설정)
  */
-void setTcpSocketBufferSize(int, int, int);
+int waitTcpSocketWritable(int, int);
 
 #endif
@@ -0,0 +1,84 @@
+#ifndef TCP_TLS_H
+#define TCP_TLS_H
+
+/**
+ * @brief   TLS 핸드셰이크 기본 제한 시간 (ms)
+ */
+#define TCP_TLS_HANDSHAKE_TIMEOUT_MS 5000
+
+/**
+ * @brief   TLS 오류 메시지 버퍼 크기
+ */
+#define TCP_TLS_ERROR_STRLEN 256
+
+/**
+ * @brief   TLS 레코드 형식 (커널 TLS 수신의 TLS_GET_RECORD_TYPE 제어 메시지 값)
+ */
+#define TCP_TLS_RECORD_ALERT 21
+#define TCP_TLS_RECORD_APP_DATA 23
+
+/**
+ * @brief TLS 설정 (인증서, 신뢰할 CA 등. 구조는 tcpTls.c 내부)
+ *
+ * @details 핸드셰이크만 사용자 공간(OpenSSL)에서 하고, 세션 키는 커널 TLS(setsockopt(TCP_ULP, "tls"))에 넘깁니다.
+ *          이후 암복호화는 커널이 하므로 소켓은 평문 소켓처럼 read()/write()/writev()/sendfile()로 씁니다.
+ *          커널이 모든 레코드를 처리해야 하므로 수신 오프로드가 되는 TLS 1.2와 AEAD 암호(AES-GCM, ChaCha20-Poly1305)만 협상하고,
+ *          재협상과 세션 티켓은 끕니다. 여러 연결이 같은 설정을 공유해도 됩니다.
+ */
+typedef struct TCP_TLS TCP_TLS;
+
+/**
+ * @brief 서버용 TLS 설정을 만듭니다.
+ *
+ * @param kpchCertFile 인증서 체인 PEM 파일
+ * @param kpchKeyFile 개인 키 PEM 파일. NULL이면 인증서 파일에서 읽습니다.
+ *
+ * @return TLS 설정. 실패 시 NULL을 반환하며 getTcpTlsError()로 원인을 얻습니다.
+ */
+TCP_TLS *createTcpTlsServer(const char*, const char*);
+
+/**
+ * @brief 클라이언트용 TLS 설정을 만듭니다.
+ *
+ * @details 서버 인증서는 항상 검증합니다. 자체 서명 인증서는 그 인증서 파일을 CA로 주면 됩니다.
+ *
+ * @param kpchCaFile 신뢰할 CA 인증서 PEM 파일. NULL이면 시스템 기본 저장소를 사용합니다.
+ *
+ * @return TLS 설정. 실패 시 NULL을 반환하며 getTcpTlsError()로 원인을 얻습니다.
+ */
+TCP_TLS *createTcpTlsClient(const char*);
+
+/**
+ * @brief TLS 설정을 해제합니다. 이미 커널 TLS로 넘긴 연결에는 영향이 없습니다.
+ *
+ * @param pstTls TLS 설정
+ */
+void destroyTcpTls(TCP_TLS*);
+
+/**
+ * @brief 연결된 소켓에서 TLS 핸드셰이크를 하고 세션 키를 커널 TLS로 넘깁니다.
+ *
+ * @details 핸드셰이크 동안만 소켓을 논블로킹으로 바꾸고 끝나면 원래 상태로 돌립니다.
+ *          성공하면 사용자 공간 TLS 상태는 해제되고, 이후 송수신은 일반 소켓 호출로 합니다.
+ *          수신 중 데이터가 아닌 레코드(경고 등)를 만나면 read()는 EIO로 실패하며,
+ *          recvmsg()에 제어 버퍼를 주면 SOL_TLS/TLS_GET_RECORD_TYPE 제어 메시지로 레코드 형식을 알려 줍니다.
+ *
+ * @param pstTls TLS 설정 (서버/클라이언트 역할이 정해져 있음)
+ * @param iSock 연결된 TCP 소켓
+ * @param kpchPeerName 클라이언트: 인증서를 확인할 서버 이름 또는 IP 주소 (NULL이면 이름 확인 생략). 서버: 무시
+ * @param iTimeoutMs 핸드셰이크 제한 시간 (ms)
+ *
+ * @return 성공 시 0, 실패 시 -1을 반환하며 errno를 설정합니다.
+ *         (핸드셰이크/인증서 검증 실패 EPROTO, 시간 초과 ETIMEDOUT, 커널 TLS를 쓸 수 없으면 EOPNOTSUPP)
+ *         실패한 소켓은 TLS 상태가 정해지지 않았으므로 닫아야 합니다.
+ */
+int startTcpTls(TCP_TLS*, int, const char*, int);
+
+/**
+ * @brief 이 스레드에서 마지막으로 실패한 TLS 호출의 원인을 반환합니다.
+ *
+ * @return 오류 메시지 (스레드별 버퍼)
+ */
+const char *getTcpTlsError(void);
+
+#endif
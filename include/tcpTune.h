@@ -0,0 +1,128 @@
+#ifndef TCP_TUNE_H
+#define TCP_TUNE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tcpMetrics.h"
+
+/**
+ * @brief   버퍼 크기를 다시 계산하는 기본 주기 (ms)
+ */
+#define TCP_TUNE_DEFAULT_INTERVAL_MS 1000
+
+/**
+ * @brief   연결별 TCP_INFO 표본을 뜨는 기본 주기 (ms)
+ */
+#define TCP_INFO_DEFAULT_INTERVAL_MS 1000
+
+/**
+ * @brief   기본 버퍼 크기 하한 (바이트)
+ */
+#define TCP_TUNE_DEFAULT_MIN_BYTES (16 * 1024)
+
+/**
+ * @brief   기본 버퍼 크기 상한 (바이트)
+ */
+#define TCP_TUNE_DEFAULT_MAX_BYTES (4 * 1024 * 1024)
+
+/**
+ * @brief   대역폭 지연 곱(BDP)에 곱하는 여유 배수 (혼잡 윈도가 더 자랄 여지)
+ */
+#define TCP_TUNE_HEADROOM 2
+
+/**
+ * @brief   현재 크기와 목표 크기가 이 비율(1/n) 이상 다를 때만 바꿉니다.
+ */
+#define TCP_TUNE_HYSTERESIS_DIV 4
+
+/**
+ * @brief TCP_INFO에서 뽑은 연결 상태 표본
+ */
+typedef struct {
+    uint32_t u32RttUs;              /**< 평활 RTT (us) */
+    uint32_t u32RttVarUs;           /**< RTT 변동 (us) */
+    uint32_t u32SndCwnd;            /**< 혼잡 윈도 (세그먼트) */
+    uint32_t u32SndMss;             /**< 송신 MSS (바이트) */
+    uint32_t u32RcvSpace;           /**< 수신 측이 RTT마다 받은 바이트 추정 (커널 수신 자동 조정 기준) */
+    uint64_t u64DeliveryRate;       /**< 최근 전달률 (바이트/초, 커널이 지원하지 않으면 0) */
+    uint32_t u32TotalRetrans;       /**< 누적 재전송 세그먼트 수 */
+    uint32_t u32Unacked;            /**< 확인 응답을 기다리는 세그먼트 수 */
+    uint64_t u64BusyUs;             /**< 누적 전송 중 시간 (us, 커널이 지원하지 않으면 0) */
+    uint64_t u64RwndLimitedUs;      /**< 누적 상대 수신 윈도 제한 시간 (us) */
+    uint64_t u64SndbufLimitedUs;    /**< 누적 송신 버퍼 제한 시간 (us) */
+} TCP_INFO_SAMPLE;
+
+/**
+ * @brief 버퍼 크기 범위
+ */
+typedef struct {
+    uint32_t u32MinBytes;           /**< 하한 (바이트) */
+    uint32_t u32MaxBytes;           /**< 상한 (바이트) */
+} TCP_TUNE_LIMIT;
+
+/**
+ * @brief 목표 버퍼 크기 (setsockopt에 넘기는 값, 커널은 관리 비용을 위해 두 배로 잡음)
+ */
+typedef struct {
+    uint32_t u32SndBytes;           /**< SO_SNDBUF */
+    uint32_t u32RcvBytes;           /**< SO_RCVBUF */
+} TCP_TUNE_SIZE;
+
+/**
+ * @brief 소켓의 TCP_INFO 표본을 얻습니다.
+ *
+ * @details 오래된 커널이 돌려준 구조체에 없는 항목은 0으로 채웁니다.
+ *
+ * @param iSock TCP 소켓 파일 디스크립터
+ * @param pstSample 표본을 저장할 구조체
+ *
+ * @return 성공 시 0, 실패 시 -1 (errno 설정)
+ */
+int getTcpInfoSample(int, TCP_INFO_SAMPLE*);
+
+/**
+ * @brief 연결의 TCP_INFO 표본을 연결별 게이지와 전체 히스토그램에 기록합니다.
+ *
+ * @details 게이지는 마지막 표본 값을 그대로 두고, 히스토그램에는 RTT와 함께 직전 표본 이후 늘어난
+ *          전송 중/수신 윈도 제한/송신 버퍼 제한 시간을 기록합니다. 첫 표본은 RTT만 기록합니다.
+ *          전송 중 시간 대부분이 수신 윈도 제한이면 상대가 느리게 읽는 것이고, 송신 버퍼 제한이면 서버의 버퍼가 작은 것이며,
+ *          둘 다 아니면 혼잡 윈도(네트워크)가 막은 것입니다. 전송 중 시간이 거의 없으면 서버가 보낼 데이터를 늦게 만든 것입니다.
+ *          연결마다 한 스레드만 호출해야 합니다. 소켓은 lockTcpConnSock()으로 잠근 동안에만 읽으므로
+ *          소유 스레드가 등록 해제하고 닫는 중인 연결과 겹쳐도 닫힌 뒤 재사용된 소켓 번호를 읽지 않습니다.
+ *
+ * @param pstConn 연결별 카운터 (iSock의 TCP_INFO를 읽음)
+ * @param u64NowNs 표본 시각 (단조 시계, ns)
+ *
+ * @return 성공 시 0, 실패 시 -1 (Unix 도메인 연결, 등록 해제된 연결(ENOTCONN) 등, errno 설정)
+ */
+int sampleTcpConnInfo(TCP_CONN_METRICS*, uint64_t);
+
+/**
+ * @brief 표본으로 목표 버퍼 크기를 계산합니다.
+ *
+ * @details 송신 버퍼는 max(전달률 x RTT, 혼잡 윈도 x MSS)에, 수신 버퍼는 수신 측 RTT당 바이트에
+ *          TCP_TUNE_HEADROOM을 곱하고 범위 안으로 자릅니다. 거의 쉬는 연결은 혼잡 윈도와 전달률이 작아 하한으로,
+ *          대량 전송 연결은 측정한 대역폭 지연 곱만큼 커집니다.
+ *
+ * @param kpstSample TCP_INFO 표본
+ * @param kpstLimit 버퍼 크기 범위
+ * @param pstSize 목표 버퍼 크기
+ */
+void calcTcpTuneSize(const TCP_INFO_SAMPLE*, const TCP_TUNE_LIMIT*, TCP_TUNE_SIZE*);
+
+/**
+ * @brief 연결 하나의 송수신 버퍼를 측정한 대역폭 지연 곱에 맞춥니다.
+ *
+ * @details TCP_INFO 표본으로 목표 크기를 계산하고, 지금 크기와 1/TCP_TUNE_HYSTERESIS_DIV 이상 다를 때만 바꿉니다.
+ *          한 번 바꾼 소켓은 커널 자동 조정에서 빠지므로 이후에는 이 함수를 주기적으로 호출해야 합니다.
+ *          권한이 있으면 SO_SNDBUFFORCE/SO_RCVBUFFORCE로 net.core.wmem_max/rmem_max 제한을 넘고,
+ *          없으면 커널이 그 값으로 자릅니다. 창 크기 배율은 연결 때 정해지므로 accept()로 받은 연결은 나중에 키워도 됩니다.
+ *
+ * @param iSock TCP 소켓 파일 디스크립터
+ * @param kpstLimit 버퍼 크기 범위
+ *
+ * @return 바꾼 버퍼 수 (0~2), 실패 시 -1 (errno 설정)
+ */
+int tuneTcpSocketBuffer(int, const TCP_TUNE_LIMIT*);
+
+#endif
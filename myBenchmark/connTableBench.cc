@@ -0,0 +1,77 @@
+#include <benchmark/benchmark.h>
+#include "tcpMetrics.h"
+#include <vector>
+
+/**
+ * @brief 연결 테이블 등록/해제 비용 (accept / 연결 종료 경로)
+ *
+ * @details range(0) 개의 연결이 이미 등록된 상태에서 하나를 더 등록하고 해제합니다.
+ *          빈 칸을 찾는 선형 탐색 비용이 점유율에 따라 어떻게 변하는지 봅니다.
+ */
+static void BM_TcpConnTableRegister(benchmark::State &state) {
+    std::vector<TCP_CONN_METRICS> vResident((size_t)state.range(0));
+    TCP_CONN_METRICS stConn;
+
+    for (size_t i = 0; i < vResident.size(); i++) {
+        registerTcpConnMetrics(&vResident[i], (int)i + 100, "127.0.0.1:1");
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(registerTcpConnMetrics(&stConn, 3, "127.0.0.1:40000"));
+        unregisterTcpConnMetrics(&stConn);
+    }
+    for (size_t i = 0; i < vResident.size(); i++) {
+        unregisterTcpConnMetrics(&vResident[i]);
+    }
+}
+BENCHMARK(BM_TcpConnTableRegister)->Arg(0)->Arg(100)->Arg(1000);
+
+static void countConn(const TCP_CONN_METRICS *kpstConn, void *pvArg) {
+    *(uint64_t *)pvArg += getTcpConnMetric(kpstConn, TCP_METRIC_BYTES_IN);
+}
+
+/**
+ * @brief 연결 테이블 전체 순회 비용 (관리 인터페이스 conns/queues 명령)
+ */
+static void BM_TcpConnTableVisit(benchmark::State &state) {
+    std::vector<TCP_CONN_METRICS> vResident((size_t)state.range(0));
+
+    for (size_t i = 0; i < vResident.size(); i++) {
+        registerTcpConnMetrics(&vResident[i], (int)i + 100, "127.0.0.1:1");
+    }
+    for (auto _ : state) {
+        uint64_t u64Sum = 0;
+        visitTcpConnMetrics(countConn, &u64Sum);
+        benchmark::DoNotOptimize(u64Sum);
+    }
+    for (size_t i = 0; i < vResident.size(); i++) {
+        unregisterTcpConnMetrics(&vResident[i]);
+    }
+}
+BENCHMARK(BM_TcpConnTableVisit)->Arg(10)->Arg(1000);
+
+/**
+ * @brief 연결별 카운터 증가 비용 (수신/송신 경로에서 메시지마다 호출)
+ */
+static void BM_TcpConnMetricAdd(benchmark::State &state) {
+    TCP_CONN_METRICS stConn;
+
+    registerTcpConnMetrics(&stConn, 3, "127.0.0.1:40000");
+    for (auto _ : state) {
+        addTcpConnMetric(&stConn, TCP_METRIC_BYTES_IN, 64);
+    }
+    unregisterTcpConnMetrics(&stConn);
+}
+BENCHMARK(BM_TcpConnMetricAdd);
+
+/**
+ * @brief 지연 히스토그램 기록 비용
+ */
+static void BM_TcpHistogramRecord(benchmark::State &state) {
+    uint64_t u64Value = 1;
+
+    for (auto _ : state) {
+        recordTcpHistogram(TCP_HIST_RECV_TO_SEND, u64Value);
+        u64Value = (u64Value * 7 + 13) & 0xFFFFF;
+    }
+}
+BENCHMARK(BM_TcpHistogramRecord);
@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+#include "tcpFrame.h"
+#include <vector>
+
+/**
+ * @brief CRC-16/CCITT-FALSE 계산 처리량 (바이트/초)
+ */
+static void BM_TcpFrameCrc(benchmark::State &state) {
+    std::vector<uint8_t> vData((size_t)state.range(0), 0x5A);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(calcTcpFrameCrc(vData.data(), vData.size(), 0xFFFF));
+    }
+    state.SetBytesProcessed((int64_t)state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TcpFrameCrc)->Arg(16)->Arg(256)->Arg(4096)->Arg(TCP_FRAME_MAX_DATA);
+
+/**
+ * @brief DATA 길이별 프레임 인코딩 (헤더 + 복사 + CRC)
+ */
+static void BM_TcpFrameEncode(benchmark::State &state) {
+    std::vector<uint8_t> vData((size_t)state.range(0), 0x5A);
+    std::vector<uint8_t> vFrame(TCP_FRAME_MAX_SIZE);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(encodeTcpFrame(vFrame.data(), vFrame.size(), 1, TCP_INST_DATA,
+                                                vData.data(), vData.size()));
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed((int64_t)state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TcpFrameEncode)->Arg(16)->Arg(256)->Arg(4096)->Arg(TCP_FRAME_MAX_DATA);
+
+/**
+ * @brief DATA 길이별 프레임 디코딩 (검증 + CRC)
+ */
+static void BM_TcpFrameDecode(benchmark::State &state) {
+    std::vector<uint8_t> vData((size_t)state.range(0), 0x5A);
+    std::vector<uint8_t> vFrame(TCP_FRAME_MAX_SIZE);
+    int iFrameLen = encodeTcpFrame(vFrame.data(), vFrame.size(), 1, TCP_INST_DATA, vData.data(), vData.size());
+    TCP_FRAME_HEADER stHeader;
+    const uint8_t *kpu8Data;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(decodeTcpFrame(vFrame.data(), (size_t)iFrameLen, &stHeader, &kpu8Data));
+    }
+    state.SetBytesProcessed((int64_t)state.iterations() * iFrameLen);
+}
+BENCHMARK(BM_TcpFrameDecode)->Arg(16)->Arg(256)->Arg(4096)->Arg(TCP_FRAME_MAX_DATA);
+
+/**
+ * @brief 프레임 사이에 쓰레기 데이터가 있을 때 재동기화 위치 탐색
+ */
+static void BM_TcpFrameResync(benchmark::State &state) {
+    std::vector<uint8_t> vStream((size_t)state.range(0), 0x11);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(findTcpFrameStart(vStream.data(), vStream.size()));
+    }
+    state.SetBytesProcessed((int64_t)state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TcpFrameResync)->Arg(256)->Arg(4096);
@@ -0,0 +1,76 @@
+#include <benchmark/benchmark.h>
+#include "tcpLz4.h"
+#include "tcpFrame.h"
+#include <string>
+#include <vector>
+
+/**
+ * @brief 반복이 많은 텍스트 (로그/측정 메시지 형태)
+ */
+static std::string makeBenchText(size_t uiLen) {
+    std::string strText;
+
+    for (int i = 0; strText.size() < uiLen; i++) {
+        strText += "sensor=" + std::to_string(i % 17) + " status=OK value=" + std::to_string(i * 7 % 1000) + " ";
+    }
+    strText.resize(uiLen);
+    return strText;
+}
+
+/**
+ * @brief DATA 길이별 LZ4 압축 처리량 (원본 바이트/초)
+ */
+static void BM_TcpLz4Compress(benchmark::State &state) {
+    std::string strText = makeBenchText((size_t)state.range(0));
+    std::vector<uint8_t> vPacked(TCP_LZ4_BOUND(strText.size()));
+    int iPackedLen = 0;
+
+    for (auto _ : state) {
+        iPackedLen = compressTcpLz4((const uint8_t *)strText.data(), strText.size(), vPacked.data(), vPacked.size());
+        benchmark::DoNotOptimize(iPackedLen);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed((int64_t)state.iterations() * state.range(0));
+    state.counters["ratio"] = (double)iPackedLen / (double)strText.size();
+}
+BENCHMARK(BM_TcpLz4Compress)->Arg(256)->Arg(4096)->Arg(TCP_FRAME_MAX_DATA);
+
+/**
+ * @brief DATA 길이별 LZ4 압축 해제 처리량 (원본 바이트/초)
+ */
+static void BM_TcpLz4Decompress(benchmark::State &state) {
+    std::string strText = makeBenchText((size_t)state.range(0));
+    std::vector<uint8_t> vPacked(TCP_LZ4_BOUND(strText.size()));
+    std::vector<uint8_t> vPlain(strText.size());
+    int iPackedLen = compressTcpLz4((const uint8_t *)strText.data(), strText.size(), vPacked.data(), vPacked.size());
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(decompressTcpLz4(vPacked.data(), (size_t)iPackedLen, vPlain.data(), vPlain.size()));
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed((int64_t)state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TcpLz4Decompress)->Arg(256)->Arg(4096)->Arg(TCP_FRAME_MAX_DATA);
+
+/**
+ * @brief 압축되지 않는 DATA에서 압축을 포기하고 일반 프레임으로 보내는 비용
+ */
+static void BM_TcpLz4FrameIncompressible(benchmark::State &state) {
+    std::vector<uint8_t> vData((size_t)state.range(0));
+    std::vector<uint8_t> vFrame(TCP_FRAME_MAX_SIZE);
+    uint32_t u32State = 2463534242u;
+
+    for (uint8_t &u8Byte : vData) {
+        u32State ^= u32State << 13;
+        u32State ^= u32State >> 17;
+        u32State ^= u32State << 5;
+        u8Byte = (uint8_t)u32State;
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(encodeTcpLz4Frame(vFrame.data(), vFrame.size(), 1, TCP_INST_DATA, vData.data(),
+                                                   vData.size(), TCP_FRAME_COMPRESS_THRESHOLD));
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed((int64_t)state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TcpLz4FrameIncompressible)->Arg(256)->Arg(4096)->Arg(TCP_FRAME_MAX_DATA);
@@ -0,0 +1,84 @@
+#include <benchmark/benchmark.h>
+#include "tcpRing.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 한 스레드에서 레코드 하나를 넣고 바로 꺼내는 비용 (레코드 크기별)
+ */
+static void BM_TcpRingPushPop(benchmark::State &state) {
+    TCP_RING *pstRing = createTcpRing(TCP_RING_DEFAULT_SIZE);
+    std::vector<uint8_t> vRecord((size_t)state.range(0), 0x5A);
+    std::vector<uint8_t> vOut((size_t)state.range(0));
+
+    for (auto _ : state) {
+        pushTcpRing(pstRing, vRecord.data(), (uint32_t)vRecord.size());
+        benchmark::DoNotOptimize(popTcpRing(pstRing, vOut.data(), (uint32_t)vOut.size()));
+    }
+    state.SetItemsProcessed((int64_t)state.iterations());
+    state.SetBytesProcessed((int64_t)state.iterations() * state.range(0));
+    destroyTcpRing(pstRing);
+}
+BENCHMARK(BM_TcpRingPushPop)->Arg(16)->Arg(256)->Arg(4096);
+
+/**
+ * @brief 서버의 송신 큐 사용 형태: [저장 시각 | 프레임] 두 조각 레코드 넣기/꺼내기
+ */
+static void BM_TcpRingPushPartsPop(benchmark::State &state) {
+    TCP_RING *pstRing = createTcpRing(TCP_RING_DEFAULT_SIZE);
+    std::vector<uint8_t> vFrame((size_t)state.range(0), 0x5A);
+    std::vector<uint8_t> vOut(sizeof(uint64_t) + (size_t)state.range(0));
+    uint64_t u64Stamp = 0;
+    struct iovec astIov[2];
+
+    astIov[0].iov_base = &u64Stamp;
+    astIov[0].iov_len = sizeof(u64Stamp);
+    astIov[1].iov_base = vFrame.data();
+    astIov[1].iov_len = vFrame.size();
+    for (auto _ : state) {
+        u64Stamp++;
+        pushTcpRingParts(pstRing, astIov, 2);
+        benchmark::DoNotOptimize(popTcpRing(pstRing, vOut.data(), (uint32_t)vOut.size()));
+    }
+    state.SetItemsProcessed((int64_t)state.iterations());
+    destroyTcpRing(pstRing);
+}
+BENCHMARK(BM_TcpRingPushPartsPop)->Arg(64)->Arg(1024);
+
+/**
+ * @brief 생산자/소비자 스레드 사이 처리량
+ *
+ * 반복마다 소비자 스레드가 레코드 65536개를 받을 때까지 생산자가 넣습니다.
+ * 두 스레드의 캐시 라인 공유 비용이 포함됩니다. (코어가 하나면 스케줄링 비용이 지배적입니다.)
+ */
+static void BM_TcpRingSpscThroughput(benchmark::State &state) {
+    const int kiRecords = 65536;
+    TCP_RING *pstRing = createTcpRing(64 * 1024);
+    std::vector<uint8_t> vRecord((size_t)state.range(0), 0x5A);
+
+    for (auto _ : state) {
+        std::thread consumer([&]() {
+            std::vector<uint8_t> vOut(vRecord.size());
+            for (int i = 0; i < kiRecords;) {
+                if (popTcpRing(pstRing, vOut.data(), (uint32_t)vOut.size()) > 0) {
+                    i++;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        for (int i = 0; i < kiRecords;) {
+            if (pushTcpRing(pstRing, vRecord.data(), (uint32_t)vRecord.size())) {
+                i++;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        consumer.join();
+    }
+    state.SetItemsProcessed((int64_t)state.iterations() * kiRecords);
+    state.SetBytesProcessed((int64_t)state.iterations() * kiRecords * state.range(0));
+    destroyTcpRing(pstRing);
+}
+BENCHMARK(BM_TcpRingSpscThroughput)->Arg(64)->Arg(1024)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,67 @@
+#include <benchmark/benchmark.h>
+#include "tcpShm.h"
+#include <unistd.h>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 공유 메모리 전송 한 쌍과 상대 스레드를 준비합니다.
+ */
+static void openShmPair(TCP_SHM **ppstClient, TCP_SHM **ppstServer) {
+    *ppstClient = createTcpShm(TCP_SHM_DEFAULT_RING_SIZE);
+    *ppstServer = attachTcpShm(dup(getTcpShmFd(*ppstClient)));
+}
+
+/**
+ * @brief range(0) 바이트 레코드 왕복 (클라이언트 송신 → 에코 스레드 → 클라이언트 수신)
+ *
+ * BM_TcpLoopbackRoundTrip, BM_TcpUnixRoundTrip과 비교합니다.
+ */
+static void BM_TcpShmRoundTrip(benchmark::State &state) {
+    TCP_SHM *pstClient, *pstServer;
+    std::vector<char> vBuf((size_t)state.range(0), 'x');
+
+    openShmPair(&pstClient, &pstServer);
+    std::thread echo([pstServer]() {
+        std::vector<char> vEcho(65536);
+        int iLen;
+        while ((iLen = recvTcpShm(pstServer, vEcho.data(), (uint32_t)vEcho.size(), -1)) > 0) {
+            sendTcpShm(pstServer, vEcho.data(), (uint32_t)iLen, -1);
+        }
+    });
+    for (auto _ : state) {
+        sendTcpShm(pstClient, vBuf.data(), (uint32_t)vBuf.size(), -1);
+        recvTcpShm(pstClient, vBuf.data(), (uint32_t)vBuf.size(), -1);
+    }
+    state.SetBytesProcessed((int64_t)state.iterations() * state.range(0) * 2);
+    closeTcpShm(pstClient);
+    echo.join();
+    destroyTcpShm(pstServer);
+    destroyTcpShm(pstClient);
+}
+BENCHMARK(BM_TcpShmRoundTrip)->Arg(64)->Arg(4096)->UseRealTime();
+
+/**
+ * @brief range(0) 바이트 레코드 한 방향 처리량 (생산자 → 소비자 스레드)
+ */
+static void BM_TcpShmThroughput(benchmark::State &state) {
+    TCP_SHM *pstClient, *pstServer;
+    std::vector<char> vBuf((size_t)state.range(0), 'x');
+
+    openShmPair(&pstClient, &pstServer);
+    std::thread consumer([pstServer]() {
+        std::vector<char> vIn(65536);
+        while (recvTcpShm(pstServer, vIn.data(), (uint32_t)vIn.size(), -1) > 0) {
+        }
+    });
+    for (auto _ : state) {
+        sendTcpShm(pstClient, vBuf.data(), (uint32_t)vBuf.size(), -1);
+    }
+    state.SetItemsProcessed((int64_t)state.iterations());
+    state.SetBytesProcessed((int64_t)state.iterations() * state.range(0));
+    closeTcpShm(pstClient);
+    consumer.join();
+    destroyTcpShm(pstServer);
+    destroyTcpShm(pstClient);
+}
+BENCHMARK(BM_TcpShmThroughput)->Arg(16)->Arg(64)->UseRealTime();
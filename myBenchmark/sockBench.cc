@@ -0,0 +1,345 @@
+#include <benchmark/benchmark.h>
+#include "tcpSock.h"
+#include "tcpMetrics.h"
+#include "tcpFrame.h"
+#include <unistd.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <poll.h>
+#include <vector>
+#include <atomic>
+#include <thread>
+
+#define LOWAT_BENCH_FRAME 1024              /**< 송신 프레임 길이 */
+#define LOWAT_BENCH_READ_BYTES (16 * 1024)  /**< 느린 상대가 한 번에 읽는 양 */
+#define LOWAT_BENCH_READ_GAP_US 200         /**< 느린 상대가 읽기 사이에 쉬는 시간 (약 80MB/s) */
+#define LOWAT_BENCH_BATCH_FRAMES 1024       /**< 처리량 측정에서 반복마다 보내는 프레임 수 */
+#define RCVLOWAT_BENCH_DATA (16 * 1024)     /**< 조금씩 보내는 큰 프레임의 DATA 길이 */
+#define RCVLOWAT_BENCH_CHUNK 1024           /**< 송신 측이 한 번에 보내는 양 */
+#define RCVLOWAT_BENCH_FRAMES 64            /**< 반복마다 보내는 프레임 수 */
+
+/**
+ * @brief 임시 포트(0)에 서버 소켓을 만들고 실제 포트를 구합니다.
+ */
+static int createEphemeralServer(int *piPort) {
+    int iServerSock = createTcpServerSocket(0, SOMAXCONN);
+
+    *piPort = getTcpSocketPort(iServerSock);
+    return iServerSock;
+}
+
+/**
+ * @brief 연결을 RST로 닫아 TIME_WAIT 소켓이 쌓이지 않게 합니다. (반복 측정 중 임시 포트 고갈 방지)
+ */
+static void closeWithReset(int iSock) {
+    struct linger stLinger;
+
+    stLinger.l_onoff = 1;
+    stLinger.l_linger = 0;
+    setsockopt(iSock, SOL_SOCKET, SO_LINGER, &stLinger, sizeof(stLinger));
+    close(iSock);
+}
+
+/**
+ * @brief createTcpServerSocket() 비용 (socket + Keep-Alive 옵션 + bind + listen)
+ */
+static void BM_TcpCreateServerSocket(benchmark::State &state) {
+    for (auto _ : state) {
+        int iServerSock = createTcpServerSocket(0, SOMAXCONN);
+        benchmark::DoNotOptimize(iServerSock);
+        close(iServerSock);
+    }
+}
+BENCHMARK(BM_TcpCreateServerSocket);
+
+/**
+ * @brief 루프백 연결 경로: createTcpClientSocket() + accept() + 종료
+ */
+static void BM_TcpLoopbackConnect(benchmark::State &state) {
+    int iPort;
+    int iServerSock = createEphemeralServer(&iPort);
+
+    for (auto _ : state) {
+        int iClientSock = createTcpClientSocket("127.0.0.1", iPort);
+        int iAcceptedSock = accept(iServerSock, NULL, NULL);
+        if (iClientSock < 0 || iAcceptedSock < 0) {
+            state.SkipWithError("connect/accept failed");
+            break;
+        }
+        closeWithReset(iClientSock);
+        close(iAcceptedSock);
+    }
+    state.SetItemsProcessed((int64_t)state.iterations());
+    close(iServerSock);
+}
+BENCHMARK(BM_TcpLoopbackConnect)->UseRealTime();
+
+/**
+ * @brief 연결된 루프백 소켓 쌍에서 range(0) 바이트 왕복 (send → recv → send → recv)
+ */
+static void BM_TcpLoopbackRoundTrip(benchmark::State &state) {
+    int iPort;
+    int iServerSock = createEphemeralServer(&iPort);
+    int iClientSock = createTcpClientSocket("127.0.0.1", iPort);
+    int iAcceptedSock = accept(iServerSock, NULL, NULL);
+    int iNoDelay = 1;
+    std::vector<char> vBuf((size_t)state.range(0), 'x');
+
+    setsockopt(iClientSock, IPPROTO_TCP, TCP_NODELAY, &iNoDelay, sizeof(iNoDelay));
+    setsockopt(iAcceptedSock, IPPROTO_TCP, TCP_NODELAY, &iNoDelay, sizeof(iNoDelay));
+    for (auto _ : state) {
+        send(iClientSock, vBuf.data(), vBuf.size(), 0);
+        recv(iAcceptedSock, vBuf.data(), vBuf.size(), MSG_WAITALL);
+        send(iAcceptedSock, vBuf.data(), vBuf.size(), 0);
+        recv(iClientSock, vBuf.data(), vBuf.size(), MSG_WAITALL);
+    }
+    state.SetBytesProcessed((int64_t)state.iterations() * state.range(0) * 2);
+    closeWithReset(iClientSock);
+    close(iAcceptedSock);
+    close(iServerSock);
+}
+BENCHMARK(BM_TcpLoopbackRoundTrip)->Arg(64)->Arg(4096)->UseRealTime();
+
+/**
+ * @brief BM_TcpLoopbackRoundTrip과 같은 왕복을 추상 네임스페이스 Unix 도메인 소켓으로 측정 (같은 호스트 전송 비교용)
+ */
+static void BM_TcpUnixRoundTrip(benchmark::State &state) {
+    int iServerSock = createTcpUnixServerSocket("@tcpSockBench", SOMAXCONN);
+    int iClientSock = createTcpUnixClientSocket("@tcpSockBench");
+    int iAcceptedSock = accept(iServerSock, NULL, NULL);
+    std::vector<char> vBuf((size_t)state.range(0), 'x');
+
+    for (auto _ : state) {
+        send(iClientSock, vBuf.data(), vBuf.size(), 0);
+        recv(iAcceptedSock, vBuf.data(), vBuf.size(), MSG_WAITALL);
+        send(iAcceptedSock, vBuf.data(), vBuf.size(), 0);
+        recv(iClientSock, vBuf.data(), vBuf.size(), MSG_WAITALL);
+    }
+    state.SetBytesProcessed((int64_t)state.iterations() * state.range(0) * 2);
+    close(iClientSock);
+    close(iAcceptedSock);
+    close(iServerSock);
+}
+BENCHMARK(BM_TcpUnixRoundTrip)->Arg(64)->Arg(4096)->UseRealTime();
+
+/**
+ * @brief 서버 송신 스레드를 흉내 내는 송신 측과 상대 측의 공유 상태
+ */
+typedef struct {
+    int iTx;                                /**< 서버 쪽 연결 소켓 */
+    int iRx;                                /**< 상대 쪽 소켓 */
+    int iLowat;                             /**< TCP_NOTSENT_LOWAT (0이면 설정하지 않음, 지금까지의 방식) */
+    bool bPaced;                            /**< 상대가 천천히 읽는지 여부 */
+    std::atomic<bool> bStop;
+    std::atomic<uint64_t> u64ControlNs;     /**< 보낼 제어 프레임을 넣은 시각 (0이면 없음) */
+    std::atomic<uint64_t> u64LatencyNs;     /**< 상대가 제어 프레임을 받기까지 걸린 시간 (0이면 아직) */
+} LOWAT_BENCH;
+
+/**
+ * @brief 대량 DATA를 끝없이 보내다가 제어 프레임이 들어오면 다음 차례에 먼저 보냅니다.
+ *
+ * @details tcpServer sendThread와 같이, 기준이 있으면 기준의 절반을 보낼 때마다 쓰기 가능을 기다린 뒤 다음 프레임을 고릅니다.
+ */
+static void runLowatSender(LOWAT_BENCH *pstBench) {
+    uint8_t au8Frame[LOWAT_BENCH_FRAME] = {};
+    size_t uiUncheckedBytes = 0;
+
+    while (!pstBench->bStop.load(std::memory_order_relaxed)) {
+        if (pstBench->iLowat > 0 && uiUncheckedBytes >= (size_t)pstBench->iLowat / 2) {
+            if (waitTcpSocketWritable(pstBench->iTx, 10) == 0) {
+                continue;
+            }
+            uiUncheckedBytes = 0;
+        }
+        uint64_t u64ControlNs = pstBench->u64ControlNs.exchange(0);
+        au8Frame[0] = u64ControlNs != 0 ? 'C' : 'B';
+        memcpy(au8Frame + sizeof(uint64_t), &u64ControlNs, sizeof(uint64_t));
+        if (send(pstBench->iTx, au8Frame, sizeof(au8Frame), MSG_NOSIGNAL) != (ssize_t)sizeof(au8Frame)) {
+            break;
+        }
+        uiUncheckedBytes += sizeof(au8Frame);
+    }
+}
+
+/**
+ * @brief 상대 측: 프레임을 읽으며 제어 프레임의 지연을 기록합니다. bPaced이면 읽기 사이에 쉽니다.
+ */
+static void runLowatReceiver(LOWAT_BENCH *pstBench) {
+    std::vector<uint8_t> vBuf(LOWAT_BENCH_READ_BYTES);
+
+    while (!pstBench->bStop.load(std::memory_order_relaxed)) {
+        ssize_t iReadSize = recv(pstBench->iRx, vBuf.data(), vBuf.size(), MSG_WAITALL);
+        if (iReadSize <= 0) {
+            break;
+        }
+        for (ssize_t i = 0; i + LOWAT_BENCH_FRAME <= iReadSize; i += LOWAT_BENCH_FRAME) {
+            if (vBuf[(size_t)i] == 'C') {
+                uint64_t u64ControlNs;
+                memcpy(&u64ControlNs, &vBuf[(size_t)i + sizeof(uint64_t)], sizeof(uint64_t));
+                pstBench->u64LatencyNs.store(getTcpMonotonicNs() - u64ControlNs);
+            }
+        }
+        if (pstBench->bPaced) {
+            usleep(LOWAT_BENCH_READ_GAP_US);
+        }
+    }
+}
+
+/**
+ * @brief 루프백 연결을 만들고 공유 상태를 초기화합니다.
+ */
+static void connectLowatBench(LOWAT_BENCH *pstBench, int iLowat, bool bPaced) {
+    int iPort;
+    int iServerSock = createEphemeralServer(&iPort);
+
+    pstBench->iRx = createTcpClientSocket("127.0.0.1", iPort);
+    pstBench->iTx = accept(iServerSock, NULL, NULL);
+    close(iServerSock);
+    pstBench->iLowat = iLowat;
+    pstBench->bPaced = bPaced;
+    pstBench->bStop = false;
+    pstBench->u64ControlNs = 0;
+    pstBench->u64LatencyNs = 0;
+    if (iLowat > 0) {
+        setTcpNotSentLowat(pstBench->iTx, iLowat);
+    }
+}
+
+/**
+ * @brief 송신/상대 스레드를 멈추고 연결을 닫습니다. (멈춘 send/recv는 shutdown으로 깨웁니다.)
+ */
+static void stopLowatBench(LOWAT_BENCH *pstBench, std::thread *pSender, std::thread *pReceiver) {
+    pstBench->bStop = true;
+    shutdown(pstBench->iTx, SHUT_RDWR);
+    shutdown(pstBench->iRx, SHUT_RDWR);
+    if (pSender->joinable()) {
+        pSender->join();
+    }
+    pReceiver->join();
+    closeWithReset(pstBench->iRx);
+    close(pstBench->iTx);
+}
+
+/**
+ * @brief 느린 상대에게 대량 DATA를 보내는 중에 들어온 제어 프레임의 지연
+ *
+ * @details 상대는 16KB씩 200us 쉬며 읽고(약 80MB/s), 송신 측은 1KB DATA 프레임을 끝없이 보냅니다.
+ *          반복마다 제어 프레임 하나를 넣고 상대가 받을 때까지의 시간을 잽니다(수동 시간).
+ *          range(0) 0: TCP_NOTSENT_LOWAT 없이 블로킹 send (지금까지의 sendThread), 그 밖: 해당 기준(바이트)
+ *          기준이 없으면 커널 송신 버퍼가 자동 조정으로 커진 만큼 제어 프레임이 그 뒤에서 기다립니다.
+ */
+static void BM_TcpNotSentLowatControlLatency(benchmark::State &state) {
+    LOWAT_BENCH stBench;
+    std::thread sender, receiver;
+    TCP_HISTOGRAM stHist;
+
+    resetTcpHistogram(&stHist);
+    connectLowatBench(&stBench, (int)state.range(0), true);
+    receiver = std::thread(runLowatReceiver, &stBench);
+    sender = std::thread(runLowatSender, &stBench);
+    usleep(200000); /**< 송신 버퍼가 자랄 때까지 */
+    for (auto _ : state) {
+        stBench.u64LatencyNs = 0;
+        stBench.u64ControlNs = getTcpMonotonicNs();
+        while (stBench.u64LatencyNs.load() == 0) {
+            usleep(20);
+        }
+        uint64_t u64LatencyNs = stBench.u64LatencyNs.load();
+        addTcpHistogramValue(&stHist, u64LatencyNs);
+        state.SetIterationTime((double)u64LatencyNs / 1e9);
+        usleep(1000);
+    }
+    stopLowatBench(&stBench, &sender, &receiver);
+    state.counters["control_p99_us"] = (double)getTcpHistogramPercentile(&stHist, 99.0) / 1000.0;
+}
+BENCHMARK(BM_TcpNotSentLowatControlLatency)->Arg(0)->Arg(16 * 1024)->Arg(TCP_SOCK_DEFAULT_NOTSENT_LOWAT)->Iterations(30)
+    ->UseManualTime()->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief 빨리 읽는 상대에게 보낼 때의 처리량 (쓰기 가능 대기 비용)
+ *
+ * @details range(0)은 BM_TcpNotSentLowatControlLatency와 같습니다. 반복마다 1KB 프레임 1024개를 보낸 만큼 셉니다.
+ */
+static void BM_TcpNotSentLowatThroughput(benchmark::State &state) {
+    LOWAT_BENCH stBench;
+    std::thread sender, receiver;
+    uint8_t au8Frame[LOWAT_BENCH_FRAME] = {'B'};
+    size_t uiUncheckedBytes = 0;
+
+    /**< 송신 스레드 대신 측정 스레드가 직접 보냅니다. */
+    connectLowatBench(&stBench, (int)state.range(0), false);
+    receiver = std::thread(runLowatReceiver, &stBench);
+    for (auto _ : state) {
+        for (int i = 0; i < LOWAT_BENCH_BATCH_FRAMES; i++) {
+            if (stBench.iLowat > 0 && uiUncheckedBytes >= (size_t)stBench.iLowat / 2) {
+                waitTcpSocketWritable(stBench.iTx, -1);
+                uiUncheckedBytes = 0;
+            }
+            send(stBench.iTx, au8Frame, sizeof(au8Frame), MSG_NOSIGNAL);
+            uiUncheckedBytes += sizeof(au8Frame);
+        }
+    }
+    state.SetBytesProcessed((int64_t)state.iterations() * LOWAT_BENCH_BATCH_FRAMES * LOWAT_BENCH_FRAME);
+    stopLowatBench(&stBench, &sender, &receiver);
+}
+BENCHMARK(BM_TcpNotSentLowatThroughput)->Arg(0)->Arg(16 * 1024)->Arg(TCP_SOCK_DEFAULT_NOTSENT_LOWAT)->UseRealTime();
+
+/**
+ * @brief 큰 프레임을 조금씩 보내는 상대로부터 프레임 하나를 받는 데 드는 read() 횟수
+ *
+ * @details 송신 측은 TCP_NODELAY로 16KB 프레임을 1KB씩 나누어 보내고, 수신 측은 서버의 receiveThread처럼
+ *          남은 프레임 바이트를 getTcpFrameNeededBytes()로 구해 읽습니다.
+ *          range(0) 0: SO_RCVLOWAT 없이 (세그먼트마다 깨어남), 1: SO_RCVLOWAT을 남은 바이트로 설정하고 poll()로 기다린 뒤 읽기
+ */
+static void BM_TcpRecvLowatReadsPerFrame(benchmark::State &state) {
+    int iPort;
+    int iServerSock = createEphemeralServer(&iPort);
+    int iRx = createTcpClientSocket("127.0.0.1", iPort);
+    int iTx = accept(iServerSock, NULL, NULL);
+    int iOne = 1;
+    std::vector<uint8_t> vData(RCVLOWAT_BENCH_DATA, 'R');
+    std::vector<uint8_t> vFrame(TCP_FRAME_MAX_SIZE);
+    std::vector<uint8_t> vStream(TCP_FRAME_MAX_SIZE);
+    int iFrameLen = encodeTcpFrame(vFrame.data(), vFrame.size(), 1, TCP_INST_DATA, vData.data(), vData.size());
+    uint64_t u64Reads = 0;
+
+    close(iServerSock);
+    setsockopt(iTx, IPPROTO_TCP, TCP_NODELAY, &iOne, sizeof(iOne));
+    for (auto _ : state) {
+        std::thread sender([&]() {
+            for (int i = 0; i < RCVLOWAT_BENCH_FRAMES; i++) {
+                for (int iOff = 0; iOff < iFrameLen; iOff += RCVLOWAT_BENCH_CHUNK) {
+                    int iLen = iFrameLen - iOff < RCVLOWAT_BENCH_CHUNK ? iFrameLen - iOff : RCVLOWAT_BENCH_CHUNK;
+                    send(iTx, vFrame.data() + iOff, (size_t)iLen, MSG_NOSIGNAL);
+                    usleep(10);
+                }
+            }
+        });
+        for (int i = 0; i < RCVLOWAT_BENCH_FRAMES; i++) {
+            size_t uiStreamLen = 0;
+            size_t uiNeeded;
+
+            while ((uiNeeded = getTcpFrameNeededBytes(vStream.data(), uiStreamLen)) > 0) {
+                if (state.range(0) != 0) {
+                    int iLowat = (int)uiNeeded;
+                    struct pollfd stPoll = {iRx, POLLIN, 0};
+
+                    setsockopt(iRx, SOL_SOCKET, SO_RCVLOWAT, &iLowat, sizeof(iLowat));
+                    poll(&stPoll, 1, -1);
+                }
+                ssize_t iRead = recv(iRx, vStream.data() + uiStreamLen, uiNeeded, 0);
+                if (iRead <= 0) {
+                    state.SkipWithError("recv failed");
+                    break;
+                }
+                uiStreamLen += (size_t)iRead;
+                u64Reads++;
+            }
+        }
+        sender.join();
+    }
+    state.counters["reads_per_frame"] = (double)u64Reads / (double)(state.iterations() * RCVLOWAT_BENCH_FRAMES);
+    closeWithReset(iRx);
+    close(iTx);
+}
+BENCHMARK(BM_TcpRecvLowatReadsPerFrame)->Arg(0)->Arg(1)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,206 @@
+#!/usr/bin/env python3
+"""
+@file e2eDrain.py
+@brief 서버 종료(drain) 종단간 테스트
+
+tcpServer 를 임시 포트(-p 0)로 띄운 뒤, 응답을 읽지 않는 연결 하나에 응답이 송신 큐에 쌓이도록 요청을 보내고,
+연결 테이블 크기(TCP_CONN_TABLE_SIZE, 1024)보다 많은 연결에서 요청을 하나씩 보냅니다.
+SIGTERM 을 보낸 뒤 모든 연결이 보낸 요청 수만큼의 DATA 응답과 마지막 SHUTDOWN 프레임을 받고 닫히는지,
+서버가 남은 연결 없이 0으로 종료하는지 확인합니다.
+--upgrade 를 주면 SIGTERM 대신 새 서버(-U)가 대기 소켓을 넘겨받게 하고, 기존 서버가 같은 방법으로 정리한 뒤
+새 서버가 같은 포트에서 요청을 처리하는지 확인합니다.
+
+사용 예)
+    python3 myE2e/e2eDrain.py
+    python3 myE2e/e2eDrain.py --conns 100
+    python3 myE2e/e2eDrain.py --upgrade
+"""
+import argparse
+import os
+import signal
+import socket
+import struct
+import sys
+import tempfile
+import time
+
+from e2eRegression import REPO_DIR, raiseFdLimit, startServer, stopServer
+
+FRAME_MAGIC = b"\xa5\x5a"
+FRAME_VERSION = 1
+FRAME_HEADER_SIZE = 8
+FRAME_CRC_SIZE = 2
+INST_DATA = 0x01
+INST_SHUTDOWN = 0x06
+TABLE_SIZE = 1024
+
+
+def calcCrc(achData):
+    """CRC-16/CCITT-FALSE (tcpFrame.c 와 같은 계산)"""
+    u16Crc = 0xFFFF
+    for u8Byte in achData:
+        u16Crc ^= u8Byte << 8
+        for _ in range(8):
+            u16Crc = ((u16Crc << 1) ^ 0x1021) if u16Crc & 0x8000 else (u16Crc << 1)
+            u16Crc &= 0xFFFF
+    return u16Crc
+
+
+def encodeFrame(u8Instruction, achData):
+    achFrame = FRAME_MAGIC + struct.pack(">BBBBH", FRAME_VERSION, 0, 0, u8Instruction, len(achData)) + achData
+    return achFrame + struct.pack(">H", calcCrc(achFrame))
+
+
+def readFrames(sock, dTimeout):
+    """상대가 닫을 때까지 읽은 프레임의 Instruction 목록"""
+    sock.settimeout(dTimeout)
+    achData = b""
+    while True:
+        achChunk = sock.recv(65536)
+        if not achChunk:
+            break
+        achData += achChunk
+
+    au8Inst = []
+    uiPos = 0
+    while uiPos + FRAME_HEADER_SIZE <= len(achData):
+        if achData[uiPos:uiPos + 2] != FRAME_MAGIC:
+            raise RuntimeError("bad magic at offset %d" % uiPos)
+        uiLen = struct.unpack(">H", achData[uiPos + 6:uiPos + 8])[0]
+        au8Inst.append(achData[uiPos + 5])
+        uiPos += FRAME_HEADER_SIZE + uiLen + FRAME_CRC_SIZE
+    if uiPos != len(achData):
+        raise RuntimeError("trailing %d bytes" % (len(achData) - uiPos))
+    return au8Inst
+
+
+def runAdminCommand(kpchAdminPath, kpchCommand):
+    with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as s:
+        s.settimeout(10)
+        s.connect(kpchAdminPath)
+        s.sendall(kpchCommand.encode() + b"\n")
+        achData = b""
+        while True:
+            achChunk = s.recv(65536)
+            if not achChunk:
+                break
+            achData += achChunk
+    return achData.decode()
+
+
+def waitQueuedReplies(kpchAdminPath, iExpected, dTimeout):
+    """송신 큐에 응답이 남은 연결이 있고, 모든 요청을 받았을 때까지 기다립니다. 큐 깊이 최대값을 반환합니다."""
+    dDeadline = time.time() + dTimeout
+    iMaxDepth = 0
+    while time.time() < dDeadline:
+        achLines = [x.split("\t") for x in runAdminCommand(kpchAdminPath, "queues").splitlines()]
+        iMaxDepth = max([int(x[2]) for x in achLines if len(x) == 3 and x[2].isdigit()] + [0])
+        achMetrics = runAdminCommand(kpchAdminPath, "metrics")
+        for line in achMetrics.splitlines():
+            if line.startswith("tcp_server_messages_in_total "):
+                if float(line.split()[1]) >= iExpected and iMaxDepth > 0:
+                    return iMaxDepth
+        time.sleep(0.05)
+    return iMaxDepth
+
+
+def main():
+    parser = argparse.ArgumentParser(description="tcpServer 종료(drain) 종단간 테스트")
+    parser.add_argument("--server", default=os.path.join(REPO_DIR, "tcpServer"))
+    parser.add_argument("--conns", type=int, default=TABLE_SIZE + 76, help="요청을 하나씩 보내는 연결 수")
+    parser.add_argument("--queued", type=int, default=256, help="응답을 읽지 않는 연결이 보내는 요청 수")
+    parser.add_argument("--size", type=int, default=1024, help="요청 DATA 크기 (바이트)")
+    parser.add_argument("--upgrade", action="store_true", help="SIGTERM 대신 새 서버에 대기 소켓을 넘겨 종료")
+    args = parser.parse_args()
+
+    if not raiseFdLimit(args.conns + 256):
+        print("skipped: RLIMIT_NOFILE hard limit too low for %d connections" % args.conns)
+        return 0
+
+    kpchAdminPath = os.path.join(tempfile.gettempdir(), "tcpE2eDrain.%d.admin" % os.getpid())
+    kpchUpgradePath = os.path.join(tempfile.gettempdir(), "tcpE2eDrain.%d.upgrade" % os.getpid())
+    achUpgradeArgs = ["-H", kpchUpgradePath] if args.upgrade else []
+    achFailures = []
+    newProc = None
+    with tempfile.NamedTemporaryFile(prefix="tcpE2eDrain.", suffix=".log", delete=False) as logFile, \
+            tempfile.NamedTemporaryFile(prefix="tcpE2eDrain.new.", suffix=".log", delete=False) as newLogFile:
+        proc, iPort = startServer(args, args.conns + 1, kpchAdminPath, logFile, achUpgradeArgs)
+        try:
+            achRequest = encodeFrame(INST_DATA, b"x" * args.size)
+
+            # 응답을 읽지 않는 연결: 수신 버퍼를 작게 하여 응답이 서버 송신 큐에 쌓이게 합니다.
+            heavySock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+            heavySock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 4096)
+            heavySock.connect(("127.0.0.1", iPort))
+            heavySock.sendall(achRequest * args.queued)
+
+            lightSocks = []
+            for _ in range(args.conns):
+                sock = socket.create_connection(("127.0.0.1", iPort))
+                sock.sendall(achRequest)
+                lightSocks.append(sock)
+
+            iDepth = waitQueuedReplies(kpchAdminPath, args.queued + args.conns, 30)
+            if iDepth == 0:
+                achFailures.append("no replies were queued before SIGTERM")
+
+            if args.upgrade:
+                newProc, _ = startServer(args, args.conns + 1, kpchAdminPath + ".new", newLogFile,
+                                         achUpgradeArgs + ["-U", kpchUpgradePath])
+            else:
+                proc.send_signal(signal.SIGTERM)
+            for kpchName, sock, iSent in [("queued", heavySock, args.queued)] + \
+                    [("conn %d" % i, x, 1) for i, x in enumerate(lightSocks)]:
+                try:
+                    au8Inst = readFrames(sock, 30)
+                except (OSError, RuntimeError) as e:
+                    achFailures.append("%s: %s" % (kpchName, e))
+                    continue
+                finally:
+                    sock.close()
+                if au8Inst != [INST_DATA] * iSent + [INST_SHUTDOWN]:
+                    achFailures.append("%s: %d DATA of %d, last instruction %s" %
+                                       (kpchName, au8Inst.count(INST_DATA), iSent,
+                                        au8Inst[-1] if au8Inst else None))
+
+            iStatus = proc.wait(timeout=30)
+            if iStatus != 0:
+                achFailures.append("tcpServer exited with %d (see %s)" % (iStatus, logFile.name))
+
+            if newProc is not None:
+                # 새 서버가 넘겨받은 대기 소켓으로 요청을 처리하는지 확인합니다.
+                with socket.create_connection(("127.0.0.1", iPort), timeout=10) as sock:
+                    sock.sendall(achRequest)
+                    achReply = b""
+                    while len(achReply) < len(achRequest):
+                        achChunk = sock.recv(65536)
+                        if not achChunk:
+                            break
+                        achReply += achChunk
+                if achReply != achRequest:
+                    achFailures.append("new server replied %d bytes of %d" % (len(achReply), len(achRequest)))
+                stopServer(newProc)
+                if newProc.returncode != 0:
+                    achFailures.append("new tcpServer exited with %d (see %s)" % (newProc.returncode, newLogFile.name))
+        except Exception:
+            for x in (proc, newProc):
+                if x is not None:
+                    x.kill()
+                    x.wait()
+            raise
+
+    print("drain%s: %d connections + 1 with %d queued replies (max queue depth %d)" %
+          (" (upgrade)" if args.upgrade else "", args.conns, args.queued, iDepth))
+    if achFailures:
+        print("\nFAILED:")
+        for kpchFailure in achFailures[:20]:
+            print("  " + kpchFailure)
+        return 1
+    os.unlink(logFile.name)
+    os.unlink(newLogFile.name)
+    print("ok")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
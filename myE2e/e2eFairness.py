@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+"""
+@file e2eFairness.py
+@brief 많이 보내는 연결 옆에서 적게 보내는 연결들의 꼬리 지연을 재는 종단간 벤치마크
+
+tcpServer 를 임시 포트(-p 0)로 띄우고, tcpLoadGen 두 개를 동시에 실행합니다.
+하나는 연결 1개로 큰 메시지를 서버가 따라가지 못할 만큼 보내고(heavy), 다른 하나는 연결 1,000개로
+작은 메시지를 조금씩 보냅니다(light). 서버 옵션 묶음(--variant)마다 light 연결들의 p50/p99/p99.9 지연과
+heavy 연결의 처리량을 --repeat 번 재어 중앙값을 출력합니다.
+
+사용 예)
+    python3 myE2e/e2eFairness.py                                    # 기본 read 예산과 예산 없음(-Q 1048576,0) 비교
+    python3 myE2e/e2eFairness.py --variant "" --variant "-Q 4096"
+"""
+import argparse
+import json
+import os
+import shlex
+import subprocess
+import sys
+import tempfile
+
+from e2eRegression import REPO_DIR, raiseFdLimit, startServer, stopServer
+
+
+def runLoadGen(args, iPort, iConns, dRate, iSize, dDuration, dWarmup):
+    return subprocess.Popen([args.loadgen, "-j", "-p", str(iPort), "-c", str(iConns), "-r", str(dRate),
+                             "-d", str(dDuration), "-w", str(dWarmup), "-s", "fixed:%d" % iSize, "-t", str(args.drain)],
+                            stdout=subprocess.PIPE, stderr=subprocess.PIPE, text=True)
+
+
+def readLoadGen(proc, dTimeout):
+    achOut, achErr = proc.communicate(timeout=dTimeout)
+    if proc.returncode != 0:
+        raise RuntimeError("tcpLoadGen failed: %s" % achErr.strip()[-500:])
+    return json.loads(achOut.strip().splitlines()[-1])
+
+
+def runOnce(args, kpchVariant):
+    """서버 옵션 묶음 하나로 한 번 실행하고 지표 dict 를 반환합니다."""
+    kpchAdminPath = os.path.join(tempfile.gettempdir(), "tcpE2eFair.%d.admin" % os.getpid())
+    serverArgs = argparse.Namespace(server=args.server)
+    with tempfile.NamedTemporaryFile(prefix="tcpE2eFair.", suffix=".log", delete=False) as logFile:
+        proc, iPort = startServer(serverArgs, args.light_conns + 1, kpchAdminPath, logFile, shlex.split(kpchVariant))
+        try:
+            # heavy 가 먼저 서버를 바쁘게 만든 뒤 light 를 잽니다.
+            heavyProc = runLoadGen(args, iPort, 1, args.heavy_rate, args.heavy_size,
+                                   args.duration + args.warmup + 1, 0)
+            lightProc = runLoadGen(args, iPort, args.light_conns, args.light_rate, args.light_size,
+                                   args.duration, args.warmup + 0.5)
+            dTimeout = args.duration + args.warmup + args.drain + 120
+            stLight = readLoadGen(lightProc, dTimeout)
+            stHeavy = readLoadGen(heavyProc, dTimeout)
+        finally:
+            stopServer(proc)
+        os.unlink(logFile.name)
+
+    return {
+        "light_p50_us": stLight["p50_us"],
+        "light_p99_us": stLight["p99_us"],
+        "light_p999_us": stLight["p999_us"],
+        "light_lost": stLight["lost"],
+        "heavy_mb_per_sec": stHeavy["mb_per_sec"],
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description="heavy 1개 + light 1,000개 연결의 꼬리 지연 비교")
+    parser.add_argument("--server", default=os.path.join(REPO_DIR, "tcpServer"))
+    parser.add_argument("--loadgen", default=os.path.join(REPO_DIR, "tcpLoadGen"))
+    parser.add_argument("--variant", action="append", help="서버에 더할 옵션 묶음 (여러 번 지정)")
+    parser.add_argument("--light-conns", type=int, default=1000)
+    parser.add_argument("--light-rate", type=float, default=2000, help="light 전체 전송률 (msgs/s)")
+    parser.add_argument("--light-size", type=int, default=64)
+    parser.add_argument("--heavy-rate", type=float, default=2000, help="heavy 전송률 (msgs/s)")
+    parser.add_argument("--heavy-size", type=int, default=16384)
+    parser.add_argument("--duration", type=float, default=3)
+    parser.add_argument("--warmup", type=float, default=1)
+    parser.add_argument("--drain", type=float, default=30, help="송신 종료 후 응답을 기다리는 최대 시간 (초)")
+    parser.add_argument("--repeat", type=int, default=3, help="반복 횟수 (지표별 중앙값 사용)")
+    parser.add_argument("--output", default="e2e_fairness.json")
+    args = parser.parse_args()
+    achVariants = args.variant if args.variant else ["", "-Q 1048576,0"]
+
+    if not raiseFdLimit(args.light_conns + 256):
+        print("skipped: RLIMIT_NOFILE hard limit too low for %d connections" % args.light_conns)
+        return 0
+
+    stResults = {}
+    print("%-24s %12s %12s %12s %10s %12s" % ("server args", "p50(us)", "p99(us)", "p99.9(us)", "lost", "heavy MB/s"))
+    for kpchVariant in achVariants:
+        astRuns = [runOnce(args, kpchVariant) for _ in range(args.repeat)]
+        stResult = {k: sorted(x[k] for x in astRuns)[len(astRuns) // 2] for k in astRuns[0]}
+        stResults[kpchVariant or "(default)"] = stResult
+        print("%-24s %12.0f %12.0f %12.0f %10d %12.1f" %
+              (kpchVariant or "(default)", stResult["light_p50_us"], stResult["light_p99_us"],
+               stResult["light_p999_us"], stResult["light_lost"], stResult["heavy_mb_per_sec"]))
+
+    with open(args.output, "w") as f:
+        json.dump({"light_conns": args.light_conns, "heavy_size": args.heavy_size, "variants": stResults}, f, indent=2)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,253 @@
+#!/usr/bin/env python3
+"""
+@file e2eRegression.py
+@brief 루프백 종단간 처리량/꼬리 지연 회귀 테스트
+
+tcpServer 를 임시 포트(-p 0)로 띄우고 tcpLoadGen 으로 연결 수(1, 100, 1k, 10k)와
+메시지 크기별 시나리오를 실행합니다. 시나리오마다 msgs/s, p99 지연, 서버 최대 RSS,
+메시지당 서버 CPU 시간을 기록하고 저장된 기준값(baseline)과 비교하여,
+허용 범위를 넘게 나빠진 지표가 있으면 0이 아닌 값으로 종료합니다.
+기준값이 없는 시나리오도 실패로 봅니다(--allow-missing-baseline 으로 허용).
+
+사용 예)
+    python3 myE2e/e2eRegression.py                      # 기준값과 비교
+    python3 myE2e/e2eRegression.py --update-baseline    # 현재 결과를 기준값으로 저장
+    python3 myE2e/e2eRegression.py --conns 1,100 --sizes 64
+    python3 myE2e/e2eRegression.py --conns 50 --allow-missing-baseline
+"""
+import argparse
+import json
+import os
+import re
+import resource
+import signal
+import socket
+import subprocess
+import sys
+import tempfile
+import time
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+REPO_DIR = os.path.dirname(SCRIPT_DIR)
+
+# 지표별 방향과 기본 허용 범위. tolerance 는 상대 비율, slack 은 작은 값의 잡음을 흡수하는 절대 여유입니다.
+# 기준값 파일의 "tolerance" 항목으로 덮어쓸 수 있습니다.
+DEFAULT_TOLERANCE = {
+    "msgs_per_sec":   {"higher_is_better": True,  "tolerance": 0.05, "slack": 0.0},
+    "p99_us":         {"higher_is_better": False, "tolerance": 1.00, "slack": 2000.0},
+    "rss_kb":         {"higher_is_better": False, "tolerance": 0.25, "slack": 4096.0},
+    "cpu_us_per_msg": {"higher_is_better": False, "tolerance": 0.50, "slack": 5.0},
+}
+
+PORT_PATTERN = re.compile(r"포트 (\d+)에서 서버 대기 중")
+
+
+def scenarioName(iConns, iSize):
+    return "c%d_s%d" % (iConns, iSize)
+
+
+def raiseFdLimit(iNeeded):
+    """자식 프로세스도 물려받도록 열린 파일 수 제한을 올립니다. 올릴 수 없으면 False."""
+    iSoft, iHard = resource.getrlimit(resource.RLIMIT_NOFILE)
+    if iHard != resource.RLIM_INFINITY and iHard < iNeeded:
+        return False
+    if iSoft != resource.RLIM_INFINITY and iSoft < iNeeded:
+        resource.setrlimit(resource.RLIMIT_NOFILE, (iNeeded, iHard))
+    return True
+
+
+def readCpuSeconds(iPid):
+    """/proc/<pid>/stat 의 utime + stime (초)"""
+    with open("/proc/%d/stat" % iPid) as f:
+        achFields = f.read().rsplit(")", 1)[1].split()
+    return (int(achFields[11]) + int(achFields[12])) / os.sysconf("SC_CLK_TCK")
+
+
+def readPeakRssKb(iPid):
+    with open("/proc/%d/status" % iPid) as f:
+        for line in f:
+            if line.startswith("VmHWM:"):
+                return int(line.split()[1])
+    return 0
+
+
+def queryAdminCounter(kpchAdminPath, kpchName):
+    """관리 소켓의 metrics 명령으로 카운터 값을 읽습니다."""
+    with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as s:
+        s.settimeout(60)
+        s.connect(kpchAdminPath)
+        s.sendall(b"metrics\n")
+        achData = b""
+        while True:
+            achChunk = s.recv(65536)
+            if not achChunk:
+                break
+            achData += achChunk
+    for line in achData.decode().splitlines():
+        if line.startswith(kpchName + " "):
+            return float(line.split()[1])
+    return 0.0
+
+
+def startServer(args, iConns, kpchAdminPath, logFile, achExtraArgs=()):
+    proc = subprocess.Popen([args.server, "-q", "-p", "0", "-c", str(iConns + 16), "-a", kpchAdminPath] + list(achExtraArgs),
+                            stdout=logFile, stderr=subprocess.STDOUT)
+    dDeadline = time.time() + 5
+    while time.time() < dDeadline:
+        logFile.flush()
+        with open(logFile.name, encoding="utf-8", errors="replace") as f:
+            match = PORT_PATTERN.search(f.read())
+        if match and os.path.exists(kpchAdminPath):
+            return proc, int(match.group(1))
+        if proc.poll() is not None:
+            break
+        time.sleep(0.05)
+    proc.kill()
+    raise RuntimeError("tcpServer did not start (see %s)" % logFile.name)
+
+
+def stopServer(proc):
+    proc.send_signal(signal.SIGTERM)
+    try:
+        proc.wait(timeout=10)
+    except subprocess.TimeoutExpired:
+        proc.kill()
+        proc.wait()
+
+
+def runScenario(args, iConns, iSize):
+    """시나리오 하나를 실행하고 지표 dict 를 반환합니다."""
+    kpchAdminPath = os.path.join(tempfile.gettempdir(), "tcpE2e.%d.admin" % os.getpid())
+    with tempfile.NamedTemporaryFile(prefix="tcpE2e.", suffix=".log", delete=False) as logFile:
+        proc, iPort = startServer(args, iConns, kpchAdminPath, logFile)
+        try:
+            dCpuBefore = readCpuSeconds(proc.pid)
+            dMsgsBefore = queryAdminCounter(kpchAdminPath, "tcp_server_messages_in_total")
+            completed = subprocess.run([args.loadgen, "-j", "-p", str(iPort), "-c", str(iConns),
+                                        "-r", str(args.rate), "-d", str(args.duration), "-w", str(args.warmup),
+                                        "-s", "fixed:%d" % iSize, "-t", str(args.drain)],
+                                       stdout=subprocess.PIPE, stderr=subprocess.PIPE, text=True,
+                                       timeout=args.duration + args.warmup + args.drain + 120)
+            if completed.returncode != 0:
+                raise RuntimeError("tcpLoadGen failed: %s" % completed.stderr.strip()[-500:])
+            stLoad = json.loads(completed.stdout.strip().splitlines()[-1])
+            dCpu = readCpuSeconds(proc.pid) - dCpuBefore
+            dMsgs = queryAdminCounter(kpchAdminPath, "tcp_server_messages_in_total") - dMsgsBefore
+            iRssKb = readPeakRssKb(proc.pid)
+        finally:
+            stopServer(proc)
+        os.unlink(logFile.name)
+
+    return {
+        "msgs_per_sec": stLoad["msgs_per_sec"],
+        "p99_us": stLoad["p99_us"],
+        "rss_kb": iRssKb,
+        "cpu_us_per_msg": dCpu * 1e6 / dMsgs if dMsgs > 0 else 0.0,
+        "lost": stLoad["lost"],
+        "frame_errors": stLoad["frame_errors"],
+        "p50_us": stLoad["p50_us"],
+        "p999_us": stLoad["p999_us"],
+    }
+
+
+def runScenarioRepeated(args, iConns, iSize):
+    """시나리오를 --repeat 번 실행하고 지표별 중앙값을 반환합니다. 손실/프레임 오류는 최대값을 씁니다."""
+    astRuns = [runScenario(args, iConns, iSize) for _ in range(args.repeat)]
+    stResult = {}
+    for kpchKey in astRuns[0]:
+        adValues = sorted(stRun[kpchKey] for stRun in astRuns)
+        stResult[kpchKey] = max(adValues) if kpchKey in ("lost", "frame_errors") else adValues[len(adValues) // 2]
+    return stResult
+
+
+def compareMetric(kpchMetric, dValue, dBase, stTol):
+    """허용 범위를 넘게 나빠졌으면 한계값을, 아니면 None 을 반환합니다."""
+    if stTol["higher_is_better"]:
+        dLimit = dBase * (1.0 - stTol["tolerance"]) - stTol["slack"]
+        return dLimit if dValue < dLimit else None
+    dLimit = dBase * (1.0 + stTol["tolerance"]) + stTol["slack"]
+    return dLimit if dValue > dLimit else None
+
+
+def main():
+    parser = argparse.ArgumentParser(description="tcpServer 종단간 회귀 테스트")
+    parser.add_argument("--server", default=os.path.join(REPO_DIR, "tcpServer"))
+    parser.add_argument("--loadgen", default=os.path.join(REPO_DIR, "tcpLoadGen"))
+    parser.add_argument("--baseline", default=os.path.join(SCRIPT_DIR, "baseline.json"))
+    parser.add_argument("--output", default="e2e_results.json", help="이번 실행 결과 JSON")
+    parser.add_argument("--conns", default="1,100,1000,10000", help="연결 수 목록")
+    parser.add_argument("--sizes", default="64,1024", help="메시지 크기 목록 (바이트)")
+    parser.add_argument("--rate", type=float, default=10000, help="시나리오별 전체 목표 전송률 (msgs/s)")
+    parser.add_argument("--duration", type=float, default=3)
+    parser.add_argument("--warmup", type=float, default=1)
+    parser.add_argument("--repeat", type=int, default=3, help="시나리오 반복 횟수 (지표별 중앙값 사용)")
+    parser.add_argument("--drain", type=float, default=30, help="송신 종료 후 응답을 기다리는 최대 시간 (초)")
+    parser.add_argument("--update-baseline", action="store_true", help="결과를 기준값으로 저장하고 비교하지 않음")
+    parser.add_argument("--allow-missing-baseline", action="store_true", help="기준값이 없는 시나리오를 실패로 보지 않음")
+    args = parser.parse_args()
+
+    stBaseline = {"tolerance": {}, "scenarios": {}}
+    if os.path.exists(args.baseline):
+        with open(args.baseline) as f:
+            stBaseline = json.load(f)
+    stTolerance = {k: dict(v, **stBaseline.get("tolerance", {}).get(k, {})) for k, v in DEFAULT_TOLERANCE.items()}
+
+    stResults = {}
+    achFailures = []
+    print("%-14s %12s %10s %10s %14s  %s" % ("scenario", "msgs/s", "p99(us)", "rss(kB)", "cpu(us)/msg", "status"))
+    for iConns in [int(x) for x in args.conns.split(",")]:
+        for iSize in [int(x) for x in args.sizes.split(",")]:
+            kpchName = scenarioName(iConns, iSize)
+            if not raiseFdLimit(iConns + 256):
+                print("%-14s skipped: RLIMIT_NOFILE hard limit too low for %d connections" % (kpchName, iConns))
+                continue
+            try:
+                stResult = runScenarioRepeated(args, iConns, iSize)
+            except (RuntimeError, subprocess.TimeoutExpired, OSError) as e:
+                achFailures.append("%s: %s" % (kpchName, e))
+                print("%-14s ERROR %s" % (kpchName, e))
+                continue
+            stResults[kpchName] = stResult
+
+            achStatus = []
+            if stResult["lost"] > 0 or stResult["frame_errors"] > 0:
+                achStatus.append("lost %d / frame errors %d" % (stResult["lost"], stResult["frame_errors"]))
+            stBase = stBaseline.get("scenarios", {}).get(kpchName)
+            if stBase is None:
+                achStatus.append("no baseline")
+            elif not args.update_baseline:
+                for kpchMetric, stTol in stTolerance.items():
+                    dLimit = compareMetric(kpchMetric, stResult[kpchMetric], stBase[kpchMetric], stTol)
+                    if dLimit is not None:
+                        achStatus.append("%s %.1f (baseline %.1f, limit %.1f)" %
+                                         (kpchMetric, stResult[kpchMetric], stBase[kpchMetric], dLimit))
+            bFailed = any(not x.startswith("no baseline") or not (args.allow_missing_baseline or args.update_baseline)
+                          for x in achStatus)
+            if bFailed:
+                achFailures.append("%s: %s" % (kpchName, "; ".join(achStatus)))
+            print("%-14s %12.1f %10.1f %10d %14.2f  %s" %
+                  (kpchName, stResult["msgs_per_sec"], stResult["p99_us"], stResult["rss_kb"],
+                   stResult["cpu_us_per_msg"], "; ".join(achStatus) if achStatus else "ok"))
+
+    with open(args.output, "w") as f:
+        json.dump({"rate": args.rate, "duration_sec": args.duration, "scenarios": stResults}, f, indent=2)
+
+    if args.update_baseline:
+        stBaseline.setdefault("scenarios", {}).update(
+            {k: {m: v[m] for m in DEFAULT_TOLERANCE} for k, v in stResults.items()})
+        stBaseline["tolerance"] = stBaseline.get("tolerance", {})
+        with open(args.baseline, "w") as f:
+            json.dump(stBaseline, f, indent=2, sort_keys=True)
+            f.write("\n")
+        print("baseline updated: %s" % args.baseline)
+
+    if achFailures:
+        print("\nREGRESSION:")
+        for kpchFailure in achFailures:
+            print("  " + kpchFailure)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include "tcpAdmin.h"
+#include "tcpMetrics.h"
+#include <sys/socket.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string>
+
+/**
+ * @brief 관리 명령 결과를 문자열로 받아오는 헬퍼
+ */
+static std::string runAdminCommand(const char *kpchCommand, int *piStatus) {
+    char *pchOut = handleTcpAdminCommand(kpchCommand, piStatus);
+    std::string strOut = (pchOut != NULL) ? pchOut : "";
+    free(pchOut);
+    return strOut;
+}
+
+/**
+ * @brief Prometheus 메트릭 출력 테스트
+ *
+ * 카운터, 게이지, 히스토그램이 Prometheus 텍스트 형식으로 출력되는지 확인합니다.
+ */
+TEST(TcpAdminTest, MetricsInPrometheusFormat) {
+    int iStatus = 0;
+    recordTcpHistogram(TCP_HIST_RECV_TO_SEND, 5000);
+
+    std::string strOut = runAdminCommand("metrics", &iStatus);
+    ASSERT_EQ(iStatus, 200);
+    ASSERT_NE(strOut.find("# TYPE tcp_server_bytes_in_total counter"), std::string::npos);
+    ASSERT_NE(strOut.find("tcp_server_active_connections "), std::string::npos);
+    ASSERT_NE(strOut.find("tcp_server_recv_to_send_latency_seconds_bucket{le=\"+Inf\"}"), std::string::npos);
+    ASSERT_NE(strOut.find("tcp_server_recv_to_send_latency_seconds_count"), std::string::npos);
+}
+
+/**
+ * @brief 연결 목록, 큐 깊이 조회 및 연결 강제 종료 테스트
+ *
+ * socketpair로 만든 연결을 등록한 뒤 목록에 보이는지, drop 명령으로 상대편이 EOF를 받는지 확인합니다.
+ */
+TEST(TcpAdminTest, ListAndDropConnection) {
+    int aiPair[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, aiPair), 0);
+
+    TCP_CONN_METRICS stConn;
+    uint64_t u64ConnId = registerTcpConnMetrics(&stConn, aiPair[0], "10.0.0.1:1234");
+    ASSERT_NE(u64ConnId, 0u);
+    addTcpConnMetric(&stConn, TCP_METRIC_ENQUEUED, 3);
+    addTcpConnMetric(&stConn, TCP_METRIC_DEQUEUED, 1);
+
+    int iStatus = 0;
+    std::string strConns = runAdminCommand("conns", &iStatus);
+    ASSERT_EQ(iStatus, 200);
+    ASSERT_NE(strConns.find("10.0.0.1:1234"), std::string::npos);
+
+    std::string strQueues = runAdminCommand("queues", &iStatus);
+    ASSERT_NE(strQueues.find(std::to_string(u64ConnId) + "\t10.0.0.1:1234\t2"), std::string::npos) << strQueues;
+
+    std::string strDrop = "drop " + std::to_string(u64ConnId);
+    runAdminCommand(strDrop.c_str(), &iStatus);
+    ASSERT_EQ(iStatus, 200);
+
+    char chByte;
+    ASSERT_EQ(read(aiPair[1], &chByte, 1), 0) << "Peer should see EOF after drop.";
+
+    unregisterTcpConnMetrics(&stConn);
+    runAdminCommand(strDrop.c_str(), &iStatus);
+    ASSERT_EQ(iStatus, 404) << "Unregistered connection must not be found.";
+
+    close(aiPair[0]);
+    close(aiPair[1]);
+}
+
+/**
+ * @brief 알 수 없는 명령 처리 테스트
+ */
+TEST(TcpAdminTest, UnknownCommand) {
+    int iStatus = 0;
+    runAdminCommand("reboot", &iStatus);
+    ASSERT_EQ(iStatus, 400);
+}
+
+/**
+ * @brief 전송률 제한 조회/변경 명령 테스트
+ *
+ * 연결별/Client ID별 제한을 바꾸고 목록에 보이는지, 잘못된 명령은 400을 돌려주는지 확인합니다.
+ */
+TEST(TcpAdminTest, ChangeRateLimits) {
+    int iStatus = 0;
+
+    runAdminCommand("limit conn 1000000 5000", &iStatus);
+    ASSERT_EQ(iStatus, 200);
+    runAdminCommand("limit id 9 2048 0", &iStatus);
+    ASSERT_EQ(iStatus, 200);
+
+    std::string strLimits = runAdminCommand("limits", &iStatus);
+    ASSERT_EQ(iStatus, 200);
+    ASSERT_NE(strLimits.find("conn\t1000000\t5000"), std::string::npos) << strLimits;
+    ASSERT_NE(strLimits.find("id 9\t2048\t0"), std::string::npos) << strLimits;
+
+    runAdminCommand("limit id 256 1 1", &iStatus);
+    ASSERT_EQ(iStatus, 400);
+    runAdminCommand("limit conn fast", &iStatus);
+    ASSERT_EQ(iStatus, 400);
+
+    runAdminCommand("limit id 9 0 0", &iStatus);
+    runAdminCommand("limit conn 0 0", &iStatus);
+    strLimits = runAdminCommand("limits", &iStatus);
+    ASSERT_EQ(strLimits.find("id 9"), std::string::npos) << strLimits;
+    ASSERT_NE(strLimits.find("conn\t0\t0"), std::string::npos) << strLimits;
+}
+
+/**
+ * @brief 과부하 기준 조회/변경 명령 테스트
+ *
+ * admission 명령으로 기준을 바꾸고 조회 결과에 반영되는지, 형식이 틀리면 400인지 확인합니다.
+ */
+TEST(TcpAdminTest, ChangeAdmissionLimits) {
+    int iStatus = 0;
+
+    std::string strOut = runAdminCommand("admission 25 1048576 100", &iStatus);
+    ASSERT_EQ(iStatus, 200) << strOut;
+    strOut = runAdminCommand("admission", &iStatus);
+    ASSERT_EQ(iStatus, 200);
+    ASSERT_NE(strOut.find("\t25.000\n"), std::string::npos) << strOut;
+    ASSERT_NE(strOut.find("\t1048576\n"), std::string::npos) << strOut;
+    ASSERT_NE(strOut.find("\t100\n"), std::string::npos) << strOut;
+
+    runAdminCommand("admission 25", &iStatus);
+    ASSERT_EQ(iStatus, 400);
+    runAdminCommand("admission 0 0 0", &iStatus);
+    ASSERT_EQ(iStatus, 200);
+}
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include "tcpAdmission.h"
+#include "tcpMetrics.h"
+
+/**
+ * @brief 수락 제어 테스트 클래스
+ *
+ * 판단 기준과 게이지는 프로세스 전역이므로 테스트마다 기준을 끄고 게이지를 되돌립니다.
+ */
+class TcpAdmissionTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        TCP_ADMISSION_LIMIT stNone = {0, 0, 0};
+        setTcpAdmissionLimit(&stNone);
+    }
+};
+
+/**
+ * @brief 스케줄링 지연 추정 테스트
+ *
+ * 지연이 늘면 바로 따라가고, 줄면 표본마다 차이의 1/4씩 내려가는지 확인합니다.
+ */
+TEST_F(TcpAdmissionTest, LagRisesFastDecaysSlowly) {
+    recordTcpLoopLag(0);
+    for (int i = 0; i < 64; i++) {
+        recordTcpLoopLag(0);
+    }
+    ASSERT_EQ(getTcpLoopLag(), 0u);
+
+    recordTcpLoopLag(8000000);
+    ASSERT_EQ(getTcpLoopLag(), 8000000u);
+    recordTcpLoopLag(0);
+    ASSERT_EQ(getTcpLoopLag(), 6000000u);
+    recordTcpLoopLag(10000000);
+    ASSERT_EQ(getTcpLoopLag(), 10000000u);
+
+    while (getTcpLoopLag() > 0) {
+        recordTcpLoopLag(0);
+    }
+}
+
+/**
+ * @brief 판단 기준 테스트
+ *
+ * 기준이 0이면 보지 않고, 지연/큐 바이트 기준은 요청과 연결 모두에, 연결 수 기준은 새 연결에만 적용되는지 확인합니다.
+ */
+TEST_F(TcpAdmissionTest, ThresholdsRejectConnectionsAndShedRequests) {
+    TCP_ADMISSION_LIMIT stLimit = {5000000, 1000, 2};
+    TCP_ADMISSION_LIMIT stRead;
+
+    addTcpQueuedBytes(5000);
+    addTcpAdmittedConns(2);
+    ASSERT_EQ(admitTcpConnection(), TCP_BUSY_NONE) << "All limits are off by default.";
+    ASSERT_EQ(admitTcpRequest(), TCP_BUSY_NONE);
+
+    setTcpAdmissionLimit(&stLimit);
+    getTcpAdmissionLimit(&stRead);
+    ASSERT_EQ(stRead.u64MaxLagNs, stLimit.u64MaxLagNs);
+    ASSERT_EQ(stRead.u64MaxQueuedBytes, stLimit.u64MaxQueuedBytes);
+    ASSERT_EQ(stRead.u32MaxConns, stLimit.u32MaxConns);
+
+    ASSERT_EQ(admitTcpConnection(), TCP_BUSY_CONNS);
+    ASSERT_EQ(admitTcpRequest(), TCP_BUSY_QUEUED);
+    addTcpQueuedBytes(-5000);
+    ASSERT_EQ(getTcpQueuedBytes(), 0u);
+    ASSERT_EQ(admitTcpRequest(), TCP_BUSY_NONE);
+    addTcpAdmittedConns(-1);
+    ASSERT_EQ(admitTcpConnection(), TCP_BUSY_NONE);
+
+    recordTcpLoopLag(6000000);
+    ASSERT_EQ(admitTcpRequest(), TCP_BUSY_LAG);
+    ASSERT_EQ(admitTcpConnection(), TCP_BUSY_LAG);
+    ASSERT_STREQ(getTcpBusyReasonName(TCP_BUSY_LAG), "lag");
+    while (getTcpLoopLag() > 0) {
+        recordTcpLoopLag(0);
+    }
+    ASSERT_EQ(admitTcpRequest(), TCP_BUSY_NONE);
+    addTcpAdmittedConns(-1);
+    ASSERT_EQ(getTcpAdmittedConns(), 0u);
+}
+
+/**
+ * @brief 종료 중 거절 테스트
+ *
+ * 종료 기한이 설정되면 다른 기준과 관계없이 새 연결과 요청을 모두 draining으로 거절하고, 기한을 지우면 되돌아오는지 확인합니다.
+ */
+TEST_F(TcpAdmissionTest, DrainingRejectsConnectionsAndRequests) {
+    ASSERT_FALSE(isTcpDraining());
+    ASSERT_EQ(getTcpDrainDeadline(), 0u);
+
+    setTcpDrainDeadline(getTcpMonotonicNs() + 1000000000ULL);
+    ASSERT_TRUE(isTcpDraining());
+    ASSERT_EQ(admitTcpConnection(), TCP_BUSY_DRAINING);
+    ASSERT_EQ(admitTcpRequest(), TCP_BUSY_DRAINING);
+    ASSERT_STREQ(getTcpBusyReasonName(TCP_BUSY_DRAINING), "draining");
+
+    setTcpDrainDeadline(0);
+    ASSERT_FALSE(isTcpDraining());
+    ASSERT_EQ(admitTcpConnection(), TCP_BUSY_NONE);
+    ASSERT_EQ(admitTcpRequest(), TCP_BUSY_NONE);
+}
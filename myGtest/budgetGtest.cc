@@ -0,0 +1,37 @@
+#include <gtest/gtest.h>
+#include "tcpBudget.h"
+
+/**
+ * @brief 크레딧 테스트
+ *
+ * 차례마다 예산만큼 더해지고 프레임 수 제한이 지켜지며, 예산보다 큰 프레임도
+ * 남은 크레딧이 이어져 몇 차례 뒤에는 처리되는지 확인합니다.
+ */
+TEST(TcpBudgetTest, CreditCarriesDeficitAcrossTurns) {
+    TCP_READ_BUDGET stBudget = {1000, 3};
+    TCP_READ_CREDIT stCredit;
+
+    resetTcpReadCredit(&stCredit);
+    startTcpReadTurn(&stCredit, &stBudget);
+    ASSERT_TRUE(takeTcpReadCredit(&stCredit, 100));
+    ASSERT_TRUE(takeTcpReadCredit(&stCredit, 100));
+    ASSERT_TRUE(takeTcpReadCredit(&stCredit, 100));
+    ASSERT_FALSE(takeTcpReadCredit(&stCredit, 100)) << "Only 3 frames per turn.";
+    ASSERT_EQ(stCredit.i64Deficit, 700);
+
+    /**< 2500바이트 프레임은 남은 700 + 1000 + 1000 크레딧이 모인 두 차례 뒤에 처리됩니다. */
+    startTcpReadTurn(&stCredit, &stBudget);
+    ASSERT_FALSE(takeTcpReadCredit(&stCredit, 2500));
+    startTcpReadTurn(&stCredit, &stBudget);
+    ASSERT_TRUE(takeTcpReadCredit(&stCredit, 2500));
+    ASSERT_EQ(stCredit.i64Deficit, 200);
+
+    /**< 프레임 수 0은 제한 없음 */
+    stBudget.u32Frames = 0;
+    resetTcpReadCredit(&stCredit);
+    startTcpReadTurn(&stCredit, &stBudget);
+    for (int i = 0; i < 10; i++) {
+        ASSERT_TRUE(takeTcpReadCredit(&stCredit, 100));
+    }
+    ASSERT_FALSE(takeTcpReadCredit(&stCredit, 1));
+}
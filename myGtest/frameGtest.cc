@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include "tcpFrame.h"
+#include <string.h>
+
+/**
+ * @brief CRC-16/CCITT-FALSE 표준 검사 값 테스트 ("123456789" → 0x29B1)
+ */
+TEST(TcpFrameTest, CrcCheckValue) {
+    const char *kpchCheck = "123456789";
+    ASSERT_EQ(calcTcpFrameCrc((const uint8_t *)kpchCheck, strlen(kpchCheck), 0xFFFF), 0x29B1);
+}
+
+/**
+ * @brief 인코딩한 프레임을 그대로 디코딩할 수 있는지 테스트
+ */
+TEST(TcpFrameTest, EncodeDecodeRoundTrip) {
+    uint8_t au8Frame[64];
+    TCP_FRAME_HEADER stHeader;
+    const uint8_t *kpu8Data = NULL;
+
+    int iFrameLen = encodeTcpFrame(au8Frame, sizeof(au8Frame), 0x07, TCP_INST_DATA, "hello", 5);
+    ASSERT_EQ(iFrameLen, TCP_FRAME_HEADER_SIZE + 5 + TCP_FRAME_CRC_SIZE);
+    ASSERT_EQ(au8Frame[0], 0xA5);
+    ASSERT_EQ(au8Frame[1], 0x5A);
+
+    ASSERT_EQ(decodeTcpFrame(au8Frame, (size_t)iFrameLen, &stHeader, &kpu8Data), iFrameLen);
+    ASSERT_EQ(stHeader.u8ClientId, 0x07);
+    ASSERT_EQ(stHeader.u8Instruction, TCP_INST_DATA);
+    ASSERT_EQ(stHeader.u16DataLen, 5);
+    ASSERT_EQ(memcmp(kpu8Data, "hello", 5), 0);
+
+    ASSERT_EQ(encodeTcpFrame(au8Frame, 10, 0x07, TCP_INST_DATA, "hello", 5), -1) << "Output buffer is too small.";
+}
+
+/**
+ * @brief Correlation ID 프레임 테스트
+ *
+ * 플래그와 ID가 DATA 앞에 실리고, 일반 프레임에서는 ID를 꺼내지 않는지 확인합니다.
+ */
+TEST(TcpFrameTest, CorrIdRoundTrip) {
+    uint8_t au8Frame[64];
+    TCP_FRAME_HEADER stHeader;
+    const uint8_t *kpu8Data = NULL;
+    uint32_t u32CorrId = 0;
+
+    int iFrameLen = encodeTcpCorrFrame(au8Frame, sizeof(au8Frame), 0x07, TCP_INST_DATA, 0x12345678, "hi", 2);
+    ASSERT_EQ(iFrameLen, TCP_FRAME_HEADER_SIZE + TCP_FRAME_CORR_ID_SIZE + 2 + TCP_FRAME_CRC_SIZE);
+    ASSERT_EQ(decodeTcpFrame(au8Frame, (size_t)iFrameLen, &stHeader, &kpu8Data), iFrameLen);
+    ASSERT_EQ(stHeader.u8Flags, TCP_FRAME_FLAG_CORR_ID);
+    ASSERT_TRUE(getTcpFrameCorrId(&stHeader, kpu8Data, &u32CorrId));
+    ASSERT_EQ(u32CorrId, 0x12345678u);
+    ASSERT_EQ(memcmp(kpu8Data + TCP_FRAME_CORR_ID_SIZE, "hi", 2), 0);
+
+    iFrameLen = encodeTcpFrame(au8Frame, sizeof(au8Frame), 0x07, TCP_INST_DATA, "hello", 5);
+    ASSERT_EQ(decodeTcpFrame(au8Frame, (size_t)iFrameLen, &stHeader, &kpu8Data), iFrameLen);
+    ASSERT_FALSE(getTcpFrameCorrId(&stHeader, kpu8Data, &u32CorrId));
+
+    ASSERT_EQ(encodeTcpCorrFrame(au8Frame, sizeof(au8Frame), 0x07, TCP_INST_DATA, 1, NULL, TCP_FRAME_MAX_DATA), -1);
+}
+
+/**
+ * @brief 나뉘어 온 프레임, 손상된 프레임, 재동기화 테스트
+ *
+ * 프레임이 덜 오면 0을, CRC가 틀리면 -1을 반환하고, 앞에 붙은 쓰레기 데이터를 건너뛰어 다음 프레임을 찾는지 확인합니다.
+ */
+TEST(TcpFrameTest, PartialCorruptAndResync) {
+    uint8_t au8Stream[128];
+    const size_t kuiGarbage = 3;
+
+    memset(au8Stream, 0x11, kuiGarbage);
+    int iFrameLen = encodeTcpFrame(au8Stream + kuiGarbage, sizeof(au8Stream) - kuiGarbage, 1, TCP_INST_HEARTBEAT, NULL, 0);
+    ASSERT_GT(iFrameLen, 0);
+
+    ASSERT_EQ(decodeTcpFrame(au8Stream + kuiGarbage, (size_t)iFrameLen - 1, NULL, NULL), 0);
+    ASSERT_EQ(decodeTcpFrame(au8Stream, kuiGarbage + (size_t)iFrameLen, NULL, NULL), -1);
+    ASSERT_EQ(findTcpFrameStart(au8Stream, kuiGarbage + (size_t)iFrameLen), kuiGarbage);
+
+    au8Stream[kuiGarbage + TCP_FRAME_HEADER_SIZE] ^= 0xFF; /**< CRC 손상 */
+    ASSERT_EQ(decodeTcpFrame(au8Stream + kuiGarbage, (size_t)iFrameLen, NULL, NULL), -1);
+}
+
+/**
+ * @brief 덜 온 프레임의 남은 바이트 테스트
+ *
+ * 헤더 전에는 가장 작은 프레임 기준으로, 헤더가 오면 Data Length 기준으로 남은 바이트를 계산하고,
+ * 완성된 프레임은 0, 잘못된 매직은 1을 반환하는지 확인합니다.
+ */
+TEST(TcpFrameTest, NeededBytesFollowDataLength) {
+    uint8_t au8Frame[TCP_FRAME_MAX_SIZE];
+    uint8_t au8Data[1000] = {};
+    int iFrameLen = encodeTcpFrame(au8Frame, sizeof(au8Frame), 1, TCP_INST_DATA, au8Data, sizeof(au8Data));
+    ASSERT_EQ(iFrameLen, TCP_FRAME_HEADER_SIZE + 1000 + TCP_FRAME_CRC_SIZE);
+
+    ASSERT_EQ(getTcpFrameNeededBytes(au8Frame, 0), (size_t)(TCP_FRAME_HEADER_SIZE + TCP_FRAME_CRC_SIZE));
+    ASSERT_EQ(getTcpFrameNeededBytes(au8Frame, 3), (size_t)(TCP_FRAME_HEADER_SIZE + TCP_FRAME_CRC_SIZE - 3));
+    ASSERT_EQ(getTcpFrameNeededBytes(au8Frame, TCP_FRAME_HEADER_SIZE), (size_t)(1000 + TCP_FRAME_CRC_SIZE));
+    ASSERT_EQ(getTcpFrameNeededBytes(au8Frame, 600), (size_t)iFrameLen - 600);
+    ASSERT_EQ(getTcpFrameNeededBytes(au8Frame, (size_t)iFrameLen), 0u);
+    au8Frame[0] ^= 0xFF;
+    ASSERT_EQ(getTcpFrameNeededBytes(au8Frame, 1), 1u);
+}
+
+/**
+ * @brief 헤더 확인과 우선순위 등급 테스트
+ *
+ * peekTcpFrame()은 CRC가 틀려도 헤더만으로 프레임 길이와 Instruction을 알려 주고,
+ * 제어 Instruction만 제어 등급으로 분류되는지 확인합니다.
+ */
+TEST(TcpFrameTest, PeekHeaderAndPriority) {
+    uint8_t au8Frame[64];
+    TCP_FRAME_HEADER stHeader;
+    int iFrameLen = encodeTcpFrame(au8Frame, sizeof(au8Frame), 7, TCP_INST_HEARTBEAT, "ping", 4);
+    ASSERT_GT(iFrameLen, 0);
+
+    ASSERT_EQ(peekTcpFrame(au8Frame, (size_t)iFrameLen - 1, &stHeader), 0);
+    au8Frame[TCP_FRAME_HEADER_SIZE] ^= 0xFF; /**< CRC 손상 */
+    ASSERT_EQ(peekTcpFrame(au8Frame, (size_t)iFrameLen, &stHeader), iFrameLen);
+    ASSERT_EQ(stHeader.u8ClientId, 7);
+    ASSERT_EQ(stHeader.u8Instruction, TCP_INST_HEARTBEAT);
+    ASSERT_EQ(stHeader.u16DataLen, 4);
+    ASSERT_EQ(decodeTcpFrame(au8Frame, (size_t)iFrameLen, NULL, NULL), -1);
+    au8Frame[0] ^= 0xFF;
+    ASSERT_EQ(peekTcpFrame(au8Frame, (size_t)iFrameLen, NULL), -1);
+
+    ASSERT_EQ(getTcpFramePriority(TCP_INST_HEARTBEAT), TCP_FRAME_PRIO_CONTROL);
+    ASSERT_EQ(getTcpFramePriority(TCP_INST_SHM_OFFER), TCP_FRAME_PRIO_CONTROL);
+    ASSERT_EQ(getTcpFramePriority(TCP_INST_CAPS), TCP_FRAME_PRIO_CONTROL);
+    ASSERT_EQ(getTcpFramePriority(TCP_INST_DATA), TCP_FRAME_PRIO_BULK);
+    ASSERT_EQ(getTcpFramePriority(0x7F), TCP_FRAME_PRIO_BULK);
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include "tcpLz4.h"
+#include "tcpFrame.h"
+#include <string.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 반복이 많은 텍스트를 만듭니다.
+ */
+static std::string makeRepetitiveText(size_t uiLen) {
+    std::string strText;
+
+    for (int i = 0; strText.size() < uiLen; i++) {
+        strText += "sensor=" + std::to_string(i % 17) + " status=OK value=0.000 ";
+    }
+    strText.resize(uiLen);
+    return strText;
+}
+
+/**
+ * @brief 압축 후 풀면 원본과 같은지, 겹치는 매치(거리 1)와 짧은 입력도 처리하는지 테스트
+ */
+TEST(TcpLz4Test, RoundTrip) {
+    std::vector<uint8_t> vPacked(TCP_LZ4_BOUND(TCP_LZ4_MAX_INPUT));
+    std::vector<uint8_t> vPlain(TCP_LZ4_MAX_INPUT);
+
+    for (size_t uiLen : {0, 1, 12, 13, 100, 4096, TCP_LZ4_MAX_INPUT}) {
+        std::string strText = makeRepetitiveText(uiLen);
+        int iPackedLen = compressTcpLz4((const uint8_t *)strText.data(), uiLen, vPacked.data(), vPacked.size());
+        ASSERT_GT(iPackedLen, 0) << uiLen;
+        if (uiLen >= 4096) {
+            ASSERT_LT((size_t)iPackedLen, uiLen / 4) << uiLen;
+        }
+        ASSERT_EQ(decompressTcpLz4(vPacked.data(), (size_t)iPackedLen, vPlain.data(), uiLen), (int)uiLen);
+        ASSERT_EQ(memcmp(vPlain.data(), strText.data(), uiLen), 0) << uiLen;
+    }
+
+    std::vector<uint8_t> vZero(1000, 0);
+    int iPackedLen = compressTcpLz4(vZero.data(), vZero.size(), vPacked.data(), vPacked.size());
+    ASSERT_GT(iPackedLen, 0);
+    ASSERT_LT(iPackedLen, 20);
+    ASSERT_EQ(decompressTcpLz4(vPacked.data(), (size_t)iPackedLen, vPlain.data(), vPlain.size()), 1000);
+    ASSERT_EQ(memcmp(vPlain.data(), vZero.data(), vZero.size()), 0);
+
+    ASSERT_EQ(compressTcpLz4(vZero.data(), TCP_LZ4_MAX_INPUT + 1, vPacked.data(), vPacked.size()), -1);
+    ASSERT_EQ(compressTcpLz4(vZero.data(), vZero.size(), vPacked.data(), 4), 0) << "Output buffer is too small.";
+}
+
+/**
+ * @brief 손상되거나 잘린 입력은 버퍼 밖으로 나가지 않고 -1을 반환하는지 테스트
+ */
+TEST(TcpLz4Test, RejectsCorruptInput) {
+    std::string strText = makeRepetitiveText(2000);
+    std::vector<uint8_t> vPacked(TCP_LZ4_BOUND(strText.size()));
+    std::vector<uint8_t> vPlain(strText.size());
+    int iPackedLen = compressTcpLz4((const uint8_t *)strText.data(), strText.size(), vPacked.data(), vPacked.size());
+    ASSERT_GT(iPackedLen, 0);
+
+    ASSERT_EQ(decompressTcpLz4(vPacked.data(), 0, vPlain.data(), vPlain.size()), -1);
+    ASSERT_EQ(decompressTcpLz4(vPacked.data(), (size_t)iPackedLen, vPlain.data(), vPlain.size() - 1), -1);
+    for (int iCut = 1; iCut < iPackedLen; iCut += 7) {
+        ASSERT_LT(decompressTcpLz4(vPacked.data(), (size_t)iCut, vPlain.data(), vPlain.size()), (int)strText.size());
+    }
+
+    const uint8_t kau8FarOffset[] = {0x10, 'a', 0xFF, 0x00, 0x00}; /**< 이미 쓴 길이보다 먼 거리 */
+    ASSERT_EQ(decompressTcpLz4(kau8FarOffset, sizeof(kau8FarOffset), vPlain.data(), vPlain.size()), -1);
+    const uint8_t kau8ZeroOffset[] = {0x10, 'a', 0x00, 0x00, 0x00};
+    ASSERT_EQ(decompressTcpLz4(kau8ZeroOffset, sizeof(kau8ZeroOffset), vPlain.data(), vPlain.size()), -1);
+}
+
+/**
+ * @brief 압축 프레임 테스트
+ *
+ * 임계값 이상이고 줄어드는 DATA만 LZ4 플래그로 압축되고, 나머지는 일반 프레임이며
+ * 어느 쪽이든 getTcpFramePlainData()로 원래 DATA를 얻는지 확인합니다.
+ */
+TEST(TcpLz4Test, FrameCompressesOnlyWhenWorthwhile) {
+    std::string strText = makeRepetitiveText(1000);
+    std::vector<uint8_t> vFrame(TCP_FRAME_MAX_SIZE);
+    std::vector<uint8_t> vPlain(TCP_FRAME_MAX_DATA);
+    TCP_FRAME_HEADER stHeader;
+    const uint8_t *kpu8Data, *kpu8Plain;
+
+    int iFrameLen = encodeTcpLz4Frame(vFrame.data(), vFrame.size(), 0x07, TCP_INST_DATA, strText.data(), strText.size(),
+                                      TCP_FRAME_COMPRESS_THRESHOLD);
+    ASSERT_GT(iFrameLen, 0);
+    ASSERT_LT((size_t)iFrameLen, strText.size() / 2);
+    ASSERT_EQ(decodeTcpFrame(vFrame.data(), (size_t)iFrameLen, &stHeader, &kpu8Data), iFrameLen);
+    ASSERT_EQ(stHeader.u8Flags, TCP_FRAME_FLAG_LZ4);
+    ASSERT_EQ(stHeader.u8ClientId, 0x07);
+    ASSERT_EQ(getTcpFramePlainData(&stHeader, kpu8Data, vPlain.data(), vPlain.size(), &kpu8Plain), (int)strText.size());
+    ASSERT_EQ(kpu8Plain, vPlain.data());
+    ASSERT_EQ(memcmp(kpu8Plain, strText.data(), strText.size()), 0);
+    ASSERT_EQ(getTcpFramePlainData(&stHeader, kpu8Data, vPlain.data(), strText.size() - 1, &kpu8Plain), -1);
+
+    /**< 임계값보다 짧으면 압축하지 않습니다. */
+    iFrameLen = encodeTcpLz4Frame(vFrame.data(), vFrame.size(), 0x07, TCP_INST_DATA, strText.data(), 100,
+                                  TCP_FRAME_COMPRESS_THRESHOLD);
+    ASSERT_EQ(iFrameLen, TCP_FRAME_HEADER_SIZE + 100 + TCP_FRAME_CRC_SIZE);
+    ASSERT_EQ(decodeTcpFrame(vFrame.data(), (size_t)iFrameLen, &stHeader, &kpu8Data), iFrameLen);
+    ASSERT_EQ(stHeader.u8Flags, 0);
+    ASSERT_EQ(getTcpFramePlainData(&stHeader, kpu8Data, vPlain.data(), vPlain.size(), &kpu8Plain), 100);
+    ASSERT_EQ(kpu8Plain, kpu8Data);
+
+    /**< 줄어들지 않는 데이터는 일반 프레임으로 보냅니다. */
+    std::vector<uint8_t> vNoise(1000);
+    uint32_t u32State = 2463534242u;
+    for (uint8_t &u8Byte : vNoise) {
+        u32State ^= u32State << 13;
+        u32State ^= u32State >> 17;
+        u32State ^= u32State << 5;
+        u8Byte = (uint8_t)u32State;
+    }
+    iFrameLen = encodeTcpLz4Frame(vFrame.data(), vFrame.size(), 0x07, TCP_INST_DATA, vNoise.data(), vNoise.size(), 0);
+    ASSERT_EQ(iFrameLen, (int)(TCP_FRAME_HEADER_SIZE + vNoise.size() + TCP_FRAME_CRC_SIZE));
+    ASSERT_EQ(decodeTcpFrame(vFrame.data(), (size_t)iFrameLen, &stHeader, &kpu8Data), iFrameLen);
+    ASSERT_EQ(stHeader.u8Flags, 0);
+    ASSERT_EQ(memcmp(kpu8Data, vNoise.data(), vNoise.size()), 0);
+}
+
+/**
+ * @brief CRC는 맞지만 압축 DATA가 잘못된 프레임은 원래 DATA를 얻지 못하는지 테스트
+ */
+TEST(TcpLz4Test, PlainDataRejectsBadCompressedFrame) {
+    uint8_t au8Frame[64];
+    uint8_t au8Plain[64];
+    TCP_FRAME_HEADER stHeader;
+    const uint8_t *kpu8Data, *kpu8Plain;
+
+    ASSERT_EQ(encodeTcpFrame(au8Frame, sizeof(au8Frame), 0x07, TCP_INST_DATA, "\x00\x05\x50hello", 8), 18);
+    au8Frame[3] = TCP_FRAME_FLAG_LZ4; /**< 원래 길이 5, 리터럴 5바이트 */
+    uint16_t u16Crc = calcTcpFrameCrc(au8Frame, TCP_FRAME_HEADER_SIZE + 8, 0xFFFF);
+    au8Frame[16] = (uint8_t)(u16Crc >> 8);
+    au8Frame[17] = (uint8_t)(u16Crc & 0xFF);
+    ASSERT_EQ(decodeTcpFrame(au8Frame, 18, &stHeader, &kpu8Data), 18);
+    ASSERT_EQ(getTcpFramePlainData(&stHeader, kpu8Data, au8Plain, sizeof(au8Plain), &kpu8Plain), 5);
+    ASSERT_EQ(memcmp(kpu8Plain, "hello", 5), 0);
+
+    au8Frame[TCP_FRAME_HEADER_SIZE + 1] = 6; /**< 원래 길이와 풀린 길이가 다름 */
+    ASSERT_EQ(getTcpFramePlainData(&stHeader, kpu8Data, au8Plain, sizeof(au8Plain), &kpu8Plain), -1);
+
+    stHeader.u16DataLen = TCP_FRAME_LZ4_LEN_SIZE;
+    ASSERT_EQ(getTcpFramePlainData(&stHeader, kpu8Data, au8Plain, sizeof(au8Plain), &kpu8Plain), -1);
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include "tcpMetrics.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 히스토그램 백분위 정확도 테스트
+ *
+ * 1 ~ 100000 까지의 값을 기록한 뒤 백분위 값이 HDR 버킷의 상대 오차(약 3%) 이내인지 확인합니다.
+ */
+TEST(TcpMetricsTest, HistogramPercentileAccuracy) {
+    static TCP_HISTOGRAM stHist;
+    resetTcpHistogram(&stHist);
+
+    for (uint64_t u64Value = 1; u64Value <= 100000; u64Value++) {
+        addTcpHistogramValue(&stHist, u64Value);
+    }
+
+    ASSERT_EQ(stHist.u64Count, 100000u);
+    ASSERT_EQ(stHist.u64Max, 100000u);
+    ASSERT_NEAR((double)getTcpHistogramPercentile(&stHist, 50.0), 50000.0, 50000.0 * 0.04);
+    ASSERT_NEAR((double)getTcpHistogramPercentile(&stHist, 99.0), 99000.0, 99000.0 * 0.04);
+    ASSERT_EQ(getTcpHistogramPercentile(&stHist, 100.0), 100000u) << "p100 must be clamped to the recorded max.";
+}
+
+/**
+ * @brief 작은 값은 정확하게, 범위를 넘는 값은 마지막 버킷에 기록되는지 테스트
+ */
+TEST(TcpMetricsTest, HistogramSmallAndHugeValues) {
+    static TCP_HISTOGRAM stHist;
+    resetTcpHistogram(&stHist);
+
+    addTcpHistogramValue(&stHist, 7);
+    ASSERT_EQ(getTcpHistogramPercentile(&stHist, 50.0), 7u);
+
+    addTcpHistogramValue(&stHist, UINT64_MAX);
+    ASSERT_EQ(stHist.au64Bucket[TCP_HIST_BUCKETS - 1], 1u);
+    ASSERT_EQ(stHist.u64Max, UINT64_MAX);
+}
+
+/**
+ * @brief 스레드별 카운터 합산 테스트
+ *
+ * 여러 스레드가 각자 카운터와 히스토그램에 기록한 뒤 종료해도, 스냅샷에 모두 합산되는지 확인합니다.
+ */
+TEST(TcpMetricsTest, PerThreadShardsAreAggregated) {
+    static TCP_METRICS_SNAPSHOT stBefore, stAfter;
+    const int kiThreads = 4;
+    const int kiIterations = 10000;
+    TCP_CONN_METRICS astConn[kiThreads];
+
+    memset(astConn, 0x0, sizeof(astConn));
+    getTcpMetricsSnapshot(&stBefore);
+
+    std::vector<std::thread> vecThreads;
+    for (int t = 0; t < kiThreads; t++) {
+        vecThreads.emplace_back([&astConn, t, kiIterations]() {
+            for (int i = 0; i < kiIterations; i++) {
+                addTcpConnMetric(&astConn[t], TCP_METRIC_MSGS_IN, 1);
+                addTcpConnMetric(&astConn[t], TCP_METRIC_BYTES_IN, 10);
+                recordTcpHistogram(TCP_HIST_RECV_TO_SEND, 1000);
+            }
+        });
+    }
+    for (auto &thread : vecThreads) {
+        thread.join();
+    }
+
+    getTcpMetricsSnapshot(&stAfter);
+    ASSERT_EQ(stAfter.au64Counter[TCP_METRIC_MSGS_IN] - stBefore.au64Counter[TCP_METRIC_MSGS_IN], (uint64_t)kiThreads * kiIterations);
+    ASSERT_EQ(stAfter.au64Counter[TCP_METRIC_BYTES_IN] - stBefore.au64Counter[TCP_METRIC_BYTES_IN], (uint64_t)kiThreads * kiIterations * 10);
+    ASSERT_EQ(stAfter.astHist[TCP_HIST_RECV_TO_SEND].u64Count - stBefore.astHist[TCP_HIST_RECV_TO_SEND].u64Count, (uint64_t)kiThreads * kiIterations);
+    for (int t = 0; t < kiThreads; t++) {
+        ASSERT_EQ(getTcpConnMetric(&astConn[t], TCP_METRIC_MSGS_IN), (uint64_t)kiIterations);
+    }
+}
+
+/**
+ * @brief 카운터에서 계산되는 게이지(활성 연결 수, 큐 깊이) 테스트
+ */
+TEST(TcpMetricsTest, DerivedGauges) {
+    TCP_METRICS_SNAPSHOT *pstSnapshot = new TCP_METRICS_SNAPSHOT();
+
+    pstSnapshot->au64Counter[TCP_METRIC_ACCEPTS] = 10;
+    pstSnapshot->au64Counter[TCP_METRIC_DISCONNECTS] = 4;
+    pstSnapshot->au64Counter[TCP_METRIC_ENQUEUED] = 100;
+    pstSnapshot->au64Counter[TCP_METRIC_DEQUEUED] = 90;
+    pstSnapshot->au64Counter[TCP_METRIC_DROPS] = 3;
+
+    ASSERT_EQ(getTcpActiveConnections(pstSnapshot), 6u);
+    ASSERT_EQ(getTcpQueueDepth(pstSnapshot), 7u);
+
+    pstSnapshot->au64Counter[TCP_METRIC_DISCONNECTS] = 11;
+    ASSERT_EQ(getTcpActiveConnections(pstSnapshot), 0u);
+    delete pstSnapshot;
+}
+
+/**
+ * @brief 다른 스레드의 연결 소켓 사용과 등록 해제 직렬화 테스트
+ *
+ * 소켓을 잠근 동안에는 등록 해제가 끝나지 않고, 해제된 뒤에는 먼저 읽어 둔 포인터로도
+ * 소켓을 얻을 수 없는지 확인합니다. (해제 후 닫힌 소켓 번호가 재사용되어도 건드리지 않음)
+ */
+TEST(TcpMetricsTest, ConnSockLockHoldsOffUnregister) {
+    TCP_CONN_METRICS stConn;
+    uint64_t u64ConnId = registerTcpConnMetrics(&stConn, 7, "10.0.0.2:5678");
+
+    ASSERT_EQ(lockTcpConnSock(&stConn, u64ConnId + 1), -1) << "Other connection ID must not lock.";
+    ASSERT_EQ(lockTcpConnSock(&stConn, u64ConnId), 7);
+
+    std::atomic<bool> bUnregistered(false);
+    std::thread unregisterThread([&stConn, &bUnregistered]() {
+        unregisterTcpConnMetrics(&stConn);
+        bUnregistered = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_FALSE(bUnregistered.load()) << "Unregister must wait while the socket is in use.";
+    unlockTcpConnSock();
+    unregisterThread.join();
+
+    ASSERT_EQ(lockTcpConnSock(&stConn, u64ConnId), -1);
+    ASSERT_EQ(lockTcpConnSock(&stConn, 0), -1) << "Unregistered connection must not lock by slot.";
+}
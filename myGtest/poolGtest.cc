@@ -0,0 +1,211 @@
+#include <gtest/gtest.h>
+#include "tcpPool.h"
+#include "tcpSock.h"
+#include "tcpFrame.h"
+#include <sys/socket.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <chrono>
+
+/**
+ * @brief 시험용 에코 서버
+ *
+ * 임시 포트에서 연결을 받고, 연결마다 프레임을 iBatch개씩 모아 거꾸로 된 순서로 돌려보냅니다.
+ * iBatch가 1이면 받은 순서대로 바로 돌려보냅니다. iBatch가 0이면 읽기만 하고 응답하지 않습니다.
+ */
+class PoolEchoServer {
+public:
+    explicit PoolEchoServer(int iBatch) : m_iBatch(iBatch) {
+        m_iServerSock = createTcpServerSocket(0, SOMAXCONN);
+        m_iPort = getTcpSocketPort(m_iServerSock);
+        m_acceptThread = std::thread([this]() { acceptLoop(); });
+    }
+
+    ~PoolEchoServer() {
+        stop();
+    }
+
+    /**
+     * @brief 모든 연결을 끊고 스레드를 정리합니다.
+     */
+    void stop() {
+        if (m_iServerSock < 0) {
+            return;
+        }
+        shutdown(m_iServerSock, SHUT_RDWR);
+        m_acceptThread.join();
+        for (int iSock : m_aiConns) {
+            shutdown(iSock, SHUT_RDWR);
+        }
+        for (auto &thread : m_connThreads) {
+            thread.join();
+        }
+        for (int iSock : m_aiConns) {
+            close(iSock);
+        }
+        close(m_iServerSock);
+        m_iServerSock = -1;
+    }
+
+    int port() const { return m_iPort; }
+
+private:
+    void acceptLoop() {
+        int iSock;
+        while ((iSock = accept(m_iServerSock, NULL, NULL)) >= 0) {
+            m_aiConns.push_back(iSock);
+            m_connThreads.emplace_back([this, iSock]() { echoLoop(iSock); });
+        }
+    }
+
+    void echoLoop(int iSock) {
+        std::vector<uint8_t> stream;
+        std::vector<std::vector<uint8_t>> batch;
+        uint8_t au8Buf[4096];
+        ssize_t iReadSize;
+
+        while ((iReadSize = read(iSock, au8Buf, sizeof(au8Buf))) > 0) {
+            stream.insert(stream.end(), au8Buf, au8Buf + iReadSize);
+            int iFrameLen;
+            while ((iFrameLen = decodeTcpFrame(stream.data(), stream.size(), NULL, NULL)) > 0) {
+                batch.emplace_back(stream.begin(), stream.begin() + iFrameLen);
+                stream.erase(stream.begin(), stream.begin() + iFrameLen);
+                if (m_iBatch > 0 && (int)batch.size() == m_iBatch) {
+                    for (auto it = batch.rbegin(); it != batch.rend(); ++it) {
+                        send(iSock, it->data(), it->size(), MSG_NOSIGNAL);
+                    }
+                    batch.clear();
+                }
+            }
+        }
+    }
+
+    int m_iBatch;
+    int m_iServerSock;
+    int m_iPort;
+    std::thread m_acceptThread;
+    std::vector<int> m_aiConns;
+    std::vector<std::thread> m_connThreads;
+};
+
+/**
+ * @brief 비동기 요청의 결과
+ */
+struct PoolResult {
+    std::atomic<int> iDone{0};
+    int iStatus = 1;
+    uint32_t u32Value = 0;
+};
+
+static void onPoolResult(void *pvUser, int iStatus, const uint8_t *kpu8Data, size_t uiLen) {
+    PoolResult *pstResult = (PoolResult *)pvUser;
+
+    pstResult->iStatus = iStatus;
+    if (iStatus == 0 && uiLen == sizeof(uint32_t)) {
+        memcpy(&pstResult->u32Value, kpu8Data, sizeof(uint32_t));
+    }
+    pstResult->iDone.fetch_add(1);
+}
+
+static bool waitPoolResults(const std::vector<PoolResult> &results) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    for (const auto &result : results) {
+        while (result.iDone.load() == 0) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 순서가 바뀐 응답 짝짓기 테스트
+ *
+ * 한 연결에서 서버가 응답을 4개씩 거꾸로 보내도 각 요청의 콜백이 자기 응답으로 정확히 한 번 호출되는지 확인합니다.
+ */
+TEST(TcpPoolTest, OutOfOrderResponsesMatchRequests) {
+    PoolEchoServer server(4);
+    TCP_POOL *pstPool = createTcpPool("127.0.0.1", server.port(), 1, 0x01, 1000);
+    ASSERT_NE(pstPool, nullptr);
+    ASSERT_EQ(getTcpPoolLiveConns(pstPool), 1);
+
+    std::vector<PoolResult> results(400);
+    for (uint32_t i = 0; i < results.size(); i++) {
+        ASSERT_EQ(submitTcpPoolRequest(pstPool, TCP_INST_DATA, &i, sizeof(i), onPoolResult, &results[i]), 0);
+    }
+    ASSERT_TRUE(waitPoolResults(results));
+    for (uint32_t i = 0; i < results.size(); i++) {
+        ASSERT_EQ(results[i].iDone.load(), 1);
+        ASSERT_EQ(results[i].iStatus, 0);
+        ASSERT_EQ(results[i].u32Value, i);
+    }
+    ASSERT_EQ(getTcpPoolInflight(pstPool), 0);
+    destroyTcpPool(pstPool);
+}
+
+/**
+ * @brief 여러 스레드의 동기 요청 테스트
+ */
+TEST(TcpPoolTest, ConcurrentSyncCalls) {
+    PoolEchoServer server(1);
+    TCP_POOL *pstPool = createTcpPool("127.0.0.1", server.port(), 2, 0x01, 1000);
+    ASSERT_NE(pstPool, nullptr);
+
+    std::atomic<int> iMismatch{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+        threads.emplace_back([&, t]() {
+            for (uint32_t i = 0; i < 200; i++) {
+                uint32_t u32Request = (uint32_t)t * 1000 + i, u32Response = 0;
+                int iLen = callTcpPool(pstPool, TCP_INST_DATA, &u32Request, sizeof(u32Request),
+                                       &u32Response, sizeof(u32Response), 2000);
+                if (iLen != (int)sizeof(u32Response) || u32Response != u32Request) {
+                    iMismatch++;
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(iMismatch.load(), 0);
+    destroyTcpPool(pstPool);
+}
+
+/**
+ * @brief 제한 시간과 연결 끊김 테스트
+ *
+ * 응답하지 않는 서버에 대한 동기 요청은 ETIMEDOUT으로 끝나고,
+ * 서버가 연결을 끊으면 대기 중인 비동기 요청이 -ECONNRESET으로 실패하는지 확인합니다.
+ */
+TEST(TcpPoolTest, TimeoutAndDisconnectFailPending) {
+    PoolEchoServer server(0);
+    TCP_POOL *pstPool = createTcpPool("127.0.0.1", server.port(), 1, 0x01, 1000);
+    ASSERT_NE(pstPool, nullptr);
+
+    uint32_t u32Request = 7, u32Response = 0;
+    ASSERT_EQ(callTcpPool(pstPool, TCP_INST_DATA, &u32Request, sizeof(u32Request),
+                          &u32Response, sizeof(u32Response), 100), -1);
+    ASSERT_EQ(errno, ETIMEDOUT);
+    ASSERT_EQ(getTcpPoolInflight(pstPool), 0);
+
+    std::vector<PoolResult> results(10);
+    for (auto &result : results) {
+        ASSERT_EQ(submitTcpPoolRequest(pstPool, TCP_INST_DATA, &u32Request, sizeof(u32Request), onPoolResult, &result), 0);
+    }
+    server.stop();
+    ASSERT_TRUE(waitPoolResults(results));
+    for (auto &result : results) {
+        ASSERT_EQ(result.iStatus, -ECONNRESET);
+    }
+    ASSERT_EQ(getTcpPoolLiveConns(pstPool), 0);
+    ASSERT_EQ(submitTcpPoolRequest(pstPool, TCP_INST_DATA, &u32Request, sizeof(u32Request), onPoolResult, &results[0]), -1);
+    ASSERT_EQ(errno, ENOTCONN);
+    destroyTcpPool(pstPool);
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include "tcpRate.h"
+#include "tcpMetrics.h"
+
+#define MS(n) ((uint64_t)(n) * 1000000ULL)
+
+/**
+ * @brief 토큰 버킷 테스트
+ *
+ * 폭주 크기(100ms 분량)까지는 바로 통과하고, 넘은 만큼은 빚이 되어 갚는 시간을 대기 시간으로 돌려주며,
+ * 시간이 지나면 다시 채워지는지 확인합니다.
+ */
+TEST(TcpRateTest, TokenBucketWaitsForDebt) {
+    TCP_RATE_LIMIT stLimit = {1000, 0};
+    TCP_TOKEN_BUCKET stBucket;
+
+    initTcpTokenBucket(&stBucket, &stLimit, MS(1000));
+    ASSERT_EQ(takeTcpTokenBucket(&stBucket, 100, 1, MS(1000)), 0u);
+    ASSERT_NEAR((double)takeTcpTokenBucket(&stBucket, 50, 1, MS(1000)), (double)MS(50), 1000.0);
+    ASSERT_EQ(takeTcpTokenBucket(&stBucket, 0, 0, MS(1050)), 0u) << "The debt is repaid after 50ms.";
+    ASSERT_EQ(takeTcpTokenBucket(&stBucket, 100, 0, MS(5000)), 0u) << "Tokens never exceed the burst size.";
+    ASSERT_GT(takeTcpTokenBucket(&stBucket, 1, 0, MS(5000)), 0u);
+
+    /**< 메시지 제한은 바이트 제한과 따로 세고, 더 긴 대기 시간을 돌려줍니다. */
+    stLimit.u64MsgsPerSec = 10;
+    initTcpTokenBucket(&stBucket, &stLimit, 0);
+    ASSERT_EQ(takeTcpTokenBucket(&stBucket, 10, 1, 0), 0u);
+    ASSERT_NEAR((double)takeTcpTokenBucket(&stBucket, 10, 2, 0), (double)MS(200), 1000.0);
+}
+
+/**
+ * @brief 제한 변경 테스트
+ *
+ * 제한을 낮춰도 남은 빚은 유지되고, 제한을 없애면 빚도 사라지는지 확인합니다.
+ */
+TEST(TcpRateTest, LimitChangeKeepsDebtUntilRemoved) {
+    TCP_RATE_LIMIT stLimit = {1000, 0};
+    TCP_RATE_LIMIT stNone = {0, 0};
+    TCP_TOKEN_BUCKET stBucket;
+
+    initTcpTokenBucket(&stBucket, &stLimit, 0);
+    ASSERT_NEAR((double)takeTcpTokenBucket(&stBucket, 200, 0, 0), (double)MS(100), 1000.0);
+    stLimit.u64BytesPerSec = 500;
+    setTcpTokenBucketLimit(&stBucket, &stLimit, 0);
+    ASSERT_NEAR((double)takeTcpTokenBucket(&stBucket, 0, 0, 0), (double)MS(200), 1000.0);
+
+    setTcpTokenBucketLimit(&stBucket, &stNone, 0);
+    ASSERT_EQ(takeTcpTokenBucket(&stBucket, 1000000, 1000, 0), 0u);
+}
+
+/**
+ * @brief 연결별 기본 제한 테스트
+ *
+ * 이미 초기화된 연결도 다음 사용량을 셀 때 바뀐 기본 제한을 따르는지 확인합니다.
+ */
+TEST(TcpRateTest, ConnRateFollowsRuntimeChange) {
+    TCP_RATE_LIMIT stLimit = {0, 100};
+    TCP_RATE_LIMIT stNone = {0, 0};
+    TCP_CONN_RATE stRate;
+
+    setTcpConnRateLimit(&stNone);
+    initTcpConnRate(&stRate, 0);
+    ASSERT_EQ(takeTcpConnRate(&stRate, 1000000, 1000, 0), 0u);
+
+    setTcpConnRateLimit(&stLimit);
+    ASSERT_EQ(takeTcpConnRate(&stRate, 0, 10, 0), 0u);
+    ASSERT_NEAR((double)takeTcpConnRate(&stRate, 0, 10, 0), (double)MS(100), 1000.0);
+
+    TCP_RATE_LIMIT stRead;
+    getTcpConnRateLimit(&stRead);
+    ASSERT_EQ(stRead.u64MsgsPerSec, 100u);
+
+    setTcpConnRateLimit(&stNone);
+    ASSERT_EQ(takeTcpConnRate(&stRate, 0, 1000, 0), 0u);
+}
+
+/**
+ * @brief Client ID별 제한 테스트
+ *
+ * 같은 Client ID는 한 버킷을 함께 쓰고, 다른 Client ID와 해제된 Client ID에는 영향이 없는지 확인합니다.
+ */
+TEST(TcpRateTest, ClientIdBucketIsShared) {
+    TCP_RATE_LIMIT stLimit = {0, 10};
+    TCP_RATE_LIMIT stRead;
+
+    ASSERT_FALSE(getTcpClientIdRateLimit(7, &stRead));
+    setTcpClientIdRateLimit(7, &stLimit);
+    ASSERT_TRUE(getTcpClientIdRateLimit(7, &stRead));
+    ASSERT_EQ(stRead.u64MsgsPerSec, 10u);
+
+    uint64_t u64NowNs = getTcpMonotonicNs();
+    ASSERT_EQ(takeTcpClientIdRate(7, 0, 1, u64NowNs), 0u) << "First connection uses the burst.";
+    ASSERT_GT(takeTcpClientIdRate(7, 0, 1, u64NowNs), 0u) << "Second connection shares the same bucket.";
+    ASSERT_EQ(takeTcpClientIdRate(8, 0, 1000, u64NowNs), 0u);
+
+    TCP_RATE_LIMIT stNone = {0, 0};
+    setTcpClientIdRateLimit(7, &stNone);
+    ASSERT_FALSE(getTcpClientIdRateLimit(7, &stRead));
+    ASSERT_EQ(takeTcpClientIdRate(7, 0, 1000, u64NowNs), 0u);
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include "tcpRing.h"
+#include <string.h>
+#include <thread>
+
+/**
+ * @brief 레코드 넣기/꺼내기와 버퍼 끝을 넘어가는 레코드 테스트
+ */
+TEST(TcpRingTest, PushPopWrapAround) {
+    TCP_RING *pstRing = createTcpRing(64);
+    uint8_t au8Out[64];
+    ASSERT_NE(pstRing, nullptr);
+    ASSERT_EQ(pstRing->u32Capacity, 64u);
+
+    for (int i = 0; i < 100; i++) {
+        uint8_t au8Record[20];
+        memset(au8Record, i, sizeof(au8Record));
+        ASSERT_TRUE(pushTcpRing(pstRing, au8Record, sizeof(au8Record)));
+        ASSERT_EQ(popTcpRing(pstRing, au8Out, sizeof(au8Out)), (int)sizeof(au8Record));
+        ASSERT_EQ(memcmp(au8Out, au8Record, sizeof(au8Record)), 0) << "record " << i;
+    }
+    ASSERT_TRUE(isTcpRingEmpty(pstRing));
+    ASSERT_EQ(popTcpRing(pstRing, au8Out, sizeof(au8Out)), 0);
+
+    destroyTcpRing(pstRing);
+}
+
+/**
+ * @brief 가득 찬 링과 작은 출력 버퍼 처리 테스트
+ *
+ * 공간이 없으면 넣기가 실패하고, 출력 버퍼가 작으면 레코드를 남겨 둔 채 -1을 반환하는지,
+ * 남은 레코드를 꺼내지 않고 버릴 수 있는지 확인합니다.
+ */
+TEST(TcpRingTest, FullAndShortBuffer) {
+    TCP_RING *pstRing = createTcpRing(64);
+    uint8_t au8Record[28] = {0};
+    uint8_t au8Out[64];
+
+    ASSERT_TRUE(pushTcpRing(pstRing, au8Record, sizeof(au8Record)));
+    ASSERT_TRUE(pushTcpRing(pstRing, au8Record, sizeof(au8Record)));
+    ASSERT_FALSE(pushTcpRing(pstRing, au8Record, 1)) << "Ring must be full.";
+    ASSERT_EQ(getTcpRingUsed(pstRing), 64u);
+
+    ASSERT_EQ(popTcpRing(pstRing, au8Out, 10), -1);
+    ASSERT_EQ(popTcpRing(pstRing, au8Out, sizeof(au8Out)), (int)sizeof(au8Record));
+
+    /**< 꺼내지 않고 버리기 */
+    ASSERT_EQ(skipTcpRing(pstRing), (int)sizeof(au8Record));
+    ASSERT_TRUE(isTcpRingEmpty(pstRing));
+    ASSERT_EQ(skipTcpRing(pstRing), 0);
+
+    destroyTcpRing(pstRing);
+}
+
+/**
+ * @brief 생산자/소비자 스레드 테스트
+ *
+ * 서로 다른 스레드에서 넣고 꺼내도 레코드가 순서대로, 손실 없이 전달되는지 확인합니다.
+ */
+TEST(TcpRingTest, ProducerConsumerThreads) {
+    TCP_RING *pstRing = createTcpRing(1024);
+    const uint32_t ku32Count = 100000;
+
+    std::thread producer([&]() {
+        for (uint32_t u32Seq = 0; u32Seq < ku32Count; u32Seq++) {
+            struct iovec astIov[2];
+            uint32_t u32Len = u32Seq % 50;
+            uint8_t au8Body[50];
+            memset(au8Body, (int)(u32Seq & 0xFF), sizeof(au8Body));
+            astIov[0].iov_base = &u32Seq;
+            astIov[0].iov_len = sizeof(u32Seq);
+            astIov[1].iov_base = au8Body;
+            astIov[1].iov_len = u32Len;
+            while (!pushTcpRingParts(pstRing, astIov, 2)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint8_t au8Out[64];
+    for (uint32_t u32Expected = 0; u32Expected < ku32Count;) {
+        int iLen = popTcpRing(pstRing, au8Out, sizeof(au8Out));
+        if (iLen == 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        uint32_t u32Seq;
+        memcpy(&u32Seq, au8Out, sizeof(u32Seq));
+        ASSERT_EQ(u32Seq, u32Expected);
+        ASSERT_EQ(iLen, (int)(sizeof(uint32_t) + u32Expected % 50));
+        if (iLen > 4) {
+            ASSERT_EQ(au8Out[iLen - 1], (uint8_t)(u32Expected & 0xFF));
+        }
+        u32Expected++;
+    }
+
+    producer.join();
+    destroyTcpRing(pstRing);
+}
@@ -0,0 +1,289 @@
+#include <gtest/gtest.h>
+#include "tcpShm.h"
+#include "tcpSock.h"
+#include "tcpFrame.h"
+#include "tcpRing.h"
+#include <sys/socket.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+#include <chrono>
+
+/**
+ * @brief 양방향 왕복과 링 끝을 넘어가는 레코드 테스트
+ *
+ * 서버 쪽 핸들이 받은 레코드를 그대로 돌려보낼 때, 크기가 다른 레코드가 순서대로 손상 없이 돌아오는지 확인합니다.
+ */
+TEST(TcpShmTest, EchoRoundTripInOrder) {
+    TCP_SHM *pstClient = createTcpShm(4096);
+    ASSERT_NE(pstClient, nullptr);
+    TCP_SHM *pstServer = attachTcpShm(dup(getTcpShmFd(pstClient)));
+    ASSERT_NE(pstServer, nullptr);
+
+    std::thread echo([pstServer]() {
+        uint8_t au8Buf[1024];
+        int iLen;
+        while ((iLen = recvTcpShm(pstServer, au8Buf, sizeof(au8Buf), -1)) > 0) {
+            if (sendTcpShm(pstServer, au8Buf, (uint32_t)iLen, -1) < 0) {
+                break;
+            }
+        }
+    });
+
+    for (uint32_t i = 0; i < 20000; i++) {
+        uint8_t au8Out[1024], au8In[1024];
+        uint32_t u32Len = 1 + (i * 37) % 700;
+        memset(au8Out, (int)(i & 0xFF), u32Len);
+        memcpy(au8Out, &i, u32Len < sizeof(i) ? u32Len : sizeof(i));
+        ASSERT_EQ(sendTcpShm(pstClient, au8Out, u32Len, 1000), 0);
+        ASSERT_EQ(recvTcpShm(pstClient, au8In, sizeof(au8In), 1000), (int)u32Len) << "record " << i;
+        ASSERT_EQ(memcmp(au8In, au8Out, u32Len), 0) << "record " << i;
+    }
+
+    closeTcpShm(pstClient);
+    echo.join();
+    destroyTcpShm(pstServer);
+    destroyTcpShm(pstClient);
+}
+
+/**
+ * @brief 가득 찬 링과 깨우기 테스트
+ *
+ * 소비자가 없으면 기다리지 않는 송신은 EAGAIN으로 실패하고, 잠들어 기다리는 송신은
+ * 소비자가 나중에 비워 주면 깨어나 모두 전달되는지 확인합니다.
+ */
+TEST(TcpShmTest, FullRingBlocksUntilConsumerDrains) {
+    TCP_SHM *pstClient = createTcpShm(256);
+    ASSERT_NE(pstClient, nullptr);
+    TCP_SHM *pstServer = attachTcpShm(dup(getTcpShmFd(pstClient)));
+    ASSERT_NE(pstServer, nullptr);
+
+    uint8_t au8Record[60] = {0};
+    int iQueued = 0;
+    while (sendTcpShm(pstClient, au8Record, sizeof(au8Record), 0) == 0) {
+        iQueued++;
+    }
+    ASSERT_EQ(errno, EAGAIN);
+    ASSERT_GT(iQueued, 0);
+    ASSERT_EQ(sendTcpShm(pstClient, au8Record, 300, 0), -1);
+    ASSERT_EQ(errno, EMSGSIZE);
+
+    const int kiTotal = 1000;
+    std::thread consumer([pstServer, iQueued, kiTotal]() {
+        uint8_t au8Buf[64];
+        std::this_thread::sleep_for(std::chrono::milliseconds(50)); /**< 생산자가 잠들 때까지 기다립니다. */
+        for (int i = 0; i < iQueued + kiTotal; i++) {
+            if (recvTcpShm(pstServer, au8Buf, sizeof(au8Buf), 1000) != 60) {
+                break;
+            }
+        }
+    });
+    for (int i = 0; i < kiTotal; i++) {
+        ASSERT_EQ(sendTcpShm(pstClient, au8Record, sizeof(au8Record), 1000), 0) << "record " << i;
+    }
+    consumer.join();
+
+    uint8_t au8Buf[64];
+    ASSERT_EQ(recvTcpShm(pstServer, au8Buf, sizeof(au8Buf), 0), 0);
+    destroyTcpShm(pstServer);
+    destroyTcpShm(pstClient);
+}
+
+/**
+ * @brief 제한 시간과 닫힘 테스트
+ *
+ * 빈 링의 수신은 제한 시간 뒤 0을 반환하고, 상대가 닫으면 잠든 수신이 깨어나 남은 레코드를 읽은 뒤 EPIPE로 끝나는지 확인합니다.
+ */
+TEST(TcpShmTest, TimeoutAndCloseWakeReceiver) {
+    TCP_SHM *pstClient = createTcpShm(4096);
+    ASSERT_NE(pstClient, nullptr);
+    TCP_SHM *pstServer = attachTcpShm(dup(getTcpShmFd(pstClient)));
+    ASSERT_NE(pstServer, nullptr);
+    uint8_t au8Buf[16];
+
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(recvTcpShm(pstServer, au8Buf, sizeof(au8Buf), 50), 0);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    ASSERT_GE(elapsed, std::chrono::milliseconds(45));
+    ASSERT_LT(elapsed, std::chrono::milliseconds(1000));
+
+    int iResult = 0, iError = 0;
+    std::thread receiver([&]() {
+        iResult = recvTcpShm(pstServer, au8Buf, sizeof(au8Buf), -1);
+        ASSERT_EQ(iResult, 4);
+        iResult = recvTcpShm(pstServer, au8Buf, sizeof(au8Buf), -1);
+        iError = errno;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_EQ(sendTcpShm(pstClient, "last", 4, 0), 0);
+    ASSERT_FALSE(isTcpShmClosed(pstServer));
+    closeTcpShm(pstClient);
+    ASSERT_TRUE(isTcpShmClosed(pstServer));
+    receiver.join();
+    ASSERT_EQ(iResult, -1);
+    ASSERT_EQ(iError, EPIPE);
+    ASSERT_EQ(sendTcpShm(pstServer, "x", 1, 0), -1);
+    ASSERT_EQ(errno, EPIPE);
+
+    destroyTcpShm(pstServer);
+    destroyTcpShm(pstClient);
+}
+
+/**
+ * @brief 영역 검사 테스트
+ *
+ * 형식이 맞지 않는 memfd에는 붙지 않는지 확인합니다.
+ */
+TEST(TcpShmTest, AttachRejectsForeignRegion) {
+    int iFd = memfd_create("notTcpShm", MFD_CLOEXEC);
+    ASSERT_GE(iFd, 0);
+    ASSERT_EQ(ftruncate(iFd, 65536), 0);
+    ASSERT_EQ(attachTcpShm(iFd), nullptr);
+    ASSERT_EQ(errno, EPROTO);
+    close(iFd);
+}
+
+/**
+ * @brief 전송 제안 테스트
+ *
+ * Unix 도메인 연결에서는 memfd가 SCM_RIGHTS로 넘어가 서버 쪽이 붙을 수 있고,
+ * TCP 연결에서는 fd를 넘길 수 없으므로 EOPNOTSUPP로 실패하는지 확인합니다.
+ */
+TEST(TcpShmTest, OfferPassesFdOverUnixSocket) {
+    int aiPair[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, aiPair), 0);
+
+    TCP_SHM *pstServer = NULL;
+    std::thread server([&]() {
+        union {
+            struct cmsghdr stAlign;
+            char achBuf[CMSG_SPACE(sizeof(int))];
+        } uCtrl;
+        uint8_t au8Buf[64];
+        struct iovec stIov = {au8Buf, sizeof(au8Buf)};
+        struct msghdr stMsg;
+        memset(&stMsg, 0, sizeof(stMsg));
+        stMsg.msg_iov = &stIov;
+        stMsg.msg_iovlen = 1;
+        stMsg.msg_control = uCtrl.achBuf;
+        stMsg.msg_controllen = sizeof(uCtrl.achBuf);
+
+        ssize_t iLen = recvmsg(aiPair[1], &stMsg, 0);
+        TCP_FRAME_HEADER stHeader;
+        ASSERT_EQ(decodeTcpFrame(au8Buf, (size_t)iLen, &stHeader, NULL), (int)iLen);
+        ASSERT_EQ(stHeader.u8Instruction, TCP_INST_SHM_OFFER);
+        struct cmsghdr *pstCmsg = CMSG_FIRSTHDR(&stMsg);
+        ASSERT_NE(pstCmsg, nullptr);
+        ASSERT_EQ(pstCmsg->cmsg_type, SCM_RIGHTS);
+        int iFd;
+        memcpy(&iFd, CMSG_DATA(pstCmsg), sizeof(iFd));
+        pstServer = attachTcpShm(iFd);
+
+        uint8_t u8Status = (pstServer != NULL) ? 0 : EPROTO;
+        int iFrameLen = encodeTcpFrame(au8Buf, sizeof(au8Buf), stHeader.u8ClientId, TCP_INST_SHM_OFFER, &u8Status, 1);
+        ASSERT_EQ(write(aiPair[1], au8Buf, (size_t)iFrameLen), iFrameLen);
+    });
+
+    TCP_SHM *pstClient = offerTcpShm(aiPair[0], 0x01, 8192, 1000);
+    server.join();
+    ASSERT_NE(pstClient, nullptr);
+    ASSERT_NE(pstServer, nullptr);
+
+    uint8_t au8Buf[8];
+    ASSERT_EQ(sendTcpShm(pstClient, "ping", 4, 0), 0);
+    ASSERT_EQ(recvTcpShm(pstServer, au8Buf, sizeof(au8Buf), 1000), 4);
+    ASSERT_EQ(memcmp(au8Buf, "ping", 4), 0);
+
+    destroyTcpShm(pstServer);
+    destroyTcpShm(pstClient);
+    close(aiPair[0]);
+    close(aiPair[1]);
+
+    int iServerSock = createTcpServerSocketOn("127.0.0.1", 0, 1);
+    int iSock = createTcpClientSocket("127.0.0.1", getTcpSocketPort(iServerSock));
+    ASSERT_GE(iSock, 0);
+    ASSERT_EQ(offerTcpShm(iSock, 0x01, 8192, 100), nullptr);
+    ASSERT_EQ(errno, EOPNOTSUPP);
+    close(iSock);
+    close(iServerSock);
+}
+
+/**
+ * @brief 연결 뒤 상대가 영역을 망가뜨리는 경우 테스트
+ *
+ * 링 머리의 용량을 바꿔도 붙을 때 읽은 크기로 계속 동작하고, 레코드 길이나 상대 위치가 쓰인 바이트를 넘으면
+ * 매핑 밖을 읽지 않고 EPROTO로 실패하는지 확인합니다. 크기 봉인이 없는 memfd에는 붙지 않고,
+ * 봉인된 memfd는 크기를 바꿀 수 없습니다.
+ */
+TEST(TcpShmTest, PeerCorruptionIsRejected) {
+    TCP_SHM *pstClient = createTcpShm(4096);
+    ASSERT_NE(pstClient, nullptr);
+    TCP_SHM *pstServer = attachTcpShm(dup(getTcpShmFd(pstClient)));
+    ASSERT_NE(pstServer, nullptr);
+    struct stat stStat;
+    ASSERT_EQ(fstat(getTcpShmFd(pstClient), &stStat), 0);
+    ASSERT_EQ(ftruncate(getTcpShmFd(pstClient), stStat.st_size * 2), -1);
+    ASSERT_EQ(ftruncate(getTcpShmFd(pstClient), 4096), -1);
+
+    uint8_t *pu8Map = (uint8_t *)mmap(NULL, (size_t)stStat.st_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                                      getTcpShmFd(pstClient), 0);
+    ASSERT_NE(pu8Map, MAP_FAILED);
+    size_t uiRingOffset = 0; /**< 첫 링이 클라이언트→서버 방향입니다. */
+    for (size_t i = 0; i + 8 <= (size_t)stStat.st_size; i += 4) {
+        uint32_t au32Field[2];
+        memcpy(au32Field, pu8Map + i, sizeof(au32Field));
+        if (au32Field[0] == 4096 && au32Field[1] == 4095) {
+            uiRingOffset = i - offsetof(TCP_RING, u32Capacity);
+            break;
+        }
+    }
+    ASSERT_NE(uiRingOffset, 0u);
+    TCP_RING *pstRing = (TCP_RING *)(pu8Map + uiRingOffset);
+
+    /**< 링 머리의 용량을 키워도 붙을 때 읽은 크기를 씁니다. */
+    std::vector<uint8_t> vBuf(65536);
+    pstRing->u32Capacity = 1u << 30;
+    pstRing->u32Mask = (1u << 30) - 1;
+    ASSERT_EQ(sendTcpShm(pstClient, "ping", 4, 0), 0);
+    ASSERT_EQ(recvTcpShm(pstServer, vBuf.data(), (uint32_t)vBuf.size(), 0), 4);
+    ASSERT_EQ(memcmp(vBuf.data(), "ping", 4), 0);
+
+    /**< 버퍼에는 들어가지만 쓰인 바이트보다 긴 레코드 길이 */
+    uint32_t u32BadLen = 3000;
+    ASSERT_EQ(sendTcpShm(pstClient, "pong", 4, 0), 0);
+    memcpy(pstRing->au8Data + (pstRing->u64Head & 4095), &u32BadLen, sizeof(u32BadLen));
+    ASSERT_EQ(recvTcpShm(pstServer, vBuf.data(), (uint32_t)vBuf.size(), 0), -1);
+    ASSERT_EQ(errno, EPROTO);
+    ASSERT_EQ(sendTcpShm(pstClient, "x", 1, 0), -1);
+    ASSERT_EQ(errno, EPIPE);
+    munmap(pu8Map, (size_t)stStat.st_size);
+    destroyTcpShm(pstServer);
+    destroyTcpShm(pstClient);
+
+    /**< 용량보다 멀리 앞선 생산자 위치 */
+    pstClient = createTcpShm(4096);
+    ASSERT_NE(pstClient, nullptr);
+    pstServer = attachTcpShm(dup(getTcpShmFd(pstClient)));
+    ASSERT_NE(pstServer, nullptr);
+    pu8Map = (uint8_t *)mmap(NULL, (size_t)stStat.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, getTcpShmFd(pstClient), 0);
+    ASSERT_NE(pu8Map, MAP_FAILED);
+    pstRing = (TCP_RING *)(pu8Map + uiRingOffset);
+    __atomic_store_n(&pstRing->u64Tail, pstRing->u64Head + (1u << 20), __ATOMIC_RELEASE);
+    ASSERT_EQ(recvTcpShm(pstServer, vBuf.data(), (uint32_t)vBuf.size(), 0), -1);
+    ASSERT_EQ(errno, EPROTO);
+
+    /**< 같은 내용이라도 크기 봉인이 없는 memfd에는 붙지 않습니다. */
+    int iUnsealed = memfd_create("unsealed", MFD_CLOEXEC);
+    ASSERT_GE(iUnsealed, 0);
+    ASSERT_EQ(write(iUnsealed, pu8Map, (size_t)stStat.st_size), (ssize_t)stStat.st_size);
+    ASSERT_EQ(attachTcpShm(iUnsealed), nullptr);
+    ASSERT_EQ(errno, EPROTO);
+    close(iUnsealed);
+    munmap(pu8Map, (size_t)stStat.st_size);
+    destroyTcpShm(pstServer);
+    destroyTcpShm(pstClient);
+}
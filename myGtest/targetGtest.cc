@@ -6,7 +6,13 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
 #include <iostream>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <sys/resource.h>
 
 /**
  * @brief 포트가 사용 중인지 확인하는 함수
@@ -226,6 +232,397 @@ TEST_F(TcpSocketTest, ClientSendWithoutServerResponse) {
     close(_iClientSsock);
 }
 
+/**
+ * @brief 비차단 연결 테스트
+ *
+ * 호스트 이름으로 연결되고, 반환된 소켓이 차단 모드로 되돌려졌는지 확인합니다.
+ */
+TEST_F(TcpSocketTest, ConnectByHostName) {
+    int _iClientSock = connectTcpClientSocket("localhost", kiPort, 1000);
+    ASSERT_GE(_iClientSock, 0) << "Failed to connect by host name.";
+    ASSERT_EQ(fcntl(_iClientSock, F_GETFL) & O_NONBLOCK, 0) << "Socket is still non-blocking.";
+
+    iClientSock = accept(iServerSock, NULL, NULL);
+    ASSERT_GE(iClientSock, 0) << "Server failed to accept client connection.";
+    close(_iClientSock);
+}
+
+/**
+ * @brief 주소 목록 연결 테스트
+ *
+ * 서버를 127.0.0.1에만 바인드하므로 ::1 시도는 실패하고, 간격을 기다리지 않고 다음 주소로 연결되는지 확인합니다.
+ */
+TEST(TcpConnectTest, ConnectAddressListFallsBack) {
+    int iServerSock = createTcpServerSocketOn("127.0.0.1", 0, 1);
+    int iPort = getTcpSocketPort(iServerSock);
+
+    auto start = std::chrono::steady_clock::now();
+    int iClientSock = connectTcpClientSocket("::1,127.0.0.1", iPort, 1000);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    ASSERT_GE(iClientSock, 0) << "Failed to fall back to the next address.";
+    ASSERT_LT(elapsed, std::chrono::milliseconds(TCP_CONNECT_ATTEMPT_DELAY_MS)) << "Fallback waited for the attempt delay.";
+
+    int iAcceptedSock = accept(iServerSock, NULL, NULL);
+    ASSERT_GE(iAcceptedSock, 0) << "Server failed to accept client connection.";
+    close(iAcceptedSock);
+    close(iClientSock);
+    close(iServerSock);
+}
+
+/**
+ * @brief 이중 스택 대기 소켓 테스트
+ *
+ * 기본 대기 소켓이 IPv4와 IPv6 연결을 모두 받고, 두 연결 모두 대기 소켓의 Keep-Alive 설정을 물려받으며
+ * TCP_NODELAY 설정이 똑같이 동작하는지 확인합니다. 상대 주소 문자열은 IPv4 매핑 주소를 풀어 씁니다.
+ */
+TEST(TcpDualStackTest, AcceptsBothFamilies) {
+    int iServerSock = createTcpServerSocket(0, 4);
+    int iPort = getTcpSocketPort(iServerSock);
+    const char *akpchHosts[] = {"127.0.0.1", "::1"};
+    const char *akpchPeerPrefix[] = {"127.0.0.1:", "[::1]:"};
+
+    ASSERT_GT(iPort, 0);
+    for (int i = 0; i < 2; i++) {
+        int iClientSock = createTcpClientSocket(akpchHosts[i], iPort);
+        if (iClientSock < 0 && i == 1) {
+            close(iServerSock);
+            GTEST_SKIP() << "IPv6 loopback is not available.";
+        }
+        ASSERT_GE(iClientSock, 0) << "Failed to connect to " << akpchHosts[i];
+
+        struct sockaddr_storage stPeer;
+        socklen_t uiPeerLen = sizeof(stPeer);
+        int iAcceptedSock = accept(iServerSock, (struct sockaddr *)&stPeer, &uiPeerLen);
+        ASSERT_GE(iAcceptedSock, 0);
+
+        char achPeer[TCP_SOCK_ADDR_STRLEN];
+        formatTcpSockAddr((struct sockaddr *)&stPeer, achPeer, sizeof(achPeer));
+        ASSERT_EQ(strncmp(achPeer, akpchPeerPrefix[i], strlen(akpchPeerPrefix[i])), 0) << achPeer;
+
+        int iValue = 0;
+        socklen_t uiOptlen = sizeof(iValue);
+        ASSERT_EQ(getsockopt(iAcceptedSock, SOL_SOCKET, SO_KEEPALIVE, &iValue, &uiOptlen), 0);
+        ASSERT_EQ(iValue, 1);
+        ASSERT_EQ(getsockopt(iAcceptedSock, IPPROTO_TCP, TCP_KEEPIDLE, &iValue, &uiOptlen), 0);
+        ASSERT_EQ(iValue, 10);
+
+        int iNoDelay = 1;
+        ASSERT_EQ(setsockopt(iClientSock, IPPROTO_TCP, TCP_NODELAY, &iNoDelay, sizeof(iNoDelay)), 0);
+        ASSERT_EQ(getsockopt(iClientSock, IPPROTO_TCP, TCP_NODELAY, &iValue, &uiOptlen), 0);
+        ASSERT_EQ(iValue, 1);
+
+        close(iAcceptedSock);
+        close(iClientSock);
+    }
+    close(iServerSock);
+}
+
+/**
+ * @brief 바인드 주소 선택 테스트
+ *
+ * "[::1]" 에 바인드하면 IPv6 루프백으로만 연결되고 127.0.0.1로는 거부되는지 확인합니다.
+ */
+TEST(TcpDualStackTest, BindAddressRestrictsFamily) {
+    int iProbeSock = socket(AF_INET6, SOCK_STREAM, 0);
+    if (iProbeSock < 0) {
+        GTEST_SKIP() << "IPv6 is not available.";
+    }
+    close(iProbeSock);
+
+    int iServerSock = createTcpServerSocketOn("[::1]", 0, 1);
+    int iPort = getTcpSocketPort(iServerSock);
+
+    ASSERT_EQ(connectTcpClientSocket("127.0.0.1", iPort, 1000), -1);
+    ASSERT_EQ(errno, ECONNREFUSED);
+
+    int iClientSock = connectTcpClientSocket("[::1]", iPort, 1000);
+    ASSERT_GE(iClientSock, 0);
+    int iAcceptedSock = accept(iServerSock, NULL, NULL);
+    ASSERT_GE(iAcceptedSock, 0);
+    close(iAcceptedSock);
+    close(iClientSock);
+    close(iServerSock);
+}
+
+/**
+ * @brief Unix 도메인 소켓 전송 테스트
+ *
+ * 파일 경로와 추상 네임스페이스 모두에서 연결과 데이터 왕복이 되고,
+ * 받은 쪽 상대 주소가 대기 경로("unix:경로")로 표시되는지 확인합니다.
+ */
+TEST(TcpUnixSocketTest, ConnectAndEcho) {
+    char achPath[64];
+    snprintf(achPath, sizeof(achPath), "/tmp/tcpSockTest.%d.sock", (int)getpid());
+    const char *akpchPaths[] = {achPath, "@tcpSockTest"};
+    const char *akpchPeers[] = {achPath, "@tcpSockTest"};
+
+    for (int i = 0; i < 2; i++) {
+        int iServerSock = createTcpUnixServerSocket(akpchPaths[i], 1);
+        int iClientSock = createTcpUnixClientSocket(akpchPaths[i]);
+        ASSERT_GE(iClientSock, 0) << "Failed to connect to " << akpchPaths[i];
+        int iAcceptedSock = accept(iServerSock, NULL, NULL);
+        ASSERT_GE(iAcceptedSock, 0);
+
+        char achPeer[TCP_SOCK_ADDR_STRLEN];
+        formatTcpPeerName(iAcceptedSock, achPeer, sizeof(achPeer));
+        ASSERT_EQ(std::string(achPeer), std::string("unix:") + akpchPeers[i]);
+
+        char achBuf[6] = {0};
+        ASSERT_EQ(send(iClientSock, "hello", 5, 0), 5);
+        ASSERT_EQ(recv(iAcceptedSock, achBuf, 5, MSG_WAITALL), 5);
+        ASSERT_STREQ(achBuf, "hello");
+
+        close(iAcceptedSock);
+        close(iClientSock);
+        close(iServerSock);
+    }
+    unlink(achPath);
+
+    ASSERT_EQ(createTcpUnixClientSocket(achPath), -1);
+    ASSERT_EQ(errno, ENOENT);
+}
+
+/**
+ * @brief 대기 소켓 인계 테스트
+ *
+ * 넘긴 쪽이 대기 소켓을 닫은 뒤에도 넘겨받은 fd로 같은 포트의 연결을 받을 수 있고,
+ * 넘기기 전에 대기열에 들어온 연결도 잃지 않는지 확인합니다. 받은 fd에는 FD_CLOEXEC가 설정되어야 합니다.
+ */
+TEST(TcpSocketFdTest, ListenerSurvivesHandoff) {
+    int aiPair[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, aiPair), 0);
+    int iServerSock = createTcpServerSocketOn("127.0.0.1", 0, 4);
+    int iPort = getTcpSocketPort(iServerSock);
+    int iEarlySock = connectTcpClientSocket("127.0.0.1", iPort, 1000);
+    ASSERT_GE(iEarlySock, 0);
+
+    ASSERT_EQ(sendTcpSocketFds(aiPair[0], &iServerSock, 1), 0);
+    close(iServerSock);
+
+    int aiFds[2] = {-1, -1};
+    ASSERT_EQ(recvTcpSocketFds(aiPair[1], aiFds, 2, 1000), 1);
+    ASSERT_EQ(getTcpSocketPort(aiFds[0]), iPort);
+    ASSERT_NE(fcntl(aiFds[0], F_GETFD) & FD_CLOEXEC, 0);
+
+    int iLateSock = connectTcpClientSocket("127.0.0.1", iPort, 1000);
+    ASSERT_GE(iLateSock, 0) << "Connect refused after handoff.";
+    for (int i = 0; i < 2; i++) {
+        int iAcceptedSock = accept(aiFds[0], NULL, NULL);
+        ASSERT_GE(iAcceptedSock, 0);
+        close(iAcceptedSock);
+    }
+
+    /**< 아무것도 오지 않으면 제한 시간 뒤 실패합니다. */
+    ASSERT_EQ(recvTcpSocketFds(aiPair[1], aiFds, 2, 50), -1);
+    ASSERT_EQ(errno, ETIMEDOUT);
+    ASSERT_EQ(sendTcpSocketFds(aiPair[0], aiFds, 0), -1);
+
+    close(iEarlySock);
+    close(iLateSock);
+    close(aiFds[0]);
+    close(aiPair[0]);
+    close(aiPair[1]);
+}
+
+/**
+ * @brief 연결 실패 테스트
+ *
+ * 대기 중인 서버가 없으면 제한 시간을 기다리지 않고 -1을 반환하는지 확인합니다.
+ */
+TEST(TcpConnectTest, RefusedFailsFast) {
+    int iSock = createTcpServerSocket(0, 1);
+    int iPort = getTcpSocketPort(iSock);
+    close(iSock);
+
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(connectTcpClientSocket("127.0.0.1", iPort, 5000), -1);
+    ASSERT_EQ(errno, ECONNREFUSED);
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+}
+
+/**
+ * @brief 연결 제한 시간 테스트
+ *
+ * 응답하지 않는 주소로의 연결이 제한 시간 안에 -1로 끝나는지 확인합니다.
+ * 라우팅이 없는 환경에서는 ENETUNREACH로 바로 끝날 수 있습니다.
+ */
+TEST(TcpConnectTest, UnreachableHonorsDeadline) {
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(connectTcpClientSocket("10.255.255.1", 9, 300), -1);
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+}
+
+/**
+ * @brief 재연결 백오프 테스트
+ *
+ * 대기 시간이 지수적으로 커지는 상한을 넘지 않고, 상한에서 멈추며, 값이 흩어지는지 확인합니다.
+ */
+TEST(TcpBackoffTest, CappedExponentialWithJitter) {
+    unsigned int uiSeed = 1;
+
+    for (int iAttempt = 0; iAttempt < 20; iAttempt++) {
+        int iCap = std::min(100 << std::min(iAttempt, 10), 5000);
+        int iMin = iCap, iMax = 0;
+        for (int i = 0; i < 200; i++) {
+            int iDelay = getTcpBackoffDelayMs(iAttempt, 100, 5000, &uiSeed);
+            ASSERT_GE(iDelay, 0);
+            ASSERT_LE(iDelay, iCap);
+            iMin = std::min(iMin, iDelay);
+            iMax = std::max(iMax, iDelay);
+        }
+        ASSERT_LT(iMin, iCap / 4) << "Delays are not jittered at attempt " << iAttempt;
+        ASSERT_GT(iMax, iCap * 3 / 4) << "Delays do not reach the cap at attempt " << iAttempt;
+    }
+}
+
+/**
+ * @brief 소켓 생성 실패 테스트
+ *
+ * 잘못된 바인드 주소와 너무 긴 Unix 경로에서 프로세스를 끝내지 않고 -1과 errno를 반환하는지 확인합니다.
+ */
+TEST(TcpServerSocketTest, FailureReturnsError) {
+    std::string strLongPath(200, 'x');
+
+    ASSERT_EQ(createTcpServerSocketOn("bogus", 0, 1), -1);
+    ASSERT_EQ(errno, EINVAL);
+    ASSERT_EQ(createTcpUnixServerSocket(strLongPath.c_str(), 1), -1);
+    ASSERT_EQ(errno, ENAMETOOLONG);
+}
+
+/**
+ * @brief 서버 소켓 주소 재사용 옵션 테스트
+ *
+ * SO_REUSEADDR만 켜지고 SO_REUSEPORT는 꺼져 있어, 같은 포트에 두 번째 서버 소켓을 만들면 EADDRINUSE로 실패하는지 확인합니다.
+ */
+TEST(TcpServerSocketTest, SetsReuseAddrOnly) {
+    int iServerSock = createTcpServerSocketOn("127.0.0.1", 0, 1);
+    ASSERT_GE(iServerSock, 0);
+
+    int iValue = 0;
+    socklen_t uiLen = sizeof(iValue);
+    ASSERT_EQ(getsockopt(iServerSock, SOL_SOCKET, SO_REUSEADDR, &iValue, &uiLen), 0);
+    ASSERT_EQ(iValue, 1);
+    uiLen = sizeof(iValue);
+    ASSERT_EQ(getsockopt(iServerSock, SOL_SOCKET, SO_REUSEPORT, &iValue, &uiLen), 0);
+    ASSERT_EQ(iValue, 0);
+
+    ASSERT_EQ(createTcpServerSocketOn("127.0.0.1", getTcpSocketPort(iServerSock), 1), -1);
+    ASSERT_EQ(errno, EADDRINUSE);
+    close(iServerSock);
+}
+
+/**
+ * @brief fd 부족 시 accept 테스트
+ *
+ * fd 표가 가득 차면 acceptTcpClientSocket()이 EMFILE로 -1을 반환하면서 예비 fd로 대기열의 연결을 받아 닫아,
+ * 클라이언트는 바로 연결 끊김을 받고 예비 fd는 다시 열려 있는지 확인합니다.
+ */
+TEST(TcpServerSocketTest, AcceptSurvivesFdExhaustion) {
+    int iServerSock = createTcpServerSocketOn("127.0.0.1", 0, 4);
+    ASSERT_GE(iServerSock, 0);
+    struct sockaddr_in stAddr = {};
+    stAddr.sin_family = AF_INET;
+    stAddr.sin_port = htons((uint16_t)getTcpSocketPort(iServerSock));
+    stAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int iClientSock = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_EQ(connect(iClientSock, (struct sockaddr *)&stAddr, sizeof(stAddr)), 0);
+    int iReserveFd = openTcpReserveFd();
+    ASSERT_GE(iReserveFd, 0);
+
+    struct rlimit stOrigLimit, stLimit;
+    ASSERT_EQ(getrlimit(RLIMIT_NOFILE, &stOrigLimit), 0);
+    stLimit = stOrigLimit;
+    stLimit.rlim_cur = 256;
+    ASSERT_EQ(setrlimit(RLIMIT_NOFILE, &stLimit), 0);
+    std::vector<int> vFill;
+    int iFd;
+    while ((iFd = dup(0)) >= 0) {
+        vFill.push_back(iFd);
+    }
+    ASSERT_EQ(errno, EMFILE);
+
+    int iRet = acceptTcpClientSocket(iServerSock, &iReserveFd);
+    int iError = errno;
+    for (int iFill : vFill) {
+        close(iFill);
+    }
+    setrlimit(RLIMIT_NOFILE, &stOrigLimit);
+    ASSERT_EQ(iRet, -1);
+    ASSERT_EQ(iError, EMFILE);
+    ASSERT_GE(iReserveFd, 0) << "Reserve fd was not reopened.";
+
+    struct timeval stTimeout = {1, 0};
+    char chByte;
+    setsockopt(iClientSock, SOL_SOCKET, SO_RCVTIMEO, &stTimeout, sizeof(stTimeout));
+    ssize_t iRecvLen = recv(iClientSock, &chByte, 1, 0);
+    ASSERT_TRUE(iRecvLen == 0 || (iRecvLen < 0 && errno == ECONNRESET)) << "Queued connection was not closed.";
+
+    /**< fd가 풀리면 평소대로 받습니다. */
+    close(iClientSock);
+    iClientSock = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_EQ(connect(iClientSock, (struct sockaddr *)&stAddr, sizeof(stAddr)), 0);
+    iFd = acceptTcpClientSocket(iServerSock, &iReserveFd);
+    ASSERT_GE(iFd, 0);
+    close(iFd);
+    close(iClientSock);
+    close(iReserveFd);
+    close(iServerSock);
+}
+
+/**
+ * @brief 미전송 바이트 기준 테스트
+ *
+ * TCP_NOTSENT_LOWAT을 설정한 소켓은 상대가 읽지 않아 보내지 않은 바이트가 쌓이면 쓰기 가능이 아니게 되고,
+ * 상대가 읽어 기준 아래로 내려가면 다시 쓰기 가능해지는지 확인합니다. Unix 도메인 소켓은 설정이 실패합니다.
+ */
+TEST(TcpNotSentLowatTest, WritableFollowsUnsentBytes) {
+    int iServerSock = createTcpServerSocketOn("127.0.0.1", 0, 1);
+    ASSERT_GE(iServerSock, 0);
+    int iClientSock = connectTcpClientSocket("127.0.0.1", getTcpSocketPort(iServerSock), 1000);
+    ASSERT_GE(iClientSock, 0);
+    int iAcceptSock = accept(iServerSock, NULL, NULL);
+    ASSERT_GE(iAcceptSock, 0);
+    ASSERT_EQ(setTcpNotSentLowat(iAcceptSock, 4096), 0);
+    ASSERT_EQ(waitTcpSocketWritable(iAcceptSock, 0), 1);
+
+    /**< 상대가 읽지 않으면 수신 윈도가 닫혀 보내지 못한 바이트가 쌓입니다. (Nagle이 붙잡은 데이터와 구분하기 위해 끔) */
+    int iNoDelay = 1;
+    setsockopt(iAcceptSock, IPPROTO_TCP, TCP_NODELAY, &iNoDelay, sizeof(iNoDelay));
+    std::vector<char> vData(4096, 'x');
+    size_t uiSent = 0;
+    while (waitTcpSocketWritable(iAcceptSock, 100) == 1) {
+        ssize_t iSent = send(iAcceptSock, vData.data(), vData.size(), MSG_DONTWAIT);
+        if (iSent > 0) {
+            uiSent += (size_t)iSent;
+        }
+        ASSERT_LT(uiSent, (size_t)256 * 1024 * 1024);
+    }
+    ASSERT_EQ(waitTcpSocketWritable(iAcceptSock, 0), 0);
+
+    std::thread reader([&]() {
+        std::vector<char> vBuf(64 * 1024);
+        size_t uiRead = 0;
+        while (uiRead < uiSent) {
+            ssize_t iReadSize = recv(iClientSock, vBuf.data(), vBuf.size(), 0);
+            if (iReadSize <= 0) {
+                break;
+            }
+            uiRead += (size_t)iReadSize;
+        }
+    });
+    ASSERT_EQ(waitTcpSocketWritable(iAcceptSock, 5000), 1);
+    reader.join();
+
+    int aiPair[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, aiPair), 0);
+    ASSERT_EQ(setTcpNotSentLowat(aiPair[0], 4096), -1);
+    close(aiPair[0]);
+    close(aiPair[1]);
+    close(iAcceptSock);
+    close(iClientSock);
+    close(iServerSock);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,230 @@
+#include <gtest/gtest.h>
+#include "tcpTls.h"
+#include "tcpSock.h"
+#include "tcpFrame.h"
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/x509v3.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <chrono>
+
+/**
+ * @brief 루프백용 자체 서명 인증서(SAN IP:127.0.0.1, DNS:localhost)와 개인 키를 PEM 파일로 만듭니다.
+ */
+static bool writeSelfSignedCert(const std::string &strCertPath, const std::string &strKeyPath) {
+    EVP_PKEY *pstKey = EVP_EC_gen("P-256");
+    X509 *pstCert = X509_new();
+    bool bOk = false;
+
+    if (pstKey != NULL && pstCert != NULL) {
+        X509V3_CTX stExtCtx;
+        X509_NAME *pstName = X509_get_subject_name(pstCert);
+
+        X509_set_version(pstCert, 2);
+        ASN1_INTEGER_set(X509_get_serialNumber(pstCert), 1);
+        X509_gmtime_adj(X509_getm_notBefore(pstCert), -60);
+        X509_gmtime_adj(X509_getm_notAfter(pstCert), 3600);
+        X509_set_pubkey(pstCert, pstKey);
+        X509_NAME_add_entry_by_txt(pstName, "CN", MBSTRING_ASC, (const unsigned char *)"localhost", -1, -1, 0);
+        X509_set_issuer_name(pstCert, pstName);
+
+        X509V3_set_ctx_nodb(&stExtCtx);
+        X509V3_set_ctx(&stExtCtx, pstCert, pstCert, NULL, NULL, 0);
+        const char *kapchExt[][2] = {{"basicConstraints", "critical,CA:TRUE"},
+                                     {"subjectAltName", "IP:127.0.0.1,DNS:localhost"}};
+        for (auto &kpchExt : kapchExt) {
+            X509_EXTENSION *pstExt = X509V3_EXT_nconf(NULL, &stExtCtx, kpchExt[0], kpchExt[1]);
+            X509_add_ext(pstCert, pstExt, -1);
+            X509_EXTENSION_free(pstExt);
+        }
+
+        FILE *pstCertFile = fopen(strCertPath.c_str(), "w");
+        FILE *pstKeyFile = fopen(strKeyPath.c_str(), "w");
+        bOk = X509_sign(pstCert, pstKey, EVP_sha256()) > 0 && pstCertFile != NULL && pstKeyFile != NULL
+              && PEM_write_X509(pstCertFile, pstCert) == 1
+              && PEM_write_PrivateKey(pstKeyFile, pstKey, NULL, NULL, 0, NULL, NULL) == 1;
+        if (pstCertFile != NULL) {
+            fclose(pstCertFile);
+        }
+        if (pstKeyFile != NULL) {
+            fclose(pstKeyFile);
+        }
+    }
+    X509_free(pstCert);
+    EVP_PKEY_free(pstKey);
+    return bOk;
+}
+
+/**
+ * @brief TLS 테스트 클래스
+ *
+ * 임시 디렉터리에 서버용 인증서와, 신뢰하지 않는 다른 인증서를 만들고 루프백 대기 소켓을 엽니다.
+ */
+class TcpTlsTest : public ::testing::Test {
+protected:
+    char achDir[32];
+    std::string strCert, strKey, strOtherCert, strOtherKey;
+    int iListenSock = -1;
+
+    void SetUp() override {
+        strcpy(achDir, "/tmp/tcpTlsGtestXXXXXX");
+        ASSERT_NE(mkdtemp(achDir), nullptr);
+        strCert = std::string(achDir) + "/cert.pem";
+        strKey = std::string(achDir) + "/key.pem";
+        strOtherCert = std::string(achDir) + "/other.pem";
+        strOtherKey = std::string(achDir) + "/otherKey.pem";
+        ASSERT_TRUE(writeSelfSignedCert(strCert, strKey));
+        ASSERT_TRUE(writeSelfSignedCert(strOtherCert, strOtherKey));
+        iListenSock = createTcpServerSocketOn("127.0.0.1", 0, 1);
+        ASSERT_GE(iListenSock, 0);
+    }
+
+    void TearDown() override {
+        if (iListenSock >= 0) {
+            close(iListenSock);
+        }
+        for (const std::string &strPath : {strCert, strKey, strOtherCert, strOtherKey}) {
+            unlink(strPath.c_str());
+        }
+        rmdir(achDir);
+    }
+
+    /**
+     * @brief 서버 스레드가 연결 하나를 받아 핸드셰이크하고, 클라이언트도 핸드셰이크한 결과를 돌려줍니다.
+     */
+    void handshake(TCP_TLS *pstServerTls, TCP_TLS *pstClientTls, const char *kpchPeerName,
+                   int *piServerSock, int *piServerResult, int *piServerErrno,
+                   int *piClientSock, int *piClientResult, int *piClientErrno) {
+        std::thread server([&]() {
+            *piServerSock = accept(iListenSock, NULL, NULL);
+            *piServerResult = startTcpTls(pstServerTls, *piServerSock, NULL, 2000);
+            *piServerErrno = errno;
+        });
+        *piClientSock = createTcpClientSocket("127.0.0.1", getTcpSocketPort(iListenSock));
+        *piClientResult = startTcpTls(pstClientTls, *piClientSock, kpchPeerName, 2000);
+        *piClientErrno = errno;
+        if (*piClientResult < 0) {
+            shutdown(*piClientSock, SHUT_RDWR); /**< 서버 핸드셰이크가 제한 시간까지 기다리지 않도록 합니다. */
+        }
+        server.join();
+    }
+};
+
+/**
+ * @brief 커널 TLS 오프로드 테스트
+ *
+ * 자체 서명 인증서로 핸드셰이크한 뒤 양쪽이 일반 write()/writev()/read()로 프레임을 주고받는지 확인합니다.
+ * 커널에 TLS 모듈이 없으면 핸드셰이크까지만 확인하고 건너뜁니다.
+ */
+TEST_F(TcpTlsTest, HandshakeOffloadsToKernel) {
+    TCP_TLS *pstServerTls = createTcpTlsServer(strCert.c_str(), strKey.c_str());
+    TCP_TLS *pstClientTls = createTcpTlsClient(strCert.c_str());
+    ASSERT_NE(pstServerTls, nullptr) << getTcpTlsError();
+    ASSERT_NE(pstClientTls, nullptr) << getTcpTlsError();
+
+    int iServerSock, iServerResult, iServerErrno, iClientSock, iClientResult, iClientErrno;
+    handshake(pstServerTls, pstClientTls, "127.0.0.1", &iServerSock, &iServerResult, &iServerErrno,
+              &iClientSock, &iClientResult, &iClientErrno);
+    destroyTcpTls(pstServerTls);
+    destroyTcpTls(pstClientTls);
+
+    if (iClientResult < 0 && iClientErrno == EOPNOTSUPP) {
+        ASSERT_EQ(iServerErrno, EOPNOTSUPP);
+        close(iClientSock);
+        close(iServerSock);
+        GTEST_SKIP() << "Kernel TLS is not available: " << getTcpTlsError();
+    }
+    ASSERT_EQ(iClientResult, 0) << getTcpTlsError();
+    ASSERT_EQ(iServerResult, 0);
+
+    uint8_t au8Frame[64], au8In[128];
+    int iFrameLen = encodeTcpFrame(au8Frame, sizeof(au8Frame), 0x01, TCP_INST_DATA, "over ktls", 9);
+    struct iovec astIov[2] = {{au8Frame, 5}, {au8Frame + 5, (size_t)iFrameLen - 5}};
+    ASSERT_EQ(writev(iClientSock, astIov, 2), iFrameLen);
+
+    int iGot = 0;
+    while (iGot < iFrameLen) {
+        ssize_t iLen = read(iServerSock, au8In + iGot, sizeof(au8In) - (size_t)iGot);
+        ASSERT_GT(iLen, 0);
+        iGot += (int)iLen;
+    }
+    ASSERT_EQ(memcmp(au8In, au8Frame, (size_t)iFrameLen), 0);
+
+    ASSERT_EQ(write(iServerSock, au8Frame, (size_t)iFrameLen), iFrameLen);
+    ASSERT_EQ(read(iClientSock, au8In, sizeof(au8In)), iFrameLen);
+    ASSERT_EQ(memcmp(au8In, au8Frame, (size_t)iFrameLen), 0);
+
+    close(iClientSock);
+    close(iServerSock);
+}
+
+/**
+ * @brief 서버 인증서 검증 테스트
+ *
+ * 신뢰하지 않는 CA나 인증서에 없는 주소로 연결하면 양쪽 핸드셰이크가 EPROTO로 실패하는지 확인합니다.
+ */
+TEST_F(TcpTlsTest, RejectsUntrustedOrMismatchedServer) {
+    TCP_TLS *pstServerTls = createTcpTlsServer(strCert.c_str(), strKey.c_str());
+    TCP_TLS *pstOtherCaTls = createTcpTlsClient(strOtherCert.c_str());
+    TCP_TLS *pstClientTls = createTcpTlsClient(strCert.c_str());
+    ASSERT_NE(pstServerTls, nullptr) << getTcpTlsError();
+    ASSERT_NE(pstOtherCaTls, nullptr) << getTcpTlsError();
+    ASSERT_NE(pstClientTls, nullptr) << getTcpTlsError();
+
+    int iServerSock, iServerResult, iServerErrno, iClientSock, iClientResult, iClientErrno;
+    handshake(pstServerTls, pstOtherCaTls, "127.0.0.1", &iServerSock, &iServerResult, &iServerErrno,
+              &iClientSock, &iClientResult, &iClientErrno);
+    EXPECT_EQ(iClientResult, -1);
+    EXPECT_EQ(iClientErrno, EPROTO);
+    EXPECT_NE(strstr(getTcpTlsError(), "인증서 검증 실패"), nullptr) << getTcpTlsError();
+    EXPECT_EQ(iServerResult, -1);
+    close(iClientSock);
+    close(iServerSock);
+
+    handshake(pstServerTls, pstClientTls, "127.0.0.2", &iServerSock, &iServerResult, &iServerErrno,
+              &iClientSock, &iClientResult, &iClientErrno);
+    EXPECT_EQ(iClientResult, -1);
+    EXPECT_EQ(iClientErrno, EPROTO);
+    EXPECT_EQ(iServerResult, -1);
+    close(iClientSock);
+    close(iServerSock);
+
+    destroyTcpTls(pstServerTls);
+    destroyTcpTls(pstOtherCaTls);
+    destroyTcpTls(pstClientTls);
+}
+
+/**
+ * @brief 핸드셰이크 제한 시간과 설정 오류 테스트
+ *
+ * 상대가 응답하지 않으면 제한 시간 뒤 ETIMEDOUT으로 끝나고 소켓의 블로킹 상태가 그대로인지,
+ * 키가 맞지 않는 서버 설정은 만들어지지 않는지 확인합니다.
+ */
+TEST_F(TcpTlsTest, HandshakeTimeoutAndBadKey) {
+    TCP_TLS *pstClientTls = createTcpTlsClient(strCert.c_str());
+    ASSERT_NE(pstClientTls, nullptr) << getTcpTlsError();
+
+    int iSock = createTcpClientSocket("127.0.0.1", getTcpSocketPort(iListenSock)); /**< accept 하지 않는 대기 소켓 */
+    ASSERT_GE(iSock, 0);
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(startTcpTls(pstClientTls, iSock, "127.0.0.1", 100), -1);
+    ASSERT_EQ(errno, ETIMEDOUT);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    ASSERT_GE(elapsed, std::chrono::milliseconds(90));
+    ASSERT_LT(elapsed, std::chrono::milliseconds(2000));
+    ASSERT_EQ(fcntl(iSock, F_GETFL) & O_NONBLOCK, 0);
+    close(iSock);
+    destroyTcpTls(pstClientTls);
+
+    ASSERT_EQ(createTcpTlsServer(strCert.c_str(), strOtherKey.c_str()), nullptr);
+    ASSERT_NE(strstr(getTcpTlsError(), "개인 키"), nullptr) << getTcpTlsError();
+}
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include "tcpTune.h"
+#include "tcpSock.h"
+#include <vector>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <errno.h>
+
+/**
+ * @brief 목표 크기 계산 테스트
+ *
+ * 거의 쉬는 연결은 하한으로, 대량 전송 연결은 전달률 x RTT의 두 배로, 너무 큰 값은 상한으로 잘리는지 확인합니다.
+ */
+TEST(TcpTuneTest, SizeFollowsBandwidthDelayProduct) {
+    TCP_TUNE_LIMIT stLimit = {64 * 1024, TCP_TUNE_DEFAULT_MAX_BYTES};
+    TCP_TUNE_SIZE stSize;
+    TCP_INFO_SAMPLE stIdle = {};
+    TCP_INFO_SAMPLE stBulk = {};
+
+    stIdle.u32RttUs = 200;
+    stIdle.u32SndCwnd = 10;
+    stIdle.u32SndMss = 1448;
+    stIdle.u32RcvSpace = 1448;
+    stIdle.u64DeliveryRate = 10000;
+    calcTcpTuneSize(&stIdle, &stLimit, &stSize);
+    ASSERT_EQ(stSize.u32SndBytes, 64u * 1024u);
+    ASSERT_EQ(stSize.u32RcvBytes, 64u * 1024u);
+
+    /**< 100MB/s, RTT 10ms: BDP 1MB */
+    stBulk.u32RttUs = 10000;
+    stBulk.u32SndCwnd = 100;
+    stBulk.u32SndMss = 1448;
+    stBulk.u32RcvSpace = 300000;
+    stBulk.u64DeliveryRate = 100000000;
+    calcTcpTuneSize(&stBulk, &stLimit, &stSize);
+    ASSERT_EQ(stSize.u32SndBytes, 1000000u * TCP_TUNE_HEADROOM);
+    ASSERT_EQ(stSize.u32RcvBytes, 300000u * TCP_TUNE_HEADROOM);
+
+    /**< 전달률을 모르면 혼잡 윈도로 계산 */
+    stBulk.u64DeliveryRate = 0;
+    calcTcpTuneSize(&stBulk, &stLimit, &stSize);
+    ASSERT_EQ(stSize.u32SndBytes, 100u * 1448u * TCP_TUNE_HEADROOM);
+
+    stBulk.u32RttUs = 1000000;
+    stBulk.u64DeliveryRate = 100000000;
+    calcTcpTuneSize(&stBulk, &stLimit, &stSize);
+    ASSERT_EQ(stSize.u32SndBytes, (uint32_t)TCP_TUNE_DEFAULT_MAX_BYTES);
+}
+
+/**
+ * @brief 소켓 버퍼 조정 테스트
+ *
+ * loopback 연결에서 TCP_INFO 표본을 읽고, 범위를 고정하면 버퍼가 그 크기로 바뀌며
+ * 같은 범위로 다시 호출하면 바꾸지 않는지 확인합니다. TCP가 아닌 소켓은 실패합니다.
+ */
+TEST(TcpTuneTest, TunesLoopbackConnection) {
+    int iServerSock = createTcpServerSocketOn("127.0.0.1", 0, 1);
+    ASSERT_GE(iServerSock, 0);
+    int iClientSock = connectTcpClientSocket("127.0.0.1", getTcpSocketPort(iServerSock), 1000);
+    ASSERT_GE(iClientSock, 0);
+    int iAcceptSock = accept(iServerSock, NULL, NULL);
+    ASSERT_GE(iAcceptSock, 0);
+
+    std::vector<char> vData(64 * 1024, 'x');
+    ASSERT_EQ(send(iAcceptSock, vData.data(), vData.size(), 0), (ssize_t)vData.size());
+    ASSERT_EQ(recv(iClientSock, vData.data(), vData.size(), MSG_WAITALL), (ssize_t)vData.size());
+
+    TCP_INFO_SAMPLE stSample;
+    ASSERT_EQ(getTcpInfoSample(iAcceptSock, &stSample), 0);
+    ASSERT_GT(stSample.u32SndMss, 0u);
+    ASSERT_GT(stSample.u32SndCwnd, 0u);
+
+    TCP_TUNE_LIMIT stLimit = {96 * 1024, 96 * 1024};
+    int iSndBuf = 0, iRcvBuf = 0;
+    socklen_t uiLen = sizeof(int);
+    ASSERT_GT(tuneTcpSocketBuffer(iAcceptSock, &stLimit), 0);
+    getsockopt(iAcceptSock, SOL_SOCKET, SO_SNDBUF, &iSndBuf, &uiLen);
+    getsockopt(iAcceptSock, SOL_SOCKET, SO_RCVBUF, &iRcvBuf, &uiLen);
+    ASSERT_EQ(iSndBuf, 2 * 96 * 1024);
+    ASSERT_EQ(iRcvBuf, 2 * 96 * 1024);
+    ASSERT_EQ(tuneTcpSocketBuffer(iAcceptSock, &stLimit), 0);
+
+    int aiPair[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, aiPair), 0);
+    ASSERT_EQ(tuneTcpSocketBuffer(aiPair[0], &stLimit), -1);
+    close(aiPair[0]);
+    close(aiPair[1]);
+    close(iAcceptSock);
+    close(iClientSock);
+    close(iServerSock);
+}
+
+/**
+ * @brief 연결별 TCP_INFO 표본 테스트
+ *
+ * loopback 연결의 표본이 연결별 게이지에 남고, 첫 표본은 RTT만, 두 번째 표본부터는 전송 중/제한 시간도
+ * 전체 히스토그램에 기록되는지 확인합니다. TCP가 아닌 연결은 실패하고 게이지를 남기지 않습니다.
+ */
+TEST(TcpTuneTest, SampleRecordsConnGauges) {
+    static TCP_METRICS_SNAPSHOT stBefore, stAfter;
+    TCP_CONN_METRICS stConn;
+    uint64_t au64Gauge[TCP_GAUGE_COUNT];
+    int iServerSock = createTcpServerSocketOn("127.0.0.1", 0, 1);
+    ASSERT_GE(iServerSock, 0);
+    int iClientSock = connectTcpClientSocket("127.0.0.1", getTcpSocketPort(iServerSock), 1000);
+    ASSERT_GE(iClientSock, 0);
+    int iAcceptSock = accept(iServerSock, NULL, NULL);
+    ASSERT_GE(iAcceptSock, 0);
+
+    std::vector<char> vData(64 * 1024, 'x');
+    ASSERT_EQ(send(iAcceptSock, vData.data(), vData.size(), 0), (ssize_t)vData.size());
+    ASSERT_EQ(recv(iClientSock, vData.data(), vData.size(), MSG_WAITALL), (ssize_t)vData.size());
+
+    registerTcpConnMetrics(&stConn, iAcceptSock, "127.0.0.1:0");
+    ASSERT_EQ(getTcpConnGauges(&stConn, au64Gauge), 0u);
+    getTcpMetricsSnapshot(&stBefore);
+    ASSERT_EQ(sampleTcpConnInfo(&stConn, 100), 0);
+    ASSERT_EQ(sampleTcpConnInfo(&stConn, 200), 0);
+    getTcpMetricsSnapshot(&stAfter);
+    ASSERT_EQ(getTcpConnGauges(&stConn, au64Gauge), 200u);
+    ASSERT_GT(au64Gauge[TCP_GAUGE_CWND], 0u);
+    ASSERT_EQ(au64Gauge[TCP_GAUGE_UNACKED], 0u);
+    ASSERT_EQ(stAfter.astHist[TCP_HIST_TCP_RTT].u64Count - stBefore.astHist[TCP_HIST_TCP_RTT].u64Count, 2u);
+    ASSERT_EQ(stAfter.astHist[TCP_HIST_TCP_BUSY].u64Count - stBefore.astHist[TCP_HIST_TCP_BUSY].u64Count, 1u);
+    ASSERT_EQ(stAfter.astHist[TCP_HIST_TCP_RWND_LIMITED].u64Count
+              - stBefore.astHist[TCP_HIST_TCP_RWND_LIMITED].u64Count, 1u);
+    unregisterTcpConnMetrics(&stConn);
+    errno = 0;
+    ASSERT_EQ(sampleTcpConnInfo(&stConn, 250), -1) << "Unregistered connection's socket may already be closed and reused.";
+    ASSERT_EQ(errno, ENOTCONN);
+    ASSERT_EQ(getTcpConnGauges(&stConn, au64Gauge), 200u);
+
+    int aiPair[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, aiPair), 0);
+    registerTcpConnMetrics(&stConn, aiPair[0], "unix");
+    ASSERT_EQ(sampleTcpConnInfo(&stConn, 300), -1);
+    ASSERT_EQ(getTcpConnGauges(&stConn, au64Gauge), 0u);
+    unregisterTcpConnMetrics(&stConn);
+    close(aiPair[0]);
+    close(aiPair[1]);
+    close(iAcceptSock);
+    close(iClientSock);
+    close(iServerSock);
+}
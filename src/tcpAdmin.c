@@ -0,0 +1,548 @@
+/**
+ * @file tcpAdmin.c
+ * @brief 서버 메트릭 조회와 연결 관리를 위한 로컬 관리 인터페이스
+ *
+ * 관리 스레드는 Unix 도메인 소켓과 선택적인 127.0.0.1 HTTP 포트에서 요청을 받아
+ * Prometheus 텍스트 형식 메트릭, 연결 목록, 큐 깊이를 응답하고 연결을 강제로 종료합니다.
+ * 메트릭은 스레드별 샤드를 합산한 스냅샷으로, 연결 정보는 잠금 없는 연결 테이블로 읽으므로
+ * 메시지 송수신 경로가 사용하는 뮤텍스는 잡지 않습니다.
+ *
+ * 주요 기능:
+ * - Unix 도메인 소켓 (추상 네임스페이스 포함) 한 줄 명령 처리
+ * - 127.0.0.1 HTTP GET 요청 처리
+ * - Prometheus 텍스트 형식 메트릭 출력
+ * - 연결 목록/큐 깊이 출력 및 연결 강제 종료 (연결별 TCP_INFO 표본 포함)
+ * - 연결별/Client ID별 수신 전송률 제한 조회 및 변경
+ * - 과부하 판단 기준 조회 및 변경
+ *
+ * @date 2024-12-17
+ */
+#include "tcpAdmin.h"
+#include "tcpMetrics.h"
+#include "tcpRate.h"
+#include "tcpAdmission.h"
+
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <pthread.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#define TCP_ADMIN_POLL_MS 500       /**< 종료 플래그 확인 주기 (ms) */
+#define TCP_ADMIN_READ_TIMEOUT_MS 1000  /**< 요청 수신 대기 시간 (ms) */
+
+static pthread_t s_adminThreadId;
+static bool s_bAdminRunning = false;
+static int s_iUnixSock = -1;
+static int s_iHttpSock = -1;
+static char s_achUnixPath[sizeof(((struct sockaddr_un *)0)->sun_path)];
+
+/**
+ * @brief Unix 도메인 소켓 주소를 채웁니다. '@'로 시작하면 추상 네임스페이스를 사용합니다.
+ */
+static socklen_t fillTcpAdminUnixAddr(struct sockaddr_un *pstAddr, const char *kpchPath)
+{
+    size_t uiLen = strlen(kpchPath);
+
+    memset(pstAddr, 0x0, sizeof(struct sockaddr_un));
+    pstAddr->sun_family = AF_UNIX;
+    if (uiLen >= sizeof(pstAddr->sun_path)) {
+        return 0;
+    }
+
+    memcpy(pstAddr->sun_path, kpchPath, uiLen);
+    if (kpchPath[0] == '@') {
+        pstAddr->sun_path[0] = '\0';
+        return (socklen_t)(offsetof(struct sockaddr_un, sun_path) + uiLen);
+    }
+
+    return (socklen_t)sizeof(struct sockaddr_un);
+}
+
+static int createTcpAdminUnixSocket(const char *kpchPath)
+{
+    struct sockaddr_un stAddr;
+    socklen_t uiAddrLen = fillTcpAdminUnixAddr(&stAddr, kpchPath);
+    int iSock;
+
+    if (uiAddrLen == 0) {
+        fprintf(stderr, "Admin socket path too long: %s\n", kpchPath);
+        return -1;
+    }
+
+    if ((iSock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)) < 0) {
+        perror("Admin socket failed");
+        return -1;
+    }
+
+    if (kpchPath[0] != '@') {
+        unlink(kpchPath); /**< 이전 실행에서 남은 소켓 파일 제거 */
+    }
+
+    if (bind(iSock, (struct sockaddr *)&stAddr, uiAddrLen) < 0 || listen(iSock, 8) < 0) {
+        perror("Admin socket bind/listen failed");
+        close(iSock);
+        return -1;
+    }
+
+    return iSock;
+}
+
+static int createTcpAdminHttpSocket(int iPort)
+{
+    struct sockaddr_in stAddr;
+    int iSockOpt = 1;
+    int iSock;
+
+    if ((iSock = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0)) < 0) {
+        perror("Admin HTTP socket failed");
+        return -1;
+    }
+    setsockopt(iSock, SOL_SOCKET, SO_REUSEADDR, &iSockOpt, sizeof(iSockOpt));
+
+    memset(&stAddr, 0x0, sizeof(stAddr));
+    stAddr.sin_family = AF_INET;
+    stAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK); /**< 로컬에서만 접근 가능 */
+    stAddr.sin_port = htons(iPort);
+
+    if (bind(iSock, (struct sockaddr *)&stAddr, sizeof(stAddr)) < 0 || listen(iSock, 8) < 0) {
+        perror("Admin HTTP bind/listen failed");
+        close(iSock);
+        return -1;
+    }
+
+    return iSock;
+}
+
+static void writeTcpAdminPrometheus(FILE *pFile)
+{
+    static TCP_METRICS_SNAPSHOT stSnapshot; /**< 관리 스레드 전용. 크기가 커서 정적 영역 사용 */
+
+    getTcpMetricsSnapshot(&stSnapshot);
+
+    for (int i = 0; i < TCP_METRIC_COUNT; i++) {
+        const char *kpchName = getTcpMetricName((TCP_METRIC_ID)i);
+        fprintf(pFile, "# TYPE tcp_server_%s_total counter\n", kpchName);
+        fprintf(pFile, "tcp_server_%s_total %llu\n", kpchName, (unsigned long long)stSnapshot.au64Counter[i]);
+    }
+
+    fprintf(pFile, "# TYPE tcp_server_active_connections gauge\n");
+    fprintf(pFile, "tcp_server_active_connections %llu\n", (unsigned long long)getTcpActiveConnections(&stSnapshot));
+    fprintf(pFile, "# TYPE tcp_server_queue_depth gauge\n");
+    fprintf(pFile, "tcp_server_queue_depth %llu\n", (unsigned long long)getTcpQueueDepth(&stSnapshot));
+    fprintf(pFile, "# TYPE tcp_server_queued_bytes gauge\n");
+    fprintf(pFile, "tcp_server_queued_bytes %llu\n", (unsigned long long)getTcpQueuedBytes());
+    fprintf(pFile, "# TYPE tcp_server_loop_lag_seconds gauge\n");
+    fprintf(pFile, "tcp_server_loop_lag_seconds %.9f\n", getTcpLoopLag() / 1e9);
+
+    /**< 종료 중에는 남은 기한과 함께 active_connections, queued_bytes 가 줄어드는 것으로 진행 상황을 봅니다. */
+    uint64_t u64DrainDeadlineNs = getTcpDrainDeadline();
+    uint64_t u64NowNs = getTcpMonotonicNs();
+    fprintf(pFile, "# TYPE tcp_server_draining gauge\n");
+    fprintf(pFile, "tcp_server_draining %d\n", u64DrainDeadlineNs != 0 ? 1 : 0);
+    fprintf(pFile, "# TYPE tcp_server_drain_remaining_seconds gauge\n");
+    fprintf(pFile, "tcp_server_drain_remaining_seconds %.3f\n",
+            u64DrainDeadlineNs > u64NowNs ? (u64DrainDeadlineNs - u64NowNs) / 1e9 : 0.0);
+
+    /**< 히스토그램은 2의 거듭제곱 구간 경계마다 누적 버킷을 출력합니다. (단위: 초) */
+    for (int i = 0; i < TCP_HIST_COUNT; i++) {
+        const char *kpchName = getTcpHistogramName((TCP_HIST_ID)i);
+        const TCP_HISTOGRAM *kpstHist = &stSnapshot.astHist[i];
+        uint64_t u64Cumulative = 0;
+
+        fprintf(pFile, "# TYPE tcp_server_%s_seconds histogram\n", kpchName);
+        for (int j = 0; j < TCP_HIST_BUCKETS; j++) {
+            u64Cumulative += kpstHist->au64Bucket[j];
+            if (((j + 1) & ((1 << TCP_HIST_SUB_BITS) - 1)) == 0 && j != TCP_HIST_BUCKETS - 1) {
+                fprintf(pFile, "tcp_server_%s_seconds_bucket{le=\"%.9f\"} %llu\n", kpchName,
+                        getTcpHistogramBucketMax(j) / 1e9, (unsigned long long)u64Cumulative);
+            }
+        }
+        fprintf(pFile, "tcp_server_%s_seconds_bucket{le=\"+Inf\"} %llu\n", kpchName, (unsigned long long)kpstHist->u64Count);
+        fprintf(pFile, "tcp_server_%s_seconds_sum %.9f\n", kpchName, kpstHist->u64Sum / 1e9);
+        fprintf(pFile, "tcp_server_%s_seconds_count %llu\n", kpchName, (unsigned long long)kpstHist->u64Count);
+    }
+}
+
+static void writeTcpAdminConn(const TCP_CONN_METRICS *kpstConn, void *pvArg)
+{
+    FILE *pFile = (FILE *)pvArg;
+    uint64_t u64Now = getTcpMonotonicNs();
+    uint64_t au64Gauge[TCP_GAUGE_COUNT];
+    uint64_t u64SampledNs;
+
+    fprintf(pFile, "%llu\t%d\t%s\t%.1f", (unsigned long long)kpstConn->u64ConnId, kpstConn->iSock,
+            kpstConn->achPeer, (u64Now - kpstConn->u64ConnectedNs) / 1e9);
+    for (int i = 0; i < TCP_METRIC_COUNT; i++) {
+        if (i == TCP_METRIC_ACCEPTS || i == TCP_METRIC_DISCONNECTS) {
+            continue;
+        }
+        fprintf(pFile, "\t%s=%llu", getTcpMetricName((TCP_METRIC_ID)i),
+                (unsigned long long)getTcpConnMetric(kpstConn, (TCP_METRIC_ID)i));
+    }
+    /**< TCP_INFO 표본은 메인 루프가 주기마다 뜹니다. Unix 도메인 연결과 아직 표본이 없는 연결은 생략합니다. */
+    u64SampledNs = getTcpConnGauges(kpstConn, au64Gauge);
+    if (u64SampledNs != 0) {
+        fprintf(pFile, "\tinfo_age_sec=%.1f", u64Now > u64SampledNs ? (u64Now - u64SampledNs) / 1e9 : 0.0);
+        for (int i = 0; i < TCP_GAUGE_COUNT; i++) {
+            fprintf(pFile, "\t%s=%llu", getTcpGaugeName((TCP_GAUGE_ID)i), (unsigned long long)au64Gauge[i]);
+        }
+    }
+    fprintf(pFile, "\n");
+}
+
+static void writeTcpAdminQueue(const TCP_CONN_METRICS *kpstConn, void *pvArg)
+{
+    FILE *pFile = (FILE *)pvArg;
+
+    fprintf(pFile, "%llu\t%s\t%llu\n", (unsigned long long)kpstConn->u64ConnId, kpstConn->achPeer,
+            (unsigned long long)getTcpConnQueueDepth(kpstConn));
+}
+
+typedef struct {
+    uint64_t u64ConnId;     /**< 종료할 연결 ID */
+    bool bFound;            /**< 대상 연결을 찾았는지 여부 */
+} TCP_ADMIN_DROP;
+
+static void dropTcpAdminConn(const TCP_CONN_METRICS *kpstConn, void *pvArg)
+{
+    TCP_ADMIN_DROP *pstDrop = (TCP_ADMIN_DROP *)pvArg;
+
+    /**
+     * 소켓을 닫지 않고 shutdown만 하면 소유 스레드가 EOF를 보고 평소처럼 정리합니다.
+     * 잠근 동안에는 등록 해제가 기다리므로 소유 스레드가 닫은 뒤 재사용된 소켓 번호를 건드리지 않습니다.
+     */
+    int iSock = lockTcpConnSock(kpstConn, pstDrop->u64ConnId);
+    if (iSock >= 0) {
+        shutdown(iSock, SHUT_RDWR);
+        unlockTcpConnSock();
+        pstDrop->bFound = true;
+    }
+}
+
+static void writeTcpAdminLimits(FILE *pFile)
+{
+    TCP_RATE_LIMIT stLimit;
+
+    getTcpConnRateLimit(&stLimit);
+    fprintf(pFile, "# scope\tbytes_per_sec\tmsgs_per_sec (0: unlimited)\n");
+    fprintf(pFile, "conn\t%llu\t%llu\n", (unsigned long long)stLimit.u64BytesPerSec,
+            (unsigned long long)stLimit.u64MsgsPerSec);
+    for (int i = 0; i < TCP_RATE_CLIENT_IDS; i++) {
+        if (getTcpClientIdRateLimit((uint8_t)i, &stLimit)) {
+            fprintf(pFile, "id %d\t%llu\t%llu\n", i, (unsigned long long)stLimit.u64BytesPerSec,
+                    (unsigned long long)stLimit.u64MsgsPerSec);
+        }
+    }
+}
+
+/**
+ * @brief "limit conn <바이트/s> <메시지/s>" 또는 "limit id <Client ID> <바이트/s> <메시지/s>" 를 적용합니다.
+ * @return 성공 시 true, 형식 오류 시 false
+ */
+static bool setTcpAdminLimit(const char *kpchArgs, FILE *pFile)
+{
+    unsigned long long ullBytesPerSec, ullMsgsPerSec;
+    unsigned int uiClientId;
+    TCP_RATE_LIMIT stLimit;
+
+    if (sscanf(kpchArgs, "conn %llu %llu", &ullBytesPerSec, &ullMsgsPerSec) == 2) {
+        stLimit.u64BytesPerSec = ullBytesPerSec;
+        stLimit.u64MsgsPerSec = ullMsgsPerSec;
+        setTcpConnRateLimit(&stLimit);
+        fprintf(pFile, "conn limit %llu bytes/s, %llu msgs/s\n", ullBytesPerSec, ullMsgsPerSec);
+    } else if (sscanf(kpchArgs, "id %u %llu %llu", &uiClientId, &ullBytesPerSec, &ullMsgsPerSec) == 3
+               && uiClientId < TCP_RATE_CLIENT_IDS) {
+        stLimit.u64BytesPerSec = ullBytesPerSec;
+        stLimit.u64MsgsPerSec = ullMsgsPerSec;
+        setTcpClientIdRateLimit((uint8_t)uiClientId, &stLimit);
+        fprintf(pFile, "id %u limit %llu bytes/s, %llu msgs/s\n", uiClientId, ullBytesPerSec, ullMsgsPerSec);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static void writeTcpAdminAdmission(FILE *pFile)
+{
+    TCP_ADMISSION_LIMIT stLimit;
+
+    getTcpAdmissionLimit(&stLimit);
+    fprintf(pFile, "# name\tcurrent\tlimit (0: unchecked)\n");
+    fprintf(pFile, "lag_ms\t%.3f\t%.3f\n", getTcpLoopLag() / 1e6, stLimit.u64MaxLagNs / 1e6);
+    fprintf(pFile, "queued_bytes\t%llu\t%llu\n", (unsigned long long)getTcpQueuedBytes(),
+            (unsigned long long)stLimit.u64MaxQueuedBytes);
+    fprintf(pFile, "conns\t%u\t%u\n", getTcpAdmittedConns(), stLimit.u32MaxConns);
+    if (isTcpDraining()) {
+        uint64_t u64DeadlineNs = getTcpDrainDeadline();
+        uint64_t u64NowNs = getTcpMonotonicNs();
+        fprintf(pFile, "draining\t%.3f s left\n", u64DeadlineNs > u64NowNs ? (u64DeadlineNs - u64NowNs) / 1e9 : 0.0);
+    }
+}
+
+/**
+ * @brief "admission <지연 ms> <큐 바이트> <연결 수>" 를 적용합니다.
+ * @return 성공 시 true, 형식 오류 시 false
+ */
+static bool setTcpAdminAdmission(const char *kpchArgs, FILE *pFile)
+{
+    unsigned long long ullLagMs, ullQueuedBytes;
+    unsigned int uiConns;
+    TCP_ADMISSION_LIMIT stLimit;
+
+    if (sscanf(kpchArgs, "%llu %llu %u", &ullLagMs, &ullQueuedBytes, &uiConns) != 3) {
+        return false;
+    }
+    stLimit.u64MaxLagNs = ullLagMs * 1000000ULL;
+    stLimit.u64MaxQueuedBytes = ullQueuedBytes;
+    stLimit.u32MaxConns = uiConns;
+    setTcpAdmissionLimit(&stLimit);
+    fprintf(pFile, "admission lag %llu ms, queued %llu bytes, conns %u\n", ullLagMs, ullQueuedBytes, uiConns);
+    return true;
+}
+
+char *handleTcpAdminCommand(const char *kpchCommand, int *piStatus)
+{
+    char *pchOut = NULL;
+    size_t uiOutLen = 0;
+    int iStatus = 200;
+    FILE *pFile = open_memstream(&pchOut, &uiOutLen);
+
+    if (pFile == NULL) {
+        return NULL;
+    }
+
+    if (strcmp(kpchCommand, "metrics") == 0) {
+        writeTcpAdminPrometheus(pFile);
+    } else if (strcmp(kpchCommand, "conns") == 0) {
+        fprintf(pFile, "# id\tfd\tpeer\tage_sec\tcounters\ttcp_info\n");
+        visitTcpConnMetrics(writeTcpAdminConn, pFile);
+    } else if (strcmp(kpchCommand, "queues") == 0) {
+        fprintf(pFile, "# id\tpeer\tqueue_depth\n");
+        visitTcpConnMetrics(writeTcpAdminQueue, pFile);
+    } else if (strncmp(kpchCommand, "drop ", 5) == 0) {
+        TCP_ADMIN_DROP stDrop;
+        stDrop.u64ConnId = strtoull(kpchCommand + 5, NULL, 10);
+        stDrop.bFound = false;
+        if (stDrop.u64ConnId != 0) {
+            visitTcpConnMetrics(dropTcpAdminConn, &stDrop);
+        }
+        if (stDrop.bFound) {
+            fprintf(pFile, "dropped %llu\n", (unsigned long long)stDrop.u64ConnId);
+        } else {
+            fprintf(pFile, "connection not found\n");
+            iStatus = 404;
+        }
+    } else if (strcmp(kpchCommand, "limits") == 0) {
+        writeTcpAdminLimits(pFile);
+    } else if (strncmp(kpchCommand, "limit ", 6) == 0) {
+        if (!setTcpAdminLimit(kpchCommand + 6, pFile)) {
+            fprintf(pFile, "usage: limit conn <bytes/s> <msgs/s> | limit id <client id> <bytes/s> <msgs/s>\n");
+            iStatus = 400;
+        }
+    } else if (strcmp(kpchCommand, "admission") == 0) {
+        writeTcpAdminAdmission(pFile);
+    } else if (strncmp(kpchCommand, "admission ", 10) == 0) {
+        if (!setTcpAdminAdmission(kpchCommand + 10, pFile)) {
+            fprintf(pFile, "usage: admission <lag ms> <queued bytes> <conns>\n");
+            iStatus = 400;
+        }
+    } else {
+        fprintf(pFile, "commands: metrics | conns | queues | drop <id> | limits | limit conn|id ... | admission [...]\n");
+        iStatus = (strcmp(kpchCommand, "help") == 0) ? 200 : 400;
+    }
+
+    fclose(pFile);
+    if (piStatus != NULL) {
+        *piStatus = iStatus;
+    }
+    return pchOut;
+}
+
+/**
+ * @brief HTTP 요청 줄("GET /drop?id=3 HTTP/1.1")을 관리 명령("drop 3")으로 바꿉니다.
+ *
+ * @details "/limit/id/7/1000/10" 처럼 /limit/, /admission/ 아래 경로는 '/'를 공백으로 바꿔 "limit id 7 1000 10"이 됩니다.
+ */
+static void convertTcpAdminHttpRequest(const char *kpchRequest, char *pchCommand, size_t uiSize)
+{
+    char achPath[256] = {0};
+
+    if (sscanf(kpchRequest, "GET %255s", achPath) != 1) {
+        snprintf(pchCommand, uiSize, "invalid");
+        return;
+    }
+
+    if (strncmp(achPath, "/drop?id=", 9) == 0) {
+        snprintf(pchCommand, uiSize, "drop %s", achPath + 9);
+    } else if (strncmp(achPath, "/limit/", 7) == 0 || strncmp(achPath, "/admission/", 11) == 0) {
+        for (char *pchSlash = strchr(achPath + 1, '/'); pchSlash != NULL; pchSlash = strchr(pchSlash, '/')) {
+            *pchSlash = ' ';
+        }
+        snprintf(pchCommand, uiSize, "%s", achPath + 1);
+    } else {
+        snprintf(pchCommand, uiSize, "%s", achPath[0] == '/' ? achPath + 1 : achPath);
+    }
+}
+
+static void writeTcpAdminAll(int iSock, const char *kpchData, size_t uiLen)
+{
+    while (uiLen > 0) {
+        ssize_t iWritten = send(iSock, kpchData, uiLen, MSG_NOSIGNAL);
+        if (iWritten <= 0) {
+            return;
+        }
+        kpchData += iWritten;
+        uiLen -= (size_t)iWritten;
+    }
+}
+
+static void serveTcpAdminClient(int iSock, bool bHttp)
+{
+    char achRequest[TCP_ADMIN_REQUEST_SIZE];
+    char achCommand[TCP_ADMIN_REQUEST_SIZE];
+    size_t uiReadLen = 0;
+    struct pollfd stPollFd;
+
+    /**< 줄바꿈이 올 때까지 읽습니다. 관리 요청은 짧으므로 한 번에 하나씩 처리합니다. */
+    stPollFd.fd = iSock;
+    stPollFd.events = POLLIN;
+    while (uiReadLen < sizeof(achRequest) - 1) {
+        if (poll(&stPollFd, 1, TCP_ADMIN_READ_TIMEOUT_MS) <= 0) {
+            break;
+        }
+        ssize_t iRead = read(iSock, achRequest + uiReadLen, sizeof(achRequest) - 1 - uiReadLen);
+        if (iRead <= 0) {
+            break;
+        }
+        uiReadLen += (size_t)iRead;
+        achRequest[uiReadLen] = '\0';
+        if (strchr(achRequest, '\n') != NULL) {
+            break;
+        }
+    }
+    achRequest[uiReadLen] = '\0';
+    achRequest[strcspn(achRequest, "\r\n")] = '\0';
+
+    if (bHttp) {
+        convertTcpAdminHttpRequest(achRequest, achCommand, sizeof(achCommand));
+    } else {
+        snprintf(achCommand, sizeof(achCommand), "%s", achRequest);
+    }
+
+    int iStatus = 500;
+    char *pchResponse = handleTcpAdminCommand(achCommand, &iStatus);
+    size_t uiResponseLen = (pchResponse != NULL) ? strlen(pchResponse) : 0;
+
+    if (bHttp) {
+        char achHeader[256];
+        int iHeaderLen = snprintf(achHeader, sizeof(achHeader),
+                                  "HTTP/1.0 %d %s\r\nContent-Type: text/plain; version=0.0.4\r\n"
+                                  "Content-Length: %zu\r\nConnection: close\r\n\r\n",
+                                  iStatus, iStatus == 200 ? "OK" : (iStatus == 404 ? "Not Found" : "Bad Request"),
+                                  uiResponseLen);
+        writeTcpAdminAll(iSock, achHeader, (size_t)iHeaderLen);
+    }
+    if (pchResponse != NULL) {
+        writeTcpAdminAll(iSock, pchResponse, uiResponseLen);
+    }
+
+    free(pchResponse);
+}
+
+static void *runTcpAdminServer(void *pvArg)
+{
+    (void)pvArg;
+
+    while (__atomic_load_n(&s_bAdminRunning, __ATOMIC_ACQUIRE)) {
+        struct pollfd astPollFd[2];
+        int iCount = 0;
+
+        if (s_iUnixSock >= 0) {
+            astPollFd[iCount].fd = s_iUnixSock;
+            astPollFd[iCount].events = POLLIN;
+            iCount++;
+        }
+        if (s_iHttpSock >= 0) {
+            astPollFd[iCount].fd = s_iHttpSock;
+            astPollFd[iCount].events = POLLIN;
+            iCount++;
+        }
+
+        if (poll(astPollFd, iCount, TCP_ADMIN_POLL_MS) <= 0) {
+            continue;
+        }
+
+        for (int i = 0; i < iCount; i++) {
+            if (!(astPollFd[i].revents & POLLIN)) {
+                continue;
+            }
+            int iClientSock = accept(astPollFd[i].fd, NULL, NULL);
+            if (iClientSock < 0) {
+                continue;
+            }
+            serveTcpAdminClient(iClientSock, astPollFd[i].fd == s_iHttpSock);
+            close(iClientSock);
+        }
+    }
+
+    return NULL;
+}
+
+int startTcpAdminServer(const char *kpchUnixPath, int iHttpPort)
+{
+    if (s_bAdminRunning) {
+        return -1;
+    }
+
+    s_achUnixPath[0] = '\0';
+    if (kpchUnixPath != NULL) {
+        if ((s_iUnixSock = createTcpAdminUnixSocket(kpchUnixPath)) < 0) {
+            return -1;
+        }
+        snprintf(s_achUnixPath, sizeof(s_achUnixPath), "%s", kpchUnixPath);
+    }
+
+    if (iHttpPort > 0 && (s_iHttpSock = createTcpAdminHttpSocket(iHttpPort)) < 0) {
+        stopTcpAdminServer();
+        return -1;
+    }
+
+    s_bAdminRunning = true;
+    if (pthread_create(&s_adminThreadId, NULL, runTcpAdminServer, NULL) != 0) {
+        perror("Admin thread creation failed");
+        s_bAdminRunning = false;
+        stopTcpAdminServer();
+        return -1;
+    }
+
+    return 0;
+}
+
+void stopTcpAdminServer(void)
+{
+    if (__atomic_load_n(&s_bAdminRunning, __ATOMIC_ACQUIRE)) {
+        __atomic_store_n(&s_bAdminRunning, false, __ATOMIC_RELEASE);
+        pthread_join(s_adminThreadId, NULL);
+    }
+
+    if (s_iUnixSock >= 0) {
+        close(s_iUnixSock);
+        s_iUnixSock = -1;
+        if (s_achUnixPath[0] != '\0' && s_achUnixPath[0] != '@') {
+            unlink(s_achUnixPath);
+        }
+    }
+    if (s_iHttpSock >= 0) {
+        close(s_iHttpSock);
+        s_iHttpSock = -1;
+    }
+}
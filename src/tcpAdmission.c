@@ -0,0 +1,178 @@
+/**
+ * @file tcpAdmission.c
+ * @brief 과부하 시 새 연결 거절과 낮은 우선순위 요청 버리기를 위한 수락 제어 API
+ *
+ * 서버가 포화되면 모든 요청이 함께 느려지다가 클라이언트가 시간 초과로 끊습니다.
+ * 스케줄링 지연, 송신 큐에 쌓인 바이트, 활성 연결 수가 기준을 넘으면 새 연결과 대량 요청을
+ * 바로 거절(BUSY)하여, 이미 받아들인 일은 좋은 지연으로 계속 처리합니다.
+ *
+ * 주요 기능:
+ * - 실행 중에 바꿀 수 있는 판단 기준
+ * - 송신 큐 바이트와 활성 연결 수 게이지
+ * - 늦게 깨어난 시간으로 재는 스케줄링 지연
+ * - 서버 종료(드레인) 기한
+ *
+ * @date 2026-10-16
+ */
+#include "tcpAdmission.h"
+#include "tcpMetrics.h"
+
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+
+static pthread_mutex_t s_admissionMutex = PTHREAD_MUTEX_INITIALIZER;   /**< 판단 기준 갱신을 보호합니다. */
+static uint64_t s_u64MaxLagNs;                                          /**< 아래 기준은 잠금 없이 읽음 */
+static uint64_t s_u64MaxQueuedBytes;
+static uint32_t s_u32MaxConns;
+static int64_t s_i64QueuedBytes;                                        /**< 송신 큐에 쌓인 바이트 */
+static int32_t s_i32Conns;                                              /**< 활성 연결 수 */
+static uint64_t s_u64LagNs;                                             /**< 스케줄링 지연 추정값 (측정 스레드만 씀) */
+static uint64_t s_u64DrainDeadlineNs;                                   /**< 종료 기한 (0이면 종료 중 아님) */
+
+void setTcpAdmissionLimit(const TCP_ADMISSION_LIMIT *kpstLimit)
+{
+    pthread_mutex_lock(&s_admissionMutex);
+    __atomic_store_n(&s_u64MaxLagNs, kpstLimit->u64MaxLagNs, __ATOMIC_RELAXED);
+    __atomic_store_n(&s_u64MaxQueuedBytes, kpstLimit->u64MaxQueuedBytes, __ATOMIC_RELAXED);
+    __atomic_store_n(&s_u32MaxConns, kpstLimit->u32MaxConns, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&s_admissionMutex);
+}
+
+void getTcpAdmissionLimit(TCP_ADMISSION_LIMIT *pstLimit)
+{
+    pthread_mutex_lock(&s_admissionMutex);
+    pstLimit->u64MaxLagNs = __atomic_load_n(&s_u64MaxLagNs, __ATOMIC_RELAXED);
+    pstLimit->u64MaxQueuedBytes = __atomic_load_n(&s_u64MaxQueuedBytes, __ATOMIC_RELAXED);
+    pstLimit->u32MaxConns = __atomic_load_n(&s_u32MaxConns, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&s_admissionMutex);
+}
+
+void addTcpQueuedBytes(int64_t i64Bytes)
+{
+    __atomic_add_fetch(&s_i64QueuedBytes, i64Bytes, __ATOMIC_RELAXED);
+}
+
+uint64_t getTcpQueuedBytes(void)
+{
+    int64_t i64Bytes = __atomic_load_n(&s_i64QueuedBytes, __ATOMIC_RELAXED);
+
+    return i64Bytes > 0 ? (uint64_t)i64Bytes : 0; /**< 넣기 전에 꺼낸 쪽이 먼저 빼면 잠깐 음수일 수 있습니다. */
+}
+
+void addTcpAdmittedConns(int32_t i32Conns)
+{
+    __atomic_add_fetch(&s_i32Conns, i32Conns, __ATOMIC_RELAXED);
+}
+
+uint32_t getTcpAdmittedConns(void)
+{
+    int32_t i32Conns = __atomic_load_n(&s_i32Conns, __ATOMIC_RELAXED);
+
+    return i32Conns > 0 ? (uint32_t)i32Conns : 0;
+}
+
+void recordTcpLoopLag(uint64_t u64LagNs)
+{
+    uint64_t u64Cur = __atomic_load_n(&s_u64LagNs, __ATOMIC_RELAXED);
+
+    if (u64LagNs < u64Cur) {
+        u64LagNs = u64Cur - (u64Cur - u64LagNs + 3) / 4; /**< 올림하여 결국 표본 값에 닿게 합니다. */
+    }
+    __atomic_store_n(&s_u64LagNs, u64LagNs, __ATOMIC_RELAXED);
+}
+
+uint64_t getTcpLoopLag(void)
+{
+    return __atomic_load_n(&s_u64LagNs, __ATOMIC_RELAXED);
+}
+
+static void *runTcpLagMonitor(void *arg)
+{
+    uint64_t u64IntervalNs = (uint64_t)(uintptr_t)arg * 1000000ULL;
+    struct timespec stSleep;
+
+    stSleep.tv_sec = (time_t)(u64IntervalNs / 1000000000ULL);
+    stSleep.tv_nsec = (long)(u64IntervalNs % 1000000000ULL);
+    while (1) {
+        uint64_t u64StartNs = getTcpMonotonicNs();
+
+        while (nanosleep(&stSleep, NULL) < 0 && errno == EINTR) {
+        }
+        uint64_t u64ElapsedNs = getTcpMonotonicNs() - u64StartNs;
+        recordTcpLoopLag(u64ElapsedNs > u64IntervalNs ? u64ElapsedNs - u64IntervalNs : 0);
+    }
+    return NULL;
+}
+
+int startTcpLagMonitor(uint32_t u32IntervalMs)
+{
+    pthread_t threadId;
+
+    if (pthread_create(&threadId, NULL, runTcpLagMonitor, (void *)(uintptr_t)u32IntervalMs) != 0) {
+        return -1;
+    }
+    pthread_detach(threadId);
+    return 0;
+}
+
+void setTcpDrainDeadline(uint64_t u64DeadlineNs)
+{
+    __atomic_store_n(&s_u64DrainDeadlineNs, u64DeadlineNs, __ATOMIC_RELEASE);
+}
+
+uint64_t getTcpDrainDeadline(void)
+{
+    return __atomic_load_n(&s_u64DrainDeadlineNs, __ATOMIC_ACQUIRE);
+}
+
+bool isTcpDraining(void)
+{
+    return getTcpDrainDeadline() != 0;
+}
+
+TCP_BUSY_REASON admitTcpRequest(void)
+{
+    uint64_t u64MaxLagNs = __atomic_load_n(&s_u64MaxLagNs, __ATOMIC_RELAXED);
+    uint64_t u64MaxQueuedBytes = __atomic_load_n(&s_u64MaxQueuedBytes, __ATOMIC_RELAXED);
+
+    if (isTcpDraining()) {
+        return TCP_BUSY_DRAINING;
+    }
+    if (u64MaxLagNs > 0 && getTcpLoopLag() > u64MaxLagNs) {
+        return TCP_BUSY_LAG;
+    }
+    if (u64MaxQueuedBytes > 0 && getTcpQueuedBytes() > u64MaxQueuedBytes) {
+        return TCP_BUSY_QUEUED;
+    }
+    return TCP_BUSY_NONE;
+}
+
+TCP_BUSY_REASON admitTcpConnection(void)
+{
+    uint32_t u32MaxConns = __atomic_load_n(&s_u32MaxConns, __ATOMIC_RELAXED);
+
+    if (isTcpDraining()) {
+        return TCP_BUSY_DRAINING;
+    }
+    if (u32MaxConns > 0 && getTcpAdmittedConns() >= u32MaxConns) {
+        return TCP_BUSY_CONNS;
+    }
+    return admitTcpRequest();
+}
+
+const char *getTcpBusyReasonName(TCP_BUSY_REASON eReason)
+{
+    switch (eReason) {
+    case TCP_BUSY_LAG:
+        return "lag";
+    case TCP_BUSY_QUEUED:
+        return "queued";
+    case TCP_BUSY_CONNS:
+        return "conns";
+    case TCP_BUSY_DRAINING:
+        return "draining";
+    default:
+        return "none";
+    }
+}
@@ -0,0 +1,40 @@
+/**
+ * @file tcpBudget.c
+ * @brief 연결별 read 예산 (차례당 처리량 크레딧) API
+ *
+ * 수신 스레드가 한 번 읽은 데이터를 끝까지 처리하면, CPU가 적은 서버에서는 소켓 버퍼를 가득 채우는 연결의 스레드가
+ * 그동안 CPU를 붙잡고 다른 연결의 스레드는 기다립니다. 차례마다 바이트 예산(과 최대 프레임 수)만큼만 처리하고
+ * CPU를 내놓으면 그 사이에 다른 연결의 스레드가 돌 수 있습니다. 남은 크레딧은 deficit round robin처럼
+ * 다음 차례로 이어지므로 예산보다 큰 프레임도 굶지 않습니다. 연결 사이의 순서는 커널 스케줄러가 정합니다.
+ *
+ * 주요 기능:
+ * - 연결별 크레딧 (차례 시작, 프레임 처리 가능 여부, 크레딧 초기화)
+ *
+ * @date 2026-10-16
+ */
+#include "tcpBudget.h"
+
+void startTcpReadTurn(TCP_READ_CREDIT *pstCredit, const TCP_READ_BUDGET *kpstBudget)
+{
+    pstCredit->i64Deficit += kpstBudget->u32Bytes;
+    pstCredit->u32Frames = kpstBudget->u32Frames;
+    pstCredit->bFrameLimited = kpstBudget->u32Frames > 0;
+}
+
+bool takeTcpReadCredit(TCP_READ_CREDIT *pstCredit, uint32_t u32Bytes)
+{
+    if ((int64_t)u32Bytes > pstCredit->i64Deficit || (pstCredit->bFrameLimited && pstCredit->u32Frames == 0)) {
+        return false;
+    }
+    pstCredit->i64Deficit -= u32Bytes;
+    if (pstCredit->bFrameLimited) {
+        pstCredit->u32Frames--;
+    }
+    return true;
+}
+
+void resetTcpReadCredit(TCP_READ_CREDIT *pstCredit)
+{
+    pstCredit->i64Deficit = 0;
+    pstCredit->u32Frames = 0;
+}
@@ -0,0 +1,267 @@
+/**
+ * @file tcpFrame.c
+ * @brief README의 PACKET Format 프레임 인코딩/디코딩 API
+ *
+ * 서버와 클라이언트가 주고받는 프레임을 만들고 해석합니다.
+ * TCP 스트림에서 프레임 경계를 찾기 위해 매직 값과 Data Length를 사용하며,
+ * CRC-16/CCITT-FALSE로 프레임 손상을 검출합니다.
+ *
+ * 주요 기능:
+ * - 테이블 기반 CRC-16/CCITT-FALSE 계산
+ * - 프레임 인코딩 (Correlation ID 포함, 협상된 연결의 LZ4 압축)
+ * - 스트림 버퍼에서 프레임 디코딩 및 재동기화
+ * - 덜 온 프레임을 완성하는 데 필요한 바이트 수 계산 (SO_RCVLOWAT용)
+ * - Instruction별 우선순위 등급
+ *
+ * @date 2024-12-18
+ */
+#include "tcpFrame.h"
+#include "tcpLz4.h"
+
+#include <string.h>
+
+#define TCP_FRAME_MAGIC_HI ((uint8_t)(TCP_FRAME_MAGIC >> 8))
+#define TCP_FRAME_MAGIC_LO ((uint8_t)(TCP_FRAME_MAGIC & 0xFF))
+
+/**
+ * @brief CRC-16/CCITT-FALSE (다항식 0x1021) 바이트 단위 테이블
+ */
+static uint16_t s_au16CrcTable[256];
+static int s_iCrcTableReady = 0;
+
+static void initTcpFrameCrcTable(void)
+{
+    for (int i = 0; i < 256; i++) {
+        uint16_t u16Crc = (uint16_t)(i << 8);
+        for (int j = 0; j < 8; j++) {
+            u16Crc = (u16Crc & 0x8000) ? (uint16_t)((u16Crc << 1) ^ 0x1021) : (uint16_t)(u16Crc << 1);
+        }
+        s_au16CrcTable[i] = u16Crc;
+    }
+    __atomic_store_n(&s_iCrcTableReady, 1, __ATOMIC_RELEASE);
+}
+
+uint16_t calcTcpFrameCrc(const uint8_t *kpu8Data, size_t uiLen, uint16_t u16Crc)
+{
+    /**< 여러 스레드가 동시에 초기화해도 같은 값을 쓰므로 안전합니다. */
+    if (!__atomic_load_n(&s_iCrcTableReady, __ATOMIC_ACQUIRE)) {
+        initTcpFrameCrcTable();
+    }
+
+    for (size_t i = 0; i < uiLen; i++) {
+        u16Crc = (uint16_t)((u16Crc << 8) ^ s_au16CrcTable[((u16Crc >> 8) ^ kpu8Data[i]) & 0xFF]);
+    }
+
+    return u16Crc;
+}
+
+/**
+ * @brief 헤더와 CRC를 채웁니다. DATA는 pu8Out + TCP_FRAME_HEADER_SIZE에 이미 있어야 합니다.
+ */
+static int finishTcpFrame(uint8_t *pu8Out, uint8_t u8Flags, uint8_t u8ClientId, uint8_t u8Instruction, size_t uiDataLen)
+{
+    pu8Out[0] = TCP_FRAME_MAGIC_HI;
+    pu8Out[1] = TCP_FRAME_MAGIC_LO;
+    pu8Out[2] = TCP_FRAME_VERSION;
+    pu8Out[3] = u8Flags;
+    pu8Out[4] = u8ClientId;
+    pu8Out[5] = u8Instruction;
+    pu8Out[6] = (uint8_t)(uiDataLen >> 8);
+    pu8Out[7] = (uint8_t)(uiDataLen & 0xFF);
+
+    uint16_t u16Crc = calcTcpFrameCrc(pu8Out, TCP_FRAME_HEADER_SIZE + uiDataLen, 0xFFFF);
+    pu8Out[TCP_FRAME_HEADER_SIZE + uiDataLen] = (uint8_t)(u16Crc >> 8);
+    pu8Out[TCP_FRAME_HEADER_SIZE + uiDataLen + 1] = (uint8_t)(u16Crc & 0xFF);
+
+    return (int)(TCP_FRAME_HEADER_SIZE + uiDataLen + TCP_FRAME_CRC_SIZE);
+}
+
+int encodeTcpFrame(uint8_t *pu8Out, size_t uiOutSize, uint8_t u8ClientId, uint8_t u8Instruction,
+                   const void *kpvData, size_t uiDataLen)
+{
+    size_t uiFrameLen = TCP_FRAME_HEADER_SIZE + uiDataLen + TCP_FRAME_CRC_SIZE;
+
+    if (uiDataLen > TCP_FRAME_MAX_DATA || uiOutSize < uiFrameLen) {
+        return -1;
+    }
+
+    if (uiDataLen > 0) {
+        memmove(pu8Out + TCP_FRAME_HEADER_SIZE, kpvData, uiDataLen);
+    }
+    return finishTcpFrame(pu8Out, 0, u8ClientId, u8Instruction, uiDataLen);
+}
+
+int encodeTcpCorrFrame(uint8_t *pu8Out, size_t uiOutSize, uint8_t u8ClientId, uint8_t u8Instruction,
+                       uint32_t u32CorrId, const void *kpvData, size_t uiDataLen)
+{
+    size_t uiFullLen = TCP_FRAME_CORR_ID_SIZE + uiDataLen;
+    uint8_t *pu8Id = pu8Out + TCP_FRAME_HEADER_SIZE;
+
+    if (uiFullLen > TCP_FRAME_MAX_DATA || uiOutSize < TCP_FRAME_HEADER_SIZE + uiFullLen + TCP_FRAME_CRC_SIZE) {
+        return -1;
+    }
+
+    if (uiDataLen > 0) {
+        memmove(pu8Id + TCP_FRAME_CORR_ID_SIZE, kpvData, uiDataLen);
+    }
+    pu8Id[0] = (uint8_t)(u32CorrId >> 24);
+    pu8Id[1] = (uint8_t)(u32CorrId >> 16);
+    pu8Id[2] = (uint8_t)(u32CorrId >> 8);
+    pu8Id[3] = (uint8_t)(u32CorrId & 0xFF);
+    return finishTcpFrame(pu8Out, TCP_FRAME_FLAG_CORR_ID, u8ClientId, u8Instruction, uiFullLen);
+}
+
+int encodeTcpLz4Frame(uint8_t *pu8Out, size_t uiOutSize, uint8_t u8ClientId, uint8_t u8Instruction,
+                      const void *kpvData, size_t uiDataLen, size_t uiThreshold)
+{
+    if (uiDataLen >= uiThreshold && uiDataLen > TCP_FRAME_LZ4_LEN_SIZE + 1 && uiDataLen <= TCP_FRAME_MAX_DATA
+        && uiOutSize >= TCP_FRAME_HEADER_SIZE + uiDataLen + TCP_FRAME_CRC_SIZE) {
+        uint8_t *pu8Data = pu8Out + TCP_FRAME_HEADER_SIZE;
+        /**< 길이 필드를 더해도 원본보다 짧아야 하므로, 그보다 길어지면 압축을 멈추고 그대로 보냅니다. */
+        int iPackedLen = compressTcpLz4((const uint8_t *)kpvData, uiDataLen, pu8Data + TCP_FRAME_LZ4_LEN_SIZE,
+                                        uiDataLen - TCP_FRAME_LZ4_LEN_SIZE - 1);
+
+        if (iPackedLen > 0) {
+            pu8Data[0] = (uint8_t)(uiDataLen >> 8);
+            pu8Data[1] = (uint8_t)(uiDataLen & 0xFF);
+            return finishTcpFrame(pu8Out, TCP_FRAME_FLAG_LZ4, u8ClientId, u8Instruction,
+                                  TCP_FRAME_LZ4_LEN_SIZE + (size_t)iPackedLen);
+        }
+    }
+    return encodeTcpFrame(pu8Out, uiOutSize, u8ClientId, u8Instruction, kpvData, uiDataLen);
+}
+
+int getTcpFramePlainData(const TCP_FRAME_HEADER *kpstHeader, const uint8_t *kpu8Data, uint8_t *pu8Scratch,
+                         size_t uiScratchSize, const uint8_t **ppu8Plain)
+{
+    size_t uiPlainLen;
+
+    if (!(kpstHeader->u8Flags & TCP_FRAME_FLAG_LZ4)) {
+        *ppu8Plain = kpu8Data;
+        return (int)kpstHeader->u16DataLen;
+    }
+    if (kpstHeader->u16DataLen <= TCP_FRAME_LZ4_LEN_SIZE) {
+        return -1;
+    }
+
+    uiPlainLen = ((size_t)kpu8Data[0] << 8) | kpu8Data[1];
+    if (uiPlainLen > uiScratchSize
+        || decompressTcpLz4(kpu8Data + TCP_FRAME_LZ4_LEN_SIZE, kpstHeader->u16DataLen - TCP_FRAME_LZ4_LEN_SIZE,
+                            pu8Scratch, uiPlainLen) != (int)uiPlainLen) {
+        return -1;
+    }
+    *ppu8Plain = pu8Scratch;
+    return (int)uiPlainLen;
+}
+
+bool getTcpFrameCorrId(const TCP_FRAME_HEADER *kpstHeader, const uint8_t *kpu8Data, uint32_t *pu32CorrId)
+{
+    if (!(kpstHeader->u8Flags & TCP_FRAME_FLAG_CORR_ID) || kpstHeader->u16DataLen < TCP_FRAME_CORR_ID_SIZE) {
+        return false;
+    }
+
+    *pu32CorrId = ((uint32_t)kpu8Data[0] << 24) | ((uint32_t)kpu8Data[1] << 16) |
+                  ((uint32_t)kpu8Data[2] << 8) | kpu8Data[3];
+    return true;
+}
+
+int peekTcpFrame(const uint8_t *kpu8Buf, size_t uiLen, TCP_FRAME_HEADER *pstHeader)
+{
+    if (uiLen < TCP_FRAME_HEADER_SIZE) {
+        /**< 헤더가 다 오지 않았어도 이미 온 매직 바이트가 틀리면 바로 오류로 처리 */
+        if ((uiLen >= 1 && kpu8Buf[0] != TCP_FRAME_MAGIC_HI) || (uiLen >= 2 && kpu8Buf[1] != TCP_FRAME_MAGIC_LO)) {
+            return -1;
+        }
+        return 0;
+    }
+
+    if (kpu8Buf[0] != TCP_FRAME_MAGIC_HI || kpu8Buf[1] != TCP_FRAME_MAGIC_LO || kpu8Buf[2] != TCP_FRAME_VERSION) {
+        return -1;
+    }
+
+    size_t uiDataLen = ((size_t)kpu8Buf[6] << 8) | kpu8Buf[7];
+    size_t uiFrameLen = TCP_FRAME_HEADER_SIZE + uiDataLen + TCP_FRAME_CRC_SIZE;
+    if (uiLen < uiFrameLen) {
+        return 0;
+    }
+
+    if (pstHeader != NULL) {
+        pstHeader->u8Version = kpu8Buf[2];
+        pstHeader->u8Flags = kpu8Buf[3];
+        pstHeader->u8ClientId = kpu8Buf[4];
+        pstHeader->u8Instruction = kpu8Buf[5];
+        pstHeader->u16DataLen = (uint16_t)uiDataLen;
+    }
+    return (int)uiFrameLen;
+}
+
+int decodeTcpFrame(const uint8_t *kpu8Buf, size_t uiLen, TCP_FRAME_HEADER *pstHeader, const uint8_t **ppu8Data)
+{
+    TCP_FRAME_HEADER stHeader;
+    int iFrameLen = peekTcpFrame(kpu8Buf, uiLen, &stHeader);
+
+    if (iFrameLen <= 0) {
+        return iFrameLen;
+    }
+
+    uint16_t u16Crc = calcTcpFrameCrc(kpu8Buf, TCP_FRAME_HEADER_SIZE + stHeader.u16DataLen, 0xFFFF);
+    uint16_t u16FrameCrc = (uint16_t)((kpu8Buf[TCP_FRAME_HEADER_SIZE + stHeader.u16DataLen] << 8) |
+                                      kpu8Buf[TCP_FRAME_HEADER_SIZE + stHeader.u16DataLen + 1]);
+    if (u16Crc != u16FrameCrc) {
+        return -1;
+    }
+
+    if (pstHeader != NULL) {
+        *pstHeader = stHeader;
+    }
+    if (ppu8Data != NULL) {
+        *ppu8Data = kpu8Buf + TCP_FRAME_HEADER_SIZE;
+    }
+
+    return iFrameLen;
+}
+
+TCP_FRAME_PRIO getTcpFramePriority(uint8_t u8Instruction)
+{
+    switch (u8Instruction) {
+    case TCP_INST_HEARTBEAT:
+    case TCP_INST_SHM_OFFER:
+    case TCP_INST_CAPS:
+    case TCP_INST_BUSY:
+    case TCP_INST_SHUTDOWN:
+        return TCP_FRAME_PRIO_CONTROL;
+    default:
+        return TCP_FRAME_PRIO_BULK;
+    }
+}
+
+size_t getTcpFrameNeededBytes(const uint8_t *kpu8Buf, size_t uiLen)
+{
+    int iFrameLen = peekTcpFrame(kpu8Buf, uiLen, NULL);
+
+    if (iFrameLen < 0) {
+        return 1;
+    }
+    if (iFrameLen > 0) {
+        return 0;
+    }
+    if (uiLen < TCP_FRAME_HEADER_SIZE) {
+        return TCP_FRAME_HEADER_SIZE + TCP_FRAME_CRC_SIZE - uiLen;
+    }
+    return TCP_FRAME_HEADER_SIZE + (((size_t)kpu8Buf[6] << 8) | kpu8Buf[7]) + TCP_FRAME_CRC_SIZE - uiLen;
+}
+
+size_t findTcpFrameStart(const uint8_t *kpu8Buf, size_t uiLen)
+{
+    /**< 현재 위치는 잘못된 프레임이므로 1바이트 뒤부터 찾습니다. */
+    for (size_t i = 1; i + 1 < uiLen; i++) {
+        if (kpu8Buf[i] == TCP_FRAME_MAGIC_HI && kpu8Buf[i + 1] == TCP_FRAME_MAGIC_LO) {
+            return i;
+        }
+    }
+
+    if (uiLen >= 2 && kpu8Buf[uiLen - 1] == TCP_FRAME_MAGIC_HI) {
+        return uiLen - 1;
+    }
+    return uiLen;
+}
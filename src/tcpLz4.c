@@ -0,0 +1,219 @@
+/**
+ * @file tcpLz4.c
+ * @brief 프레임 DATA 압축을 위한 LZ4 블록 형식 압축/해제 API
+ *
+ * 한 시퀀스는 [토큰 | 리터럴 길이 추가 바이트 | 리터럴 | 거리(2, 리틀엔디언) | 매치 길이 추가 바이트] 이며,
+ * 토큰의 상위 4비트는 리터럴 길이, 하위 4비트는 (매치 길이 - 4) 입니다. 15이면 255 미만 바이트가 나올 때까지 더합니다.
+ * 마지막 시퀀스는 리터럴만 있으며, 표준 구현과 맞추기 위해 마지막 5바이트는 항상 리터럴로 두고
+ * 마지막 매치는 끝에서 12바이트 앞보다 먼저 시작합니다.
+ *
+ * 주요 기능:
+ * - 해시 한 단계 탐욕 매칭 압축 (압축되지 않는 구간은 점점 건너뛰며 탐색)
+ * - 경계를 모두 검사하는 압축 해제
+ *
+ * @date 2026-10-16
+ */
+#include "tcpLz4.h"
+
+#include <string.h>
+#include <stdbool.h>
+
+#define TCP_LZ4_MIN_MATCH 4             /**< 최소 매치 길이 */
+#define TCP_LZ4_LAST_LITERALS 5         /**< 블록 끝에 항상 리터럴로 두는 바이트 수 */
+#define TCP_LZ4_MF_LIMIT 12             /**< 마지막 매치가 시작할 수 있는 끝에서의 최소 거리 */
+#define TCP_LZ4_HASH_BITS 12            /**< 해시 테이블 크기 (2^비트, 항목당 2바이트) */
+#define TCP_LZ4_SKIP_SHIFT 6            /**< 매치가 없을 때 탐색 간격을 늘리는 속도 */
+#define TCP_LZ4_RUN_MASK 15             /**< 토큰 길이 필드 최대 값 */
+
+static uint32_t readTcpLz4U32(const uint8_t *kpu8Src)
+{
+    uint32_t u32Value;
+
+    memcpy(&u32Value, kpu8Src, sizeof(u32Value));
+    return u32Value;
+}
+
+static uint32_t hashTcpLz4(uint32_t u32Seq)
+{
+    return (u32Seq * 2654435761u) >> (32 - TCP_LZ4_HASH_BITS);
+}
+
+/**
+ * @brief 토큰에 다 들어가지 않는 길이(15 이상)의 나머지를 씁니다.
+ */
+static uint8_t *writeTcpLz4Length(uint8_t *pu8Out, size_t uiLen)
+{
+    while (uiLen >= 255) {
+        *pu8Out++ = 255;
+        uiLen -= 255;
+    }
+    *pu8Out++ = (uint8_t)uiLen;
+    return pu8Out;
+}
+
+/**
+ * @brief 시퀀스 하나(리터럴 + 선택적 매치)를 씁니다.
+ * @return 다음 쓸 위치. 버퍼가 모자라면 NULL
+ */
+static uint8_t *writeTcpLz4Sequence(uint8_t *pu8Out, const uint8_t *kpu8OutEnd, const uint8_t *kpu8Literal,
+                                    size_t uiLiteralLen, size_t uiOffset, size_t uiMatchLen)
+{
+    size_t uiNeed = 1 + uiLiteralLen / 255 + 1 + uiLiteralLen + (uiOffset > 0 ? 2 + uiMatchLen / 255 + 1 : 0);
+    uint8_t *pu8Token = pu8Out;
+
+    if ((size_t)(kpu8OutEnd - pu8Out) < uiNeed) {
+        return NULL;
+    }
+
+    pu8Out++;
+    *pu8Token = (uint8_t)((uiLiteralLen >= TCP_LZ4_RUN_MASK ? TCP_LZ4_RUN_MASK : uiLiteralLen) << 4);
+    if (uiLiteralLen >= TCP_LZ4_RUN_MASK) {
+        pu8Out = writeTcpLz4Length(pu8Out, uiLiteralLen - TCP_LZ4_RUN_MASK);
+    }
+    memcpy(pu8Out, kpu8Literal, uiLiteralLen);
+    pu8Out += uiLiteralLen;
+
+    if (uiOffset > 0) {
+        *pu8Out++ = (uint8_t)(uiOffset & 0xFF);
+        *pu8Out++ = (uint8_t)(uiOffset >> 8);
+        *pu8Token |= (uint8_t)(uiMatchLen >= TCP_LZ4_RUN_MASK ? TCP_LZ4_RUN_MASK : uiMatchLen);
+        if (uiMatchLen >= TCP_LZ4_RUN_MASK) {
+            pu8Out = writeTcpLz4Length(pu8Out, uiMatchLen - TCP_LZ4_RUN_MASK);
+        }
+    }
+    return pu8Out;
+}
+
+int compressTcpLz4(const uint8_t *kpu8Src, size_t uiSrcLen, uint8_t *pu8Dst, size_t uiDstCap)
+{
+    const uint8_t *kpu8End = kpu8Src + uiSrcLen;
+    const uint8_t *kpu8Anchor = kpu8Src;
+    const uint8_t *kpu8OutEnd = pu8Dst + uiDstCap;
+    uint8_t *pu8Out = pu8Dst;
+
+    if (uiSrcLen > TCP_LZ4_MAX_INPUT) {
+        return -1;
+    }
+
+    if (uiSrcLen > TCP_LZ4_MF_LIMIT) {
+        uint16_t au16Table[1 << TCP_LZ4_HASH_BITS]; /**< 해시 → 원본 위치. 입력이 64KB 미만이라 2바이트로 충분합니다. */
+        const uint8_t *kpu8MatchLimit = kpu8End - TCP_LZ4_LAST_LITERALS;
+        const uint8_t *kpu8MfLimit = kpu8End - TCP_LZ4_MF_LIMIT;
+        const uint8_t *kpu8In = kpu8Src + 1;
+
+        memset(au16Table, 0, sizeof(au16Table)); /**< 0은 원본 첫 위치이며, 후보는 항상 바이트를 비교하여 확인합니다. */
+        while (kpu8In <= kpu8MfLimit) {
+            uint32_t u32Seq = readTcpLz4U32(kpu8In);
+            uint32_t u32Hash = hashTcpLz4(u32Seq);
+            const uint8_t *kpu8Ref = kpu8Src + au16Table[u32Hash];
+
+            au16Table[u32Hash] = (uint16_t)(kpu8In - kpu8Src);
+            if (kpu8Ref >= kpu8In || readTcpLz4U32(kpu8Ref) != u32Seq) {
+                kpu8In += 1 + ((size_t)(kpu8In - kpu8Anchor) >> TCP_LZ4_SKIP_SHIFT);
+                continue;
+            }
+
+            /**< 매치를 앞뒤로 늘립니다. */
+            while (kpu8In > kpu8Anchor && kpu8Ref > kpu8Src && kpu8In[-1] == kpu8Ref[-1]) {
+                kpu8In--;
+                kpu8Ref--;
+            }
+            const uint8_t *kpu8MatchEnd = kpu8In + TCP_LZ4_MIN_MATCH;
+            const uint8_t *kpu8RefEnd = kpu8Ref + TCP_LZ4_MIN_MATCH;
+            while (kpu8MatchEnd < kpu8MatchLimit && *kpu8MatchEnd == *kpu8RefEnd) {
+                kpu8MatchEnd++;
+                kpu8RefEnd++;
+            }
+
+            pu8Out = writeTcpLz4Sequence(pu8Out, kpu8OutEnd, kpu8Anchor, (size_t)(kpu8In - kpu8Anchor),
+                                         (size_t)(kpu8In - kpu8Ref),
+                                         (size_t)(kpu8MatchEnd - kpu8In) - TCP_LZ4_MIN_MATCH);
+            if (pu8Out == NULL) {
+                return 0;
+            }
+            kpu8In = kpu8MatchEnd;
+            kpu8Anchor = kpu8In;
+            au16Table[hashTcpLz4(readTcpLz4U32(kpu8In - 2))] = (uint16_t)(kpu8In - 2 - kpu8Src);
+        }
+    }
+
+    pu8Out = writeTcpLz4Sequence(pu8Out, kpu8OutEnd, kpu8Anchor, (size_t)(kpu8End - kpu8Anchor), 0, 0);
+    if (pu8Out == NULL) {
+        return 0;
+    }
+    return (int)(pu8Out - pu8Dst);
+}
+
+/**
+ * @brief 토큰 뒤의 추가 길이 바이트를 읽습니다.
+ * @return 성공 시 true, 입력이 끝나면 false
+ */
+static bool readTcpLz4Length(const uint8_t **ppu8In, const uint8_t *kpu8InEnd, size_t *puiLen)
+{
+    uint8_t u8Byte;
+
+    do {
+        if (*ppu8In >= kpu8InEnd) {
+            return false;
+        }
+        u8Byte = *(*ppu8In)++;
+        *puiLen += u8Byte;
+    } while (u8Byte == 255);
+    return true;
+}
+
+int decompressTcpLz4(const uint8_t *kpu8Src, size_t uiSrcLen, uint8_t *pu8Dst, size_t uiDstCap)
+{
+    const uint8_t *kpu8In = kpu8Src;
+    const uint8_t *kpu8InEnd = kpu8Src + uiSrcLen;
+    uint8_t *pu8Out = pu8Dst;
+    uint8_t *pu8OutEnd = pu8Dst + uiDstCap;
+
+    while (kpu8In < kpu8InEnd) {
+        uint8_t u8Token = *kpu8In++;
+        size_t uiLiteralLen = u8Token >> 4;
+        size_t uiMatchLen = u8Token & TCP_LZ4_RUN_MASK;
+        size_t uiOffset;
+
+        if (uiLiteralLen == TCP_LZ4_RUN_MASK && !readTcpLz4Length(&kpu8In, kpu8InEnd, &uiLiteralLen)) {
+            return -1;
+        }
+        if ((size_t)(kpu8InEnd - kpu8In) < uiLiteralLen || (size_t)(pu8OutEnd - pu8Out) < uiLiteralLen) {
+            return -1;
+        }
+        memcpy(pu8Out, kpu8In, uiLiteralLen);
+        pu8Out += uiLiteralLen;
+        kpu8In += uiLiteralLen;
+        if (kpu8In == kpu8InEnd) {
+            return (int)(pu8Out - pu8Dst); /**< 마지막 시퀀스는 리터럴만 있습니다. */
+        }
+
+        if (kpu8InEnd - kpu8In < 2) {
+            return -1;
+        }
+        uiOffset = (size_t)kpu8In[0] | ((size_t)kpu8In[1] << 8);
+        kpu8In += 2;
+        if (uiOffset == 0 || uiOffset > (size_t)(pu8Out - pu8Dst)) {
+            return -1;
+        }
+        if (uiMatchLen == TCP_LZ4_RUN_MASK && !readTcpLz4Length(&kpu8In, kpu8InEnd, &uiMatchLen)) {
+            return -1;
+        }
+        uiMatchLen += TCP_LZ4_MIN_MATCH;
+        if ((size_t)(pu8OutEnd - pu8Out) < uiMatchLen) {
+            return -1;
+        }
+
+        const uint8_t *kpu8Ref = pu8Out - uiOffset;
+        if (uiOffset >= uiMatchLen) {
+            memcpy(pu8Out, kpu8Ref, uiMatchLen);
+            pu8Out += uiMatchLen;
+        } else {
+            /**< 거리가 매치보다 짧으면 방금 쓴 바이트를 반복하므로 한 바이트씩 복사합니다. */
+            for (size_t i = 0; i < uiMatchLen; i++) {
+                *pu8Out++ = *kpu8Ref++;
+            }
+        }
+    }
+    return -1; /**< 빈 입력이거나 매치로 끝남 */
+}
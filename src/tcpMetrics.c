@@ -0,0 +1,461 @@
+/**
+ * @file tcpMetrics.c
+ * @brief 서버 동작 상태를 수집하는 카운터와 지연 히스토그램 API
+ *
+ * 카운터와 히스토그램은 스레드별 샤드에 기록되고, 읽을 때 모든 샤드를 합산합니다.
+ * 샤드는 해당 스레드만 갱신하므로 기록 경로에서는 공유 원자 연산(lock 접두어)이나 잠금이 없습니다.
+ * 읽는 쪽과의 경합은 relaxed 원자 load/store 로만 처리합니다.
+ *
+ * 주요 기능:
+ * - 스레드별 카운터 증가 및 연결별 카운터 증가
+ * - HDR 방식(로그-선형 버킷) 지연 히스토그램 기록 및 백분위 계산
+ * - 모든 스레드의 메트릭 합산 스냅샷
+ * - 관리 인터페이스가 잠금 없이 조회하는 연결 테이블
+ * - 연결 해제와 겹치지 않는 다른 스레드의 연결 소켓 사용
+ * - 연결별 TCP_INFO 게이지
+ *
+ * @date 2024-12-16
+ */
+#include "tcpMetrics.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief 스레드별 메트릭 샤드
+ */
+typedef struct TCP_METRICS_SHARD {
+    uint64_t au64Counter[TCP_METRIC_COUNT];     /**< 스레드 카운터 */
+    TCP_HISTOGRAM *apstHist[TCP_HIST_COUNT];    /**< 처음 기록할 때 할당되는 히스토그램 */
+    struct TCP_METRICS_SHARD *pstNext;          /**< 등록된 샤드 목록 링크 */
+} TCP_METRICS_SHARD;
+
+/**
+ * @brief 샤드 등록/해제와 스냅샷에서만 사용하는 뮤텍스. 기록 경로에서는 사용하지 않습니다.
+ */
+static pthread_mutex_t s_registryMutex = PTHREAD_MUTEX_INITIALIZER;
+static TCP_METRICS_SHARD *s_pstShardList = NULL;
+static uint64_t s_au64RetiredCounter[TCP_METRIC_COUNT];    /**< 종료된 스레드의 카운터 합계 */
+static TCP_HISTOGRAM s_astRetiredHist[TCP_HIST_COUNT];      /**< 종료된 스레드의 히스토그램 합계 */
+
+static TCP_CONN_METRICS *s_apstConnTable[TCP_CONN_TABLE_SIZE]; /**< 등록된 연결 (잠금 없이 조회) */
+/**
+ * @brief 연결 식별 정보(연결 ID, 소켓)를 바꾸는 등록/해제와 다른 스레드의 소켓 사용을 직렬화하는 뮤텍스.
+ *        메시지 경로에서는 사용하지 않습니다.
+ */
+static pthread_mutex_t s_connSockMutex = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t s_u64NextConnId = 1;
+
+static const char *s_kapchMetricName[TCP_METRIC_COUNT] = {
+    "bytes_in", "bytes_out", "messages_in", "messages_out",
+    "enqueued", "dequeued", "drops", "accepts", "disconnects", "frame_errors",
+    "reconnect_attempts", "reconnects", "compressed_in",
+    "throttles", "rejects", "shed", "shutdowns", "drain_timeouts",
+    "accept_errors", "buffer_tunes", "send_waits", "reads"
+};
+
+static const char *s_kapchHistName[TCP_HIST_COUNT] = {
+    "recv_to_send_latency", "reconnect_latency",
+    "tcp_rtt", "tcp_busy", "tcp_rwnd_limited", "tcp_sndbuf_limited"
+};
+
+static const char *s_kapchGaugeName[TCP_GAUGE_COUNT] = {
+    "rtt_us", "rttvar_us", "retrans", "cwnd", "unacked", "delivery_rate",
+    "busy_us", "rwnd_limited_us", "sndbuf_limited_us"
+};
+
+static pthread_key_t s_shardKey;
+static pthread_once_t s_shardKeyOnce = PTHREAD_ONCE_INIT;
+static __thread TCP_METRICS_SHARD *s_pstThreadShard = NULL;
+
+/**
+ * @brief 소유 스레드만 갱신하는 값을 더합니다. 읽는 쪽이 찢어진 값을 보지 않도록 relaxed store를 사용합니다.
+ */
+static inline void addOwnedCounter(uint64_t *pu64Counter, uint64_t u64Value)
+{
+    __atomic_store_n(pu64Counter, __atomic_load_n(pu64Counter, __ATOMIC_RELAXED) + u64Value, __ATOMIC_RELAXED);
+}
+
+static int getTcpHistogramIndex(uint64_t u64Value)
+{
+    if (u64Value < (1ULL << TCP_HIST_SUB_BITS)) {
+        return (int)u64Value;
+    }
+
+    int iMsb = 63 - __builtin_clzll(u64Value);
+    if (iMsb >= TCP_HIST_MAX_BITS) {
+        return TCP_HIST_BUCKETS - 1;
+    }
+
+    int iShift = iMsb - TCP_HIST_SUB_BITS;
+    return ((iShift + 1) << TCP_HIST_SUB_BITS) + (int)((u64Value >> iShift) - (1ULL << TCP_HIST_SUB_BITS));
+}
+
+uint64_t getTcpHistogramBucketMax(int iIndex)
+{
+    if (iIndex < (1 << TCP_HIST_SUB_BITS)) {
+        return (uint64_t)iIndex;
+    }
+
+    int iShift = (iIndex >> TCP_HIST_SUB_BITS) - 1;
+    uint64_t u64Top = (uint64_t)(iIndex & ((1 << TCP_HIST_SUB_BITS) - 1)) + (1ULL << TCP_HIST_SUB_BITS);
+    return ((u64Top + 1) << iShift) - 1;
+}
+
+/**
+ * @brief 샤드를 종료 합계에 병합하고 목록에서 제거합니다. 스레드 종료 시 pthread 키 소멸자로 호출됩니다.
+ */
+static void retireTcpMetricsShard(void *pvShard)
+{
+    TCP_METRICS_SHARD *pstShard = (TCP_METRICS_SHARD *)pvShard;
+
+    pthread_mutex_lock(&s_registryMutex);
+    for (int i = 0; i < TCP_METRIC_COUNT; i++) {
+        s_au64RetiredCounter[i] += pstShard->au64Counter[i];
+    }
+    for (int i = 0; i < TCP_HIST_COUNT; i++) {
+        if (pstShard->apstHist[i] != NULL) {
+            mergeTcpHistogram(&s_astRetiredHist[i], pstShard->apstHist[i]);
+        }
+    }
+
+    TCP_METRICS_SHARD **ppstLink = &s_pstShardList;
+    while (*ppstLink != NULL && *ppstLink != pstShard) {
+        ppstLink = &(*ppstLink)->pstNext;
+    }
+    if (*ppstLink != NULL) {
+        *ppstLink = pstShard->pstNext;
+    }
+    pthread_mutex_unlock(&s_registryMutex);
+
+    for (int i = 0; i < TCP_HIST_COUNT; i++) {
+        free(pstShard->apstHist[i]);
+    }
+    free(pstShard);
+    s_pstThreadShard = NULL;
+}
+
+static void createTcpMetricsShardKey(void)
+{
+    pthread_key_create(&s_shardKey, retireTcpMetricsShard);
+}
+
+/**
+ * @brief 현재 스레드의 샤드를 반환합니다. 처음 호출될 때 샤드를 할당하고 등록합니다.
+ */
+static TCP_METRICS_SHARD *getTcpMetricsShard(void)
+{
+    if (s_pstThreadShard != NULL) {
+        return s_pstThreadShard;
+    }
+
+    TCP_METRICS_SHARD *pstShard = (TCP_METRICS_SHARD *)calloc(1, sizeof(TCP_METRICS_SHARD));
+    if (pstShard == NULL) {
+        return NULL;
+    }
+
+    pthread_once(&s_shardKeyOnce, createTcpMetricsShardKey);
+    pthread_setspecific(s_shardKey, pstShard);
+
+    pthread_mutex_lock(&s_registryMutex);
+    pstShard->pstNext = s_pstShardList;
+    s_pstShardList = pstShard;
+    pthread_mutex_unlock(&s_registryMutex);
+
+    s_pstThreadShard = pstShard;
+    return pstShard;
+}
+
+void addTcpMetric(TCP_METRIC_ID eId, uint64_t u64Value)
+{
+    TCP_METRICS_SHARD *pstShard = getTcpMetricsShard();
+    if (pstShard != NULL) {
+        addOwnedCounter(&pstShard->au64Counter[eId], u64Value);
+    }
+}
+
+void addTcpConnMetric(TCP_CONN_METRICS *pstConn, TCP_METRIC_ID eId, uint64_t u64Value)
+{
+    if (pstConn != NULL) {
+        addOwnedCounter(&pstConn->au64Counter[eId], u64Value);
+    }
+    addTcpMetric(eId, u64Value);
+}
+
+uint64_t getTcpConnMetric(const TCP_CONN_METRICS *kpstConn, TCP_METRIC_ID eId)
+{
+    return __atomic_load_n(&kpstConn->au64Counter[eId], __ATOMIC_RELAXED);
+}
+
+void setTcpConnGauges(TCP_CONN_METRICS *pstConn, const uint64_t *kau64Gauge, uint64_t u64SampledNs)
+{
+    for (int i = 0; i < TCP_GAUGE_COUNT; i++) {
+        __atomic_store_n(&pstConn->au64Gauge[i], kau64Gauge[i], __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&pstConn->u64SampledNs, u64SampledNs, __ATOMIC_RELEASE);
+}
+
+uint64_t getTcpConnGauges(const TCP_CONN_METRICS *kpstConn, uint64_t *pu64Gauge)
+{
+    uint64_t u64SampledNs = __atomic_load_n(&kpstConn->u64SampledNs, __ATOMIC_ACQUIRE);
+
+    for (int i = 0; i < TCP_GAUGE_COUNT; i++) {
+        pu64Gauge[i] = __atomic_load_n(&kpstConn->au64Gauge[i], __ATOMIC_RELAXED);
+    }
+    return u64SampledNs;
+}
+
+uint64_t registerTcpConnMetrics(TCP_CONN_METRICS *pstConn, int iSock, const char *kpchPeer)
+{
+    uint64_t u64ConnId;
+
+    /**< 해제 전에 포인터를 읽어 둔 스레드가 lockTcpConnSock()으로 읽는 식별 정보를 잠금 안에서 바꿉니다. */
+    pthread_mutex_lock(&s_connSockMutex);
+    memset(pstConn, 0x0, sizeof(TCP_CONN_METRICS));
+    u64ConnId = __atomic_fetch_add(&s_u64NextConnId, 1, __ATOMIC_RELAXED);
+    pstConn->u64ConnId = u64ConnId;
+    pstConn->iSock = iSock;
+    snprintf(pstConn->achPeer, sizeof(pstConn->achPeer), "%s", kpchPeer);
+    pstConn->u64ConnectedNs = getTcpMonotonicNs();
+    pthread_mutex_unlock(&s_connSockMutex);
+
+    for (int i = 0; i < TCP_CONN_TABLE_SIZE; i++) {
+        TCP_CONN_METRICS *pstExpected = NULL;
+        /**< 식별 정보를 다 채운 뒤 release로 게시 */
+        if (__atomic_compare_exchange_n(&s_apstConnTable[i], &pstExpected, pstConn, false,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+            break;
+        }
+    }
+
+    return u64ConnId;
+}
+
+void unregisterTcpConnMetrics(TCP_CONN_METRICS *pstConn)
+{
+    for (int i = 0; i < TCP_CONN_TABLE_SIZE; i++) {
+        TCP_CONN_METRICS *pstExpected = pstConn;
+        if (__atomic_compare_exchange_n(&s_apstConnTable[i], &pstExpected, (TCP_CONN_METRICS *)NULL, false,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+            break;
+        }
+    }
+
+    /**< 소켓을 쓰고 있는 스레드가 끝나기를 기다린 뒤 식별 정보를 지웁니다. 이후 소유 스레드가 소켓을 닫아도 됩니다. */
+    pthread_mutex_lock(&s_connSockMutex);
+    __atomic_store_n(&pstConn->u64ConnId, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&pstConn->iSock, -1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&s_connSockMutex);
+}
+
+int lockTcpConnSock(const TCP_CONN_METRICS *kpstConn, uint64_t u64ConnId)
+{
+    uint64_t u64Registered;
+
+    pthread_mutex_lock(&s_connSockMutex);
+    u64Registered = __atomic_load_n(&kpstConn->u64ConnId, __ATOMIC_RELAXED);
+    if (u64Registered == 0 || (u64ConnId != 0 && u64Registered != u64ConnId)) {
+        pthread_mutex_unlock(&s_connSockMutex);
+        return -1;
+    }
+    return __atomic_load_n(&kpstConn->iSock, __ATOMIC_RELAXED);
+}
+
+void unlockTcpConnSock(void)
+{
+    pthread_mutex_unlock(&s_connSockMutex);
+}
+
+void visitTcpConnMetrics(TCP_CONN_VISITOR pfnVisitor, void *pvArg)
+{
+    for (int i = 0; i < TCP_CONN_TABLE_SIZE; i++) {
+        TCP_CONN_METRICS *pstConn = __atomic_load_n(&s_apstConnTable[i], __ATOMIC_ACQUIRE);
+        if (pstConn != NULL) {
+            pfnVisitor(pstConn, pvArg);
+        }
+    }
+}
+
+uint64_t getTcpConnQueueDepth(const TCP_CONN_METRICS *kpstConn)
+{
+    uint64_t u64In = getTcpConnMetric(kpstConn, TCP_METRIC_ENQUEUED);
+    uint64_t u64Out = getTcpConnMetric(kpstConn, TCP_METRIC_DEQUEUED) + getTcpConnMetric(kpstConn, TCP_METRIC_DROPS);
+
+    return (u64In > u64Out) ? u64In - u64Out : 0;
+}
+
+const char *getTcpMetricName(TCP_METRIC_ID eId)
+{
+    return s_kapchMetricName[eId];
+}
+
+const char *getTcpGaugeName(TCP_GAUGE_ID eId)
+{
+    return s_kapchGaugeName[eId];
+}
+
+const char *getTcpHistogramName(TCP_HIST_ID eId)
+{
+    return s_kapchHistName[eId];
+}
+
+void recordTcpHistogram(TCP_HIST_ID eId, uint64_t u64Value)
+{
+    TCP_METRICS_SHARD *pstShard = getTcpMetricsShard();
+    if (pstShard == NULL) {
+        return;
+    }
+
+    TCP_HISTOGRAM *pstHist = pstShard->apstHist[eId];
+    if (pstHist == NULL) {
+        pstHist = (TCP_HISTOGRAM *)calloc(1, sizeof(TCP_HISTOGRAM));
+        if (pstHist == NULL) {
+            return;
+        }
+        /**< 스냅샷 스레드가 초기화된 히스토그램만 보도록 release로 게시 */
+        __atomic_store_n(&pstShard->apstHist[eId], pstHist, __ATOMIC_RELEASE);
+    }
+
+    addOwnedCounter(&pstHist->au64Bucket[getTcpHistogramIndex(u64Value)], 1);
+    addOwnedCounter(&pstHist->u64Count, 1);
+    addOwnedCounter(&pstHist->u64Sum, u64Value);
+    if (u64Value > pstHist->u64Max) {
+        __atomic_store_n(&pstHist->u64Max, u64Value, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief 다른 스레드가 기록 중인 히스토그램을 relaxed load로 읽어 더합니다.
+ */
+static void mergeTcpHistogramRelaxed(TCP_HISTOGRAM *pstDst, const TCP_HISTOGRAM *kpstSrc)
+{
+    for (int i = 0; i < TCP_HIST_BUCKETS; i++) {
+        pstDst->au64Bucket[i] += __atomic_load_n(&kpstSrc->au64Bucket[i], __ATOMIC_RELAXED);
+    }
+    pstDst->u64Count += __atomic_load_n(&kpstSrc->u64Count, __ATOMIC_RELAXED);
+    pstDst->u64Sum += __atomic_load_n(&kpstSrc->u64Sum, __ATOMIC_RELAXED);
+
+    uint64_t u64Max = __atomic_load_n(&kpstSrc->u64Max, __ATOMIC_RELAXED);
+    if (u64Max > pstDst->u64Max) {
+        pstDst->u64Max = u64Max;
+    }
+}
+
+void getTcpMetricsSnapshot(TCP_METRICS_SNAPSHOT *pstSnapshot)
+{
+    memset(pstSnapshot, 0x0, sizeof(TCP_METRICS_SNAPSHOT));
+
+    pthread_mutex_lock(&s_registryMutex);
+    memcpy(pstSnapshot->au64Counter, s_au64RetiredCounter, sizeof(s_au64RetiredCounter));
+    for (int i = 0; i < TCP_HIST_COUNT; i++) {
+        mergeTcpHistogram(&pstSnapshot->astHist[i], &s_astRetiredHist[i]);
+    }
+
+    for (TCP_METRICS_SHARD *pstShard = s_pstShardList; pstShard != NULL; pstShard = pstShard->pstNext) {
+        for (int i = 0; i < TCP_METRIC_COUNT; i++) {
+            pstSnapshot->au64Counter[i] += __atomic_load_n(&pstShard->au64Counter[i], __ATOMIC_RELAXED);
+        }
+        for (int i = 0; i < TCP_HIST_COUNT; i++) {
+            TCP_HISTOGRAM *pstHist = __atomic_load_n(&pstShard->apstHist[i], __ATOMIC_ACQUIRE);
+            if (pstHist != NULL) {
+                mergeTcpHistogramRelaxed(&pstSnapshot->astHist[i], pstHist);
+            }
+        }
+    }
+    pthread_mutex_unlock(&s_registryMutex);
+
+    clock_gettime(CLOCK_MONOTONIC, &pstSnapshot->stTime);
+}
+
+void resetTcpHistogram(TCP_HISTOGRAM *pstHist)
+{
+    memset(pstHist, 0x0, sizeof(TCP_HISTOGRAM));
+}
+
+void addTcpHistogramValue(TCP_HISTOGRAM *pstHist, uint64_t u64Value)
+{
+    pstHist->au64Bucket[getTcpHistogramIndex(u64Value)]++;
+    pstHist->u64Count++;
+    pstHist->u64Sum += u64Value;
+    if (u64Value > pstHist->u64Max) {
+        pstHist->u64Max = u64Value;
+    }
+}
+
+void mergeTcpHistogram(TCP_HISTOGRAM *pstDst, const TCP_HISTOGRAM *kpstSrc)
+{
+    for (int i = 0; i < TCP_HIST_BUCKETS; i++) {
+        pstDst->au64Bucket[i] += kpstSrc->au64Bucket[i];
+    }
+    pstDst->u64Count += kpstSrc->u64Count;
+    pstDst->u64Sum += kpstSrc->u64Sum;
+    if (kpstSrc->u64Max > pstDst->u64Max) {
+        pstDst->u64Max = kpstSrc->u64Max;
+    }
+}
+
+uint64_t getTcpHistogramPercentile(const TCP_HISTOGRAM *kpstHist, double dPercentile)
+{
+    if (kpstHist->u64Count == 0) {
+        return 0;
+    }
+
+    if (dPercentile < 0.0) {
+        dPercentile = 0.0;
+    } else if (dPercentile > 100.0) {
+        dPercentile = 100.0;
+    }
+
+    uint64_t u64Target = (uint64_t)(dPercentile / 100.0 * (double)kpstHist->u64Count + 0.5);
+    if (u64Target == 0) {
+        u64Target = 1;
+    }
+
+    uint64_t u64Seen = 0;
+    for (int i = 0; i < TCP_HIST_BUCKETS; i++) {
+        u64Seen += kpstHist->au64Bucket[i];
+        if (u64Seen >= u64Target) {
+            uint64_t u64Value = getTcpHistogramBucketMax(i);
+            return (u64Value < kpstHist->u64Max) ? u64Value : kpstHist->u64Max;
+        }
+    }
+
+    return kpstHist->u64Max;
+}
+
+uint64_t getTcpActiveConnections(const TCP_METRICS_SNAPSHOT *kpstSnapshot)
+{
+    uint64_t u64Accepts = kpstSnapshot->au64Counter[TCP_METRIC_ACCEPTS];
+    uint64_t u64Disconnects = kpstSnapshot->au64Counter[TCP_METRIC_DISCONNECTS];
+
+    /**< 샤드를 순서대로 읽으므로 순간적으로 해제 수가 더 클 수 있습니다. */
+    return (u64Accepts > u64Disconnects) ? u64Accepts - u64Disconnects : 0;
+}
+
+uint64_t getTcpQueueDepth(const TCP_METRICS_SNAPSHOT *kpstSnapshot)
+{
+    uint64_t u64In = kpstSnapshot->au64Counter[TCP_METRIC_ENQUEUED];
+    uint64_t u64Out = kpstSnapshot->au64Counter[TCP_METRIC_DEQUEUED] + kpstSnapshot->au64Counter[TCP_METRIC_DROPS];
+
+    return (u64In > u64Out) ? u64In - u64Out : 0;
+}
+
+double getTcpMetricRate(const TCP_METRICS_SNAPSHOT *kpstPrev, const TCP_METRICS_SNAPSHOT *kpstCur, TCP_METRIC_ID eId)
+{
+    double dElapsed = (double)(kpstCur->stTime.tv_sec - kpstPrev->stTime.tv_sec)
+                    + (double)(kpstCur->stTime.tv_nsec - kpstPrev->stTime.tv_nsec) / 1e9;
+    if (dElapsed <= 0.0) {
+        return 0.0;
+    }
+
+    return (double)(kpstCur->au64Counter[eId] - kpstPrev->au64Counter[eId]) / dElapsed;
+}
+
+uint64_t getTcpMonotonicNs(void)
+{
+    struct timespec stNow;
+    clock_gettime(CLOCK_MONOTONIC, &stNow);
+    return (uint64_t)stNow.tv_sec * 1000000000ULL + (uint64_t)stNow.tv_nsec;
+}
@@ -0,0 +1,492 @@
+/**
+ * @file tcpPool.c
+ * @brief 지속 연결 풀과 Correlation ID 기반 요청/응답 다중화 API
+ *
+ * 세션마다 연결을 새로 여는 대신, 서버에 몇 개의 지속 연결을 열어 두고 여러 스레드의 요청을 나눠 보냅니다.
+ * 요청 프레임에는 Correlation ID를 붙이고 연결별 대기 슬롯에 콜백을 등록해 두며,
+ * 연결마다 하나인 수신 스레드가 응답의 ID로 슬롯을 찾아 콜백을 호출하므로 응답 순서가 바뀌어도 됩니다.
+ *
+ * 주요 기능:
+ * - 풀 생성/해제 (연결별 수신 스레드)
+ * - 비동기 요청 (콜백) 및 동기 요청 (제한 시간)
+ * - 연결 끊김 시 대기 요청 실패 처리
+ *
+ * @date 2026-10-16
+ */
+#include "tcpPool.h"
+#include "tcpSock.h"
+#include "tcpFrame.h"
+
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <netinet/tcp.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#define TCP_POOL_SLOT_MASK ((uint32_t)TCP_POOL_MAX_INFLIGHT - 1)
+#define TCP_POOL_RECV_SIZE (TCP_FRAME_MAX_SIZE + 16 * BUFFER_SIZE) /**< 프레임 조립용 수신 버퍼 크기 */
+
+/**
+ * @brief 응답을 기다리는 요청 하나
+ */
+typedef struct {
+    uint32_t u32CorrId;             /**< 요청에 붙인 Correlation ID */
+    TCP_POOL_CALLBACK pfnCallback;  /**< 응답 콜백 (NULL이면 빈 슬롯) */
+    void *pvUser;                   /**< 콜백 사용자 포인터 */
+} TCP_POOL_SLOT;
+
+/**
+ * @brief 풀의 연결 하나
+ *
+ * @details 송신은 sendMutex로 프레임 단위로 직렬화하고, 대기 슬롯은 slotMutex로 보호합니다.
+ *          소켓은 풀을 해제할 때만 닫으므로 연결이 끊긴 뒤에도 다른 스레드의 send()가 엉뚱한 fd로 가지 않습니다.
+ */
+typedef struct {
+    struct TCP_POOL *pstPool;       /**< 소속 풀 */
+    int iSock;                      /**< 소켓 파일 디스크립터 (-1이면 연결 실패) */
+    bool bAlive;                    /**< 연결 상태. slotMutex 안에서 변경 */
+    bool bThreadStarted;            /**< 수신 스레드 생성 여부 */
+    pthread_t recvThreadId;         /**< 수신 스레드 ID */
+    pthread_mutex_t sendMutex;      /**< 송신 직렬화 뮤텍스 */
+    uint8_t *pu8SendBuf;            /**< 프레임 인코딩 버퍼 (sendMutex로 보호) */
+    pthread_mutex_t slotMutex;      /**< 대기 슬롯 뮤텍스 */
+    pthread_cond_t slotCond;        /**< 슬롯이 비었거나 연결이 끊겼음을 알림 */
+    uint32_t u32Generation;         /**< Correlation ID 세대 */
+    int iFreeCount;                 /**< 빈 슬롯 수 */
+    uint16_t au16Free[TCP_POOL_MAX_INFLIGHT];       /**< 빈 슬롯 번호 스택 */
+    TCP_POOL_SLOT astSlots[TCP_POOL_MAX_INFLIGHT];  /**< 대기 슬롯 */
+} TCP_POOL_CONN;
+
+struct TCP_POOL {
+    int iConnCount;                 /**< 연결 수 */
+    uint8_t u8ClientId;             /**< 프레임 Client ID */
+    bool bClosing;                  /**< destroyTcpPool() 진행 중 */
+    TCP_POOL_CONN *pstConns;        /**< 연결 배열 */
+};
+
+/**
+ * @brief callTcpPool()이 응답을 기다리는 상태
+ */
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool bDone;
+    int iStatus;
+    void *pvOut;
+    size_t uiOutSize;
+    size_t uiLen;
+} TCP_POOL_CALL;
+
+static bool isTcpPoolConnAlive(TCP_POOL_CONN *pstConn) {
+    return __atomic_load_n(&pstConn->bAlive, __ATOMIC_ACQUIRE);
+}
+
+static bool sendAllTcpPool(int iSock, const uint8_t *kpu8Data, size_t uiLen) {
+    while (uiLen > 0) {
+        ssize_t iSent = send(iSock, kpu8Data, uiLen, MSG_NOSIGNAL);
+        if (iSent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        kpu8Data += iSent;
+        uiLen -= (size_t)iSent;
+    }
+    return true;
+}
+
+/**
+ * @brief 빈 슬롯에 콜백을 등록하고 Correlation ID를 만듭니다. 빈 슬롯이 없으면 기다립니다.
+ * @return 성공 시 0, 연결이 끊겼으면 -1
+ */
+static int allocTcpPoolSlot(TCP_POOL_CONN *pstConn, TCP_POOL_CALLBACK pfnCallback, void *pvUser, uint32_t *pu32CorrId) {
+    pthread_mutex_lock(&pstConn->slotMutex);
+    while (pstConn->iFreeCount == 0 && pstConn->bAlive) {
+        pthread_cond_wait(&pstConn->slotCond, &pstConn->slotMutex);
+    }
+    if (!pstConn->bAlive) {
+        pthread_mutex_unlock(&pstConn->slotMutex);
+        return -1;
+    }
+
+    uint16_t u16Slot = pstConn->au16Free[--pstConn->iFreeCount];
+    TCP_POOL_SLOT *pstSlot = &pstConn->astSlots[u16Slot];
+
+    pstSlot->u32CorrId = (++pstConn->u32Generation << TCP_POOL_SLOT_BITS) | u16Slot;
+    pstSlot->pfnCallback = pfnCallback;
+    pstSlot->pvUser = pvUser;
+    *pu32CorrId = pstSlot->u32CorrId;
+    pthread_mutex_unlock(&pstConn->slotMutex);
+    return 0;
+}
+
+/**
+ * @brief Correlation ID에 해당하는 슬롯을 비우고 콜백을 꺼냅니다.
+ * @return 슬롯이 아직 대기 중이었으면 true (이미 처리되었거나 오래된 ID이면 false)
+ */
+static bool takeTcpPoolSlot(TCP_POOL_CONN *pstConn, uint32_t u32CorrId, TCP_POOL_CALLBACK *ppfnCallback, void **ppvUser) {
+    uint16_t u16Slot = (uint16_t)(u32CorrId & TCP_POOL_SLOT_MASK);
+    TCP_POOL_SLOT *pstSlot = &pstConn->astSlots[u16Slot];
+    bool bTaken = false;
+
+    pthread_mutex_lock(&pstConn->slotMutex);
+    if (pstSlot->pfnCallback != NULL && pstSlot->u32CorrId == u32CorrId) {
+        *ppfnCallback = pstSlot->pfnCallback;
+        *ppvUser = pstSlot->pvUser;
+        pstSlot->pfnCallback = NULL;
+        pstConn->au16Free[pstConn->iFreeCount++] = u16Slot;
+        pthread_cond_signal(&pstConn->slotCond);
+        bTaken = true;
+    }
+    pthread_mutex_unlock(&pstConn->slotMutex);
+    return bTaken;
+}
+
+/**
+ * @brief 연결을 끊긴 상태로 바꾸고 대기 중인 요청의 콜백을 모두 오류로 호출합니다.
+ */
+static void failTcpPoolConn(TCP_POOL_CONN *pstConn, int iStatus) {
+    pthread_mutex_lock(&pstConn->slotMutex);
+    __atomic_store_n(&pstConn->bAlive, false, __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&pstConn->slotCond);
+    for (int i = 0; i < TCP_POOL_MAX_INFLIGHT; i++) {
+        TCP_POOL_SLOT *pstSlot = &pstConn->astSlots[i];
+        if (pstSlot->pfnCallback == NULL) {
+            continue;
+        }
+
+        TCP_POOL_CALLBACK pfnCallback = pstSlot->pfnCallback;
+        void *pvUser = pstSlot->pvUser;
+        pstSlot->pfnCallback = NULL;
+        pstConn->au16Free[pstConn->iFreeCount++] = (uint16_t)i;
+
+        /**< 콜백은 잠금 밖에서 호출합니다. */
+        pthread_mutex_unlock(&pstConn->slotMutex);
+        pfnCallback(pvUser, iStatus, NULL, 0);
+        pthread_mutex_lock(&pstConn->slotMutex);
+    }
+    pthread_mutex_unlock(&pstConn->slotMutex);
+}
+
+/**
+ * @brief 연결별 수신 스레드
+ *
+ * @details 응답 프레임을 조립하고 Correlation ID로 슬롯을 찾아 콜백을 호출합니다.
+ *          ID가 없거나 이미 처리된 (제한 시간이 지나 취소된) 응답은 버립니다.
+ *          연결이 끊기면 대기 요청을 모두 실패 처리하고 끝납니다.
+ */
+static void *tcpPoolReceiveThread(void *pvData) {
+    TCP_POOL_CONN *pstConn = (TCP_POOL_CONN *)pvData;
+    uint8_t *pu8Stream = (uint8_t *)malloc(TCP_POOL_RECV_SIZE);
+    size_t uiStreamLen = 0;
+
+    while (pu8Stream != NULL) {
+        ssize_t iReadSize = read(pstConn->iSock, pu8Stream + uiStreamLen, TCP_POOL_RECV_SIZE - uiStreamLen);
+        if (iReadSize <= 0) {
+            if (iReadSize < 0 && errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        uiStreamLen += (size_t)iReadSize;
+
+        size_t uiOffset = 0;
+        while (uiOffset < uiStreamLen) {
+            TCP_FRAME_HEADER stHeader;
+            const uint8_t *kpu8Data;
+            uint32_t u32CorrId;
+            TCP_POOL_CALLBACK pfnCallback;
+            void *pvUser;
+            int iFrameLen = decodeTcpFrame(pu8Stream + uiOffset, uiStreamLen - uiOffset, &stHeader, &kpu8Data);
+
+            if (iFrameLen == 0) {
+                break;
+            }
+            if (iFrameLen < 0) {
+                uiOffset += findTcpFrameStart(pu8Stream + uiOffset, uiStreamLen - uiOffset);
+                continue;
+            }
+            if (getTcpFrameCorrId(&stHeader, kpu8Data, &u32CorrId) &&
+                takeTcpPoolSlot(pstConn, u32CorrId, &pfnCallback, &pvUser)) {
+                pfnCallback(pvUser, 0, kpu8Data + TCP_FRAME_CORR_ID_SIZE,
+                            (size_t)stHeader.u16DataLen - TCP_FRAME_CORR_ID_SIZE);
+            }
+            uiOffset += (size_t)iFrameLen;
+        }
+        memmove(pu8Stream, pu8Stream + uiOffset, uiStreamLen - uiOffset);
+        uiStreamLen -= uiOffset;
+    }
+
+    free(pu8Stream);
+    shutdown(pstConn->iSock, SHUT_RDWR);
+    failTcpPoolConn(pstConn, __atomic_load_n(&pstConn->pstPool->bClosing, __ATOMIC_ACQUIRE) ? -ECANCELED : -ECONNRESET);
+    return NULL;
+}
+
+TCP_POOL *createTcpPool(const char *kpchHosts, int iPort, int iConnCount, uint8_t u8ClientId, int iConnectTimeoutMs) {
+    TCP_POOL *pstPool;
+    int iLiveCount = 0;
+
+    if (iConnCount <= 0 || iConnCount > TCP_POOL_MAX_CONNS) {
+        errno = EINVAL;
+        return NULL;
+    }
+    pstPool = (TCP_POOL *)calloc(1, sizeof(TCP_POOL));
+    if (pstPool == NULL) {
+        return NULL;
+    }
+    pstPool->pstConns = (TCP_POOL_CONN *)calloc((size_t)iConnCount, sizeof(TCP_POOL_CONN));
+    if (pstPool->pstConns == NULL) {
+        free(pstPool);
+        return NULL;
+    }
+    pstPool->iConnCount = iConnCount;
+    pstPool->u8ClientId = u8ClientId;
+
+    for (int i = 0; i < iConnCount; i++) {
+        TCP_POOL_CONN *pstConn = &pstPool->pstConns[i];
+        int iNoDelay = 1;
+
+        pstConn->pstPool = pstPool;
+        pthread_mutex_init(&pstConn->sendMutex, NULL);
+        pthread_mutex_init(&pstConn->slotMutex, NULL);
+        pthread_cond_init(&pstConn->slotCond, NULL);
+        for (int j = 0; j < TCP_POOL_MAX_INFLIGHT; j++) {
+            pstConn->au16Free[j] = (uint16_t)(TCP_POOL_MAX_INFLIGHT - 1 - j);
+        }
+        pstConn->iFreeCount = TCP_POOL_MAX_INFLIGHT;
+
+        pstConn->pu8SendBuf = (uint8_t *)malloc(TCP_FRAME_MAX_SIZE);
+        pstConn->iSock = (pstConn->pu8SendBuf != NULL) ? connectTcpClientSocket(kpchHosts, iPort, iConnectTimeoutMs) : -1;
+        if (pstConn->iSock < 0) {
+            continue;
+        }
+        setsockopt(pstConn->iSock, IPPROTO_TCP, TCP_NODELAY, &iNoDelay, sizeof(iNoDelay));
+
+        pstConn->bAlive = true;
+        if (pthread_create(&pstConn->recvThreadId, NULL, tcpPoolReceiveThread, pstConn) != 0) {
+            perror("풀 수신 스레드 생성 실패");
+            pstConn->bAlive = false;
+            continue;
+        }
+        pstConn->bThreadStarted = true;
+        iLiveCount++;
+    }
+
+    if (iLiveCount == 0) {
+        destroyTcpPool(pstPool);
+        errno = ECONNREFUSED;
+        return NULL;
+    }
+    return pstPool;
+}
+
+void destroyTcpPool(TCP_POOL *pstPool) {
+    if (pstPool == NULL) {
+        return;
+    }
+
+    __atomic_store_n(&pstPool->bClosing, true, __ATOMIC_RELEASE);
+    for (int i = 0; i < pstPool->iConnCount; i++) {
+        if (pstPool->pstConns[i].iSock >= 0) {
+            shutdown(pstPool->pstConns[i].iSock, SHUT_RDWR);
+        }
+    }
+    for (int i = 0; i < pstPool->iConnCount; i++) {
+        TCP_POOL_CONN *pstConn = &pstPool->pstConns[i];
+
+        if (pstConn->bThreadStarted) {
+            pthread_join(pstConn->recvThreadId, NULL);
+        }
+        if (pstConn->iSock >= 0) {
+            close(pstConn->iSock);
+        }
+        free(pstConn->pu8SendBuf);
+        pthread_cond_destroy(&pstConn->slotCond);
+        pthread_mutex_destroy(&pstConn->slotMutex);
+        pthread_mutex_destroy(&pstConn->sendMutex);
+    }
+    free(pstPool->pstConns);
+    free(pstPool);
+}
+
+/**
+ * @brief 대기 요청이 가장 적은 살아 있는 연결을 고릅니다.
+ */
+static TCP_POOL_CONN *pickTcpPoolConn(TCP_POOL *pstPool) {
+    TCP_POOL_CONN *pstBest = NULL;
+    int iBestFree = -1;
+
+    for (int i = 0; i < pstPool->iConnCount; i++) {
+        TCP_POOL_CONN *pstConn = &pstPool->pstConns[i];
+        int iFree = __atomic_load_n(&pstConn->iFreeCount, __ATOMIC_RELAXED);
+
+        if (isTcpPoolConnAlive(pstConn) && iFree > iBestFree) {
+            pstBest = pstConn;
+            iBestFree = iFree;
+        }
+    }
+    return pstBest;
+}
+
+/**
+ * @brief 요청을 보내고, 취소할 수 있도록 고른 연결과 Correlation ID를 돌려줍니다.
+ */
+static int sendTcpPoolRequest(TCP_POOL *pstPool, uint8_t u8Instruction, const void *kpvData, size_t uiLen,
+                              TCP_POOL_CALLBACK pfnCallback, void *pvUser,
+                              TCP_POOL_CONN **ppstConn, uint32_t *pu32CorrId) {
+    TCP_POOL_CONN *pstConn;
+    uint32_t u32CorrId;
+    bool bSent;
+
+    if (uiLen > TCP_FRAME_MAX_DATA - TCP_FRAME_CORR_ID_SIZE || pfnCallback == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    do {
+        pstConn = pickTcpPoolConn(pstPool);
+        if (pstConn == NULL) {
+            errno = ENOTCONN;
+            return -1;
+        }
+    } while (allocTcpPoolSlot(pstConn, pfnCallback, pvUser, &u32CorrId) != 0);
+
+    /**< 응답이 먼저 올 수 있으므로 슬롯을 등록한 뒤에 보냅니다. */
+    pthread_mutex_lock(&pstConn->sendMutex);
+    int iFrameLen = encodeTcpCorrFrame(pstConn->pu8SendBuf, TCP_FRAME_MAX_SIZE, pstPool->u8ClientId, u8Instruction,
+                                       u32CorrId, kpvData, uiLen);
+    bSent = sendAllTcpPool(pstConn->iSock, pstConn->pu8SendBuf, (size_t)iFrameLen);
+    pthread_mutex_unlock(&pstConn->sendMutex);
+
+    if (!bSent) {
+        int iSendError = errno;
+        TCP_POOL_CALLBACK pfnUnused;
+        void *pvUnused;
+
+        /**< 수신 스레드를 깨워 나머지 대기 요청을 정리하게 합니다. */
+        shutdown(pstConn->iSock, SHUT_RDWR);
+        if (takeTcpPoolSlot(pstConn, u32CorrId, &pfnUnused, &pvUnused)) {
+            errno = iSendError;
+            return -1;
+        }
+        /**< 수신 스레드가 이미 콜백을 오류로 호출했습니다. */
+    }
+
+    *ppstConn = pstConn;
+    *pu32CorrId = u32CorrId;
+    return 0;
+}
+
+int submitTcpPoolRequest(TCP_POOL *pstPool, uint8_t u8Instruction, const void *kpvData, size_t uiLen,
+                         TCP_POOL_CALLBACK pfnCallback, void *pvUser) {
+    TCP_POOL_CONN *pstConn;
+    uint32_t u32CorrId;
+
+    return sendTcpPoolRequest(pstPool, u8Instruction, kpvData, uiLen, pfnCallback, pvUser, &pstConn, &u32CorrId);
+}
+
+static void onTcpPoolCallDone(void *pvUser, int iStatus, const uint8_t *kpu8Data, size_t uiLen) {
+    TCP_POOL_CALL *pstCall = (TCP_POOL_CALL *)pvUser;
+
+    pthread_mutex_lock(&pstCall->mutex);
+    pstCall->iStatus = iStatus;
+    pstCall->uiLen = uiLen;
+    if (iStatus == 0 && uiLen > 0) {
+        memcpy(pstCall->pvOut, kpu8Data, uiLen < pstCall->uiOutSize ? uiLen : pstCall->uiOutSize);
+    }
+    pstCall->bDone = true;
+    pthread_cond_signal(&pstCall->cond);
+    pthread_mutex_unlock(&pstCall->mutex);
+}
+
+int callTcpPool(TCP_POOL *pstPool, uint8_t u8Instruction, const void *kpvData, size_t uiLen,
+                void *pvOut, size_t uiOutSize, int iTimeoutMs) {
+    TCP_POOL_CALL stCall;
+    TCP_POOL_CONN *pstConn;
+    uint32_t u32CorrId;
+    struct timespec stDeadline;
+    int iRet;
+
+    memset(&stCall, 0, sizeof(stCall));
+    pthread_mutex_init(&stCall.mutex, NULL);
+    pthread_cond_init(&stCall.cond, NULL);
+    stCall.pvOut = pvOut;
+    stCall.uiOutSize = uiOutSize;
+
+    clock_gettime(CLOCK_REALTIME, &stDeadline);
+    stDeadline.tv_sec += iTimeoutMs / 1000;
+    stDeadline.tv_nsec += (long)(iTimeoutMs % 1000) * 1000000L;
+    if (stDeadline.tv_nsec >= 1000000000L) {
+        stDeadline.tv_sec++;
+        stDeadline.tv_nsec -= 1000000000L;
+    }
+
+    if (sendTcpPoolRequest(pstPool, u8Instruction, kpvData, uiLen, onTcpPoolCallDone, &stCall, &pstConn, &u32CorrId) != 0) {
+        iRet = -1;
+    } else {
+        bool bTimedOut = false;
+        bool bDone;
+
+        pthread_mutex_lock(&stCall.mutex);
+        while (!stCall.bDone && !bTimedOut) {
+            if (iTimeoutMs > 0) {
+                bTimedOut = (pthread_cond_timedwait(&stCall.cond, &stCall.mutex, &stDeadline) == ETIMEDOUT);
+            } else {
+                pthread_cond_wait(&stCall.cond, &stCall.mutex);
+            }
+        }
+        bDone = stCall.bDone;
+        pthread_mutex_unlock(&stCall.mutex);
+
+        TCP_POOL_CALLBACK pfnUnused;
+        void *pvUnused;
+        if (!bDone && takeTcpPoolSlot(pstConn, u32CorrId, &pfnUnused, &pvUnused)) {
+            /**< 취소했으므로 늦게 온 응답은 수신 스레드가 버립니다. */
+            stCall.iStatus = -ETIMEDOUT;
+        } else {
+            /**< 수신 스레드가 이미 슬롯을 꺼냈으면 콜백이 끝날 때까지 기다립니다. */
+            pthread_mutex_lock(&stCall.mutex);
+            while (!stCall.bDone) {
+                pthread_cond_wait(&stCall.cond, &stCall.mutex);
+            }
+            pthread_mutex_unlock(&stCall.mutex);
+        }
+
+        if (stCall.iStatus != 0) {
+            errno = -stCall.iStatus;
+            iRet = -1;
+        } else {
+            iRet = (int)stCall.uiLen;
+        }
+    }
+
+    pthread_cond_destroy(&stCall.cond);
+    pthread_mutex_destroy(&stCall.mutex);
+    return iRet;
+}
+
+int getTcpPoolInflight(TCP_POOL *pstPool) {
+    int iInflight = 0;
+
+    for (int i = 0; i < pstPool->iConnCount; i++) {
+        iInflight += TCP_POOL_MAX_INFLIGHT - __atomic_load_n(&pstPool->pstConns[i].iFreeCount, __ATOMIC_RELAXED);
+    }
+    return iInflight;
+}
+
+int getTcpPoolLiveConns(TCP_POOL *pstPool) {
+    int iLive = 0;
+
+    for (int i = 0; i < pstPool->iConnCount; i++) {
+        iLive += isTcpPoolConnAlive(&pstPool->pstConns[i]) ? 1 : 0;
+    }
+    return iLive;
+}
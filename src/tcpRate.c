@@ -0,0 +1,175 @@
+/**
+ * @file tcpRate.c
+ * @brief 연결별, Client ID별 수신 전송률 제한을 위한 토큰 버킷 API
+ *
+ * 수신 스레드는 처리한 프레임의 바이트와 개수를 버킷에서 빼고, 제한을 넘으면 돌려받은 시간 동안
+ * 소켓을 읽지 않습니다. 그동안 커널 수신 버퍼가 차고 TCP 윈도가 닫히므로 보내는 쪽이 자연히 느려집니다.
+ * 제한 값은 관리 인터페이스에서 실행 중에 바꿀 수 있습니다.
+ *
+ * 주요 기능:
+ * - 바이트/메시지 이중 토큰 버킷 (빚을 허용하고 대기 시간을 계산)
+ * - 버전으로 갱신을 알리는 연결별 기본 제한
+ * - 모든 연결이 함께 쓰는 Client ID별 버킷
+ *
+ * @date 2026-10-16
+ */
+#include "tcpRate.h"
+#include "tcpMetrics.h"
+
+#include <pthread.h>
+
+#define TCP_RATE_NS_PER_SEC 1e9
+
+static pthread_mutex_t s_rateMutex = PTHREAD_MUTEX_INITIALIZER; /**< 아래 설정과 Client ID 버킷을 보호합니다. */
+static TCP_RATE_LIMIT s_stConnLimit;                            /**< 연결별 기본 제한 */
+static uint32_t s_u32ConnLimitVersion;                          /**< 연결별 기본 제한이 바뀔 때마다 증가 */
+static TCP_TOKEN_BUCKET s_astIdBucket[TCP_RATE_CLIENT_IDS];     /**< Client ID별 버킷 */
+static bool s_abIdLimited[TCP_RATE_CLIENT_IDS];                 /**< 제한이 있는 Client ID (잠금 없이 읽음) */
+
+static double getTcpRateBurst(uint64_t u64PerSec)
+{
+    double dBurst = (double)u64PerSec * TCP_RATE_BURST_MS / 1000.0;
+
+    return dBurst < 1.0 ? 1.0 : dBurst;
+}
+
+/**
+ * @brief 지난 시간만큼 토큰을 채웁니다. 폭주 크기를 넘지 않습니다.
+ */
+static void refillTcpTokenBucket(TCP_TOKEN_BUCKET *pstBucket, uint64_t u64NowNs)
+{
+    double dElapsedSec = u64NowNs > pstBucket->u64LastNs ? (double)(u64NowNs - pstBucket->u64LastNs) / TCP_RATE_NS_PER_SEC : 0.0;
+
+    pstBucket->u64LastNs = u64NowNs > pstBucket->u64LastNs ? u64NowNs : pstBucket->u64LastNs;
+    if (pstBucket->stLimit.u64BytesPerSec > 0) {
+        double dBurst = getTcpRateBurst(pstBucket->stLimit.u64BytesPerSec);
+        pstBucket->dByteTokens += dElapsedSec * (double)pstBucket->stLimit.u64BytesPerSec;
+        if (pstBucket->dByteTokens > dBurst) {
+            pstBucket->dByteTokens = dBurst;
+        }
+    }
+    if (pstBucket->stLimit.u64MsgsPerSec > 0) {
+        double dBurst = getTcpRateBurst(pstBucket->stLimit.u64MsgsPerSec);
+        pstBucket->dMsgTokens += dElapsedSec * (double)pstBucket->stLimit.u64MsgsPerSec;
+        if (pstBucket->dMsgTokens > dBurst) {
+            pstBucket->dMsgTokens = dBurst;
+        }
+    }
+}
+
+void initTcpTokenBucket(TCP_TOKEN_BUCKET *pstBucket, const TCP_RATE_LIMIT *kpstLimit, uint64_t u64NowNs)
+{
+    pstBucket->stLimit = *kpstLimit;
+    pstBucket->dByteTokens = kpstLimit->u64BytesPerSec > 0 ? getTcpRateBurst(kpstLimit->u64BytesPerSec) : 0.0;
+    pstBucket->dMsgTokens = kpstLimit->u64MsgsPerSec > 0 ? getTcpRateBurst(kpstLimit->u64MsgsPerSec) : 0.0;
+    pstBucket->u64LastNs = u64NowNs;
+}
+
+void setTcpTokenBucketLimit(TCP_TOKEN_BUCKET *pstBucket, const TCP_RATE_LIMIT *kpstLimit, uint64_t u64NowNs)
+{
+    TCP_RATE_LIMIT stOld = pstBucket->stLimit;
+
+    refillTcpTokenBucket(pstBucket, u64NowNs);
+    pstBucket->stLimit = *kpstLimit;
+    /**< 제한이 새로 생긴 쪽은 가득 찬 상태에서, 없어진 쪽은 빚 없이 시작합니다. */
+    if (kpstLimit->u64BytesPerSec == 0 || stOld.u64BytesPerSec == 0) {
+        pstBucket->dByteTokens = kpstLimit->u64BytesPerSec > 0 ? getTcpRateBurst(kpstLimit->u64BytesPerSec) : 0.0;
+    }
+    if (kpstLimit->u64MsgsPerSec == 0 || stOld.u64MsgsPerSec == 0) {
+        pstBucket->dMsgTokens = kpstLimit->u64MsgsPerSec > 0 ? getTcpRateBurst(kpstLimit->u64MsgsPerSec) : 0.0;
+    }
+    refillTcpTokenBucket(pstBucket, u64NowNs); /**< 새 폭주 크기로 자릅니다. */
+}
+
+uint64_t takeTcpTokenBucket(TCP_TOKEN_BUCKET *pstBucket, uint64_t u64Bytes, uint64_t u64Msgs, uint64_t u64NowNs)
+{
+    double dWaitSec = 0.0;
+
+    refillTcpTokenBucket(pstBucket, u64NowNs);
+    if (pstBucket->stLimit.u64BytesPerSec > 0) {
+        pstBucket->dByteTokens -= (double)u64Bytes;
+        if (pstBucket->dByteTokens < 0.0) {
+            dWaitSec = -pstBucket->dByteTokens / (double)pstBucket->stLimit.u64BytesPerSec;
+        }
+    }
+    if (pstBucket->stLimit.u64MsgsPerSec > 0) {
+        pstBucket->dMsgTokens -= (double)u64Msgs;
+        if (pstBucket->dMsgTokens < 0.0) {
+            double dMsgWaitSec = -pstBucket->dMsgTokens / (double)pstBucket->stLimit.u64MsgsPerSec;
+            dWaitSec = dMsgWaitSec > dWaitSec ? dMsgWaitSec : dWaitSec;
+        }
+    }
+    return (uint64_t)(dWaitSec * TCP_RATE_NS_PER_SEC);
+}
+
+void setTcpConnRateLimit(const TCP_RATE_LIMIT *kpstLimit)
+{
+    pthread_mutex_lock(&s_rateMutex);
+    s_stConnLimit = *kpstLimit;
+    __atomic_add_fetch(&s_u32ConnLimitVersion, 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&s_rateMutex);
+}
+
+void getTcpConnRateLimit(TCP_RATE_LIMIT *pstLimit)
+{
+    pthread_mutex_lock(&s_rateMutex);
+    *pstLimit = s_stConnLimit;
+    pthread_mutex_unlock(&s_rateMutex);
+}
+
+void setTcpClientIdRateLimit(uint8_t u8ClientId, const TCP_RATE_LIMIT *kpstLimit)
+{
+    uint64_t u64NowNs = getTcpMonotonicNs();
+
+    pthread_mutex_lock(&s_rateMutex);
+    setTcpTokenBucketLimit(&s_astIdBucket[u8ClientId], kpstLimit, u64NowNs);
+    __atomic_store_n(&s_abIdLimited[u8ClientId], kpstLimit->u64BytesPerSec > 0 || kpstLimit->u64MsgsPerSec > 0,
+                     __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&s_rateMutex);
+}
+
+bool getTcpClientIdRateLimit(uint8_t u8ClientId, TCP_RATE_LIMIT *pstLimit)
+{
+    bool bLimited;
+
+    pthread_mutex_lock(&s_rateMutex);
+    *pstLimit = s_astIdBucket[u8ClientId].stLimit;
+    bLimited = s_abIdLimited[u8ClientId];
+    pthread_mutex_unlock(&s_rateMutex);
+    return bLimited;
+}
+
+void initTcpConnRate(TCP_CONN_RATE *pstRate, uint64_t u64NowNs)
+{
+    pthread_mutex_lock(&s_rateMutex);
+    initTcpTokenBucket(&pstRate->stBucket, &s_stConnLimit, u64NowNs);
+    pstRate->u32Version = s_u32ConnLimitVersion;
+    pthread_mutex_unlock(&s_rateMutex);
+}
+
+uint64_t takeTcpConnRate(TCP_CONN_RATE *pstRate, uint64_t u64Bytes, uint64_t u64Msgs, uint64_t u64NowNs)
+{
+    if (__atomic_load_n(&s_u32ConnLimitVersion, __ATOMIC_ACQUIRE) != pstRate->u32Version) {
+        pthread_mutex_lock(&s_rateMutex);
+        setTcpTokenBucketLimit(&pstRate->stBucket, &s_stConnLimit, u64NowNs);
+        pstRate->u32Version = s_u32ConnLimitVersion;
+        pthread_mutex_unlock(&s_rateMutex);
+    }
+    if (pstRate->stBucket.stLimit.u64BytesPerSec == 0 && pstRate->stBucket.stLimit.u64MsgsPerSec == 0) {
+        return 0;
+    }
+    return takeTcpTokenBucket(&pstRate->stBucket, u64Bytes, u64Msgs, u64NowNs);
+}
+
+uint64_t takeTcpClientIdRate(uint8_t u8ClientId, uint64_t u64Bytes, uint64_t u64Msgs, uint64_t u64NowNs)
+{
+    uint64_t u64WaitNs;
+
+    if (!__atomic_load_n(&s_abIdLimited[u8ClientId], __ATOMIC_ACQUIRE)) {
+        return 0;
+    }
+    pthread_mutex_lock(&s_rateMutex);
+    u64WaitNs = takeTcpTokenBucket(&s_astIdBucket[u8ClientId], u64Bytes, u64Msgs, u64NowNs);
+    pthread_mutex_unlock(&s_rateMutex);
+    return u64WaitNs;
+}
@@ -0,0 +1,249 @@
+/**
+ * @file tcpRing.c
+ * @brief 단일 생산자/단일 소비자 가변 길이 레코드 링 버퍼 API
+ *
+ * 수신 스레드가 파싱한 프레임을 송신 스레드로 넘기는 큐로 사용합니다.
+ * 생산자와 소비자가 각자의 위치만 갱신하고 acquire/release 순서로 서로의 위치를 읽으므로
+ * 레코드를 넣고 꺼내는 데 잠금이 필요하지 않습니다.
+ *
+ * 주요 기능:
+ * - 링 버퍼 생성/해제 및 공유 메모리 등 외부 메모리에 배치
+ * - 레코드(여러 조각을 이어 붙인 레코드 포함) 넣기
+ * - 레코드 꺼내기 및 사용량 조회
+ * - 상대 프로세스가 머리를 바꿀 수 있는 공유 링의 검사하는 끝
+ *
+ * @date 2024-12-18
+ */
+#include "tcpRing.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define TCP_RING_LEN_SIZE ((uint32_t)sizeof(uint32_t))
+
+/**
+ * @brief 요청한 크기를 2의 거듭제곱으로 올린 데이터 영역 크기를 구합니다. (최소 64바이트)
+ */
+static uint32_t roundTcpRingCapacity(uint32_t u32Capacity)
+{
+    uint32_t u32Size = 64;
+
+    while (u32Size < u32Capacity && u32Size < 0x80000000u) {
+        u32Size <<= 1;
+    }
+    return u32Size;
+}
+
+size_t getTcpRingFootprint(uint32_t u32Capacity)
+{
+    return sizeof(TCP_RING) + roundTcpRingCapacity(u32Capacity);
+}
+
+TCP_RING *initTcpRing(void *pvMem, uint32_t u32Capacity)
+{
+    TCP_RING *pstRing = (TCP_RING *)pvMem;
+    uint32_t u32Size = roundTcpRingCapacity(u32Capacity);
+
+    memset(pstRing, 0x0, sizeof(TCP_RING));
+    pstRing->u32Capacity = u32Size;
+    pstRing->u32Mask = u32Size - 1;
+    return pstRing;
+}
+
+TCP_RING *createTcpRing(uint32_t u32Capacity)
+{
+    void *pvMem = calloc(1, getTcpRingFootprint(u32Capacity));
+
+    if (pvMem == NULL) {
+        return NULL;
+    }
+    return initTcpRing(pvMem, u32Capacity);
+}
+
+void destroyTcpRing(TCP_RING *pstRing)
+{
+    free(pstRing);
+}
+
+/**
+ * @brief 링의 논리 위치에 데이터를 복사합니다. 끝을 넘어가면 앞부분으로 이어서 복사합니다.
+ * @param u32Capacity 데이터 영역 크기 (공유 링은 이쪽이 보관한 값)
+ */
+static void copyToTcpRing(TCP_RING *pstRing, uint32_t u32Capacity, uint64_t u64Pos, const void *kpvData, uint32_t u32Len)
+{
+    uint32_t u32Offset = (uint32_t)u64Pos & (u32Capacity - 1);
+    uint32_t u32First = u32Capacity - u32Offset;
+
+    if (u32First >= u32Len) {
+        memcpy(pstRing->au8Data + u32Offset, kpvData, u32Len);
+    } else {
+        memcpy(pstRing->au8Data + u32Offset, kpvData, u32First);
+        memcpy(pstRing->au8Data, (const uint8_t *)kpvData + u32First, u32Len - u32First);
+    }
+}
+
+static void copyFromTcpRing(const TCP_RING *kpstRing, uint32_t u32Capacity, uint64_t u64Pos, void *pvOut, uint32_t u32Len)
+{
+    uint32_t u32Offset = (uint32_t)u64Pos & (u32Capacity - 1);
+    uint32_t u32First = u32Capacity - u32Offset;
+
+    if (u32First >= u32Len) {
+        memcpy(pvOut, kpstRing->au8Data + u32Offset, u32Len);
+    } else {
+        memcpy(pvOut, kpstRing->au8Data + u32Offset, u32First);
+        memcpy((uint8_t *)pvOut + u32First, kpstRing->au8Data, u32Len - u32First);
+    }
+}
+
+bool pushTcpRingParts(TCP_RING *pstRing, const struct iovec *kpstIov, int iIovCount)
+{
+    uint64_t u64Len = 0;
+
+    for (int i = 0; i < iIovCount; i++) {
+        u64Len += kpstIov[i].iov_len;
+    }
+    if (u64Len == 0 || u64Len + TCP_RING_LEN_SIZE > pstRing->u32Capacity) {
+        return false;
+    }
+
+    uint64_t u64Tail = pstRing->u64Tail; /**< 생산자만 갱신하므로 그대로 읽습니다. */
+    uint64_t u64Head = __atomic_load_n(&pstRing->u64Head, __ATOMIC_ACQUIRE);
+    if (u64Tail - u64Head + TCP_RING_LEN_SIZE + u64Len > pstRing->u32Capacity) {
+        return false;
+    }
+
+    uint32_t u32Len = (uint32_t)u64Len;
+    copyToTcpRing(pstRing, pstRing->u32Capacity, u64Tail, &u32Len, TCP_RING_LEN_SIZE);
+    u64Tail += TCP_RING_LEN_SIZE;
+    for (int i = 0; i < iIovCount; i++) {
+        copyToTcpRing(pstRing, pstRing->u32Capacity, u64Tail, kpstIov[i].iov_base, (uint32_t)kpstIov[i].iov_len);
+        u64Tail += kpstIov[i].iov_len;
+    }
+
+    /**< 데이터를 모두 쓴 뒤 소비자에게 게시 */
+    __atomic_store_n(&pstRing->u64Tail, u64Tail, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool pushTcpRing(TCP_RING *pstRing, const void *kpvData, uint32_t u32Len)
+{
+    struct iovec stIov;
+
+    stIov.iov_base = (void *)kpvData;
+    stIov.iov_len = u32Len;
+    return pushTcpRingParts(pstRing, &stIov, 1);
+}
+
+int popTcpRing(TCP_RING *pstRing, void *pvOut, uint32_t u32OutSize)
+{
+    uint64_t u64Head = pstRing->u64Head; /**< 소비자만 갱신하므로 그대로 읽습니다. */
+    uint64_t u64Tail = __atomic_load_n(&pstRing->u64Tail, __ATOMIC_ACQUIRE);
+    uint32_t u32Len;
+
+    if (u64Head == u64Tail) {
+        return 0;
+    }
+
+    copyFromTcpRing(pstRing, pstRing->u32Capacity, u64Head, &u32Len, TCP_RING_LEN_SIZE);
+    if (u32Len > u32OutSize) {
+        return -1;
+    }
+
+    copyFromTcpRing(pstRing, pstRing->u32Capacity, u64Head + TCP_RING_LEN_SIZE, pvOut, u32Len);
+
+    /**< 데이터를 다 읽은 뒤 공간을 생산자에게 돌려줍니다. */
+    __atomic_store_n(&pstRing->u64Head, u64Head + TCP_RING_LEN_SIZE + u32Len, __ATOMIC_RELEASE);
+    return (int)u32Len;
+}
+
+int skipTcpRing(TCP_RING *pstRing)
+{
+    uint64_t u64Head = pstRing->u64Head;
+    uint64_t u64Tail = __atomic_load_n(&pstRing->u64Tail, __ATOMIC_ACQUIRE);
+    uint32_t u32Len;
+
+    if (u64Head == u64Tail) {
+        return 0;
+    }
+
+    copyFromTcpRing(pstRing, pstRing->u32Capacity, u64Head, &u32Len, TCP_RING_LEN_SIZE);
+    __atomic_store_n(&pstRing->u64Head, u64Head + TCP_RING_LEN_SIZE + u32Len, __ATOMIC_RELEASE);
+    return (int)u32Len;
+}
+
+uint32_t getTcpRingUsed(const TCP_RING *kpstRing)
+{
+    uint64_t u64Head = __atomic_load_n(&kpstRing->u64Head, __ATOMIC_ACQUIRE);
+    uint64_t u64Tail = __atomic_load_n(&kpstRing->u64Tail, __ATOMIC_ACQUIRE);
+
+    return (uint32_t)(u64Tail - u64Head);
+}
+
+bool isTcpRingEmpty(const TCP_RING *kpstRing)
+{
+    return getTcpRingUsed(kpstRing) == 0;
+}
+
+void openTcpRingEnd(TCP_RING_END *pstEnd, TCP_RING *pstRing, uint32_t u32Capacity, bool bProducer)
+{
+    pstEnd->pstRing = pstRing;
+    pstEnd->u32Capacity = u32Capacity;
+    pstEnd->u64Pos = __atomic_load_n(bProducer ? &pstRing->u64Tail : &pstRing->u64Head, __ATOMIC_ACQUIRE);
+}
+
+uint64_t getTcpRingEndUsed(const TCP_RING_END *kpstEnd)
+{
+    uint64_t u64Head = __atomic_load_n(&kpstEnd->pstRing->u64Head, __ATOMIC_ACQUIRE);
+    uint64_t u64Tail = __atomic_load_n(&kpstEnd->pstRing->u64Tail, __ATOMIC_ACQUIRE);
+
+    /**< 상대 위치가 이쪽 위치보다 뒤에 있으면 빼기가 넘쳐 용량보다 큰 값이 됩니다. */
+    return u64Tail - u64Head;
+}
+
+int pushTcpRingEnd(TCP_RING_END *pstEnd, const void *kpvData, uint32_t u32Len)
+{
+    uint64_t u64Tail = pstEnd->u64Pos;
+    uint64_t u64Head = __atomic_load_n(&pstEnd->pstRing->u64Head, __ATOMIC_ACQUIRE);
+    uint64_t u64Used = u64Tail - u64Head;
+
+    if (u64Used > pstEnd->u32Capacity) {
+        return TCP_RING_CORRUPT;
+    }
+    if (u32Len == 0 || u64Used + TCP_RING_LEN_SIZE + u32Len > pstEnd->u32Capacity) {
+        return 0;
+    }
+
+    copyToTcpRing(pstEnd->pstRing, pstEnd->u32Capacity, u64Tail, &u32Len, TCP_RING_LEN_SIZE);
+    copyToTcpRing(pstEnd->pstRing, pstEnd->u32Capacity, u64Tail + TCP_RING_LEN_SIZE, kpvData, u32Len);
+    pstEnd->u64Pos = u64Tail + TCP_RING_LEN_SIZE + u32Len;
+    __atomic_store_n(&pstEnd->pstRing->u64Tail, pstEnd->u64Pos, __ATOMIC_RELEASE);
+    return 1;
+}
+
+int popTcpRingEnd(TCP_RING_END *pstEnd, void *pvOut, uint32_t u32OutSize)
+{
+    uint64_t u64Head = pstEnd->u64Pos;
+    uint64_t u64Tail = __atomic_load_n(&pstEnd->pstRing->u64Tail, __ATOMIC_ACQUIRE);
+    uint64_t u64Used = u64Tail - u64Head;
+    uint32_t u32Len;
+
+    if (u64Used == 0) {
+        return 0;
+    }
+    if (u64Used > pstEnd->u32Capacity || u64Used < TCP_RING_LEN_SIZE) {
+        return TCP_RING_CORRUPT;
+    }
+
+    copyFromTcpRing(pstEnd->pstRing, pstEnd->u32Capacity, u64Head, &u32Len, TCP_RING_LEN_SIZE);
+    if (u32Len == 0 || u32Len > u64Used - TCP_RING_LEN_SIZE) {
+        return TCP_RING_CORRUPT;
+    }
+    if (u32Len > u32OutSize) {
+        return -1;
+    }
+
+    copyFromTcpRing(pstEnd->pstRing, pstEnd->u32Capacity, u64Head + TCP_RING_LEN_SIZE, pvOut, u32Len);
+    pstEnd->u64Pos = u64Head + TCP_RING_LEN_SIZE + u32Len;
+    __atomic_store_n(&pstEnd->pstRing->u64Head, pstEnd->u64Pos, __ATOMIC_RELEASE);
+    return (int)u32Len;
+}
@@ -0,0 +1,592 @@
+/**
+ * @file tcpShm.c
+ * @brief 같은 호스트의 고속 생산자를 위한 공유 메모리 링 전송 API
+ *
+ * 클라이언트가 memfd 영역에 방향별 SPSC 링(TCP_RING) 두 개를 만들고, Unix 도메인 연결로
+ * fd를 넘겨(SCM_RIGHTS) 서버와 공유합니다. 이후 프레임은 소켓을 거치지 않고 링으로 오갑니다.
+ * 소비자는 링이 비었을 때 잠깐 돌며 기다린 뒤 futex로 잠들고, 생산자는 상대가 잠들었다고
+ * 표시한 경우에만 깨우므로 메시지가 이어지는 동안에는 시스템 호출이 없습니다.
+ * 상대는 영역을 언제든 쓸 수 있으므로, 링 크기와 이쪽 위치는 붙을 때 이쪽 메모리에 복사해 두고(TCP_RING_END)
+ * 상대 위치와 레코드 길이는 읽을 때마다 검사합니다. memfd는 크기를 바꿀 수 없도록 봉인(F_SEAL_SHRINK|F_SEAL_GROW)하여
+ * 매핑한 뒤 잘려 SIGBUS가 나지 않게 합니다.
+ *
+ * 주요 기능:
+ * - 공유 메모리 영역 생성/붙기/닫기
+ * - 레코드 송수신 (가득 참/비어 있음 대기, 제한 시간)
+ * - Unix 도메인 연결을 통한 전송 제안
+ *
+ * @date 2026-10-16
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /**< memfd_create() */
+#endif
+#include "tcpShm.h"
+#include "tcpRing.h"
+#include "tcpFrame.h"
+
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#define TCP_SHM_DIRS 2                  /**< 0: 클라이언트→서버, 1: 서버→클라이언트 */
+#define TCP_SHM_ALIGN 64                /**< 링 시작 정렬 (캐시 라인) */
+#define TCP_SHM_RECORD_OVERHEAD ((uint32_t)sizeof(uint32_t)) /**< 링 레코드 길이 필드 */
+#define TCP_SHM_SEALS (F_SEAL_SHRINK | F_SEAL_GROW) /**< 붙기 전에 memfd에 있어야 하는 봉인 */
+
+/**
+ * @brief 한쪽이 잠들어 기다리는 자리 (futex)
+ */
+typedef struct {
+    uint32_t u32Seq;                /**< futex 값. 깨울 때마다 증가합니다. */
+    uint32_t u32Waiting;            /**< 잠들려는 쪽이 있으면 1 */
+    uint8_t au8Pad[56];             /**< 캐시 라인 분리 */
+} TCP_SHM_WAKE;
+
+/**
+ * @brief 공유 메모리 영역 머리. 뒤에 방향별 링이 이어집니다.
+ */
+typedef struct {
+    uint32_t u32Magic;              /**< TCP_SHM_MAGIC. 초기화를 마친 뒤 기록합니다. */
+    uint32_t u32Version;            /**< TCP_SHM_VERSION */
+    uint32_t u32RingSize;           /**< 방향별 링 데이터 크기 (2의 거듭제곱) */
+    uint32_t u32Closed;             /**< 어느 한쪽이 닫았으면 1 */
+    uint8_t au8Pad[48];             /**< 캐시 라인 분리 */
+    TCP_SHM_WAKE astDataWake[TCP_SHM_DIRS];     /**< 방향별 링이 비어 소비자가 기다리는 자리 */
+    TCP_SHM_WAKE astSpaceWake[TCP_SHM_DIRS];    /**< 방향별 링이 가득 차 생산자가 기다리는 자리 */
+} TCP_SHM_REGION;
+
+struct TCP_SHM {
+    int iFd;                        /**< memfd */
+    TCP_SHM_REGION *pstRegion;      /**< 매핑된 영역 */
+    size_t uiMapSize;               /**< 매핑 크기 */
+    uint32_t u32RingSize;           /**< 붙을 때 확인한 방향별 링 크기 (영역의 값은 다시 읽지 않음) */
+    int iTxDir;                     /**< 이쪽이 생산자인 링 번호 */
+    int iRxDir;                     /**< 이쪽이 소비자인 링 번호 */
+    TCP_RING_END stTx;              /**< 송신 링의 생산자 끝 */
+    TCP_RING_END stRx;              /**< 수신 링의 소비자 끝 */
+};
+
+static size_t alignTcpShm(size_t uiSize)
+{
+    return (uiSize + TCP_SHM_ALIGN - 1) & ~(size_t)(TCP_SHM_ALIGN - 1);
+}
+
+/**
+ * @brief 링 크기로 영역 배치를 구합니다.
+ * @return 영역 전체 크기 (페이지 단위로 올림)
+ */
+static size_t getTcpShmLayout(uint32_t u32RingSize, size_t auiRingOffset[TCP_SHM_DIRS])
+{
+    size_t uiOffset = alignTcpShm(sizeof(TCP_SHM_REGION));
+    size_t uiPage = (size_t)sysconf(_SC_PAGESIZE);
+
+    for (int i = 0; i < TCP_SHM_DIRS; i++) {
+        auiRingOffset[i] = uiOffset;
+        uiOffset = alignTcpShm(uiOffset + getTcpRingFootprint(u32RingSize));
+    }
+    return (uiOffset + uiPage - 1) / uiPage * uiPage;
+}
+
+static int64_t getTcpShmNowNs(void)
+{
+    struct timespec stNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &stNow);
+    return (int64_t)stNow.tv_sec * 1000000000LL + stNow.tv_nsec;
+}
+
+static inline void relaxTcpShmCpu(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+/**
+ * @brief 잠들기 전에 돌며 기다릴 횟수를 구합니다.
+ *
+ * @details CPU가 하나뿐이면 도는 동안 상대가 실행될 수 없으므로 돌지 않고 바로 잠듭니다.
+ */
+static int getTcpShmSpinCount(void)
+{
+    static int s_iSpinCount = -1;
+    int iSpinCount = __atomic_load_n(&s_iSpinCount, __ATOMIC_RELAXED);
+
+    if (iSpinCount < 0) {
+        iSpinCount = (sysconf(_SC_NPROCESSORS_ONLN) > 1) ? TCP_SHM_SPIN_COUNT : 0;
+        __atomic_store_n(&s_iSpinCount, iSpinCount, __ATOMIC_RELAXED);
+    }
+    return iSpinCount;
+}
+
+bool isTcpShmClosed(const TCP_SHM *kpstShm)
+{
+    return __atomic_load_n(&kpstShm->pstRegion->u32Closed, __ATOMIC_ACQUIRE) != 0;
+}
+
+/**
+ * @brief 링이 기다리던 상태가 되었는지 확인합니다.
+ * @param u32Need 0이면 레코드가 있는지, 0이 아니면 그만큼 빈 공간이 있는지 확인합니다.
+ *
+ * @details 상대가 위치를 망가뜨렸으면 준비되었다고 보고, 호출자가 넣기/꺼내기에서 TCP_RING_CORRUPT를 보게 합니다.
+ */
+static bool isTcpShmRingReady(const TCP_RING_END *kpstEnd, uint32_t u32Need)
+{
+    uint64_t u64Used = getTcpRingEndUsed(kpstEnd);
+
+    if (u32Need == 0 || u64Used > kpstEnd->u32Capacity) {
+        return u64Used != 0;
+    }
+    return kpstEnd->u32Capacity - u64Used >= u32Need;
+}
+
+/**
+ * @brief 상대가 잠들어 있으면 깨웁니다.
+ *
+ * @details 링 위치를 게시한 뒤 u32Waiting을 읽기 전에 전체 순서 울타리를 두어,
+ *          상대가 "잠든다고 표시 → 링 재확인" 하는 순서와 엇갈려도 깨우기를 놓치지 않습니다.
+ */
+static void wakeTcpShmWaiter(TCP_SHM_WAKE *pstWake)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&pstWake->u32Waiting, __ATOMIC_RELAXED) == 0) {
+        return;
+    }
+    if (__atomic_exchange_n(&pstWake->u32Waiting, 0, __ATOMIC_ACQ_REL) != 0) {
+        __atomic_fetch_add(&pstWake->u32Seq, 1, __ATOMIC_RELEASE);
+        syscall(SYS_futex, &pstWake->u32Seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+    }
+}
+
+/**
+ * @brief 링이 준비되거나 전송이 닫힐 때까지 한 번 잠듭니다.
+ * @param i64DeadlineNs 제한 시각 (음수이면 제한 없음)
+ * @return 제한 시각이 지났으면 false
+ *
+ * @details 프로세스 간에 공유하므로 FUTEX_PRIVATE_FLAG 없이 기다립니다. 깨어난 뒤 조건은 호출자가 다시 확인합니다.
+ */
+static bool sleepTcpShm(TCP_SHM *pstShm, TCP_SHM_WAKE *pstWake, const TCP_RING_END *kpstEnd, uint32_t u32Need,
+                        int64_t i64DeadlineNs)
+{
+    uint32_t u32Seq = __atomic_load_n(&pstWake->u32Seq, __ATOMIC_ACQUIRE);
+    bool bInTime = true;
+
+    __atomic_store_n(&pstWake->u32Waiting, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (!isTcpShmRingReady(kpstEnd, u32Need) && !isTcpShmClosed(pstShm)) {
+        struct timespec stTimeout, *pstTimeout = NULL;
+
+        if (i64DeadlineNs >= 0) {
+            int64_t i64RemainNs = i64DeadlineNs - getTcpShmNowNs();
+
+            if (i64RemainNs <= 0) {
+                bInTime = false;
+            }
+            stTimeout.tv_sec = i64RemainNs / 1000000000LL;
+            stTimeout.tv_nsec = i64RemainNs % 1000000000LL;
+            pstTimeout = &stTimeout;
+        }
+        if (bInTime) {
+            syscall(SYS_futex, &pstWake->u32Seq, FUTEX_WAIT, u32Seq, pstTimeout, NULL, 0);
+        }
+    }
+    __atomic_store_n(&pstWake->u32Waiting, 0, __ATOMIC_RELAXED);
+    return bInTime;
+}
+
+static int64_t getTcpShmDeadline(int iTimeoutMs)
+{
+    return (iTimeoutMs < 0) ? -1 : getTcpShmNowNs() + (int64_t)iTimeoutMs * 1000000LL;
+}
+
+/**
+ * @brief 매핑된 영역으로 핸들을 채웁니다.
+ * @param u32RingSize 확인을 마친 방향별 링 크기
+ */
+static TCP_SHM *openTcpShm(int iFd, TCP_SHM_REGION *pstRegion, size_t uiMapSize, uint32_t u32RingSize, bool bCreator)
+{
+    size_t auiRingOffset[TCP_SHM_DIRS];
+    TCP_SHM *pstShm = (TCP_SHM *)calloc(1, sizeof(TCP_SHM));
+
+    if (pstShm == NULL) {
+        return NULL;
+    }
+    getTcpShmLayout(u32RingSize, auiRingOffset);
+    pstShm->iFd = iFd;
+    pstShm->pstRegion = pstRegion;
+    pstShm->uiMapSize = uiMapSize;
+    pstShm->u32RingSize = u32RingSize;
+    pstShm->iTxDir = bCreator ? 0 : 1;
+    pstShm->iRxDir = bCreator ? 1 : 0;
+    openTcpRingEnd(&pstShm->stTx, (TCP_RING *)((uint8_t *)pstRegion + auiRingOffset[pstShm->iTxDir]), u32RingSize, true);
+    openTcpRingEnd(&pstShm->stRx, (TCP_RING *)((uint8_t *)pstRegion + auiRingOffset[pstShm->iRxDir]), u32RingSize, false);
+    return pstShm;
+}
+
+TCP_SHM *createTcpShm(uint32_t u32RingSize)
+{
+    size_t auiRingOffset[TCP_SHM_DIRS];
+    size_t uiMapSize;
+    TCP_SHM_REGION *pstRegion;
+    TCP_SHM *pstShm;
+    int iFd;
+
+    if (u32RingSize == 0 || u32RingSize > TCP_SHM_MAX_RING_SIZE) {
+        errno = EINVAL;
+        return NULL;
+    }
+    u32RingSize = (uint32_t)(getTcpRingFootprint(u32RingSize) - sizeof(TCP_RING)); /**< 2의 거듭제곱으로 올림 */
+    uiMapSize = getTcpShmLayout(u32RingSize, auiRingOffset);
+
+    if ((iFd = memfd_create("tcpShm", MFD_CLOEXEC | MFD_ALLOW_SEALING)) < 0) {
+        return NULL;
+    }
+    /**< 상대가 붙은 뒤 크기를 바꿔 매핑 밖을 가리키지 않도록 크기를 봉인합니다. */
+    if (ftruncate(iFd, (off_t)uiMapSize) < 0 || fcntl(iFd, F_ADD_SEALS, TCP_SHM_SEALS | F_SEAL_SEAL) < 0) {
+        close(iFd);
+        return NULL;
+    }
+    /**< 첫 메시지에서 페이지 폴트가 나지 않도록 미리 채웁니다. */
+    pstRegion = (TCP_SHM_REGION *)mmap(NULL, uiMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, iFd, 0);
+    if (pstRegion == MAP_FAILED) {
+        close(iFd);
+        return NULL;
+    }
+
+    pstRegion->u32Version = TCP_SHM_VERSION;
+    pstRegion->u32RingSize = u32RingSize;
+    for (int i = 0; i < TCP_SHM_DIRS; i++) {
+        initTcpRing((uint8_t *)pstRegion + auiRingOffset[i], u32RingSize);
+    }
+    __atomic_store_n(&pstRegion->u32Magic, TCP_SHM_MAGIC, __ATOMIC_RELEASE);
+
+    if ((pstShm = openTcpShm(iFd, pstRegion, uiMapSize, u32RingSize, true)) == NULL) {
+        munmap(pstRegion, uiMapSize);
+        close(iFd);
+        errno = ENOMEM;
+    }
+    return pstShm;
+}
+
+TCP_SHM *attachTcpShm(int iMemFd)
+{
+    size_t auiRingOffset[TCP_SHM_DIRS];
+    struct stat stStat;
+    TCP_SHM_REGION *pstRegion;
+    TCP_SHM *pstShm;
+    uint32_t u32RingSize;
+    bool bValid;
+    int iSeals;
+
+    if ((iSeals = fcntl(iMemFd, F_GET_SEALS)) < 0 || (iSeals & TCP_SHM_SEALS) != TCP_SHM_SEALS) {
+        errno = EPROTO; /**< 크기를 바꿀 수 있는 fd는 매핑 뒤 잘려 SIGBUS를 낼 수 있습니다. */
+        return NULL;
+    }
+    if (fstat(iMemFd, &stStat) < 0) {
+        return NULL;
+    }
+    if ((size_t)stStat.st_size < sizeof(TCP_SHM_REGION)) {
+        errno = EPROTO;
+        return NULL;
+    }
+    pstRegion = (TCP_SHM_REGION *)mmap(NULL, (size_t)stStat.st_size, PROT_READ | PROT_WRITE,
+                                       MAP_SHARED | MAP_POPULATE, iMemFd, 0);
+    if (pstRegion == MAP_FAILED) {
+        return NULL;
+    }
+
+    u32RingSize = __atomic_load_n(&pstRegion->u32RingSize, __ATOMIC_RELAXED); /**< 한 번만 읽어 이쪽에 둡니다. */
+    bValid = __atomic_load_n(&pstRegion->u32Magic, __ATOMIC_ACQUIRE) == TCP_SHM_MAGIC
+             && pstRegion->u32Version == TCP_SHM_VERSION
+             && u32RingSize >= 64 && u32RingSize <= TCP_SHM_MAX_RING_SIZE
+             && (u32RingSize & (u32RingSize - 1)) == 0
+             && getTcpShmLayout(u32RingSize, auiRingOffset) <= (size_t)stStat.st_size;
+    if (!bValid) {
+        munmap(pstRegion, (size_t)stStat.st_size);
+        errno = EPROTO;
+        return NULL;
+    }
+
+    if ((pstShm = openTcpShm(iMemFd, pstRegion, (size_t)stStat.st_size, u32RingSize, false)) == NULL) {
+        munmap(pstRegion, (size_t)stStat.st_size);
+        errno = ENOMEM;
+    }
+    return pstShm;
+}
+
+void closeTcpShm(TCP_SHM *pstShm)
+{
+    TCP_SHM_REGION *pstRegion = pstShm->pstRegion;
+
+    __atomic_store_n(&pstRegion->u32Closed, 1, __ATOMIC_RELEASE);
+    /**< 잠든 표시와 관계없이 모든 자리를 깨워 양쪽이 닫힘을 보게 합니다. */
+    for (int i = 0; i < TCP_SHM_DIRS; i++) {
+        __atomic_fetch_add(&pstRegion->astDataWake[i].u32Seq, 1, __ATOMIC_RELEASE);
+        syscall(SYS_futex, &pstRegion->astDataWake[i].u32Seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+        __atomic_fetch_add(&pstRegion->astSpaceWake[i].u32Seq, 1, __ATOMIC_RELEASE);
+        syscall(SYS_futex, &pstRegion->astSpaceWake[i].u32Seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+    }
+}
+
+void destroyTcpShm(TCP_SHM *pstShm)
+{
+    if (pstShm == NULL) {
+        return;
+    }
+    closeTcpShm(pstShm);
+    munmap(pstShm->pstRegion, pstShm->uiMapSize);
+    close(pstShm->iFd);
+    free(pstShm);
+}
+
+int getTcpShmFd(const TCP_SHM *kpstShm)
+{
+    return kpstShm->iFd;
+}
+
+int sendTcpShm(TCP_SHM *pstShm, const void *kpvData, uint32_t u32Len, int iTimeoutMs)
+{
+    TCP_SHM_WAKE *pstSpaceWake = &pstShm->pstRegion->astSpaceWake[pstShm->iTxDir];
+    uint32_t u32Need = u32Len + TCP_SHM_RECORD_OVERHEAD;
+    int64_t i64DeadlineNs = getTcpShmDeadline(iTimeoutMs);
+    int iSpinCount = getTcpShmSpinCount();
+
+    if (u32Len == 0 || u32Need > pstShm->u32RingSize) {
+        errno = EMSGSIZE;
+        return -1;
+    }
+
+    for (int iSpin = 0;; iSpin++) {
+        if (isTcpShmClosed(pstShm)) {
+            errno = EPIPE;
+            return -1;
+        }
+        int iPushed = pushTcpRingEnd(&pstShm->stTx, kpvData, u32Len);
+
+        if (iPushed > 0) {
+            wakeTcpShmWaiter(&pstShm->pstRegion->astDataWake[pstShm->iTxDir]);
+            return 0;
+        }
+        if (iPushed == TCP_RING_CORRUPT) {
+            closeTcpShm(pstShm);
+            errno = EPROTO;
+            return -1;
+        }
+        if (iTimeoutMs == 0) {
+            errno = EAGAIN;
+            return -1;
+        }
+        if (iSpin < iSpinCount) {
+            relaxTcpShmCpu();
+        } else if (!sleepTcpShm(pstShm, pstSpaceWake, &pstShm->stTx, u32Need, i64DeadlineNs)) {
+            errno = EAGAIN;
+            return -1;
+        }
+    }
+}
+
+int recvTcpShm(TCP_SHM *pstShm, void *pvOut, uint32_t u32OutSize, int iTimeoutMs)
+{
+    TCP_SHM_WAKE *pstDataWake = &pstShm->pstRegion->astDataWake[pstShm->iRxDir];
+    int64_t i64DeadlineNs = getTcpShmDeadline(iTimeoutMs);
+    int iSpinCount = getTcpShmSpinCount();
+
+    for (int iSpin = 0;; iSpin++) {
+        int iLen = popTcpRingEnd(&pstShm->stRx, pvOut, u32OutSize);
+
+        if (iLen > 0) {
+            wakeTcpShmWaiter(&pstShm->pstRegion->astSpaceWake[pstShm->iRxDir]);
+            return iLen;
+        }
+        if (iLen == TCP_RING_CORRUPT) {
+            closeTcpShm(pstShm);
+            errno = EPROTO;
+            return -1;
+        }
+        if (iLen < 0) {
+            errno = EMSGSIZE;
+            return -1;
+        }
+        if (isTcpShmClosed(pstShm)) {
+            /**< 닫기 직전에 들어온 레코드는 마저 읽습니다. */
+            if (getTcpRingEndUsed(&pstShm->stRx) != 0) {
+                continue;
+            }
+            errno = EPIPE;
+            return -1;
+        }
+        if (iTimeoutMs == 0) {
+            return 0;
+        }
+        if (iSpin < iSpinCount) {
+            relaxTcpShmCpu();
+        } else if (!sleepTcpShm(pstShm, pstDataWake, &pstShm->stRx, 0, i64DeadlineNs)) {
+            return 0;
+        }
+    }
+}
+
+/**
+ * @brief 프레임과 함께 fd 하나를 SCM_RIGHTS로 보냅니다.
+ */
+static int sendTcpShmOffer(int iSock, const uint8_t *kpu8Frame, size_t uiFrameLen, int iFd)
+{
+    union {
+        struct cmsghdr stAlign;
+        char achBuf[CMSG_SPACE(sizeof(int))];
+    } uCtrl;
+    struct iovec stIov;
+    struct msghdr stMsg;
+    struct cmsghdr *pstCmsg;
+    ssize_t iSent;
+
+    memset(&uCtrl, 0x0, sizeof(uCtrl));
+    memset(&stMsg, 0x0, sizeof(stMsg));
+    stIov.iov_base = (void *)kpu8Frame;
+    stIov.iov_len = uiFrameLen;
+    stMsg.msg_iov = &stIov;
+    stMsg.msg_iovlen = 1;
+    stMsg.msg_control = uCtrl.achBuf;
+    stMsg.msg_controllen = sizeof(uCtrl.achBuf);
+    pstCmsg = CMSG_FIRSTHDR(&stMsg);
+    pstCmsg->cmsg_level = SOL_SOCKET;
+    pstCmsg->cmsg_type = SCM_RIGHTS;
+    pstCmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(pstCmsg), &iFd, sizeof(int));
+
+    do {
+        iSent = sendmsg(iSock, &stMsg, MSG_NOSIGNAL);
+    } while (iSent < 0 && errno == EINTR);
+    if (iSent < 0) {
+        return -1;
+    }
+    if ((size_t)iSent != uiFrameLen) {
+        errno = EIO;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief TCP_INST_SHM_OFFER 응답 프레임을 기다려 상태 값을 돌려줍니다.
+ * @return 서버가 보낸 상태 (0이면 수락). 실패 시 -1 (errno 설정)
+ */
+static int waitTcpShmReply(int iSock, int iTimeoutMs)
+{
+    size_t uiCap = TCP_FRAME_MAX_SIZE * 2;
+    uint8_t *pu8Stream = (uint8_t *)malloc(uiCap);
+    size_t uiLen = 0;
+    int64_t i64DeadlineNs = getTcpShmDeadline(iTimeoutMs);
+    int iStatus = -1;
+
+    if (pu8Stream == NULL) {
+        return -1;
+    }
+    while (iStatus < 0) {
+        struct pollfd stPoll;
+        int iWaitMs = (int)((i64DeadlineNs - getTcpShmNowNs()) / 1000000LL);
+        ssize_t iReadSize;
+        size_t uiOffset = 0;
+        int iReady;
+
+        stPoll.fd = iSock;
+        stPoll.events = POLLIN;
+        stPoll.revents = 0;
+        if (iWaitMs <= 0) {
+            errno = ETIMEDOUT;
+            break;
+        }
+        if ((iReady = poll(&stPoll, 1, iWaitMs)) < 0 && errno == EINTR) {
+            continue;
+        }
+        if (iReady <= 0) {
+            errno = (iReady == 0) ? ETIMEDOUT : errno;
+            break;
+        }
+        iReadSize = read(iSock, pu8Stream + uiLen, uiCap - uiLen);
+        if (iReadSize <= 0) {
+            if (iReadSize < 0 && errno == EINTR) {
+                continue;
+            }
+            errno = (iReadSize == 0) ? ECONNRESET : errno;
+            break;
+        }
+        uiLen += (size_t)iReadSize;
+
+        /**< 제안 응답이 아닌 프레임은 버립니다. */
+        while (uiOffset < uiLen) {
+            TCP_FRAME_HEADER stHeader;
+            const uint8_t *kpu8Data;
+            int iFrameLen = decodeTcpFrame(pu8Stream + uiOffset, uiLen - uiOffset, &stHeader, &kpu8Data);
+
+            if (iFrameLen == 0) {
+                break;
+            }
+            if (iFrameLen < 0) {
+                uiOffset += findTcpFrameStart(pu8Stream + uiOffset, uiLen - uiOffset);
+                continue;
+            }
+            if (stHeader.u8Instruction == TCP_INST_SHM_OFFER && stHeader.u16DataLen >= 1) {
+                iStatus = kpu8Data[0];
+                break;
+            }
+            uiOffset += (size_t)iFrameLen;
+        }
+        memmove(pu8Stream, pu8Stream + uiOffset, uiLen - uiOffset);
+        uiLen -= uiOffset;
+    }
+    free(pu8Stream);
+    return iStatus;
+}
+
+TCP_SHM *offerTcpShm(int iSock, uint8_t u8ClientId, uint32_t u32RingSize, int iTimeoutMs)
+{
+    struct sockaddr_storage stAddr;
+    socklen_t uiAddrLen = sizeof(stAddr);
+    uint8_t au8Frame[TCP_FRAME_HEADER_SIZE + TCP_FRAME_CRC_SIZE];
+    TCP_SHM *pstShm;
+    int iFrameLen;
+    int iStatus;
+
+    if (getsockname(iSock, (struct sockaddr *)&stAddr, &uiAddrLen) < 0) {
+        return NULL;
+    }
+    if (stAddr.ss_family != AF_UNIX) {
+        errno = EOPNOTSUPP; /**< fd는 Unix 도메인 소켓으로만 넘길 수 있습니다. */
+        return NULL;
+    }
+    if ((pstShm = createTcpShm(u32RingSize)) == NULL) {
+        return NULL;
+    }
+
+    iFrameLen = encodeTcpFrame(au8Frame, sizeof(au8Frame), u8ClientId, TCP_INST_SHM_OFFER, NULL, 0);
+    if (sendTcpShmOffer(iSock, au8Frame, (size_t)iFrameLen, pstShm->iFd) < 0
+        || (iStatus = waitTcpShmReply(iSock, iTimeoutMs)) < 0) {
+        int iError = errno;
+
+        destroyTcpShm(pstShm);
+        errno = iError;
+        return NULL;
+    }
+    if (iStatus != 0) {
+        destroyTcpShm(pstShm);
+        errno = iStatus;
+        return NULL;
+    }
+    return pstShm;
+}
@@ -8,10 +8,18 @@
  * 연결 해제 처리에 대한 기능을 제공합니다. 
  *
  * 주요 기능:
- * - 서버 소켓 생성 및 설정 (TCP Keep-Alive 포함)
- * - 클라이언트 소켓 생성 및 서버 연결
+ * - 서버 소켓 생성 및 설정 (TCP Keep-Alive 포함, IPv4/IPv6 이중 스택, 바인드 주소 선택)
+ * - 클라이언트 소켓 생성 및 서버 연결 (IPv4/IPv6)
+ * - 같은 호스트용 Unix 도메인 소켓 대기 및 연결 (추상 네임스페이스 포함)
+ * - 다른 프로세스로 소켓 fd 넘기기 (SCM_RIGHTS, 재시작 중 대기 소켓 인계)
+ * - fd가 모자라도(EMFILE/ENFILE) 대기열을 비우는 accept (예비 fd)
+ * - 실패 시 프로세스를 끝내지 않고 -1과 errno 반환
+ * - 소켓 주소 문자열 변환 및 대기 포트 조회
+ * - 제한 시간이 있는 비차단 연결 (여러 주소 동시 시도, Happy Eyeballs)
+ * - 재연결 백오프 시간 계산
  * - 클라이언트 연결 해제 및 연결 상태 모니터링
  * - 소켓의 RX 및 TX 버퍼 크기 설정
+ * - 커널에 쌓이는 미전송 바이트 제한 (TCP_NOTSENT_LOWAT)과 쓰기 가능 대기
  *
  * @author 박철우
  * @date 2024-12-04
@@ -19,32 +27,30 @@
 #include "tcpSock.h"
 
 #include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <netdb.h>
+#include <poll.h>
+#include <time.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/un.h>
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
 
-int createTcpServerSocket(int iPort, int iMaxClients)
+/**
+ * @brief 대기 소켓과 연결 소켓에 공통으로 쓰는 TCP Keep-Alive 옵션을 설정합니다.
+ *
+ * @details SOL_SOCKET/IPPROTO_TCP 수준 옵션이므로 IPv4와 IPv6 소켓에서 똑같이 동작하며,
+ *          accept()로 얻은 소켓은 대기 소켓의 값을 물려받습니다.
+ */
+static int setTcpKeepAliveOptions(int iSock)
 {
-    int iServerSock;
-    struct sockaddr_in stSockAddr;
-    int iSockOpt = 1;
-
-    if ((iServerSock = socket(AF_INET, SOCK_STREAM, 0)) == 0) {
-        perror("Socket failed");
-        exit(EXIT_FAILURE);
-    }
-
-    /**
-     * @brief 주소 재사용을 허용하기 위해 소켓 옵션 설정
-     */
-    if (setsockopt(iServerSock, SOL_SOCKET, SO_REUSEADDR | SO_REUSEPORT, &iSockOpt, sizeof(iSockOpt))) {
-        perror("Setsockopt failed");
-        exit(EXIT_FAILURE);
-    }
-
     // TCP Keep-Alive 설정 추가
     int iKeepAlive = 1;
     int iKeepIdle = 10; // 첫 번째 Keep-Alive 패킷을 보내기까지의 대기 시간 (초)
@@ -56,78 +62,648 @@ int createTcpServerSocket(int iPort, int iMaxClients)
      * 
      * SO_KEEPALIVE: 소켓에서 Keep-Alive 메시지를 활성화합니다.
      */
-    if (setsockopt(iServerSock, SOL_SOCKET, SO_KEEPALIVE, &iKeepAlive, sizeof(iKeepAlive)) < 0) {
+    if (setsockopt(iSock, SOL_SOCKET, SO_KEEPALIVE, &iKeepAlive, sizeof(iKeepAlive)) < 0) {
         perror("Setsockopt SO_KEEPALIVE failed");
-        exit(EXIT_FAILURE);
+        return -1;
     }
     /**
      * @brief 첫 번째 Keep-Alive 프로브를 보내기 전에 대기하는 시간을 설정합니다.
      * 
      * TCP_KEEPIDLE: Keep-Alive 프로브를 보내기 전까지 대기할 시간(초)입니다.
      */
-    if (setsockopt(iServerSock, IPPROTO_TCP, TCP_KEEPIDLE, &iKeepIdle, sizeof(iKeepIdle)) < 0) {
+    if (setsockopt(iSock, IPPROTO_TCP, TCP_KEEPIDLE, &iKeepIdle, sizeof(iKeepIdle)) < 0) {
         perror("Setsockopt TCP_KEEPIDLE failed");
-        exit(EXIT_FAILURE);
+        return -1;
     }
     /**
      * @brief Keep-Alive 프로브 간의 간격을 설정합니다.
      * 
      * TCP_KEEPINTVL: 각 Keep-Alive 프로브 간의 시간 간격(초)입니다.
      */
-    if (setsockopt(iServerSock, IPPROTO_TCP, TCP_KEEPINTVL, &iKeepInterval, sizeof(iKeepInterval)) < 0) {
+    if (setsockopt(iSock, IPPROTO_TCP, TCP_KEEPINTVL, &iKeepInterval, sizeof(iKeepInterval)) < 0) {
         perror("Setsockopt TCP_KEEPINTVL failed");
-        exit(EXIT_FAILURE);
+        return -1;
     }
     /**
      * @brief 연결이 끊긴 것으로 간주하기 전까지 보낼 최대 Keep-Alive 프로브 수를 설정합니다.
      * 
      * TCP_KEEPCNT: 연결이 끊겼다고 선언하기 전 실패한 Keep-Alive 프로브의 수입니다.
      */
-    if (setsockopt(iServerSock, IPPROTO_TCP, TCP_KEEPCNT, &iKeepCount, sizeof(iKeepCount)) < 0) {
+    if (setsockopt(iSock, IPPROTO_TCP, TCP_KEEPCNT, &iKeepCount, sizeof(iKeepCount)) < 0) {
         perror("Setsockopt TCP_KEEPCNT failed");
-        exit(EXIT_FAILURE);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 실패 원인을 출력하고 소켓을 닫은 뒤 -1을 반환합니다. errno는 실패 원인 그대로 남깁니다.
+ */
+static int failTcpSocket(int iSock, const char *kpchWhat)
+{
+    int iError = errno;
+
+    if (kpchWhat != NULL) {
+        perror(kpchWhat);
+    }
+    if (iSock >= 0) {
+        close(iSock);
+    }
+    errno = iError;
+    return -1;
+}
+
+/**
+ * @brief 바인드 주소 문자열을 소켓 주소로 바꿉니다.
+ * @return 성공 시 0, 숫자 주소가 아니면 -1
+ *
+ * @details NULL이나 빈 문자열, "*" 는 이중 스택 와일드카드(::)로 봅니다. IPv6 주소는 "[::1]" 처럼 대괄호로 감싸도 됩니다.
+ */
+static int parseTcpBindAddr(const char *kpchBindAddr, int iPort, struct sockaddr_storage *pstAddr, socklen_t *puiAddrLen)
+{
+    struct sockaddr_in6 *pstAddr6 = (struct sockaddr_in6 *)pstAddr;
+    struct sockaddr_in *pstAddr4 = (struct sockaddr_in *)pstAddr;
+    char achHost[INET6_ADDRSTRLEN];
+    size_t uiLen;
+
+    memset(pstAddr, 0x0, sizeof(*pstAddr));
+    if (kpchBindAddr == NULL || kpchBindAddr[0] == '\0' || strcmp(kpchBindAddr, "*") == 0) {
+        kpchBindAddr = "::";
+    }
+    uiLen = strlen(kpchBindAddr);
+    if (kpchBindAddr[0] == '[' && uiLen > 2 && kpchBindAddr[uiLen - 1] == ']') {
+        kpchBindAddr++;
+        uiLen -= 2;
+    }
+    if (uiLen >= sizeof(achHost)) {
+        return -1;
+    }
+    memcpy(achHost, kpchBindAddr, uiLen);
+    achHost[uiLen] = '\0';
+
+    if (inet_pton(AF_INET6, achHost, &pstAddr6->sin6_addr) == 1) {
+        pstAddr6->sin6_family = AF_INET6;
+        pstAddr6->sin6_port = htons(iPort);
+        *puiAddrLen = sizeof(struct sockaddr_in6);
+        return 0;
+    }
+    if (inet_pton(AF_INET, achHost, &pstAddr4->sin_addr) == 1) {
+        pstAddr4->sin_family = AF_INET;
+        pstAddr4->sin_port = htons(iPort);
+        *puiAddrLen = sizeof(struct sockaddr_in);
+        return 0;
+    }
+    return -1;
+}
+
+int createTcpServerSocketOn(const char *kpchBindAddr, int iPort, int iMaxClients)
+{
+    int iServerSock;
+    struct sockaddr_storage stSockAddr;
+    socklen_t uiSockAddrLen;
+    int iSockOpt = 1;
+
+    if (parseTcpBindAddr(kpchBindAddr, iPort, &stSockAddr, &uiSockAddrLen) < 0) {
+        fprintf(stderr, "Invalid bind address: %s\n", kpchBindAddr);
+        errno = EINVAL;
+        return -1;
+    }
+
+    iServerSock = socket(stSockAddr.ss_family, SOCK_STREAM, 0);
+    if (iServerSock < 0 && errno == EAFNOSUPPORT && stSockAddr.ss_family == AF_INET6
+        && IN6_IS_ADDR_UNSPECIFIED(&((struct sockaddr_in6 *)&stSockAddr)->sin6_addr)) {
+        /**< IPv6를 끈 커널에서는 와일드카드 대기를 IPv4(0.0.0.0)로 대신합니다. */
+        parseTcpBindAddr("0.0.0.0", iPort, &stSockAddr, &uiSockAddrLen);
+        iServerSock = socket(AF_INET, SOCK_STREAM, 0);
+    }
+    if (iServerSock < 0) {
+        return failTcpSocket(-1, "Socket failed");
+    }
+
+    /**
+     * @brief TIME_WAIT 연결이 남아 있어도 바로 다시 바인드하도록 SO_REUSEADDR만 설정합니다.
+     *
+     * 옵션 이름은 비트 플래그가 아니므로 OR 하면 다른 옵션이 됩니다. SO_REUSEPORT는 켜지 않으므로 같은 포트에
+     * 두 번째 서버가 조용히 붙지 못하고 EADDRINUSE로 실패합니다. 재시작 시에는 대기 소켓 자체를 넘깁니다.
+     */
+    if (setsockopt(iServerSock, SOL_SOCKET, SO_REUSEADDR, &iSockOpt, sizeof(iSockOpt))) {
+        return failTcpSocket(iServerSock, "Setsockopt failed");
+    }
+
+    /**
+     * @brief IPv6 소켓은 IPv4 연결도 받도록 IPV6_V6ONLY를 끕니다.
+     *
+     * net.ipv6.bindv6only 기본값에 기대지 않고 명시적으로 설정합니다. IPv4 연결은 ::ffff:a.b.c.d 주소로 보입니다.
+     */
+    if (stSockAddr.ss_family == AF_INET6) {
+        int iV6Only = 0;
+
+        if (setsockopt(iServerSock, IPPROTO_IPV6, IPV6_V6ONLY, &iV6Only, sizeof(iV6Only)) < 0) {
+            return failTcpSocket(iServerSock, "Setsockopt IPV6_V6ONLY failed");
+        }
     }
 
-    stSockAddr.sin_family = AF_INET;
-    stSockAddr.sin_addr.s_addr = INADDR_ANY;
-    stSockAddr.sin_port = htons(iPort);
+    if (setTcpKeepAliveOptions(iServerSock) < 0) {
+        return failTcpSocket(iServerSock, NULL);
+    }
 
-    if (bind(iServerSock, (struct sockaddr *)&stSockAddr, sizeof(stSockAddr)) < 0) {
-        perror("Bind failed");
-        exit(EXIT_FAILURE);
+    if (bind(iServerSock, (struct sockaddr *)&stSockAddr, uiSockAddrLen) < 0) {
+        return failTcpSocket(iServerSock, "Bind failed");
     }
 
     if (listen(iServerSock, iMaxClients) < 0) {
-        perror("Listen failed");
-        exit(EXIT_FAILURE);
+        return failTcpSocket(iServerSock, "Listen failed");
     }
 
     return iServerSock;
 }
 
+int createTcpServerSocket(int iPort, int iMaxClients)
+{
+    return createTcpServerSocketOn(NULL, iPort, iMaxClients);
+}
+
 int createTcpClientSocket(const char *kpchIp, int iPort) {
+    return connectTcpClientSocket(kpchIp, iPort, 0);
+}
+
+/**
+ * @brief Unix 도메인 소켓 주소를 채웁니다. '@'로 시작하면 추상 네임스페이스를 사용합니다.
+ * @return 주소 길이. 경로가 너무 길면 0
+ */
+static socklen_t fillTcpUnixAddr(struct sockaddr_un *pstAddr, const char *kpchPath)
+{
+    size_t uiLen = strlen(kpchPath);
+
+    memset(pstAddr, 0x0, sizeof(struct sockaddr_un));
+    pstAddr->sun_family = AF_UNIX;
+    if (uiLen == 0 || uiLen >= sizeof(pstAddr->sun_path)) {
+        return 0;
+    }
+
+    memcpy(pstAddr->sun_path, kpchPath, uiLen);
+    if (kpchPath[0] == '@') {
+        pstAddr->sun_path[0] = '\0';
+        return (socklen_t)(offsetof(struct sockaddr_un, sun_path) + uiLen);
+    }
+
+    return (socklen_t)sizeof(struct sockaddr_un);
+}
+
+int createTcpUnixServerSocket(const char *kpchPath, int iMaxClients)
+{
+    struct sockaddr_un stSockAddr;
+    socklen_t uiSockAddrLen = fillTcpUnixAddr(&stSockAddr, kpchPath);
+    int iServerSock;
+
+    if (uiSockAddrLen == 0) {
+        fprintf(stderr, "Invalid Unix socket path: %s\n", kpchPath);
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+
+    if ((iServerSock = socket(AF_UNIX, SOCK_STREAM, 0)) < 0) {
+        return failTcpSocket(-1, "Socket failed");
+    }
+
+    if (kpchPath[0] != '@') {
+        unlink(kpchPath); /**< 이전 실행에서 남은 소켓 파일 제거 */
+    }
+
+    if (bind(iServerSock, (struct sockaddr *)&stSockAddr, uiSockAddrLen) < 0) {
+        return failTcpSocket(iServerSock, "Bind failed");
+    }
+
+    if (listen(iServerSock, iMaxClients) < 0) {
+        return failTcpSocket(iServerSock, "Listen failed");
+    }
+
+    return iServerSock;
+}
+
+int createTcpUnixClientSocket(const char *kpchPath)
+{
+    struct sockaddr_un stSockAddr;
+    socklen_t uiSockAddrLen = fillTcpUnixAddr(&stSockAddr, kpchPath);
     int iSock;
-    struct sockaddr_in stSockServAddr;
 
-    if ((iSock = socket(AF_INET, SOCK_STREAM, 0)) < 0) {
+    if (uiSockAddrLen == 0) {
+        fprintf(stderr, "Invalid Unix socket path: %s\n", kpchPath);
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+
+    if ((iSock = socket(AF_UNIX, SOCK_STREAM, 0)) < 0) {
         perror("Socket creation error");
         return -1;
     }
 
-    stSockServAddr.sin_family = AF_INET;
-    stSockServAddr.sin_port = htons(iPort);
+    if (connect(iSock, (struct sockaddr *)&stSockAddr, uiSockAddrLen) < 0) {
+        int iError = errno;
 
-    if (inet_pton(AF_INET, kpchIp, &stSockServAddr.sin_addr) <= 0) {
-        perror("Invalid address/ Address not supported");
+        fprintf(stderr, "Connection to %s failed: %s\n", kpchPath, strerror(iError));
+        close(iSock);
+        errno = iError;
         return -1;
     }
 
-    if (connect(iSock, (struct sockaddr *)&stSockServAddr, sizeof(stSockServAddr)) < 0) {
-        perror("Connection failed");
+    return iSock;
+}
+
+int sendTcpSocketFds(int iSock, const int *kpiFds, int iCount)
+{
+    union {
+        struct cmsghdr stAlign;
+        char achBuf[CMSG_SPACE(sizeof(int) * TCP_SOCK_MAX_PASS_FDS)];
+    } uCtrl;
+    uint8_t u8Count = (uint8_t)iCount;
+    struct iovec stIov;
+    struct msghdr stMsg;
+    struct cmsghdr *pstCmsg;
+    ssize_t iSent;
+
+    if (iCount <= 0 || iCount > TCP_SOCK_MAX_PASS_FDS) {
+        errno = EINVAL;
         return -1;
     }
 
-    return iSock;
+    memset(&uCtrl, 0x0, sizeof(uCtrl));
+    memset(&stMsg, 0x0, sizeof(stMsg));
+    stIov.iov_base = &u8Count; /**< SCM_RIGHTS는 데이터가 1바이트 이상 있어야 전달됩니다. */
+    stIov.iov_len = sizeof(u8Count);
+    stMsg.msg_iov = &stIov;
+    stMsg.msg_iovlen = 1;
+    stMsg.msg_control = uCtrl.achBuf;
+    stMsg.msg_controllen = CMSG_SPACE(sizeof(int) * (size_t)iCount);
+    pstCmsg = CMSG_FIRSTHDR(&stMsg);
+    pstCmsg->cmsg_level = SOL_SOCKET;
+    pstCmsg->cmsg_type = SCM_RIGHTS;
+    pstCmsg->cmsg_len = CMSG_LEN(sizeof(int) * (size_t)iCount);
+    memcpy(CMSG_DATA(pstCmsg), kpiFds, sizeof(int) * (size_t)iCount);
+
+    do {
+        iSent = sendmsg(iSock, &stMsg, MSG_NOSIGNAL);
+    } while (iSent < 0 && errno == EINTR);
+    return iSent == (ssize_t)sizeof(u8Count) ? 0 : -1;
+}
+
+int recvTcpSocketFds(int iSock, int *piFds, int iMaxCount, int iTimeoutMs)
+{
+    union {
+        struct cmsghdr stAlign;
+        char achBuf[CMSG_SPACE(sizeof(int) * TCP_SOCK_MAX_PASS_FDS)];
+    } uCtrl;
+    uint8_t u8Count = 0;
+    struct iovec stIov;
+    struct msghdr stMsg;
+    struct cmsghdr *pstCmsg;
+    struct pollfd stPoll;
+    ssize_t iRecv;
+    int iCount = 0;
+    int iReady;
+
+    stPoll.fd = iSock;
+    stPoll.events = POLLIN;
+    stPoll.revents = 0;
+    do {
+        iReady = poll(&stPoll, 1, iTimeoutMs > 0 ? iTimeoutMs : -1);
+    } while (iReady < 0 && errno == EINTR);
+    if (iReady <= 0) {
+        errno = (iReady == 0) ? ETIMEDOUT : errno;
+        return -1;
+    }
+
+    memset(&uCtrl, 0x0, sizeof(uCtrl));
+    memset(&stMsg, 0x0, sizeof(stMsg));
+    stIov.iov_base = &u8Count;
+    stIov.iov_len = sizeof(u8Count);
+    stMsg.msg_iov = &stIov;
+    stMsg.msg_iovlen = 1;
+    stMsg.msg_control = uCtrl.achBuf;
+    stMsg.msg_controllen = sizeof(uCtrl.achBuf);
+    do {
+        iRecv = recvmsg(iSock, &stMsg, MSG_CMSG_CLOEXEC);
+    } while (iRecv < 0 && errno == EINTR);
+    if (iRecv <= 0) {
+        errno = (iRecv == 0) ? ECONNRESET : errno;
+        return -1;
+    }
+
+    for (pstCmsg = CMSG_FIRSTHDR(&stMsg); pstCmsg != NULL; pstCmsg = CMSG_NXTHDR(&stMsg, pstCmsg)) {
+        if (pstCmsg->cmsg_level != SOL_SOCKET || pstCmsg->cmsg_type != SCM_RIGHTS) {
+            continue;
+        }
+        int iFds = (int)((pstCmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int));
+        for (int i = 0; i < iFds; i++) {
+            int iFd;
+
+            memcpy(&iFd, CMSG_DATA(pstCmsg) + sizeof(int) * (size_t)i, sizeof(int));
+            if (iCount < iMaxCount) {
+                piFds[iCount++] = iFd;
+            } else {
+                close(iFd); /**< 받을 자리가 없는 fd는 새지 않게 닫습니다. */
+            }
+        }
+    }
+    if ((stMsg.msg_flags & MSG_CTRUNC) != 0 || iCount != (int)u8Count) {
+        for (int i = 0; i < iCount; i++) {
+            close(piFds[i]);
+        }
+        errno = EPROTO;
+        return -1;
+    }
+    return iCount;
+}
+
+int openTcpReserveFd(void)
+{
+    return open("/dev/null", O_RDONLY | O_CLOEXEC);
+}
+
+int acceptTcpClientSocket(int iListenSock, int *piReserveFd)
+{
+    int iSock = accept(iListenSock, NULL, NULL);
+    int iError;
+
+    if (iSock >= 0 || (errno != EMFILE && errno != ENFILE) || piReserveFd == NULL || *piReserveFd < 0) {
+        return iSock;
+    }
+
+    /**
+     * fd가 모자라면 대기열의 연결은 받을 수 없어 그대로 남고, 대기 소켓은 계속 읽기 가능으로 보여 호출자가 헛돕니다.
+     * 예비 fd를 잠깐 풀어 맨 앞 연결을 받아 바로 닫으면, 상대는 시간 초과까지 기다리지 않고 실패를 알게 됩니다.
+     */
+    iError = errno;
+    close(*piReserveFd);
+    if ((iSock = accept(iListenSock, NULL, NULL)) >= 0) {
+        close(iSock);
+    }
+    *piReserveFd = openTcpReserveFd();
+    errno = iError;
+    return -1;
+}
+
+int getTcpSocketPort(int iSock)
+{
+    struct sockaddr_storage stAddr;
+    socklen_t uiAddrLen = sizeof(stAddr);
+
+    if (getsockname(iSock, (struct sockaddr *)&stAddr, &uiAddrLen) < 0) {
+        return -1;
+    }
+    if (stAddr.ss_family == AF_INET6) {
+        return ntohs(((struct sockaddr_in6 *)&stAddr)->sin6_port);
+    }
+    if (stAddr.ss_family == AF_INET) {
+        return ntohs(((struct sockaddr_in *)&stAddr)->sin_port);
+    }
+    errno = EAFNOSUPPORT;
+    return -1;
+}
+
+const char *formatTcpSockAddr(const struct sockaddr *kpstAddr, char *pchBuf, size_t uiBufSize)
+{
+    char achHost[INET6_ADDRSTRLEN];
+
+    if (kpstAddr->sa_family == AF_INET6) {
+        const struct sockaddr_in6 *kpstAddr6 = (const struct sockaddr_in6 *)kpstAddr;
+
+        if (IN6_IS_ADDR_V4MAPPED(&kpstAddr6->sin6_addr)) {
+            /**< 이중 스택 소켓으로 들어온 IPv4 연결은 원래 IPv4 표기로 보여줍니다. */
+            inet_ntop(AF_INET, &kpstAddr6->sin6_addr.s6_addr[12], achHost, sizeof(achHost));
+            snprintf(pchBuf, uiBufSize, "%s:%d", achHost, ntohs(kpstAddr6->sin6_port));
+        } else {
+            inet_ntop(AF_INET6, &kpstAddr6->sin6_addr, achHost, sizeof(achHost));
+            snprintf(pchBuf, uiBufSize, "[%s]:%d", achHost, ntohs(kpstAddr6->sin6_port));
+        }
+    } else if (kpstAddr->sa_family == AF_INET) {
+        const struct sockaddr_in *kpstAddr4 = (const struct sockaddr_in *)kpstAddr;
+
+        inet_ntop(AF_INET, &kpstAddr4->sin_addr, achHost, sizeof(achHost));
+        snprintf(pchBuf, uiBufSize, "%s:%d", achHost, ntohs(kpstAddr4->sin_port));
+    } else if (kpstAddr->sa_family == AF_UNIX) {
+        const struct sockaddr_un *kpstAddrUn = (const struct sockaddr_un *)kpstAddr;
+
+        if (kpstAddrUn->sun_path[0] == '\0' && kpstAddrUn->sun_path[1] != '\0') {
+            snprintf(pchBuf, uiBufSize, "unix:@%.*s", (int)sizeof(kpstAddrUn->sun_path) - 1, kpstAddrUn->sun_path + 1);
+        } else {
+            snprintf(pchBuf, uiBufSize, "unix:%.*s", (int)sizeof(kpstAddrUn->sun_path), kpstAddrUn->sun_path);
+        }
+    } else {
+        snprintf(pchBuf, uiBufSize, "?");
+    }
+    return pchBuf;
+}
+
+const char *formatTcpPeerName(int iSock, char *pchBuf, size_t uiBufSize)
+{
+    struct sockaddr_storage stAddr;
+    socklen_t uiAddrLen = sizeof(stAddr);
+
+    memset(&stAddr, 0x0, sizeof(stAddr));
+    if (getpeername(iSock, (struct sockaddr *)&stAddr, &uiAddrLen) < 0) {
+        snprintf(pchBuf, uiBufSize, "?");
+        return pchBuf;
+    }
+    if (stAddr.ss_family == AF_UNIX && uiAddrLen <= offsetof(struct sockaddr_un, sun_path)) {
+        /**< 이름 없는 Unix 클라이언트는 받은 쪽 대기 경로로 구분합니다. */
+        uiAddrLen = sizeof(stAddr);
+        memset(&stAddr, 0x0, sizeof(stAddr));
+        getsockname(iSock, (struct sockaddr *)&stAddr, &uiAddrLen);
+    }
+    return formatTcpSockAddr((struct sockaddr *)&stAddr, pchBuf, uiBufSize);
+}
+
+/**
+ * @brief 연결을 시도할 주소 하나
+ */
+typedef struct {
+    struct sockaddr_storage stAddr;
+    socklen_t uiAddrLen;
+} TCP_CONNECT_ADDR;
+
+static int64_t getMonotonicMs(void) {
+    struct timespec stNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &stNow);
+    return (int64_t)stNow.tv_sec * 1000 + stNow.tv_nsec / 1000000;
+}
+
+/**
+ * @brief 쉼표로 구분된 호스트 목록을 풀어 IPv6/IPv4가 번갈아 오도록 주소 배열을 채웁니다.
+ * @return 채운 주소 수
+ *
+ * @details 첫 주소의 주소 체계로 시작하고, 같은 체계 안에서는 getaddrinfo() 순서를 유지합니다. (RFC 8305 4절)
+ */
+static int resolveTcpConnectAddrs(const char *kpchHosts, int iPort, TCP_CONNECT_ADDR *pstAddrs, int iMaxAddrs) {
+    TCP_CONNECT_ADDR astV6[TCP_CONNECT_MAX_ADDRS], astV4[TCP_CONNECT_MAX_ADDRS];
+    int iV6Count = 0, iV4Count = 0, iCount = 0;
+    bool bV6First = false;
+    char achPort[8];
+    char *pchList = strdup(kpchHosts);
+    char *pchSave = NULL;
+
+    if (pchList == NULL) {
+        return 0;
+    }
+    snprintf(achPort, sizeof(achPort), "%d", iPort);
+
+    for (char *pchHost = strtok_r(pchList, ", ", &pchSave); pchHost != NULL; pchHost = strtok_r(NULL, ", ", &pchSave)) {
+        struct addrinfo stHints, *pstResult;
+        size_t uiHostLen = strlen(pchHost);
+        int iGaiRet;
+
+        /**< "[::1]" 처럼 대괄호로 감싼 IPv6 주소도 받습니다. */
+        if (pchHost[0] == '[' && uiHostLen > 2 && pchHost[uiHostLen - 1] == ']') {
+            pchHost[uiHostLen - 1] = '\0';
+            pchHost++;
+        }
+
+        memset(&stHints, 0, sizeof(stHints));
+        stHints.ai_family = AF_UNSPEC;
+        stHints.ai_socktype = SOCK_STREAM;
+        stHints.ai_flags = AI_NUMERICSERV;
+        if ((iGaiRet = getaddrinfo(pchHost, achPort, &stHints, &pstResult)) != 0) {
+            fprintf(stderr, "getaddrinfo(%s) failed: %s\n", pchHost, gai_strerror(iGaiRet));
+            continue;
+        }
+        for (struct addrinfo *pstAi = pstResult; pstAi != NULL; pstAi = pstAi->ai_next) {
+            TCP_CONNECT_ADDR *pstDst;
+
+            if (pstAi->ai_family == AF_INET6 && iV6Count < TCP_CONNECT_MAX_ADDRS) {
+                pstDst = &astV6[iV6Count++];
+            } else if (pstAi->ai_family == AF_INET && iV4Count < TCP_CONNECT_MAX_ADDRS) {
+                pstDst = &astV4[iV4Count++];
+            } else {
+                continue;
+            }
+            if (iV6Count + iV4Count == 1) {
+                bV6First = (pstAi->ai_family == AF_INET6);
+            }
+            memcpy(&pstDst->stAddr, pstAi->ai_addr, pstAi->ai_addrlen);
+            pstDst->uiAddrLen = pstAi->ai_addrlen;
+        }
+        freeaddrinfo(pstResult);
+    }
+    free(pchList);
+
+    for (int i6 = 0, i4 = 0; iCount < iMaxAddrs && (i6 < iV6Count || i4 < iV4Count);) {
+        bool bTakeV6 = (i4 >= iV4Count) || (i6 < iV6Count && ((iCount % 2 == 0) == bV6First));
+        pstAddrs[iCount++] = bTakeV6 ? astV6[i6++] : astV4[i4++];
+    }
+    return iCount;
+}
+
+int connectTcpClientSocket(const char *kpchHosts, int iPort, int iTimeoutMs) {
+    TCP_CONNECT_ADDR astAddrs[TCP_CONNECT_MAX_ADDRS];
+    struct pollfd astPending[TCP_CONNECT_MAX_ADDRS];
+    int iAddrCount = resolveTcpConnectAddrs(kpchHosts, iPort, astAddrs, TCP_CONNECT_MAX_ADDRS);
+    int iPendingCount = 0, iNextAddr = 0;
+    int iConnected = -1;
+    int iLastError = (iAddrCount == 0) ? EADDRNOTAVAIL : ECONNREFUSED;
+    int64_t i64Deadline = getMonotonicMs() + iTimeoutMs;
+    int64_t i64NextAttempt = getMonotonicMs();
+
+    while (iConnected < 0) {
+        int64_t i64Now = getMonotonicMs();
+
+        if (iTimeoutMs > 0 && i64Now >= i64Deadline) {
+            iLastError = ETIMEDOUT;
+            break;
+        }
+
+        /**< 간격이 지났거나 진행 중인 시도가 없으면 다음 주소로 연결을 시작합니다. */
+        while (iNextAddr < iAddrCount && (i64Now >= i64NextAttempt || iPendingCount == 0)) {
+            TCP_CONNECT_ADDR *pstAddr = &astAddrs[iNextAddr++];
+            int iSock = socket(pstAddr->stAddr.ss_family, SOCK_STREAM | SOCK_NONBLOCK, 0);
+
+            if (iSock < 0) {
+                iLastError = errno;
+                continue;
+            }
+            if (connect(iSock, (struct sockaddr *)&pstAddr->stAddr, pstAddr->uiAddrLen) == 0) {
+                iConnected = iSock;
+                break;
+            }
+            if (errno != EINPROGRESS) {
+                iLastError = errno;
+                close(iSock);
+                continue;
+            }
+            astPending[iPendingCount].fd = iSock;
+            astPending[iPendingCount].events = POLLOUT;
+            astPending[iPendingCount].revents = 0;
+            iPendingCount++;
+            i64NextAttempt = i64Now + TCP_CONNECT_ATTEMPT_DELAY_MS;
+        }
+        if (iConnected >= 0 || iPendingCount == 0) {
+            break;
+        }
+
+        int64_t i64Wait = -1;
+        if (iNextAddr < iAddrCount) {
+            i64Wait = i64NextAttempt - i64Now;
+        }
+        if (iTimeoutMs > 0 && (i64Wait < 0 || i64Deadline - i64Now < i64Wait)) {
+            i64Wait = i64Deadline - i64Now;
+        }
+
+        int iReady = poll(astPending, iPendingCount, (int)i64Wait);
+        if (iReady < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            iLastError = errno;
+            break;
+        }
+
+        for (int i = 0; i < iPendingCount && iReady > 0; i++) {
+            int iSockError = 0;
+            socklen_t uiLen = sizeof(iSockError);
+
+            if (astPending[i].revents == 0) {
+                continue;
+            }
+            iReady--;
+            getsockopt(astPending[i].fd, SOL_SOCKET, SO_ERROR, &iSockError, &uiLen);
+            if (iSockError == 0 && iConnected < 0) {
+                iConnected = astPending[i].fd;
+            } else {
+                /**< 실패한 시도는 닫고, 다음 주소는 간격을 기다리지 않고 바로 시작합니다. */
+                iLastError = (iSockError != 0) ? iSockError : iLastError;
+                close(astPending[i].fd);
+                i64NextAttempt = getMonotonicMs();
+            }
+            astPending[i--] = astPending[--iPendingCount];
+        }
+    }
+
+    for (int i = 0; i < iPendingCount; i++) {
+        close(astPending[i].fd);
+    }
+    if (iConnected < 0) {
+        fprintf(stderr, "Connection to %s:%d failed: %s\n", kpchHosts, iPort, strerror(iLastError));
+        errno = iLastError;
+        return -1;
+    }
+
+    fcntl(iConnected, F_SETFL, fcntl(iConnected, F_GETFL) & ~O_NONBLOCK);
+    return iConnected;
+}
+
+int getTcpBackoffDelayMs(int iAttempt, int iBaseMs, int iMaxMs, unsigned int *puiSeed) {
+    int64_t i64Cap = iBaseMs;
+
+    for (int i = 0; i < iAttempt && i64Cap < iMaxMs; i++) {
+        i64Cap *= 2;
+    }
+    if (i64Cap > iMaxMs) {
+        i64Cap = iMaxMs;
+    }
+    if (i64Cap <= 0) {
+        return 0;
+    }
+    return (int)(rand_r(puiSeed) % (i64Cap + 1));
 }
 
 void handleTcpClientDisconnection(int iClientSockfd) {
@@ -150,15 +726,46 @@ void checkTcpClientConnections(int *piClientSockets, int iMaxClients) {
 }
 
 
-void setTcpSocketBufferSize(int iSock, int iRxSize, int iTxSize) 
+int setTcpSocketBufferSize(int iSock, int iRxSize, int iTxSize)
 {
     if (setsockopt(iSock, SOL_SOCKET, SO_RCVBUF, &iRxSize, sizeof(iRxSize)) < 0) {
         perror("Setsockopt SO_RCVBUF failed");
-        exit(EXIT_FAILURE);
+        return -1;
     }
 
     if (setsockopt(iSock, SOL_SOCKET, SO_SNDBUF, &iTxSize, sizeof(iTxSize)) < 0) {
         perror("Setsockopt SO_SNDBUF failed");
-        exit(EXIT_FAILURE);
+        return -1;
     }
-}
\ No newline at end of file
+    return 0;
+}
+
+int setTcpNotSentLowat(int iSock, int iBytes)
+{
+    return setsockopt(iSock, IPPROTO_TCP, TCP_NOTSENT_LOWAT, &iBytes, sizeof(iBytes));
+}
+
+int waitTcpSocketWritable(int iSock, int iTimeoutMs)
+{
+    struct pollfd stPoll = {iSock, POLLOUT, 0};
+    int iNoDelay = 0;
+    socklen_t uiLen = sizeof(iNoDelay);
+    int iReady;
+
+    if ((iReady = poll(&stPoll, 1, 0)) != 0 || iTimeoutMs == 0) {
+        return iReady;
+    }
+    /**
+     * Nagle 알고리즘은 MSS보다 작은 꼬리 데이터를 ACK가 올 때까지 붙잡아 두므로, 기준 남짓만 남기고 기다리면
+     * 지연 ACK까지 멈출 수 있습니다. 기다리기 전에 TCP_NODELAY를 잠깐 켜서 붙잡힌 데이터를 내보냅니다.
+     */
+    if (getsockopt(iSock, IPPROTO_TCP, TCP_NODELAY, &iNoDelay, &uiLen) == 0 && iNoDelay == 0) {
+        int iOn = 1;
+
+        setsockopt(iSock, IPPROTO_TCP, TCP_NODELAY, &iOn, sizeof(iOn));
+        setsockopt(iSock, IPPROTO_TCP, TCP_NODELAY, &iNoDelay, sizeof(iNoDelay));
+    }
+    while ((iReady = poll(&stPoll, 1, iTimeoutMs)) < 0 && errno == EINTR) {
+    }
+    return iReady;
+}
@@ -0,0 +1,291 @@
+/**
+ * @file tcpTls.c
+ * @brief 커널 TLS(kTLS) 오프로드를 위한 TLS 핸드셰이크 API
+ *
+ * 핸드셰이크는 OpenSSL로 사용자 공간에서 하고, 협상된 세션 키는 OpenSSL의 kTLS 지원(SSL_OP_ENABLE_KTLS)으로
+ * setsockopt(TCP_ULP, "tls")와 TLS_TX/TLS_RX 를 통해 커널에 넘깁니다. 핸드셰이크가 끝나면 사용자 공간
+ * TLS 상태는 버리고, 소켓은 기존 read()/write()/sendfile() 경로 그대로 씁니다. 데이터를 사용자 공간에서
+ * 한 번 더 복사하여 암호화하지 않으므로 평문에 가까운 처리량을 냅니다.
+ *
+ * 주요 기능:
+ * - 서버/클라이언트 TLS 설정 생성 (인증서, 신뢰할 CA)
+ * - 핸드셰이크 후 커널 TLS 송수신 오프로드 설치
+ *
+ * @date 2026-10-16
+ */
+#include "tcpTls.h"
+
+#include <openssl/ssl.h>
+#include <openssl/err.h>
+#include <openssl/x509v3.h>
+
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <signal.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+/**
+ * @brief 커널이 송수신을 모두 오프로드할 수 있는 TLS 1.2 AEAD 암호
+ */
+#define TCP_TLS_CIPHERS "ECDHE-ECDSA-AES128-GCM-SHA256:ECDHE-RSA-AES128-GCM-SHA256:" \
+                        "ECDHE-ECDSA-AES256-GCM-SHA384:ECDHE-RSA-AES256-GCM-SHA384:" \
+                        "ECDHE-ECDSA-CHACHA20-POLY1305:ECDHE-RSA-CHACHA20-POLY1305"
+
+/**
+ * @brief TLS 설정
+ */
+struct TCP_TLS {
+    SSL_CTX *pstCtx;                /**< OpenSSL 설정 */
+    bool bServer;                   /**< 서버 역할이면 true */
+};
+
+static __thread char s_achTlsError[TCP_TLS_ERROR_STRLEN]; /**< 스레드별 마지막 오류 */
+
+/**
+ * @brief 오류 메시지를 기록하고 OpenSSL 오류 큐를 비웁니다.
+ * @param kpchWhat 실패한 단계
+ */
+static void setTcpTlsError(const char *kpchWhat)
+{
+    unsigned long ulErr = ERR_peek_last_error();
+
+    if (ulErr != 0) {
+        char achReason[160];
+
+        ERR_error_string_n(ulErr, achReason, sizeof(achReason));
+        snprintf(s_achTlsError, sizeof(s_achTlsError), "%s: %s", kpchWhat, achReason);
+    } else {
+        snprintf(s_achTlsError, sizeof(s_achTlsError), "%s", kpchWhat);
+    }
+    ERR_clear_error();
+}
+
+/**
+ * @brief 역할별 공통 설정을 만듭니다. (TLS 1.2, AEAD 암호, 커널 TLS, 재협상/티켓/압축 끔)
+ */
+static TCP_TLS *createTcpTlsContext(bool bServer)
+{
+    TCP_TLS *pstTls = (TCP_TLS *)calloc(1, sizeof(TCP_TLS));
+
+    if (pstTls == NULL) {
+        snprintf(s_achTlsError, sizeof(s_achTlsError), "%s", strerror(errno));
+        return NULL;
+    }
+    pstTls->bServer = bServer;
+    pstTls->pstCtx = SSL_CTX_new(bServer ? TLS_server_method() : TLS_client_method());
+    if (pstTls->pstCtx == NULL) {
+        setTcpTlsError("SSL_CTX_new 실패");
+        free(pstTls);
+        return NULL;
+    }
+
+    /**< OpenSSL 3.0의 커널 TLS 수신 오프로드는 TLS 1.2만 지원하므로 TLS 1.2로 고정합니다. */
+    if (SSL_CTX_set_min_proto_version(pstTls->pstCtx, TLS1_2_VERSION) != 1
+        || SSL_CTX_set_max_proto_version(pstTls->pstCtx, TLS1_2_VERSION) != 1
+        || SSL_CTX_set_cipher_list(pstTls->pstCtx, TCP_TLS_CIPHERS) != 1) {
+        setTcpTlsError("프로토콜/암호 설정 실패");
+        destroyTcpTls(pstTls);
+        return NULL;
+    }
+    SSL_CTX_set_options(pstTls->pstCtx, SSL_OP_ENABLE_KTLS | SSL_OP_NO_RENEGOTIATION | SSL_OP_NO_TICKET
+                        | SSL_OP_NO_COMPRESSION);
+    SSL_CTX_set_session_cache_mode(pstTls->pstCtx, SSL_SESS_CACHE_OFF);
+    return pstTls;
+}
+
+TCP_TLS *createTcpTlsServer(const char *kpchCertFile, const char *kpchKeyFile)
+{
+    TCP_TLS *pstTls = createTcpTlsContext(true);
+
+    if (pstTls == NULL) {
+        return NULL;
+    }
+    if (SSL_CTX_use_certificate_chain_file(pstTls->pstCtx, kpchCertFile) != 1) {
+        setTcpTlsError("인증서 읽기 실패");
+    } else if (SSL_CTX_use_PrivateKey_file(pstTls->pstCtx, kpchKeyFile != NULL ? kpchKeyFile : kpchCertFile,
+                                           SSL_FILETYPE_PEM) != 1) {
+        setTcpTlsError("개인 키 읽기 실패");
+    } else if (SSL_CTX_check_private_key(pstTls->pstCtx) != 1) {
+        setTcpTlsError("인증서와 개인 키가 맞지 않습니다");
+    } else {
+        return pstTls;
+    }
+    destroyTcpTls(pstTls);
+    return NULL;
+}
+
+TCP_TLS *createTcpTlsClient(const char *kpchCaFile)
+{
+    TCP_TLS *pstTls = createTcpTlsContext(false);
+    int iLoaded;
+
+    if (pstTls == NULL) {
+        return NULL;
+    }
+    iLoaded = (kpchCaFile != NULL) ? SSL_CTX_load_verify_locations(pstTls->pstCtx, kpchCaFile, NULL)
+                                   : SSL_CTX_set_default_verify_paths(pstTls->pstCtx);
+    if (iLoaded != 1) {
+        setTcpTlsError("CA 인증서 읽기 실패");
+        destroyTcpTls(pstTls);
+        return NULL;
+    }
+    SSL_CTX_set_verify(pstTls->pstCtx, SSL_VERIFY_PEER, NULL);
+    return pstTls;
+}
+
+void destroyTcpTls(TCP_TLS *pstTls)
+{
+    if (pstTls == NULL) {
+        return;
+    }
+    SSL_CTX_free(pstTls->pstCtx);
+    free(pstTls);
+}
+
+/**
+ * @brief 클라이언트가 확인할 서버 이름을 설정합니다. IP 주소면 인증서의 IP SAN과 비교합니다.
+ */
+static int setTcpTlsPeerName(SSL *pstSsl, const char *kpchPeerName)
+{
+    unsigned char au8Addr[sizeof(struct in6_addr)];
+
+    if (inet_pton(AF_INET, kpchPeerName, au8Addr) == 1 || inet_pton(AF_INET6, kpchPeerName, au8Addr) == 1) {
+        return X509_VERIFY_PARAM_set1_ip_asc(SSL_get0_param(pstSsl), kpchPeerName);
+    }
+    if (SSL_set_tlsext_host_name(pstSsl, kpchPeerName) != 1) {
+        return 0;
+    }
+    return SSL_set1_host(pstSsl, kpchPeerName);
+}
+
+static int64_t getTcpTlsNowMs(void)
+{
+    struct timespec stNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &stNow);
+    return (int64_t)stNow.tv_sec * 1000 + stNow.tv_nsec / 1000000;
+}
+
+/**
+ * @brief 논블로킹 핸드셰이크를 제한 시간 안에 끝냅니다.
+ * @return 성공 시 0, 실패 시 errno 값
+ */
+static int runTcpTlsHandshake(SSL *pstSsl, bool bServer, int iSock, int iTimeoutMs)
+{
+    int64_t i64DeadlineMs = getTcpTlsNowMs() + iTimeoutMs;
+
+    while (1) {
+        int iRet = bServer ? SSL_accept(pstSsl) : SSL_connect(pstSsl);
+        struct pollfd stPoll;
+        int iRemainMs;
+
+        if (iRet == 1) {
+            return 0;
+        }
+        switch (SSL_get_error(pstSsl, iRet)) {
+        case SSL_ERROR_WANT_READ:
+            stPoll.events = POLLIN;
+            break;
+        case SSL_ERROR_WANT_WRITE:
+            stPoll.events = POLLOUT;
+            break;
+        default:
+            if (SSL_get_verify_result(pstSsl) != X509_V_OK) {
+                snprintf(s_achTlsError, sizeof(s_achTlsError), "인증서 검증 실패: %s",
+                         X509_verify_cert_error_string(SSL_get_verify_result(pstSsl)));
+                ERR_clear_error();
+            } else {
+                setTcpTlsError("핸드셰이크 실패");
+            }
+            return EPROTO;
+        }
+
+        iRemainMs = (int)(i64DeadlineMs - getTcpTlsNowMs());
+        if (iRemainMs <= 0) {
+            snprintf(s_achTlsError, sizeof(s_achTlsError), "핸드셰이크 시간 초과");
+            return ETIMEDOUT;
+        }
+        stPoll.fd = iSock;
+        stPoll.revents = 0;
+        iRet = poll(&stPoll, 1, iRemainMs);
+        if (iRet < 0 && errno != EINTR) {
+            int iError = errno;
+
+            snprintf(s_achTlsError, sizeof(s_achTlsError), "poll 실패: %s", strerror(iError));
+            return iError;
+        }
+    }
+}
+
+int startTcpTls(TCP_TLS *pstTls, int iSock, const char *kpchPeerName, int iTimeoutMs)
+{
+    sigset_t stPipeSet, stOldSet, stPending;
+    bool bPipePending;
+    int iFlags = fcntl(iSock, F_GETFL);
+    int iError = 0;
+    SSL *pstSsl;
+
+    if (iFlags < 0) {
+        snprintf(s_achTlsError, sizeof(s_achTlsError), "%s", strerror(errno));
+        return -1;
+    }
+    pstSsl = SSL_new(pstTls->pstCtx);
+    if (pstSsl == NULL) {
+        setTcpTlsError("SSL_new 실패");
+        errno = ENOMEM;
+        return -1;
+    }
+    if (SSL_set_fd(pstSsl, iSock) != 1
+        || (!pstTls->bServer && kpchPeerName != NULL && setTcpTlsPeerName(pstSsl, kpchPeerName) != 1)) {
+        setTcpTlsError("연결 설정 실패");
+        SSL_free(pstSsl);
+        errno = EINVAL;
+        return -1;
+    }
+
+    /**< OpenSSL은 MSG_NOSIGNAL 없이 쓰므로, 상대가 핸드셰이크 중 끊어도 SIGPIPE로 죽지 않도록 이 스레드에서 막아 둡니다. */
+    sigemptyset(&stPipeSet);
+    sigaddset(&stPipeSet, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &stPipeSet, &stOldSet);
+    sigpending(&stPending);
+    bPipePending = sigismember(&stPending, SIGPIPE);
+
+    fcntl(iSock, F_SETFL, iFlags | O_NONBLOCK);
+    iError = runTcpTlsHandshake(pstSsl, pstTls->bServer, iSock, iTimeoutMs);
+    if (iError == 0 && (!BIO_get_ktls_send(SSL_get_wbio(pstSsl)) || !BIO_get_ktls_recv(SSL_get_rbio(pstSsl)))) {
+        /**< 사용자 공간 TLS로 계속하면 기존 read()/write() 경로가 암호문을 보게 되므로 실패로 처리합니다. */
+        snprintf(s_achTlsError, sizeof(s_achTlsError), "커널 TLS를 사용할 수 없습니다 (tls 모듈 확인, 협상된 암호 %s)",
+                 SSL_get_cipher_name(pstSsl));
+        iError = EOPNOTSUPP;
+    }
+    fcntl(iSock, F_SETFL, iFlags);
+    SSL_free(pstSsl); /**< 소켓은 닫지 않으며, 커널에 넘긴 키는 소켓에 남습니다. */
+
+    if (!bPipePending) {
+        struct timespec stZero = {0, 0};
+
+        while (sigtimedwait(&stPipeSet, NULL, &stZero) == SIGPIPE) {
+        }
+    }
+    pthread_sigmask(SIG_SETMASK, &stOldSet, NULL);
+
+    if (iError != 0) {
+        errno = iError;
+        return -1;
+    }
+    return 0;
+}
+
+const char *getTcpTlsError(void)
+{
+    return s_achTlsError;
+}
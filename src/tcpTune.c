@@ -0,0 +1,171 @@
+/**
+ * @file tcpTune.c
+ * @brief TCP_INFO 표본으로 연결별 송수신 버퍼 크기를 대역폭 지연 곱(BDP)에 맞추는 API
+ *
+ * SO_SNDBUF/SO_RCVBUF를 고정 값으로 설정하면 커널 자동 조정이 꺼지고, 모든 연결이 같은 크기를 갖게 됩니다.
+ * 연결마다 RTT, 혼잡 윈도, 전달률을 주기적으로 읽어 필요한 만큼만 버퍼를 주면, 거의 쉬는 연결은 작은 버퍼로
+ * 메모리를 아끼고 대량 전송 연결은 경로를 채울 만큼의 윈도를 얻습니다.
+ * 같은 표본을 연결별 게이지와 전체 히스토그램으로 남겨 네트워크(상대)에 막힌 연결과 서버에 막힌 연결을 구분합니다.
+ *
+ * 주요 기능:
+ * - TCP_INFO 표본 (오래된 커널에서 빠진 항목은 0)
+ * - 범위 안의 목표 버퍼 크기 계산
+ * - 변화가 작을 때는 바꾸지 않는 버퍼 조정
+ * - 연결별 TCP_INFO 게이지와 전체 히스토그램 기록
+ *
+ * @date 2026-10-16
+ */
+#include "tcpTune.h"
+
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <linux/tcp.h> /**< tcpi_delivery_rate 등 glibc 구조체에 없는 항목 */
+
+/**
+ * @brief 커널이 돌려준 길이에 항목이 들어 있는지 확인합니다.
+ */
+#define TCP_TUNE_HAS_FIELD(uiLen, field) \
+    ((uiLen) >= offsetof(struct tcp_info, field) + sizeof(((struct tcp_info *)0)->field))
+
+int getTcpInfoSample(int iSock, TCP_INFO_SAMPLE *pstSample)
+{
+    struct tcp_info stInfo;
+    socklen_t uiLen = sizeof(stInfo);
+
+    memset(&stInfo, 0, sizeof(stInfo));
+    if (getsockopt(iSock, IPPROTO_TCP, TCP_INFO, &stInfo, &uiLen) < 0) {
+        return -1;
+    }
+    pstSample->u32RttUs = stInfo.tcpi_rtt;
+    pstSample->u32RttVarUs = stInfo.tcpi_rttvar;
+    pstSample->u32SndCwnd = stInfo.tcpi_snd_cwnd;
+    pstSample->u32SndMss = stInfo.tcpi_snd_mss;
+    pstSample->u32RcvSpace = stInfo.tcpi_rcv_space;
+    pstSample->u64DeliveryRate = TCP_TUNE_HAS_FIELD(uiLen, tcpi_delivery_rate) ? stInfo.tcpi_delivery_rate : 0;
+    pstSample->u32TotalRetrans = stInfo.tcpi_total_retrans;
+    pstSample->u32Unacked = stInfo.tcpi_unacked;
+    pstSample->u64BusyUs = TCP_TUNE_HAS_FIELD(uiLen, tcpi_busy_time) ? stInfo.tcpi_busy_time : 0;
+    pstSample->u64RwndLimitedUs = TCP_TUNE_HAS_FIELD(uiLen, tcpi_rwnd_limited) ? stInfo.tcpi_rwnd_limited : 0;
+    pstSample->u64SndbufLimitedUs = TCP_TUNE_HAS_FIELD(uiLen, tcpi_sndbuf_limited) ? stInfo.tcpi_sndbuf_limited : 0;
+    return 0;
+}
+
+/**
+ * @brief 누적 시간(us) 게이지가 직전 표본 이후 늘어난 만큼을 ns로 기록합니다.
+ */
+static void recordTcpInfoDelta(TCP_HIST_ID eId, uint64_t u64CurUs, uint64_t u64PrevUs)
+{
+    recordTcpHistogram(eId, u64CurUs > u64PrevUs ? (u64CurUs - u64PrevUs) * 1000ULL : 0);
+}
+
+int sampleTcpConnInfo(TCP_CONN_METRICS *pstConn, uint64_t u64NowNs)
+{
+    TCP_INFO_SAMPLE stSample;
+    uint64_t au64Prev[TCP_GAUGE_COUNT];
+    uint64_t au64Gauge[TCP_GAUGE_COUNT];
+
+    /**< 소켓 번호는 잠근 동안에만 유효합니다. 등록 해제된 연결은 소유 스레드가 이미 닫았을 수 있습니다. */
+    int iSock = lockTcpConnSock(pstConn, 0);
+    if (iSock < 0) {
+        errno = ENOTCONN;
+        return -1;
+    }
+    int iRet = getTcpInfoSample(iSock, &stSample);
+    unlockTcpConnSock();
+    if (iRet < 0) {
+        return -1;
+    }
+    au64Gauge[TCP_GAUGE_RTT_US] = stSample.u32RttUs;
+    au64Gauge[TCP_GAUGE_RTTVAR_US] = stSample.u32RttVarUs;
+    au64Gauge[TCP_GAUGE_RETRANS] = stSample.u32TotalRetrans;
+    au64Gauge[TCP_GAUGE_CWND] = stSample.u32SndCwnd;
+    au64Gauge[TCP_GAUGE_UNACKED] = stSample.u32Unacked;
+    au64Gauge[TCP_GAUGE_DELIVERY_RATE] = stSample.u64DeliveryRate;
+    au64Gauge[TCP_GAUGE_BUSY_US] = stSample.u64BusyUs;
+    au64Gauge[TCP_GAUGE_RWND_LIMITED_US] = stSample.u64RwndLimitedUs;
+    au64Gauge[TCP_GAUGE_SNDBUF_LIMITED_US] = stSample.u64SndbufLimitedUs;
+
+    recordTcpHistogram(TCP_HIST_TCP_RTT, (uint64_t)stSample.u32RttUs * 1000ULL);
+    if (getTcpConnGauges(pstConn, au64Prev) != 0) {
+        recordTcpInfoDelta(TCP_HIST_TCP_BUSY, au64Gauge[TCP_GAUGE_BUSY_US], au64Prev[TCP_GAUGE_BUSY_US]);
+        recordTcpInfoDelta(TCP_HIST_TCP_RWND_LIMITED, au64Gauge[TCP_GAUGE_RWND_LIMITED_US],
+                           au64Prev[TCP_GAUGE_RWND_LIMITED_US]);
+        recordTcpInfoDelta(TCP_HIST_TCP_SNDBUF_LIMITED, au64Gauge[TCP_GAUGE_SNDBUF_LIMITED_US],
+                           au64Prev[TCP_GAUGE_SNDBUF_LIMITED_US]);
+    }
+    setTcpConnGauges(pstConn, au64Gauge, u64NowNs);
+    return 0;
+}
+
+static uint32_t clampTcpTuneBytes(uint64_t u64Bytes, const TCP_TUNE_LIMIT *kpstLimit)
+{
+    if (u64Bytes < kpstLimit->u32MinBytes) {
+        return kpstLimit->u32MinBytes;
+    }
+    if (u64Bytes > kpstLimit->u32MaxBytes) {
+        return kpstLimit->u32MaxBytes;
+    }
+    return (uint32_t)u64Bytes;
+}
+
+void calcTcpTuneSize(const TCP_INFO_SAMPLE *kpstSample, const TCP_TUNE_LIMIT *kpstLimit, TCP_TUNE_SIZE *pstSize)
+{
+    uint64_t u64RateBdp = kpstSample->u64DeliveryRate * kpstSample->u32RttUs / 1000000ULL;
+    uint64_t u64CwndBdp = (uint64_t)kpstSample->u32SndCwnd * kpstSample->u32SndMss;
+    uint64_t u64SndBdp = u64RateBdp > u64CwndBdp ? u64RateBdp : u64CwndBdp;
+
+    pstSize->u32SndBytes = clampTcpTuneBytes(u64SndBdp * TCP_TUNE_HEADROOM, kpstLimit);
+    pstSize->u32RcvBytes = clampTcpTuneBytes((uint64_t)kpstSample->u32RcvSpace * TCP_TUNE_HEADROOM, kpstLimit);
+}
+
+/**
+ * @brief 버퍼 하나를 목표 크기로 바꿉니다. 지금 크기와 차이가 작으면 그대로 둡니다.
+ *
+ * @return 바꿨으면 1, 그대로 두면 0, 실패 시 -1
+ */
+static int setTcpTuneBuffer(int iSock, int iOpt, int iForceOpt, uint32_t u32Bytes)
+{
+    int iCur = 0;
+    int iBytes = (int)u32Bytes;
+    socklen_t uiLen = sizeof(iCur);
+    int64_t i64Diff;
+
+    if (getsockopt(iSock, SOL_SOCKET, iOpt, &iCur, &uiLen) < 0) {
+        return -1;
+    }
+    /**< getsockopt는 커널이 두 배로 잡은 값을 돌려줍니다. */
+    i64Diff = (int64_t)iCur - (int64_t)u32Bytes * 2;
+    if (i64Diff < 0) {
+        i64Diff = -i64Diff;
+    }
+    if (i64Diff < iCur / TCP_TUNE_HYSTERESIS_DIV) {
+        return 0;
+    }
+    if (setsockopt(iSock, SOL_SOCKET, iForceOpt, &iBytes, sizeof(iBytes)) == 0) {
+        return 1;
+    }
+    if (errno != EPERM || setsockopt(iSock, SOL_SOCKET, iOpt, &iBytes, sizeof(iBytes)) < 0) {
+        return -1;
+    }
+    return 1;
+}
+
+int tuneTcpSocketBuffer(int iSock, const TCP_TUNE_LIMIT *kpstLimit)
+{
+    TCP_INFO_SAMPLE stSample;
+    TCP_TUNE_SIZE stSize;
+    int iSnd, iRcv;
+
+    if (getTcpInfoSample(iSock, &stSample) < 0) {
+        return -1;
+    }
+    calcTcpTuneSize(&stSample, kpstLimit, &stSize);
+    if ((iSnd = setTcpTuneBuffer(iSock, SO_SNDBUF, SO_SNDBUFFORCE, stSize.u32SndBytes)) < 0
+        || (iRcv = setTcpTuneBuffer(iSock, SO_RCVBUF, SO_RCVBUFFORCE, stSize.u32RcvBytes)) < 0) {
+        return -1;
+    }
+    return iSnd + iRcv;
+}
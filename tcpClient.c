@@ -1,19 +1,29 @@
 /**
  * @file tcpClient.c
  * @brief TCP 클라이언트 프로그램으로, 서버와의 송수신을 관리합니다.
- * 
+ *
  * 이 프로그램은 TCP 클라이언트로서 서버와의 통신을 위해 두 개의 스레드를 생성합니다.
  * 하나의 스레드는 사용자가 입력한 메시지를 서버로 전송하고, 다른 하나는 서버로부터 수신한 메시지를 출력합니다.
- * 
- * 송신 스레드는 사용자의 입력을 기다리며, "exit" 명령을 입력하면 종료됩니다. 
- * 수신 스레드는 서버로부터 메시지를 수신하고, 일정 시간(10초) 동안 응답이 없으면 타임아웃 처리를 합니다.
- * 두 스레드가 모두 종료되면 클라이언트 소켓을 다시 생성하여 재연결 할 수 있는 기능도 제공합니다.
- * 
+ *
+ * 송신 스레드는 사용자의 입력을 기다리며, "exit" 명령을 입력하면 종료됩니다.
+ * 수신 스레드는 연결마다 새로 만들어지며, 서버 연결이 끊기면 종료됩니다.
+ * 연결이 끊기면 상한이 있는 지수 백오프와 jitter로 자동 재연결하며, 그동안 입력된 메시지는
+ * 크기가 제한된 큐에 보관했다가 재연결 후 보내거나(flush) 버립니다(drop).
+ * 재연결 시도/성공 수와 재연결 지연은 메트릭으로 집계하며 -a 옵션으로 관리 소켓에서 조회할 수 있습니다.
+ * -t 로 CA 인증서를 주면 TCP 연결마다 TLS 핸드셰이크 후 커널 TLS로 암호화하며, 송수신 경로는 평문과 같습니다.
+ * -z 를 주면 연결마다 LZ4 압축을 협상하고, 합의되면 임계값 이상인 메시지를 압축하여 보냅니다.
+ *
  * @author 박철우
  * @date 2015.05
  */
 
 #include "tcpSock.h"
+#include "tcpProbe.h"
+#include "tcpFrame.h"
+#include "tcpRing.h"
+#include "tcpMetrics.h"
+#include "tcpAdmin.h"
+#include "tcpTls.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -22,49 +32,165 @@
 #include <pthread.h>  // pthread 사용을 위해 추가
 #include <sys/select.h>  // select() 사용을 위해 추가
 #include <stdbool.h>
+#include <time.h>
 
 #define PORT 8080
 #define SERVER_IP "127.0.0.1"
+#define CONNECT_TIMEOUT_MS 3000 /**< 연결 제한 시간. 서버 재시작 중 SYN 재전송에 묶이지 않도록 합니다. */
+#define CLIENT_ID 0x01 /**< 프레임 Client ID 필드 값 */
+#define BACKOFF_BASE_MS 100 /**< 재연결 첫 대기 상한 (ms) */
+#define BACKOFF_MAX_MS 30000 /**< 재연결 대기 상한 (ms) */
+#define OUTAGE_QUEUE_SIZE (64 * 1024) /**< 연결이 끊긴 동안 메시지를 보관하는 큐 크기 (바이트) */
 
 /**
  * @brief 클라이언트 정보를 저장하는 구조체.
- * 
+ *
  * @details 클라이언트 소켓, 송수신 버퍼, 수신 및 송신 스레드 ID를 포함하며,
  *          클라이언트 상태를 관리하기 위한 플래그와 동기화를 위한 뮤텍스를 포함합니다.
+ *          uRunningMutex는 실행 상태, 연결 상태, 끊김 동안의 메시지 큐를 함께 보호하며, 블로킹 송신 중에는 잡지 않습니다.
+ *          sendMutex는 송신 스레드의 send()와 main의 소켓 닫기를 직렬화하여, 닫힌 뒤 재사용된 fd로 보내지 않게 합니다.
  */
 typedef struct {
-    int iSock;                      /**< 클라이언트 소켓 파일 디스크립터 */
+    int iSock;                      /**< 클라이언트 소켓 파일 디스크립터 (-1이면 연결 없음) */
     bool bIsRunning;                /**< 클라이언트 실행 상태 플래그 */
+    bool bConnected;                /**< 서버 연결 상태 플래그 */
     char achBuffer[BUFFER_SIZE];    /**< 데이터 송수신을 위한 버퍼 */
     pthread_t recvThreadId;         /**< 데이터 수신 스레드 ID */
     pthread_t sendThreadId;         /**< 데이터 송신 스레드 ID */
     pthread_mutex_t uRunningMutex;  /**< 실행 상태 동기화를 위한 뮤텍스 */
+    pthread_mutex_t sendMutex;      /**< 소켓 송신과 소켓 닫기를 직렬화하는 뮤텍스 */
+    pthread_cond_t stateCond;       /**< 종료 또는 연결 끊김을 알리는 조건 변수 */
+    TCP_RING *pstOutageQueue;       /**< 연결이 끊긴 동안 입력된 프레임 */
+    bool bFlushOnReconnect;         /**< 재연결 후 보관한 프레임을 보낼지(true) 버릴지(false) */
+    bool bInputClosed;              /**< 입력이 끝남 (보관한 프레임을 처리하면 종료) */
+    uint64_t u64DisconnectedNs;     /**< 연결 끊김을 감지한 시각 (단조 시계, ns) */
+    int iCompressThreshold;         /**< 압축할 최소 메시지 길이 (-1이면 압축을 협상하지 않음) */
+    uint8_t u8Caps;                 /**< 현재 연결에서 서버와 합의한 기능 비트 (TCP_FRAME_CAP_*) */
 } CLIENT_INFO;
 
+/**
+ * @brief 실행 상태를 확인합니다.
+ */
+static bool isClientRunning(CLIENT_INFO *pstClientInfo) {
+    bool bIsRunning;
+
+    pthread_mutex_lock(&pstClientInfo->uRunningMutex);
+    bIsRunning = pstClientInfo->bIsRunning;
+    pthread_mutex_unlock(&pstClientInfo->uRunningMutex);
+    return bIsRunning;
+}
+
+/**
+ * @brief 클라이언트를 종료 상태로 바꾸고 대기 중인 스레드를 깨웁니다.
+ */
+static void stopClient(CLIENT_INFO *pstClientInfo) {
+    pthread_mutex_lock(&pstClientInfo->uRunningMutex);
+    pstClientInfo->bIsRunning = false;
+    pthread_cond_broadcast(&pstClientInfo->stateCond);
+    pthread_mutex_unlock(&pstClientInfo->uRunningMutex);
+}
+
+/**
+ * @brief 연결이 끊긴 것으로 표시합니다. uRunningMutex를 잡은 상태에서 호출합니다.
+ *
+ * @details 소켓은 shutdown만 하고 닫지는 않습니다. 수신 스레드가 끝난 뒤 main이 닫습니다.
+ */
+static void markClientDisconnected(CLIENT_INFO *pstClientInfo) {
+    if (pstClientInfo->bConnected) {
+        pstClientInfo->bConnected = false;
+        pstClientInfo->u8Caps = 0;
+        pstClientInfo->u64DisconnectedNs = getTcpMonotonicNs();
+        shutdown(pstClientInfo->iSock, SHUT_RDWR);
+        pthread_cond_broadcast(&pstClientInfo->stateCond);
+    }
+}
+
+/**
+ * @brief 프레임을 끝까지 전송합니다.
+ */
+static bool sendFrame(int iSock, const uint8_t *kpu8Frame, size_t uiLen) {
+    while (uiLen > 0) {
+        ssize_t iWriteSize = send(iSock, kpu8Frame, uiLen, MSG_NOSIGNAL);
+        TCP_PROBE2(tcpClient, send, iSock, iWriteSize);
+        if (iWriteSize < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        kpu8Frame += iWriteSize;
+        uiLen -= (size_t)iWriteSize;
+    }
+    return true;
+}
+
+/**
+ * @brief 연결이 끊긴 동안 입력된 프레임을 큐에 보관합니다. uRunningMutex를 잡은 상태에서 호출합니다.
+ *
+ * @details 큐가 가득 차면 새 프레임을 버리고 drops 메트릭으로 집계합니다.
+ */
+static void queueOutageFrame(CLIENT_INFO *pstClientInfo, const uint8_t *kpu8Frame, size_t uiLen) {
+    if (pushTcpRing(pstClientInfo->pstOutageQueue, kpu8Frame, (uint32_t)uiLen)) {
+        addTcpMetric(TCP_METRIC_ENQUEUED, 1);
+        fprintf(stderr, "Not connected, message queued\n");
+    } else {
+        addTcpMetric(TCP_METRIC_DROPS, 1);
+        fprintf(stderr, "Not connected and queue is full, message dropped\n");
+    }
+}
+
+/**
+ * @brief 재연결 직후 보관한 프레임을 보내거나 버립니다. uRunningMutex를 잡은 상태에서 호출합니다.
+ *
+ * @return 전송 중 연결이 끊기면 false. 보내지 못한 프레임은 버리고, 남은 프레임은 다음 연결까지 보관합니다.
+ */
+static bool flushOutageQueue(CLIENT_INFO *pstClientInfo, int iSock) {
+    static uint8_t s_au8Frame[TCP_FRAME_MAX_SIZE];
+    int iFrameLen;
+    int iSent = 0, iDropped = 0;
+
+    while ((iFrameLen = popTcpRing(pstClientInfo->pstOutageQueue, s_au8Frame, sizeof(s_au8Frame))) > 0) {
+        addTcpMetric(TCP_METRIC_DEQUEUED, 1);
+        if (!pstClientInfo->bFlushOnReconnect) {
+            addTcpMetric(TCP_METRIC_DROPS, 1);
+            iDropped++;
+            continue;
+        }
+        if (!sendFrame(iSock, s_au8Frame, (size_t)iFrameLen)) {
+            perror("Write error");
+            addTcpMetric(TCP_METRIC_DROPS, 1);
+            return false;
+        }
+        iSent++;
+    }
+    if (iSent > 0 || iDropped > 0) {
+        printf("Queued messages: %d sent, %d dropped\n", iSent, iDropped);
+    }
+    return true;
+}
+
 /**
  * @brief 메시지 송신을 담당하는 스레드 함수
- * 
- * @details 사용자가 입력한 메시지를 서버로 전송합니다. 
- *          "exit" 입력 시 클라이언트를 종료합니다.
- * 
+ *
+ * @details 사용자가 입력한 메시지를 DATA 프레임으로 만들어 서버로 전송합니다.
+ *          서버와 LZ4에 합의한 연결에서는 임계값 이상인 메시지를 압축합니다.
+ *          연결이 끊긴 동안에는 메시지를 큐에 보관합니다. 다음 연결이 압축을 협상하기 전에 보낼 수 있도록 압축하지 않고 보관합니다. "exit" 입력 시 클라이언트를 종료합니다.
+ *          재연결과 관계없이 클라이언트가 끝날 때까지 유지됩니다.
+ *          소켓과 연결 상태는 uRunningMutex 안에서 읽고 send()는 그 밖에서 하므로, 서버가 읽기를 멈춰 send()가 막혀도
+ *          수신 스레드는 계속 응답을 읽습니다. 소켓은 sendMutex를 잡은 동안 닫히지 않습니다.
+ *
  * @param pvData CLIENT_INFO 구조체 포인터
  * @return void*
  */
 void *sendMessages(void *pvData) {
     CLIENT_INFO* pstClientInfo = (CLIENT_INFO *)pvData;
     char achBuffer[BUFFER_SIZE];
+    uint8_t au8Frame[TCP_FRAME_HEADER_SIZE + BUFFER_SIZE + TCP_FRAME_CRC_SIZE];
     // 입력 대기를 타임아웃 처리하기 위해 select() 사용
     fd_set stReadFds;
     struct timeval stTimeout;
     fprintf(stderr,"Enter message('exit' to quit): ");
-    while (1) {
-        pthread_mutex_lock(&pstClientInfo->uRunningMutex);
-        if (!pstClientInfo->bIsRunning) {
-            pthread_mutex_unlock(&pstClientInfo->uRunningMutex);
-            break;
-        }
-        pthread_mutex_unlock(&pstClientInfo->uRunningMutex);
-        
+    while (isClientRunning(pstClientInfo)) {
         FD_ZERO(&stReadFds);
         FD_SET(STDIN_FILENO, &stReadFds);
 
@@ -72,24 +198,52 @@ void *sendMessages(void *pvData) {
         stTimeout.tv_usec = 0;
         int activity = select(STDIN_FILENO + 1, &stReadFds, NULL, NULL, &stTimeout);
         if (activity > 0 && FD_ISSET(STDIN_FILENO, &stReadFds)) {
-            fgets(achBuffer, BUFFER_SIZE, stdin);
+            if (fgets(achBuffer, BUFFER_SIZE, stdin) == NULL) {
+                /**< 입력이 끝나면(EOF) 연결된 상태에서는 바로, 끊긴 상태에서는 재연결 후 보관한 메시지를 처리하고 종료합니다. */
+                pthread_mutex_lock(&pstClientInfo->uRunningMutex);
+                pstClientInfo->bInputClosed = true;
+                if (pstClientInfo->bConnected) {
+                    pstClientInfo->bIsRunning = false;
+                    pthread_cond_broadcast(&pstClientInfo->stateCond);
+                }
+                pthread_mutex_unlock(&pstClientInfo->uRunningMutex);
+                break;
+            }
             achBuffer[strcspn(achBuffer, "\n")] = 0;
 
             if (strcmp(achBuffer, "exit") == 0) {
-                pthread_mutex_lock(&pstClientInfo->uRunningMutex);
-                pstClientInfo->bIsRunning = false;
-                pthread_mutex_unlock(&pstClientInfo->uRunningMutex);
+                stopClient(pstClientInfo);
                 printf("Client Exit\n");
                 break;
             }
 
-            if (write(pstClientInfo->iSock, achBuffer, strlen(achBuffer)) < 0) {
+            int iFrameLen;
+            pthread_mutex_lock(&pstClientInfo->sendMutex);
+            pthread_mutex_lock(&pstClientInfo->uRunningMutex);
+            bool bConnected = pstClientInfo->bConnected;
+            int iSock = pstClientInfo->iSock;
+            if (bConnected && (pstClientInfo->u8Caps & TCP_FRAME_CAP_LZ4)) {
+                iFrameLen = encodeTcpLz4Frame(au8Frame, sizeof(au8Frame), CLIENT_ID, TCP_INST_DATA, achBuffer,
+                                              strlen(achBuffer), (size_t)pstClientInfo->iCompressThreshold);
+            } else {
+                iFrameLen = encodeTcpFrame(au8Frame, sizeof(au8Frame), CLIENT_ID, TCP_INST_DATA,
+                                           achBuffer, strlen(achBuffer));
+            }
+            if (!bConnected) {
+                queueOutageFrame(pstClientInfo, au8Frame, (size_t)iFrameLen);
+            }
+            pthread_mutex_unlock(&pstClientInfo->uRunningMutex);
+
+            if (bConnected && !sendFrame(iSock, au8Frame, (size_t)iFrameLen)) {
                 perror("Write error");
+                iFrameLen = encodeTcpFrame(au8Frame, sizeof(au8Frame), CLIENT_ID, TCP_INST_DATA,
+                                           achBuffer, strlen(achBuffer));
                 pthread_mutex_lock(&pstClientInfo->uRunningMutex);
-                pstClientInfo->bIsRunning = false;
+                markClientDisconnected(pstClientInfo);
+                queueOutageFrame(pstClientInfo, au8Frame, (size_t)iFrameLen);
                 pthread_mutex_unlock(&pstClientInfo->uRunningMutex);
-                pthread_exit(NULL);
             }
+            pthread_mutex_unlock(&pstClientInfo->sendMutex);
             fprintf(stderr,"Enter message('exit' to quit): ");
         }
     }
@@ -99,121 +253,311 @@ void *sendMessages(void *pvData) {
 
 /**
  * @brief 메시지 수신을 담당하는 스레드 함수
- * 
- * @details 서버로부터 수신된 메시지를 출력하며, 일정 시간 동안 응답이 없을 경우 타임아웃을 처리합니다.
- * 
+ *
+ * @details 서버로부터 수신된 데이터를 프레임 단위로 조립하여 DATA 부분을 출력합니다.
+ *          프레임이 여러 번에 나뉘어 오거나 한 번에 여러 개가 와도 순서대로 처리합니다.
+ *          LZ4 압축 프레임은 풀어서 출력하고, 기능 협상 응답을 받으면 합의한 기능을 기록합니다.
+ *          연결이 끊기면 연결 끊김을 표시하고 종료합니다. 재연결은 main이 담당합니다.
+ *
  * @param pvData CLIENT_INFO 구조체 포인터
  * @return void*
  */
 void *receiveMessages(void *pvData) {
     CLIENT_INFO* pstClientInfo = (CLIENT_INFO *)pvData;
-    char achBuffer[BUFFER_SIZE];
+    static uint8_t s_au8Stream[TCP_FRAME_MAX_SIZE + BUFFER_SIZE];
+    static uint8_t s_au8Plain[TCP_FRAME_MAX_DATA];
+    size_t uiStreamLen = 0;
     fd_set stReadFds;
     struct timeval stTimeout;
+    int iSock = pstClientInfo->iSock;
 
-    while (1) {
-        pthread_mutex_lock(&pstClientInfo->uRunningMutex);
-        if (!pstClientInfo->bIsRunning) {
-            pthread_mutex_unlock(&pstClientInfo->uRunningMutex);
-            break;
-        }
-        pthread_mutex_unlock(&pstClientInfo->uRunningMutex);
-
+    while (isClientRunning(pstClientInfo)) {
         FD_ZERO(&stReadFds);
-        FD_SET(pstClientInfo->iSock, &stReadFds);
+        FD_SET(iSock, &stReadFds);
 
         stTimeout.tv_sec = 0;
         stTimeout.tv_usec = 500*1000;
 
-        int activity = select(pstClientInfo->iSock + 1, &stReadFds, NULL, NULL, &stTimeout);
+        int activity = select(iSock + 1, &stReadFds, NULL, NULL, &stTimeout);
 
         if (activity < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
             perror("Select error");
-            pthread_mutex_lock(&pstClientInfo->uRunningMutex);
-            pstClientInfo->bIsRunning = false;
-            pthread_mutex_unlock(&pstClientInfo->uRunningMutex);
             break;
-        } else if (activity != 0) {            
-            if (FD_ISSET(pstClientInfo->iSock, &stReadFds)) {
-                memset(achBuffer, 0x0, BUFFER_SIZE);
-                int iReadSize = read(pstClientInfo->iSock, achBuffer, BUFFER_SIZE);
+        } else if (activity != 0) {
+            if (FD_ISSET(iSock, &stReadFds)) {
+                int iReadSize = read(iSock, s_au8Stream + uiStreamLen, sizeof(s_au8Stream) - uiStreamLen);
+                TCP_PROBE2(tcpClient, recv, iSock, iReadSize);
                 if (iReadSize > 0) {
-                    achBuffer[iReadSize] = '\0';
-                    printf("Server: %s\n", achBuffer);
+                    size_t uiOffset = 0;
+                    uiStreamLen += (size_t)iReadSize;
+                    while (uiOffset < uiStreamLen) {
+                        TCP_FRAME_HEADER stHeader;
+                        const uint8_t *kpu8Data;
+                        int iFrameLen = decodeTcpFrame(s_au8Stream + uiOffset, uiStreamLen - uiOffset, &stHeader, &kpu8Data);
+                        if (iFrameLen == 0) {
+                            break;
+                        } else if (iFrameLen < 0) {
+                            fprintf(stderr, "Invalid frame, resync\n");
+                            uiOffset += findTcpFrameStart(s_au8Stream + uiOffset, uiStreamLen - uiOffset);
+                            continue;
+                        }
+                        uiOffset += (size_t)iFrameLen;
+                        if (stHeader.u8Instruction == TCP_INST_CAPS && stHeader.u16DataLen >= 1) {
+                            pthread_mutex_lock(&pstClientInfo->uRunningMutex);
+                            pstClientInfo->u8Caps = kpu8Data[0];
+                            pthread_mutex_unlock(&pstClientInfo->uRunningMutex);
+                            printf("Compression %s by server\n", (kpu8Data[0] & TCP_FRAME_CAP_LZ4) ? "enabled" : "declined");
+                            continue;
+                        }
+                        if (stHeader.u8Instruction == TCP_INST_BUSY && stHeader.u16DataLen >= 1) {
+                            printf("Server busy (reason %u), message not processed\n", (unsigned)kpu8Data[0]);
+                            continue;
+                        }
+                        if (stHeader.u8Instruction == TCP_INST_SHUTDOWN) {
+                            printf("Server shutting down, all replies received\n");
+                            continue;
+                        }
+
+                        const uint8_t *kpu8Plain;
+                        int iPlainLen = getTcpFramePlainData(&stHeader, kpu8Data, s_au8Plain, sizeof(s_au8Plain), &kpu8Plain);
+                        if (iPlainLen < 0) {
+                            fprintf(stderr, "Invalid compressed frame, skipped\n");
+                            continue;
+                        }
+                        printf("Server: %.*s\n", iPlainLen, (const char *)kpu8Plain);
+                    }
+                    memmove(s_au8Stream, s_au8Stream + uiOffset, uiStreamLen - uiOffset);
+                    uiStreamLen -= uiOffset;
                 } else if (iReadSize == 0) {
                     printf("Server disconnected.\n");
-                    pthread_mutex_lock(&pstClientInfo->uRunningMutex);
-                    pstClientInfo->bIsRunning = false;
-                    pthread_mutex_unlock(&pstClientInfo->uRunningMutex);
-                    pthread_exit(NULL);
+                    break;
                 } else {
                     perror("Read error");
-                    pthread_mutex_lock(&pstClientInfo->uRunningMutex);
-                    pstClientInfo->bIsRunning = false;
-                    pthread_mutex_unlock(&pstClientInfo->uRunningMutex);
-                    pthread_exit(NULL);
+                    break;
                 }
             }
         }
     }
 
+    pthread_mutex_lock(&pstClientInfo->uRunningMutex);
+    markClientDisconnected(pstClientInfo);
+    pthread_mutex_unlock(&pstClientInfo->uRunningMutex);
     pthread_exit(NULL);
 }
 
+/**
+ * @brief 종료 요청이 없으면 지정한 시간 동안 기다립니다.
+ */
+static void waitWhileRunning(CLIENT_INFO *pstClientInfo, int iDelayMs) {
+    struct timespec stDeadline;
+
+    clock_gettime(CLOCK_REALTIME, &stDeadline);
+    stDeadline.tv_sec += iDelayMs / 1000;
+    stDeadline.tv_nsec += (long)(iDelayMs % 1000) * 1000000L;
+    if (stDeadline.tv_nsec >= 1000000000L) {
+        stDeadline.tv_sec++;
+        stDeadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&pstClientInfo->uRunningMutex);
+    while (pstClientInfo->bIsRunning &&
+           pthread_cond_timedwait(&pstClientInfo->stateCond, &pstClientInfo->uRunningMutex, &stDeadline) != ETIMEDOUT) {
+    }
+    pthread_mutex_unlock(&pstClientInfo->uRunningMutex);
+}
+
+/**
+ * @brief 재연결 메트릭 요약을 출력합니다.
+ */
+static void printReconnectSummary(void) {
+    TCP_METRICS_SNAPSHOT stSnapshot;
+    const TCP_HISTOGRAM *kpstHist;
+
+    getTcpMetricsSnapshot(&stSnapshot);
+    kpstHist = &stSnapshot.astHist[TCP_HIST_RECONNECT];
+    printf("reconnects: %lu (attempts %lu), latency p50 %.1f ms, max %.1f ms, queued drops: %lu\n",
+           (unsigned long)stSnapshot.au64Counter[TCP_METRIC_RECONNECTS],
+           (unsigned long)stSnapshot.au64Counter[TCP_METRIC_RECONNECT_ATTEMPTS],
+           (double)getTcpHistogramPercentile(kpstHist, 50.0) / 1e6, (double)kpstHist->u64Max / 1e6,
+           (unsigned long)stSnapshot.au64Counter[TCP_METRIC_DROPS]);
+}
+
 /**
  * @brief 메인 함수: TCP 클라이언트 소켓을 생성하고 서버와 통신을 처리
- * 
- * @details 클라이언트 소켓을 생성하여 서버와 연결을 시도합니다. 
- *          연결이 성공하면 송신 및 수신 스레드를 생성하여 데이터를 처리하며,
- *          연결 종료 후 재연결 여부를 사용자로부터 확인받습니다.
- * 
+ *
+ * @details 클라이언트 소켓을 생성하여 서버와 연결을 시도합니다.
+ *          연결이 성공하면 수신 스레드를 생성하여 데이터를 처리하며,
+ *          연결이 끊기거나 연결에 실패하면 백오프 후 자동으로 다시 연결합니다.
+ *          -n 으로 연속 실패 횟수를 제한하면 그 횟수를 넘을 때 종료합니다.
+ *
+ * @param argc 인자 개수
+ * @param argv 인자 목록 (-h 서버 주소, -p 포트, -u Unix 도메인 소켓 경로(지정하면 -h/-p 대신 사용), -b/-m 백오프 시작/상한(ms), -n 최대 연속 실패 수,
+ *             -q 끊김 동안의 큐 크기(바이트), -f flush|drop 재연결 후 큐 처리, -a 관리 소켓 경로, -t TLS로 연결할 때 신뢰할 CA 인증서,
+ *             -z LZ4 압축을 협상하고 이 길이(바이트) 이상인 메시지를 압축)
  * @return int 실행 결과
  */
-int main() {
+int main(int argc, char *argv[]) {
     CLIENT_INFO stClientInfo = {        \
-                .iSock = 0,             \
-                .bIsRunning = false,    \
+                .iSock = -1,            \
+                .bIsRunning = true,     \
+                .bConnected = false,    \
                 .achBuffer = {0},       \
                 .recvThreadId = 0,      \
                 .sendThreadId = 0,      \
-                .uRunningMutex = PTHREAD_MUTEX_INITIALIZER  \
+                .uRunningMutex = PTHREAD_MUTEX_INITIALIZER,  \
+                .sendMutex = PTHREAD_MUTEX_INITIALIZER,      \
+                .stateCond = PTHREAD_COND_INITIALIZER,       \
+                .pstOutageQueue = NULL, \
+                .bFlushOnReconnect = true, \
+                .bInputClosed = false,  \
+                .u64DisconnectedNs = 0, \
+                .iCompressThreshold = -1, \
+                .u8Caps = 0             \
             };
+    const char *kpchHost = SERVER_IP;
+    const char *kpchUnixPath = NULL;
+    const char *kpchAdminPath = NULL;
+    const char *kpchTlsCaFile = NULL;
+    TCP_TLS *pstTls = NULL;
+    int iPort = PORT;
+    int iBackoffBaseMs = BACKOFF_BASE_MS;
+    int iBackoffMaxMs = BACKOFF_MAX_MS;
+    int iMaxFailures = 0;
+    int iQueueSize = OUTAGE_QUEUE_SIZE;
+    unsigned int uiSeed = (unsigned int)(getTcpMonotonicNs() ^ (uint64_t)getpid());
+    bool bEverConnected = false;
+    int iFailures = 0;
+    int iOpt;
 
-    while(1){
-        stClientInfo.iSock = createTcpClientSocket(SERVER_IP, PORT);
-        if (stClientInfo.iSock < 0) {
-            printf("Failed to connect to server\n");
+    while ((iOpt = getopt(argc, argv, "h:p:u:b:m:n:q:f:a:t:z:")) != -1) {
+        switch (iOpt) {
+        case 'h': kpchHost = optarg; break;
+        case 'p': iPort = atoi(optarg); break;
+        case 'u': kpchUnixPath = optarg; break;
+        case 'b': iBackoffBaseMs = atoi(optarg); break;
+        case 'm': iBackoffMaxMs = atoi(optarg); break;
+        case 'n': iMaxFailures = atoi(optarg); break;
+        case 'q': iQueueSize = atoi(optarg); break;
+        case 'a': kpchAdminPath = optarg; break;
+        case 't': kpchTlsCaFile = optarg; break;
+        case 'z': stClientInfo.iCompressThreshold = atoi(optarg) < 0 ? 0 : atoi(optarg); break;
+        case 'f':
+            if (strcmp(optarg, "flush") == 0 || strcmp(optarg, "drop") == 0) {
+                stClientInfo.bFlushOnReconnect = (strcmp(optarg, "flush") == 0);
+                break;
+            }
+            /* fall through */
+        default:
+            fprintf(stderr, "Usage: %s [-h host] [-p port] [-u unix_socket] [-b backoff_base_ms] [-m backoff_max_ms] [-n max_failures]\n"
+                            "          [-q queue_bytes] [-f flush|drop] [-a admin_socket] [-t tls_ca_file] [-z compress_threshold]\n", argv[0]);
             return -1;
         }
-        stClientInfo.bIsRunning = true;
+    }
 
-        // 송신 및 수신 스레드 생성
-        if (pthread_create(&stClientInfo.sendThreadId, NULL, sendMessages, (void *)&stClientInfo) != 0) {
-            perror("Failed to create send thread");
-            close(stClientInfo.iSock);
-            return -1;
+    if (kpchTlsCaFile != NULL && kpchUnixPath == NULL && (pstTls = createTcpTlsClient(kpchTlsCaFile)) == NULL) {
+        fprintf(stderr, "Failed to set up TLS: %s\n", getTcpTlsError());
+        return -1;
+    }
+    stClientInfo.pstOutageQueue = createTcpRing((uint32_t)iQueueSize);
+    if (stClientInfo.pstOutageQueue == NULL) {
+        perror("Failed to create outage queue");
+        return -1;
+    }
+    if (kpchAdminPath != NULL && startTcpAdminServer(kpchAdminPath, 0) != 0) {
+        fprintf(stderr, "Failed to start admin interface: %s\n", kpchAdminPath);
+    }
+
+    // 송신(입력) 스레드는 재연결과 관계없이 하나만 둡니다.
+    if (pthread_create(&stClientInfo.sendThreadId, NULL, sendMessages, (void *)&stClientInfo) != 0) {
+        perror("Failed to create send thread");
+        return -1;
+    }
+
+    while (isClientRunning(&stClientInfo)) {
+        int iSock = (kpchUnixPath != NULL) ? createTcpUnixClientSocket(kpchUnixPath)
+                                           : connectTcpClientSocket(kpchHost, iPort, CONNECT_TIMEOUT_MS);
+        if (iSock >= 0 && pstTls != NULL && startTcpTls(pstTls, iSock, kpchHost, TCP_TLS_HANDSHAKE_TIMEOUT_MS) < 0) {
+            printf("TLS handshake failed: %s\n", getTcpTlsError());
+            close(iSock);
+            iSock = -1;
+        }
+        TCP_PROBE2(tcpClient, connect, iSock, iPort);
+        if (bEverConnected) {
+            addTcpMetric(TCP_METRIC_RECONNECT_ATTEMPTS, 1);
         }
 
+        if (iSock < 0) {
+            iFailures++;
+            if (iMaxFailures > 0 && iFailures >= iMaxFailures) {
+                printf("Failed to connect to server %d times, giving up\n", iFailures);
+                stopClient(&stClientInfo);
+                break;
+            }
+            int iDelayMs = getTcpBackoffDelayMs(iFailures - 1, iBackoffBaseMs, iBackoffMaxMs, &uiSeed);
+            printf("Failed to connect to server, retrying in %d ms (attempt %d)\n", iDelayMs, iFailures);
+            waitWhileRunning(&stClientInfo, iDelayMs);
+            continue;
+        }
+
+        // 보관한 메시지를 먼저 처리한 뒤 연결 상태로 바꾸므로, 새 입력은 그 뒤에 전송됩니다.
+        pthread_mutex_lock(&stClientInfo.uRunningMutex);
+        if (bEverConnected) {
+            uint64_t u64OutageNs = getTcpMonotonicNs() - stClientInfo.u64DisconnectedNs;
+            addTcpMetric(TCP_METRIC_RECONNECTS, 1);
+            recordTcpHistogram(TCP_HIST_RECONNECT, u64OutageNs);
+            printf("Reconnected after %d failed attempts, %.1f ms\n", iFailures, (double)u64OutageNs / 1e6);
+        }
+        bool bFlushed = flushOutageQueue(&stClientInfo, iSock);
+        if (bFlushed && stClientInfo.iCompressThreshold >= 0) {
+            /**< 응답은 수신 스레드가 받으며, 그 전까지는 압축하지 않고 보냅니다. */
+            uint8_t au8Caps[TCP_FRAME_HEADER_SIZE + 1 + TCP_FRAME_CRC_SIZE];
+            uint8_t u8Caps = TCP_FRAME_CAP_LZ4;
+            int iCapsLen = encodeTcpFrame(au8Caps, sizeof(au8Caps), CLIENT_ID, TCP_INST_CAPS, &u8Caps, 1);
+            bFlushed = sendFrame(iSock, au8Caps, (size_t)iCapsLen);
+        }
+        if (bFlushed) {
+            stClientInfo.iSock = iSock;
+            stClientInfo.bConnected = true;
+            if (stClientInfo.bInputClosed) {
+                stClientInfo.bIsRunning = false;
+            }
+        }
+        pthread_mutex_unlock(&stClientInfo.uRunningMutex);
+        bEverConnected = true;
+        if (!bFlushed) {
+            close(iSock);
+            iFailures = 1;
+            continue;
+        }
+        iFailures = 0;
+
         if (pthread_create(&stClientInfo.recvThreadId, NULL, receiveMessages, (void *)&stClientInfo) != 0) {
             perror("Failed to create receive thread");
-            close(stClientInfo.iSock);
-            return -1;
+            stopClient(&stClientInfo);
+        } else {
+            // 연결이 끊기거나 종료할 때까지 대기
+            pthread_join(stClientInfo.recvThreadId, NULL);
         }
 
-        // 스레드가 종료될 때까지 대기
-        pthread_join(stClientInfo.sendThreadId, NULL);
-        pthread_join(stClientInfo.recvThreadId, NULL);
-
-        close(stClientInfo.iSock);
+        // shutdown으로 막혀 있는 send()를 풀고, 송신 스레드가 이 소켓을 놓은 뒤 닫습니다.
+        pthread_mutex_lock(&stClientInfo.uRunningMutex);
+        markClientDisconnected(&stClientInfo);
+        stClientInfo.iSock = -1;
+        pthread_mutex_unlock(&stClientInfo.uRunningMutex);
+        pthread_mutex_lock(&stClientInfo.sendMutex);
+        close(iSock);
+        pthread_mutex_unlock(&stClientInfo.sendMutex);
+    }
 
-        // 다시 시도할지 여부 확인
-        char retry;
-        printf("Do you want to reconnect? (y/n): ");
-        scanf(" %c", &retry);
-        if (retry != 'y' && retry != 'Y') {
-            break;
-        }
-        getchar();  // 입력 버퍼에 남아있는 개행 문자를 제거
+    pthread_join(stClientInfo.sendThreadId, NULL);
+    printReconnectSummary();
+    if (kpchAdminPath != NULL) {
+        stopTcpAdminServer();
     }
+    destroyTcpRing(stClientInfo.pstOutageQueue);
+    destroyTcpTls(pstTls);
     return 0;
 }
@@ -0,0 +1,643 @@
+/**
+ * @file tcpLoadGen.c
+ * @brief 에코 서버 성능 측정을 위한 개방 루프(open-loop) 부하 발생기입니다.
+ *
+ * 지정한 수의 연결을 맺고, 전체 목표 전송률(msgs/s)에 맞춘 고정 일정으로 DATA 프레임을 보냅니다.
+ * 각 메시지는 "보내야 했던 시각"을 페이로드에 담고, 돌아온 프레임의 지연은 그 시각부터 계산합니다.
+ * 서버가 느려져 송신이 밀려도 일정은 그대로 유지되므로, 밀린 시간까지 지연에 포함되어
+ * 협응 누락(coordinated omission)으로 꼬리 지연이 작게 보이는 문제를 피합니다.
+ *
+ * 주요 기능:
+ * - 연결 수, 목표 전송률, 측정 시간, 워밍업 시간 지정
+ * - 메시지 크기 분포 (고정, 균등, 지수)
+ * - 처리량(msgs/s, MB/s)과 p50/p99/p99.9/최대 지연 보고 (사람이 읽는 형식 또는 JSON 한 줄)
+ * - 연결별 LZ4 압축 협상 (-z, 측정 정보 뒤 페이로드는 0이라 잘 압축됩니다)
+ *
+ * 사용 예) ./tcpLoadGen -c 10 -r 20000 -d 10 -w 2 -s uniform:16-512
+ *
+ * @date 2024-12-18
+ */
+
+#include "tcpSock.h"
+#include "tcpFrame.h"
+#include "tcpMetrics.h"
+#include "tcpTls.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <getopt.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <poll.h>
+
+#define LOADGEN_DEFAULT_PORT 8080
+#define LOADGEN_DEFAULT_HOST "127.0.0.1"
+#define LOADGEN_DRAIN_SEC 2                 /**< 송신 종료 후 응답을 기다리는 기본 시간 (초) */
+#define LOADGEN_MAX_EVENTS 256
+#define LOADGEN_CONNECT_TIMEOUT_MS 5000       /**< 연결별 연결 제한 시간 (ms) */
+
+/**
+ * @brief 페이로드 앞부분에 담는 측정 정보. 메시지 크기는 이보다 작을 수 없습니다.
+ */
+typedef struct {
+    uint64_t u64IntendedNs;                 /**< 일정상 송신 시각 (CLOCK_MONOTONIC ns) */
+    uint32_t u32Seq;                        /**< 전체 순번 */
+    uint32_t u32Conn;                       /**< 연결 번호 */
+} LOADGEN_STAMP;
+
+/**
+ * @brief 메시지 크기 분포 종류
+ */
+typedef enum {
+    LOADGEN_SIZE_FIXED,                     /**< 고정 크기 */
+    LOADGEN_SIZE_UNIFORM,                   /**< [최소, 최대] 균등 분포 */
+    LOADGEN_SIZE_EXP                        /**< 평균을 지정한 지수 분포 */
+} LOADGEN_SIZE_DIST;
+
+/**
+ * @brief 연결별 수신 상태
+ */
+typedef struct {
+    int iSock;                              /**< 소켓 파일 디스크립터 */
+    uint8_t *pu8Stream;                     /**< 프레임 조립 버퍼 (uiStreamCap 바이트) */
+    size_t uiStreamLen;                     /**< 조립 버퍼의 데이터 길이 */
+    bool bCompress;                         /**< 서버와 LZ4 압축에 합의함 */
+} LOADGEN_CONN;
+
+/**
+ * @brief 부하 발생기 설정과 결과
+ */
+typedef struct {
+    const char *kpchHost;                   /**< 서버 주소 */
+    const char *kpchUnixPath;               /**< Unix 도메인 소켓 경로. 지정하면 TCP 대신 사용합니다. */
+    const char *kpchTlsCaFile;              /**< TLS로 연결할 때 신뢰할 CA 인증서 (NULL이면 평문) */
+    int iPort;                              /**< 서버 포트 */
+    int iConnCount;                         /**< 연결 수 */
+    double dRate;                           /**< 전체 목표 전송률 (msgs/s) */
+    double dDurationSec;                    /**< 측정 시간 (초) */
+    double dWarmupSec;                      /**< 워밍업 시간 (초). 이 구간의 메시지는 집계하지 않습니다. */
+    double dDrainSec;                       /**< 송신 종료 후 응답을 기다리는 최대 시간 (초). 넘으면 손실로 집계합니다. */
+    LOADGEN_SIZE_DIST eSizeDist;            /**< 메시지 크기 분포 */
+    size_t uiSizeA;                         /**< 고정 크기 / 균등 최소 / 지수 평균 */
+    size_t uiSizeB;                         /**< 균등 최대 */
+    uint8_t u8ClientId;                     /**< 프레임 Client ID */
+    bool bJson;                             /**< 결과를 JSON 한 줄로 출력 */
+    int iCompressThreshold;                 /**< 압축할 최소 메시지 길이 (-1이면 압축을 협상하지 않음) */
+    size_t uiStreamCap;                     /**< 연결별 조립 버퍼 크기 (최대 프레임 2개) */
+    uint64_t u64ConnectNs;                  /**< 전체 연결 수립에 걸린 시간 */
+
+    LOADGEN_CONN *pstConns;                 /**< 연결 배열 */
+    int iEpollFd;                           /**< 수신용 epoll */
+    uint64_t u64StartNs;                    /**< 일정 시작 시각 */
+    uint64_t u64MeasureStartNs;             /**< 집계 시작 시각 (워밍업 이후) */
+    volatile bool bSending;                 /**< 송신 스레드 동작 중 */
+    volatile bool bReceiving;               /**< 수신 스레드 동작 중 */
+
+    uint64_t u64Sent;                       /**< 집계 구간 송신 메시지 수 */
+    uint64_t u64SentBytes;                  /**< 집계 구간 송신 바이트 (프레임 기준) */
+    uint64_t u64Compressed;                 /**< 집계 구간 송신 메시지 중 압축한 수 */
+    uint64_t u64Received;                   /**< 집계 구간 수신 메시지 수 (수신 스레드만 갱신) */
+    uint64_t u64ReceivedBytes;              /**< 집계 구간 수신 바이트 (수신 스레드 전용) */
+    uint64_t u64FrameErrors;                /**< 잘못된 프레임 수 */
+    uint64_t u64Busy;                       /**< 집계 구간에 서버가 과부하로 거절(BUSY)한 메시지 수 (수신 스레드만 갱신) */
+    uint64_t u64SendBehindMax;              /**< 일정보다 늦게 보낸 최대 시간 (ns) */
+    TCP_HISTOGRAM stLatency;                /**< 지연 히스토그램 (ns, 수신 스레드 전용) */
+} LOADGEN;
+
+/**
+ * @brief xorshift64* 난수. 부하 발생 경로에서 rand()의 잠금을 피합니다.
+ */
+static uint64_t nextRandom(uint64_t *pu64State) {
+    uint64_t u64X = *pu64State;
+
+    u64X ^= u64X >> 12;
+    u64X ^= u64X << 25;
+    u64X ^= u64X >> 27;
+    *pu64State = u64X;
+    return u64X * 0x2545F4914F6CDD1DULL;
+}
+
+/**
+ * @brief 분포에 따라 다음 메시지 크기를 구합니다.
+ */
+static size_t nextMessageSize(const LOADGEN *kpstGen, uint64_t *pu64Rand) {
+    size_t uiSize;
+
+    switch (kpstGen->eSizeDist) {
+    case LOADGEN_SIZE_UNIFORM:
+        uiSize = kpstGen->uiSizeA + (size_t)(nextRandom(pu64Rand) % (kpstGen->uiSizeB - kpstGen->uiSizeA + 1));
+        break;
+    case LOADGEN_SIZE_EXP: {
+        double dU = (double)(nextRandom(pu64Rand) >> 11) / (double)(1ULL << 53);
+        uiSize = (size_t)(-log(1.0 - dU) * (double)kpstGen->uiSizeA);
+        break;
+    }
+    case LOADGEN_SIZE_FIXED:
+    default:
+        uiSize = kpstGen->uiSizeA;
+        break;
+    }
+
+    if (uiSize < sizeof(LOADGEN_STAMP)) {
+        uiSize = sizeof(LOADGEN_STAMP);
+    }
+    if (uiSize > TCP_FRAME_MAX_DATA) {
+        uiSize = TCP_FRAME_MAX_DATA;
+    }
+    return uiSize;
+}
+
+/**
+ * @brief 크기 분포 문자열을 해석합니다. (fixed:N, uniform:A-B, exp:MEAN)
+ * @return 성공 시 0, 형식 오류 시 -1
+ */
+static int parseSizeDist(LOADGEN *pstGen, const char *kpchSpec) {
+    unsigned long ulA, ulB;
+
+    if (sscanf(kpchSpec, "fixed:%lu", &ulA) == 1) {
+        pstGen->eSizeDist = LOADGEN_SIZE_FIXED;
+        pstGen->uiSizeA = ulA;
+    } else if (sscanf(kpchSpec, "uniform:%lu-%lu", &ulA, &ulB) == 2 && ulA <= ulB) {
+        pstGen->eSizeDist = LOADGEN_SIZE_UNIFORM;
+        pstGen->uiSizeA = ulA;
+        pstGen->uiSizeB = ulB;
+    } else if (sscanf(kpchSpec, "exp:%lu", &ulA) == 1 && ulA > 0) {
+        pstGen->eSizeDist = LOADGEN_SIZE_EXP;
+        pstGen->uiSizeA = ulA;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 절대 시각(CLOCK_MONOTONIC ns)까지 잠듭니다.
+ */
+static void sleepUntilNs(uint64_t u64DeadlineNs) {
+    struct timespec stDeadline;
+
+    stDeadline.tv_sec = (time_t)(u64DeadlineNs / 1000000000ULL);
+    stDeadline.tv_nsec = (long)(u64DeadlineNs % 1000000000ULL);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &stDeadline, NULL) == EINTR) {
+    }
+}
+
+/**
+ * @brief 데이터를 모두 송신합니다.
+ * @return 성공 시 true, 연결 오류 시 false
+ */
+static bool sendAll(int iSock, const uint8_t *kpu8Data, size_t uiLen) {
+    while (uiLen > 0) {
+        ssize_t iWriteSize = send(iSock, kpu8Data, uiLen, MSG_NOSIGNAL);
+        if (iWriteSize < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        kpu8Data += iWriteSize;
+        uiLen -= (size_t)iWriteSize;
+    }
+    return true;
+}
+
+/**
+ * @brief 개방 루프 송신 스레드
+ *
+ * @details k번째 메시지의 일정상 송신 시각은 시작 시각 + k / 전송률 이며, 연결은 차례로 돌아가며 사용합니다.
+ *          일정보다 늦어져도 건너뛰지 않고 바로 보내며, 지연은 일정상 시각 기준으로 측정됩니다.
+ */
+static void *loadGenSendThread(void *pvData) {
+    LOADGEN *pstGen = (LOADGEN *)pvData;
+    uint8_t *pu8Frame = (uint8_t *)malloc(TCP_FRAME_MAX_SIZE);
+    uint8_t *pu8Payload = (uint8_t *)calloc(1, TCP_FRAME_MAX_DATA);
+    uint64_t u64Rand = 0x9E3779B97F4A7C15ULL ^ (uint64_t)getpid();
+    double dIntervalNs = 1e9 / pstGen->dRate;
+    uint64_t u64EndNs = pstGen->u64StartNs + (uint64_t)((pstGen->dWarmupSec + pstGen->dDurationSec) * 1e9);
+
+    if (pu8Frame == NULL || pu8Payload == NULL) {
+        perror("송신 버퍼 할당 실패");
+        free(pu8Frame);
+        free(pu8Payload);
+        pstGen->bSending = false;
+        return NULL;
+    }
+
+    for (uint64_t u64Seq = 0; pstGen->bSending; u64Seq++) {
+        uint64_t u64IntendedNs = pstGen->u64StartNs + (uint64_t)((double)u64Seq * dIntervalNs);
+        if (u64IntendedNs >= u64EndNs) {
+            break;
+        }
+
+        uint64_t u64NowNs = getTcpMonotonicNs();
+        if (u64NowNs < u64IntendedNs) {
+            sleepUntilNs(u64IntendedNs);
+        } else if (u64NowNs - u64IntendedNs > pstGen->u64SendBehindMax) {
+            pstGen->u64SendBehindMax = u64NowNs - u64IntendedNs;
+        }
+
+        LOADGEN_STAMP stStamp;
+        size_t uiSize = nextMessageSize(pstGen, &u64Rand);
+        int iConn = (int)(u64Seq % (uint64_t)pstGen->iConnCount);
+
+        stStamp.u64IntendedNs = u64IntendedNs;
+        stStamp.u32Seq = (uint32_t)u64Seq;
+        stStamp.u32Conn = (uint32_t)iConn;
+        memcpy(pu8Payload, &stStamp, sizeof(stStamp));
+
+        int iFrameLen;
+        if (pstGen->pstConns[iConn].bCompress) {
+            iFrameLen = encodeTcpLz4Frame(pu8Frame, TCP_FRAME_MAX_SIZE, pstGen->u8ClientId, TCP_INST_DATA,
+                                          pu8Payload, uiSize, (size_t)pstGen->iCompressThreshold);
+        } else {
+            iFrameLen = encodeTcpFrame(pu8Frame, TCP_FRAME_MAX_SIZE, pstGen->u8ClientId, TCP_INST_DATA,
+                                       pu8Payload, uiSize);
+        }
+        if (!sendAll(pstGen->pstConns[iConn].iSock, pu8Frame, (size_t)iFrameLen)) {
+            perror("send 실패");
+            break;
+        }
+        if (u64IntendedNs >= pstGen->u64MeasureStartNs) {
+            pstGen->u64Sent++;
+            pstGen->u64SentBytes += (uint64_t)iFrameLen;
+            if ((size_t)iFrameLen < TCP_FRAME_HEADER_SIZE + uiSize + TCP_FRAME_CRC_SIZE) {
+                pstGen->u64Compressed++;
+            }
+        }
+    }
+
+    free(pu8Frame);
+    free(pu8Payload);
+    pstGen->bSending = false;
+    return NULL;
+}
+
+/**
+ * @brief 연결 하나의 조립 버퍼에서 완성된 프레임을 처리합니다.
+ * @param pu8Plain 압축 프레임을 풀 버퍼 (TCP_FRAME_MAX_DATA 바이트)
+ */
+static void processLoadGenFrames(LOADGEN *pstGen, LOADGEN_CONN *pstConn, uint8_t *pu8Plain) {
+    size_t uiOffset = 0;
+    uint64_t u64NowNs = getTcpMonotonicNs();
+
+    while (uiOffset < pstConn->uiStreamLen) {
+        TCP_FRAME_HEADER stHeader;
+        const uint8_t *kpu8Data;
+        int iFrameLen = decodeTcpFrame(pstConn->pu8Stream + uiOffset, pstConn->uiStreamLen - uiOffset,
+                                       &stHeader, &kpu8Data);
+        if (iFrameLen == 0) {
+            break;
+        } else if (iFrameLen < 0) {
+            pstGen->u64FrameErrors++;
+            uiOffset += findTcpFrameStart(pstConn->pu8Stream + uiOffset, pstConn->uiStreamLen - uiOffset);
+            continue;
+        }
+
+        const uint8_t *kpu8Plain;
+        int iPlainLen = getTcpFramePlainData(&stHeader, kpu8Data, pu8Plain, TCP_FRAME_MAX_DATA, &kpu8Plain);
+        if (stHeader.u8Instruction == TCP_INST_BUSY) {
+            /**< 거절 응답에는 보낸 시각이 없으므로 받은 시각으로 집계 구간을 판단합니다. */
+            if (u64NowNs >= pstGen->u64MeasureStartNs) {
+                __atomic_store_n(&pstGen->u64Busy, pstGen->u64Busy + 1, __ATOMIC_RELAXED); /**< 메인 스레드가 응답 대기 중 읽음 */
+            }
+        } else if (iPlainLen < 0) {
+            pstGen->u64FrameErrors++;
+        } else if ((size_t)iPlainLen >= sizeof(LOADGEN_STAMP)) {
+            LOADGEN_STAMP stStamp;
+            memcpy(&stStamp, kpu8Plain, sizeof(stStamp));
+            if (stStamp.u64IntendedNs >= pstGen->u64MeasureStartNs) {
+                __atomic_store_n(&pstGen->u64Received, pstGen->u64Received + 1, __ATOMIC_RELAXED);
+                pstGen->u64ReceivedBytes += (uint64_t)iFrameLen;
+                addTcpHistogramValue(&pstGen->stLatency,
+                                     u64NowNs > stStamp.u64IntendedNs ? u64NowNs - stStamp.u64IntendedNs : 0);
+            }
+        }
+        uiOffset += (size_t)iFrameLen;
+    }
+
+    memmove(pstConn->pu8Stream, pstConn->pu8Stream + uiOffset, pstConn->uiStreamLen - uiOffset);
+    pstConn->uiStreamLen -= uiOffset;
+}
+
+/**
+ * @brief 모든 연결의 응답을 epoll 로 받는 수신 스레드
+ */
+static void *loadGenReceiveThread(void *pvData) {
+    LOADGEN *pstGen = (LOADGEN *)pvData;
+    struct epoll_event astEvents[LOADGEN_MAX_EVENTS];
+    uint8_t *pu8Plain = (uint8_t *)malloc(TCP_FRAME_MAX_DATA);
+
+    if (pu8Plain == NULL) {
+        perror("수신 버퍼 할당 실패");
+        return NULL;
+    }
+
+    while (pstGen->bReceiving) {
+        int iEventCount = epoll_wait(pstGen->iEpollFd, astEvents, LOADGEN_MAX_EVENTS, 100);
+        if (iEventCount < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("epoll_wait 실패");
+            break;
+        }
+
+        for (int i = 0; i < iEventCount; i++) {
+            LOADGEN_CONN *pstConn = &pstGen->pstConns[astEvents[i].data.u32];
+            ssize_t iReadSize = read(pstConn->iSock, pstConn->pu8Stream + pstConn->uiStreamLen,
+                                     pstGen->uiStreamCap - pstConn->uiStreamLen);
+            if (iReadSize <= 0) {
+                if (iReadSize < 0 && (errno == EINTR || errno == EAGAIN)) {
+                    continue;
+                }
+                fprintf(stderr, "연결 %u 종료\n", astEvents[i].data.u32);
+                epoll_ctl(pstGen->iEpollFd, EPOLL_CTL_DEL, pstConn->iSock, NULL);
+                continue;
+            }
+            pstConn->uiStreamLen += (size_t)iReadSize;
+            processLoadGenFrames(pstGen, pstConn, pu8Plain);
+        }
+    }
+
+    free(pu8Plain);
+    return NULL;
+}
+
+/**
+ * @brief 연결 직후 LZ4 압축을 협상하고 응답을 기다립니다.
+ * @return 서버가 LZ4에 합의했으면 true. 거절했거나 응답이 없으면 false (압축하지 않고 측정합니다)
+ *
+ * @details 송신을 시작하기 전이라 응답 외의 프레임은 오지 않으므로, 응답 프레임 길이만큼만 읽습니다.
+ */
+static bool negotiateLoadGenCaps(const LOADGEN *kpstGen, int iSock) {
+    uint8_t au8Frame[TCP_FRAME_HEADER_SIZE + 1 + TCP_FRAME_CRC_SIZE];
+    uint8_t u8Caps = TCP_FRAME_CAP_LZ4;
+    int iFrameLen = encodeTcpFrame(au8Frame, sizeof(au8Frame), kpstGen->u8ClientId, TCP_INST_CAPS, &u8Caps, 1);
+    size_t uiGot = 0;
+
+    if (!sendAll(iSock, au8Frame, (size_t)iFrameLen)) {
+        return false;
+    }
+    while (uiGot < sizeof(au8Frame)) {
+        struct pollfd stPoll = {iSock, POLLIN, 0};
+        ssize_t iReadSize;
+
+        if (poll(&stPoll, 1, LOADGEN_CONNECT_TIMEOUT_MS) <= 0) {
+            return false;
+        }
+        iReadSize = read(iSock, au8Frame + uiGot, sizeof(au8Frame) - uiGot);
+        if (iReadSize <= 0) {
+            return false;
+        }
+        uiGot += (size_t)iReadSize;
+    }
+
+    TCP_FRAME_HEADER stHeader;
+    const uint8_t *kpu8Data;
+    return decodeTcpFrame(au8Frame, sizeof(au8Frame), &stHeader, &kpu8Data) > 0
+           && stHeader.u8Instruction == TCP_INST_CAPS && (kpu8Data[0] & TCP_FRAME_CAP_LZ4);
+}
+
+/**
+ * @brief 메시지 크기 분포에서 나올 수 있는 최대 DATA 길이를 구합니다.
+ */
+static size_t getMaxMessageSize(const LOADGEN *kpstGen) {
+    size_t uiSize;
+
+    switch (kpstGen->eSizeDist) {
+    case LOADGEN_SIZE_UNIFORM:
+        uiSize = kpstGen->uiSizeB;
+        break;
+    case LOADGEN_SIZE_EXP:
+        uiSize = TCP_FRAME_MAX_DATA;
+        break;
+    case LOADGEN_SIZE_FIXED:
+    default:
+        uiSize = kpstGen->uiSizeA;
+        break;
+    }
+
+    if (uiSize < sizeof(LOADGEN_STAMP)) {
+        uiSize = sizeof(LOADGEN_STAMP);
+    }
+    return uiSize < TCP_FRAME_MAX_DATA ? uiSize : TCP_FRAME_MAX_DATA;
+}
+
+/**
+ * @brief 응답(처리 응답 + 과부하 거절 BUSY)을 받은 메시지 수를 구합니다.
+ *
+ * @details 수신 스레드가 갱신 중이어도 읽을 수 있도록 원자적으로 읽습니다.
+ */
+static uint64_t getLoadGenAnswered(const LOADGEN *kpstGen) {
+    return __atomic_load_n(&kpstGen->u64Received, __ATOMIC_RELAXED) + __atomic_load_n(&kpstGen->u64Busy, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief 결과를 JSON 한 줄로 출력합니다. 회귀 테스트 스크립트가 읽습니다.
+ */
+static void printLoadGenJson(const LOADGEN *kpstGen) {
+    const TCP_HISTOGRAM *kpstHist = &kpstGen->stLatency;
+    uint64_t u64Answered = getLoadGenAnswered(kpstGen);
+    uint64_t u64Lost = kpstGen->u64Sent > u64Answered ? kpstGen->u64Sent - u64Answered : 0;
+
+    printf("{\"connections\": %d, \"target_rate\": %.0f, \"duration_sec\": %.3f, "
+           "\"sent\": %lu, \"received\": %lu, \"busy\": %lu, \"lost\": %lu, \"frame_errors\": %lu, "
+           "\"msgs_per_sec\": %.1f, \"mb_per_sec\": %.3f, \"connect_ms\": %.1f, \"send_behind_max_us\": %.1f, "
+           "\"p50_us\": %.1f, \"p99_us\": %.1f, \"p999_us\": %.1f, \"max_us\": %.1f, \"compressed\": %lu}\n",
+           kpstGen->iConnCount, kpstGen->dRate, kpstGen->dDurationSec,
+           (unsigned long)kpstGen->u64Sent, (unsigned long)kpstGen->u64Received,
+           (unsigned long)kpstGen->u64Busy, (unsigned long)u64Lost, (unsigned long)kpstGen->u64FrameErrors,
+           (double)kpstGen->u64Received / kpstGen->dDurationSec,
+           (double)kpstGen->u64ReceivedBytes / kpstGen->dDurationSec / 1e6,
+           (double)kpstGen->u64ConnectNs / 1e6,
+           (double)kpstGen->u64SendBehindMax / 1e3,
+           (double)getTcpHistogramPercentile(kpstHist, 50.0) / 1e3,
+           (double)getTcpHistogramPercentile(kpstHist, 99.0) / 1e3,
+           (double)getTcpHistogramPercentile(kpstHist, 99.9) / 1e3,
+           (double)kpstHist->u64Max / 1e3, (unsigned long)kpstGen->u64Compressed);
+}
+
+/**
+ * @brief 결과를 출력합니다.
+ */
+static void printLoadGenReport(const LOADGEN *kpstGen) {
+    const TCP_HISTOGRAM *kpstHist = &kpstGen->stLatency;
+    uint64_t u64Answered = getLoadGenAnswered(kpstGen);
+    uint64_t u64Lost = kpstGen->u64Sent > u64Answered ? kpstGen->u64Sent - u64Answered : 0;
+
+    if (kpstGen->bJson) {
+        printLoadGenJson(kpstGen);
+        return;
+    }
+
+    printf("connections   : %d\n", kpstGen->iConnCount);
+    printf("target rate   : %.0f msgs/s\n", kpstGen->dRate);
+    printf("sent          : %lu\n", (unsigned long)kpstGen->u64Sent);
+    printf("received      : %lu\n", (unsigned long)kpstGen->u64Received);
+    printf("busy          : %lu\n", (unsigned long)kpstGen->u64Busy);
+    printf("lost          : %lu\n", (unsigned long)u64Lost);
+    printf("frame errors  : %lu\n", (unsigned long)kpstGen->u64FrameErrors);
+    if (kpstGen->iCompressThreshold >= 0) {
+        printf("compressed    : %lu\n", (unsigned long)kpstGen->u64Compressed);
+    }
+    printf("connect time  : %.1f ms\n", (double)kpstGen->u64ConnectNs / 1e6);
+    printf("throughput    : %.1f msgs/s, %.3f MB/s\n",
+           (double)kpstGen->u64Received / kpstGen->dDurationSec,
+           (double)kpstGen->u64ReceivedBytes / kpstGen->dDurationSec / 1e6);
+    printf("send behind   : max %.1f us\n", (double)kpstGen->u64SendBehindMax / 1e3);
+    printf("latency (us)  : p50 %.1f  p99 %.1f  p99.9 %.1f  max %.1f\n",
+           (double)getTcpHistogramPercentile(kpstHist, 50.0) / 1e3,
+           (double)getTcpHistogramPercentile(kpstHist, 99.0) / 1e3,
+           (double)getTcpHistogramPercentile(kpstHist, 99.9) / 1e3,
+           (double)kpstHist->u64Max / 1e3);
+}
+
+static void printUsage(const char *kpchProg) {
+    fprintf(stderr,
+            "사용법: %s [-h 호스트] [-p 포트] [-u Unix소켓경로] [-c 연결수] [-r msgs/s] [-d 측정초] [-w 워밍업초]\n"
+            "          [-s fixed:N|uniform:A-B|exp:MEAN] [-i ClientID] [-t 응답대기초] [-T TLS_CA파일] [-z 압축임계바이트] [-j]\n", kpchProg);
+}
+
+/**
+ * @brief 메인 함수: 연결을 맺고 송신/수신 스레드를 실행한 뒤 결과를 출력합니다.
+ */
+int main(int argc, char *argv[]) {
+    LOADGEN stGen;
+    TCP_TLS *pstTls = NULL;
+    int iOpt;
+    int iRet = 0;
+
+    memset(&stGen, 0x0, sizeof(stGen));
+    stGen.kpchHost = LOADGEN_DEFAULT_HOST;
+    stGen.iPort = LOADGEN_DEFAULT_PORT;
+    stGen.iConnCount = 1;
+    stGen.dRate = 1000.0;
+    stGen.dDurationSec = 10.0;
+    stGen.dWarmupSec = 1.0;
+    stGen.dDrainSec = LOADGEN_DRAIN_SEC;
+    stGen.eSizeDist = LOADGEN_SIZE_FIXED;
+    stGen.uiSizeA = 64;
+    stGen.u8ClientId = 0x01;
+    stGen.iCompressThreshold = -1;
+
+    while ((iOpt = getopt(argc, argv, "h:p:u:c:r:d:w:s:i:t:T:z:j")) != -1) {
+        switch (iOpt) {
+        case 'h': stGen.kpchHost = optarg; break;
+        case 'p': stGen.iPort = atoi(optarg); break;
+        case 'u': stGen.kpchUnixPath = optarg; break;
+        case 'c': stGen.iConnCount = atoi(optarg); break;
+        case 'r': stGen.dRate = atof(optarg); break;
+        case 'd': stGen.dDurationSec = atof(optarg); break;
+        case 'w': stGen.dWarmupSec = atof(optarg); break;
+        case 'i': stGen.u8ClientId = (uint8_t)strtoul(optarg, NULL, 0); break;
+        case 't': stGen.dDrainSec = atof(optarg); break;
+        case 'T': stGen.kpchTlsCaFile = optarg; break;
+        case 'z': stGen.iCompressThreshold = atoi(optarg) < 0 ? 0 : atoi(optarg); break;
+        case 'j': stGen.bJson = true; break;
+        case 's':
+            if (parseSizeDist(&stGen, optarg) != 0) {
+                printUsage(argv[0]);
+                return -1;
+            }
+            break;
+        default:
+            printUsage(argv[0]);
+            return -1;
+        }
+    }
+    if (stGen.iConnCount <= 0 || stGen.dRate <= 0.0 || stGen.dDurationSec <= 0.0 || stGen.dWarmupSec < 0.0) {
+        printUsage(argv[0]);
+        return -1;
+    }
+    if (stGen.kpchTlsCaFile != NULL && stGen.kpchUnixPath == NULL
+        && (pstTls = createTcpTlsClient(stGen.kpchTlsCaFile)) == NULL) {
+        fprintf(stderr, "TLS 설정 실패: %s\n", getTcpTlsError());
+        return -1;
+    }
+
+    stGen.pstConns = (LOADGEN_CONN *)calloc((size_t)stGen.iConnCount, sizeof(LOADGEN_CONN));
+    stGen.iEpollFd = epoll_create1(0);
+    if (stGen.pstConns == NULL || stGen.iEpollFd < 0) {
+        perror("초기화 실패");
+        return -1;
+    }
+    resetTcpHistogram(&stGen.stLatency);
+    stGen.uiStreamCap = (TCP_FRAME_HEADER_SIZE + getMaxMessageSize(&stGen) + TCP_FRAME_CRC_SIZE) * 2;
+
+    uint64_t u64ConnectStartNs = getTcpMonotonicNs();
+    int iConnected = 0;
+    for (; iConnected < stGen.iConnCount; iConnected++) {
+        LOADGEN_CONN *pstConn = &stGen.pstConns[iConnected];
+        struct epoll_event stEvent;
+        int iNoDelay = 1;
+
+        if (stGen.kpchUnixPath != NULL) {
+            pstConn->iSock = createTcpUnixClientSocket(stGen.kpchUnixPath);
+        } else {
+            pstConn->iSock = connectTcpClientSocket(stGen.kpchHost, stGen.iPort, LOADGEN_CONNECT_TIMEOUT_MS);
+        }
+        pstConn->pu8Stream = (uint8_t *)malloc(stGen.uiStreamCap);
+        if (pstConn->iSock < 0 || pstConn->pu8Stream == NULL) {
+            fprintf(stderr, "연결 %d 실패\n", iConnected);
+            iRet = -1;
+            break;
+        }
+        if (pstTls != NULL && startTcpTls(pstTls, pstConn->iSock, stGen.kpchHost, TCP_TLS_HANDSHAKE_TIMEOUT_MS) < 0) {
+            fprintf(stderr, "연결 %d TLS 실패: %s\n", iConnected, getTcpTlsError());
+            iRet = -1;
+            break;
+        }
+        if (stGen.kpchUnixPath == NULL) {
+            setsockopt(pstConn->iSock, IPPROTO_TCP, TCP_NODELAY, &iNoDelay, sizeof(iNoDelay));
+        }
+        if (stGen.iCompressThreshold >= 0 && !(pstConn->bCompress = negotiateLoadGenCaps(&stGen, pstConn->iSock))) {
+            fprintf(stderr, "연결 %d: 서버가 압축을 거절하여 압축하지 않고 보냅니다\n", iConnected);
+        }
+
+        stEvent.events = EPOLLIN;
+        stEvent.data.u32 = (uint32_t)iConnected;
+        epoll_ctl(stGen.iEpollFd, EPOLL_CTL_ADD, pstConn->iSock, &stEvent);
+    }
+
+    stGen.u64ConnectNs = getTcpMonotonicNs() - u64ConnectStartNs;
+
+    if (iRet == 0) {
+        pthread_t sendThreadId, recvThreadId;
+
+        stGen.u64StartNs = getTcpMonotonicNs() + 10000000ULL; /**< 스레드 준비를 위해 10ms 뒤 시작 */
+        stGen.u64MeasureStartNs = stGen.u64StartNs + (uint64_t)(stGen.dWarmupSec * 1e9);
+        stGen.bSending = true;
+        stGen.bReceiving = true;
+
+        pthread_create(&recvThreadId, NULL, loadGenReceiveThread, &stGen);
+        pthread_create(&sendThreadId, NULL, loadGenSendThread, &stGen);
+        pthread_join(sendThreadId, NULL);
+
+        /**< 남은 응답을 기다립니다. BUSY로 거절된 메시지도 응답을 받은 것이므로 함께 셉니다. */
+        uint64_t u64DrainEndNs = getTcpMonotonicNs() + (uint64_t)(stGen.dDrainSec * 1e9);
+        while (getTcpMonotonicNs() < u64DrainEndNs && getLoadGenAnswered(&stGen) < stGen.u64Sent) {
+            usleep(10000);
+        }
+        stGen.bReceiving = false;
+        pthread_join(recvThreadId, NULL);
+
+        printLoadGenReport(&stGen);
+    }
+
+    for (int i = 0; i < stGen.iConnCount; i++) {
+        if (stGen.pstConns[i].iSock > 0) {
+            close(stGen.pstConns[i].iSock);
+        }
+        free(stGen.pstConns[i].pu8Stream);
+    }
+    free(stGen.pstConns);
+    close(stGen.iEpollFd);
+    destroyTcpTls(pstTls);
+    return iRet;
+}
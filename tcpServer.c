@@ -11,6 +11,17 @@
  */
 
 #include "tcpSock.h"
+#include "tcpMetrics.h"
+#include "tcpAdmin.h"
+#include "tcpProbe.h"
+#include "tcpFrame.h"
+#include "tcpRing.h"
+#include "tcpShm.h"
+#include "tcpTls.h"
+#include "tcpRate.h"
+#include "tcpBudget.h"
+#include "tcpAdmission.h"
+#include "tcpTune.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -18,108 +29,919 @@
 #include <pthread.h>
 #include <sys/types.h>
 #include <sys/select.h>
+#include <sys/socket.h>
 #include <errno.h>
 #include <stdbool.h>
 #include <sys/time.h>
+#include <getopt.h>
+#include <poll.h>
+#include <sched.h>
+#include <signal.h>
+#include <time.h>
+#include <linux/tls.h>
 
 #define PORT 8080
+#define METRICS_REPORT_INTERVAL_SEC 10 /**< 메트릭 요약 출력 주기 (초) */
+#define RECV_STREAM_SIZE (TCP_FRAME_MAX_SIZE + 16 * BUFFER_SIZE) /**< 프레임 조립용 수신 버퍼 크기 */
+#define QUEUE_RECORD_SIZE (sizeof(uint64_t) + TCP_FRAME_MAX_SIZE) /**< 큐 레코드 최대 크기 (저장 시각 + 프레임) */
+#define CONTROL_QUEUE_SIZE (TCP_RING_DEFAULT_SIZE / 2) /**< 제어 프레임 송신 큐 크기. 최대 크기 레코드가 하나 이상 들어가야 합니다. */
+#define CLIENT_THREAD_STACK_SIZE (256 * 1024) /**< 연결별 스레드 스택 크기. 버퍼는 힙에 두므로 작게 잡습니다. */
+#define RECV_LOWAT_DEFAULT_MAX TCP_FRAME_MAX_SIZE /**< 수신 대기 기준(SO_RCVLOWAT) 기본 상한 (-L 옵션) */
+#define THROTTLE_POLL_MAX_MS 1000 /**< 전송률 제한 대기 중 종료 여부를 다시 확인하는 주기 (ms) */
+#define SHM_THROTTLE_SLICE_MS 10 /**< 공유 메모리 전송의 전송률 제한 대기 중 전송 닫힘을 다시 확인하는 주기 (ms) */
+#define UPGRADE_ACK_TIMEOUT_MS 5000 /**< 대기 소켓을 넘긴 뒤 새 프로세스의 준비 응답을 기다리는 시간 (ms) */
+#define UPGRADE_READY_BYTE 'R' /**< 새 프로세스가 대기 소켓을 받아 준비를 마쳤다는 응답 */
+#define DRAIN_DEFAULT_MS 5000 /**< 종료 신호를 받은 뒤 송신 큐를 보내는 기한 기본값 (ms, -D 옵션) */
+#define DRAIN_POLL_MS 100 /**< 종료 중 남은 연결을 확인하는 주기 (ms) */
+#define DRAIN_CLOSE_WAIT_MS 1000 /**< 기한이 지나 강제로 닫은 연결의 스레드가 정리되기를 기다리는 시간 (ms) */
+#define ACCEPT_BACKOFF_MIN_MS 10 /**< accept() 실패 후 연결 받기를 멈추는 첫 시간 (ms) */
+#define ACCEPT_BACKOFF_MAX_MS 1000 /**< 실패가 이어질 때 두 배씩 늘리는 멈춤 시간의 상한 (ms) */
+#define INFO_SAMPLE_BATCH 64 /**< 메인 루프가 한 번에 TCP_INFO 표본을 뜨는 연결 수 */
+#define INFO_SLICE_GAP_MS 1 /**< 한 바퀴를 다 돌지 못했을 때 다음 묶음까지 쉬는 시간 (ms) */
+
+static bool s_bVerbose = true; /**< 수신 메시지마다 로그 출력 여부 (-q 옵션으로 끔) */
+static TCP_TLS *s_pstTls = NULL; /**< TCP 연결에 쓸 TLS 설정 (-t 옵션으로 켬, NULL이면 평문) */
+static TCP_READ_BUDGET s_stReadBudget = {TCP_READ_BUDGET_DEFAULT_BYTES, TCP_READ_BUDGET_DEFAULT_FRAMES}; /**< 연결별 차례당 read 예산 (-Q 옵션) */
+static volatile sig_atomic_t s_iStopSignal = 0; /**< 받은 종료 신호 (SIGTERM, SIGINT. 0이면 없음) */
+static int s_iReserveFd = -1; /**< fd가 모자랄 때 대기열의 연결을 받아 닫기 위한 예비 fd (메인 스레드 전용) */
+static TCP_TUNE_LIMIT s_stTuneLimit; /**< 연결별 버퍼 크기 범위 (-B 옵션, 상한이 0이면 커널 자동 조정) */
+static int s_iNotSentLowat = TCP_SOCK_DEFAULT_NOTSENT_LOWAT; /**< 커널에 남길 미전송 바이트 기준 (-N 옵션, 0이면 끔) */
+static int s_iRecvLowatMax = RECV_LOWAT_DEFAULT_MAX; /**< 수신 대기 기준(SO_RCVLOWAT) 상한 (-L 옵션, 0이면 끔) */
 
 /**
  * @brief 클라이언트와의 데이터 공유를 위한 구조체
  * 
- * @details 클라이언트로부터 수신한 데이터를 저장하고, 데이터의 사용 상태를 관리하며, 
- *          동기화를 위해 뮤텍스와 조건 변수를 포함합니다.
+ * @details 수신 스레드가 파싱한 프레임을 송신 스레드로 넘기는 큐와, 큐 상태 변화를 알리기 위한
+ *          뮤텍스와 조건 변수를 포함합니다. 큐 레코드는 [저장 시각(ns, 8바이트) | 프레임] 입니다.
+ *          큐는 우선순위 등급(TCP_FRAME_PRIO)마다 따로 있어, 제어 프레임이 대량 DATA 뒤에서 기다리지 않습니다.
  */
 typedef struct {
-    char chData[BUFFER_SIZE];       /**< 클라이언트로부터 수신한 데이터 */
-    bool hasData;                   /**< 데이터 존재 여부 플래그 */
-    pthread_mutex_t mutex;          /**< 데이터 접근 동기화를 위한 뮤텍스 */
+    TCP_RING *apstQueue[TCP_FRAME_PRIO_COUNT]; /**< 등급별 송신 대기 프레임 큐 (수신 스레드 → 송신 스레드) */
+    pthread_mutex_t mutex;          /**< 조건 변수 대기를 위한 뮤텍스 */
     pthread_cond_t cond;            /**< 데이터 준비 상태를 알리는 조건 변수 */
+    pthread_cond_t spaceCond;       /**< 큐 공간 확보를 알리는 조건 변수 */
+    uint64_t u64QueuedBytes;        /**< 큐에 남은 프레임 바이트 (연결 정리 시 전체 게이지에서 뺌) */
 } SHARED_DATA;
 
 /**
  * @brief 클라이언트 정보를 저장하는 구조체
  * 
  * @details 클라이언트 소켓과 관련된 상태 정보를 저장하고, 클라이언트별 스레드와 데이터 공유 구조체를 포함합니다.
+ *          iClientSock 이 0이면 빈 슬롯이며, 수신 스레드가 연결 정리를 마친 뒤 0으로 되돌립니다.
  */
 typedef struct {
     int iClientSock;                /**< 클라이언트 소켓 파일 디스크립터 */
     bool bExitFlag;                 /**< 연결 종료 플래그 */
+    bool bFlushFlag;                /**< 서버 종료 중 송신 큐를 비운 뒤 SHUTDOWN 프레임을 보내라는 요청 (exitFlagMutex로 보호) */
     SHARED_DATA stSharedData;       /**< 클라이언트와 공유되는 데이터 구조체 */
     pthread_t recvThreadId;         /**< 수신 스레드 ID */
     pthread_t sendThreadId;         /**< 송신 스레드 ID */
     pthread_mutex_t exitFlagMutex;  /**< 연결 종료 플래그 동기화를 위한 뮤텍스 */
+    TCP_CONN_METRICS stMetrics;     /**< 연결별 카운터 */
+    int iShmFd;                     /**< Unix 도메인 연결로 넘어온 공유 메모리 fd (-1이면 없음) */
+    TCP_SHM *pstShm;                /**< 수락한 공유 메모리 전송 (NULL이면 없음) */
+    pthread_t shmThreadId;          /**< 공유 메모리 처리 스레드 ID */
+    TCP_TLS *pstTls;                /**< 수신 스레드가 먼저 핸드셰이크할 TLS 설정 (NULL이면 평문) */
+    uint8_t u8Caps;                 /**< 협상된 연결 기능 비트 (TCP_FRAME_CAP_*, 수신 스레드만 사용) */
+    TCP_CONN_RATE stRate;           /**< 연결별 수신 전송률 제한 (rateMutex로 보호, 수신 스레드와 공유 메모리 스레드가 함께 사용) */
+    pthread_mutex_t rateMutex;      /**< 소켓과 공유 메모리 경로가 연결별 제한 하나를 함께 쓰기 위한 뮤텍스 */
+    TCP_READ_CREDIT stBudget;       /**< 차례당 read 예산 크레딧 (수신 스레드만 사용) */
+    int iRecvLowat;                 /**< 소켓에 설정한 SO_RCVLOWAT (수신 스레드만 사용) */
 } CLIENT_INFO;
 
 /**
- * @brief 클라이언트로부터 데이터를 수신하는 스레드 함수
+ * @brief 연결 종료 플래그를 확인합니다.
+ * @param pstClientInfo CLIENT_INFO 구조체 포인터
+ * @return 종료 중이면 true
+ */
+static bool isClientExiting(CLIENT_INFO *pstClientInfo) {
+    bool bExitFlag;
+
+    pthread_mutex_lock(&pstClientInfo->exitFlagMutex);
+    bExitFlag = pstClientInfo->bExitFlag;
+    pthread_mutex_unlock(&pstClientInfo->exitFlagMutex);
+    return bExitFlag;
+}
+
+/**
+ * @brief 연결 종료 플래그를 설정하고 대기 중인 스레드를 깨웁니다.
+ * @param pstClientInfo CLIENT_INFO 구조체 포인터
+ */
+static void setClientExiting(CLIENT_INFO *pstClientInfo) {
+    pthread_mutex_lock(&pstClientInfo->exitFlagMutex);
+    pstClientInfo->bExitFlag = true;
+    pthread_mutex_unlock(&pstClientInfo->exitFlagMutex);
+
+    pthread_mutex_lock(&pstClientInfo->stSharedData.mutex);
+    pthread_cond_broadcast(&pstClientInfo->stSharedData.cond);
+    pthread_cond_broadcast(&pstClientInfo->stSharedData.spaceCond);
+    pthread_mutex_unlock(&pstClientInfo->stSharedData.mutex);
+}
+
+/**
+ * @brief 송신 큐를 비운 뒤 SHUTDOWN 프레임을 보내야 하는지 확인합니다.
+ * @param pstClientInfo CLIENT_INFO 구조체 포인터
+ * @return 요청되었으면 true
+ */
+static bool isClientFlushing(CLIENT_INFO *pstClientInfo) {
+    bool bFlushFlag;
+
+    pthread_mutex_lock(&pstClientInfo->exitFlagMutex);
+    bFlushFlag = pstClientInfo->bFlushFlag;
+    pthread_mutex_unlock(&pstClientInfo->exitFlagMutex);
+    return bFlushFlag;
+}
+
+/**
+ * @brief 송신 스레드에 남은 큐를 보내고 SHUTDOWN 프레임으로 끝내도록 요청합니다.
+ * @param pstClientInfo CLIENT_INFO 구조체 포인터
+ *
+ * @details 수신 스레드가 더는 큐에 넣지 않을 때 호출하므로, 송신 스레드가 큐를 비었다고 본 뒤에는 새 프레임이 들어오지 않습니다.
+ */
+static void requestClientFlush(CLIENT_INFO *pstClientInfo) {
+    pthread_mutex_lock(&pstClientInfo->exitFlagMutex);
+    pstClientInfo->bFlushFlag = true;
+    pthread_mutex_unlock(&pstClientInfo->exitFlagMutex);
+
+    pthread_mutex_lock(&pstClientInfo->stSharedData.mutex);
+    pthread_cond_broadcast(&pstClientInfo->stSharedData.cond);
+    pthread_mutex_unlock(&pstClientInfo->stSharedData.mutex);
+}
+
+/**
+ * @brief 등급별 송신 큐를 해제합니다.
+ * @param pstShared SHARED_DATA 구조체 포인터
+ */
+static void destroySharedQueues(SHARED_DATA *pstShared) {
+    for (int i = 0; i < TCP_FRAME_PRIO_COUNT; i++) {
+        destroyTcpRing(pstShared->apstQueue[i]);
+        pstShared->apstQueue[i] = NULL;
+    }
+}
+
+/**
+ * @brief 등급별 송신 큐에 남은 레코드를 모두 버립니다.
+ * @param pstShared SHARED_DATA 구조체 포인터
+ * @return 버린 레코드 수
+ *
+ * @details 송신 스레드가 끝난 뒤 연결을 정리할 때 호출합니다. 버린 수는 drops로 집계해야 큐 깊이(ENQUEUED - DEQUEUED - DROPS)가 맞습니다.
+ */
+static uint64_t dropSharedQueues(SHARED_DATA *pstShared) {
+    uint64_t u64Dropped = 0;
+
+    for (int i = 0; i < TCP_FRAME_PRIO_COUNT; i++) {
+        while (skipTcpRing(pstShared->apstQueue[i]) > 0) {
+            u64Dropped++;
+        }
+    }
+    return u64Dropped;
+}
+
+/**
+ * @brief 등급별 송신 큐를 만듭니다.
+ * @param pstShared SHARED_DATA 구조체 포인터
+ * @return 성공 시 true, 메모리가 부족하면 false (만든 큐는 모두 해제)
+ */
+static bool createSharedQueues(SHARED_DATA *pstShared) {
+    pstShared->apstQueue[TCP_FRAME_PRIO_CONTROL] = createTcpRing(CONTROL_QUEUE_SIZE);
+    pstShared->apstQueue[TCP_FRAME_PRIO_BULK] = createTcpRing(TCP_RING_DEFAULT_SIZE);
+    for (int i = 0; i < TCP_FRAME_PRIO_COUNT; i++) {
+        if (pstShared->apstQueue[i] == NULL) {
+            destroySharedQueues(pstShared);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 파싱된 프레임을 송신 큐에 넣습니다.
+ * @param pstClientInfo CLIENT_INFO 구조체 포인터
+ * @param kpu8Frame 프레임
+ * @param uiFrameLen 프레임 길이
+ * @return 성공 시 true, 큐를 기다리는 중 연결이 종료되면 false
+ *
+ * @details 프레임은 Instruction의 우선순위 등급 큐에 넣습니다.
+ *          큐가 가득 차면 버리지 않고 공간이 생길 때까지 기다립니다. 그동안 소켓을 읽지 않으므로
+ *          TCP 흐름 제어로 클라이언트 송신이 느려집니다. 종료 플래그는 같은 뮤텍스 안에서 확인하므로
+ *          setClientExiting()의 깨우기를 놓치지 않습니다.
+ */
+static bool enqueueClientFrame(CLIENT_INFO *pstClientInfo, const uint8_t *kpu8Frame, size_t uiFrameLen) {
+    SHARED_DATA *pstShared = &pstClientInfo->stSharedData;
+    TCP_RING *pstQueue = pstShared->apstQueue[getTcpFramePriority(kpu8Frame[5])];
+    uint64_t u64StoredNs = getTcpMonotonicNs();
+    struct iovec astIov[2];
+    bool bQueued = true;
+
+    astIov[0].iov_base = &u64StoredNs;
+    astIov[0].iov_len = sizeof(u64StoredNs);
+    astIov[1].iov_base = (void *)kpu8Frame;
+    astIov[1].iov_len = uiFrameLen;
+
+    pthread_mutex_lock(&pstShared->mutex);
+    while (!pushTcpRingParts(pstQueue, astIov, 2)) {
+        if (isClientExiting(pstClientInfo)) {
+            bQueued = false;
+            break;
+        }
+        pthread_cond_wait(&pstShared->spaceCond, &pstShared->mutex);
+    }
+    if (bQueued) {
+        __atomic_add_fetch(&pstShared->u64QueuedBytes, uiFrameLen, __ATOMIC_RELAXED);
+        addTcpQueuedBytes((int64_t)uiFrameLen);
+        pthread_cond_signal(&pstShared->cond); /**< 조건 변수 신호 전송 */
+    }
+    pthread_mutex_unlock(&pstShared->mutex);
+    if (!bQueued) {
+        return false;
+    }
+
+    addTcpConnMetric(&pstClientInfo->stMetrics, TCP_METRIC_ENQUEUED, 1);
+    TCP_PROBE2(tcpServer, enqueue, pstClientInfo->stMetrics.u64ConnId, uiFrameLen);
+    return true;
+}
+
+/**
+ * @brief 과부하로 처리하지 않은 요청에 보낼 BUSY 프레임을 만듭니다.
+ * @param pu8Reply 프레임을 저장할 버퍼
+ * @param uiReplySize 버퍼 크기 (TCP_FRAME_HEADER_SIZE + TCP_FRAME_CORR_ID_SIZE + 1 + TCP_FRAME_CRC_SIZE 이상)
+ * @param kpstHeader 요청 프레임 헤더
+ * @param kpu8Data 요청 DATA
+ * @param eReason 거절 이유
+ * @return 프레임 길이
+ *
+ * @details 요청에 Correlation ID가 있으면 응답에도 붙여 클라이언트가 어떤 요청이 거절되었는지 알 수 있게 합니다.
+ */
+static int encodeClientBusy(uint8_t *pu8Reply, size_t uiReplySize, const TCP_FRAME_HEADER *kpstHeader, const uint8_t *kpu8Data,
+                            TCP_BUSY_REASON eReason) {
+    uint8_t u8Reason = (uint8_t)eReason;
+    uint32_t u32CorrId;
+
+    if (getTcpFrameCorrId(kpstHeader, kpu8Data, &u32CorrId)) {
+        return encodeTcpCorrFrame(pu8Reply, uiReplySize, kpstHeader->u8ClientId, TCP_INST_BUSY, u32CorrId, &u8Reason, 1);
+    }
+    return encodeTcpFrame(pu8Reply, uiReplySize, kpstHeader->u8ClientId, TCP_INST_BUSY, &u8Reason, 1);
+}
+
+/**
+ * @brief 전송률 제한을 넘은 공유 메모리 전송을 지정한 시간 동안 읽지 않습니다.
+ * @param pstClientInfo CLIENT_INFO 구조체 포인터
+ * @param u64ThrottleNs 기다릴 시간 (ns)
+ *
+ * @details 읽지 않는 동안 링이 차면 클라이언트의 sendTcpShm()이 기다리므로, 소켓 경로의 TCP 흐름 제어와 같이 상대가 느려집니다.
+ *          SHM_THROTTLE_SLICE_MS마다 깨어 전송이 닫혔거나 연결/서버가 종료 중이면 바로 돌아갑니다.
+ */
+static void throttleClientShm(CLIENT_INFO *pstClientInfo, uint64_t u64ThrottleNs) {
+    uint64_t u64EndNs = getTcpMonotonicNs() + u64ThrottleNs;
+    uint64_t u64NowNs;
+
+    addTcpMetric(TCP_METRIC_THROTTLES, 1);
+    while (!isTcpShmClosed(pstClientInfo->pstShm) && !isClientExiting(pstClientInfo) && !isTcpDraining()
+           && (u64NowNs = getTcpMonotonicNs()) < u64EndNs) {
+        uint64_t u64SliceNs = u64EndNs - u64NowNs;
+        if (u64SliceNs > SHM_THROTTLE_SLICE_MS * 1000000ULL) {
+            u64SliceNs = SHM_THROTTLE_SLICE_MS * 1000000ULL;
+        }
+        struct timespec stSleep = {(time_t)(u64SliceNs / 1000000000ULL), (long)(u64SliceNs % 1000000000ULL)};
+        nanosleep(&stSleep, NULL);
+    }
+}
+
+/**
+ * @brief 공유 메모리 링으로 들어온 프레임을 처리하는 스레드 함수
  * @param arg CLIENT_INFO 구조체 포인터
  * @return NULL
- * 
- * @details 클라이언트 소켓으로부터 데이터를 읽어 SHARED_DATA 구조체에 저장합니다. 
- *          데이터를 수신하면 조건 변수를 통해 송신 스레드에 알립니다.
+ *
+ * @details 소켓 경로와 같이 프레임을 검사한 뒤 같은 전송으로 그대로 돌려보냅니다.
+ *          송신 큐와 송신 스레드를 거치지 않으므로 메시지마다 잠금이나 시스템 호출이 없습니다.
+ *          연결별 카운터는 소켓 수신/송신 스레드가 소유하므로 이 경로는 전체 카운터에만 집계하고, 메시지별 로그도 남기지 않습니다.
+ *          소켓 경로와 같은 제한을 받습니다. 레코드마다 연결별 제한(소켓 경로와 같은 버킷)과 Client ID별 제한에 먼저 사용량을 세고,
+ *          제한을 넘으면 그만큼 링을 읽지 않습니다. 서버가 과부하이거나 종료 중이면(admitTcpRequest()) 대량 등급 요청은 BUSY로 응답합니다.
+ *          전송이 닫히면(클라이언트가 닫거나 수신 스레드가 연결을 정리하면) 끝납니다.
  */
-void *receiveThread(void *arg) {
+static void *shmThread(void *arg) {
     CLIENT_INFO *pstClientInfo = (CLIENT_INFO *)arg;
-    struct sockaddr_in stSockClientAddr;
-    socklen_t uiClientAddrLen = sizeof(stSockClientAddr);
-    char achBuffer[BUFFER_SIZE];
-    fd_set stReadFds;
-    struct timeval stTimeout;
-    sleep(1); /**< 초기화 지연 */
+    TCP_SHM *pstShm = pstClientInfo->pstShm;
+    uint64_t u64ConnId = pstClientInfo->stMetrics.u64ConnId;
+    uint8_t *pu8Frame = (uint8_t *)malloc(TCP_FRAME_MAX_SIZE);
+    uint8_t au8Busy[TCP_FRAME_HEADER_SIZE + TCP_FRAME_CORR_ID_SIZE + 1 + TCP_FRAME_CRC_SIZE];
+    int iFrameLen;
 
-    if (getpeername(pstClientInfo->iClientSock, (struct sockaddr *)&stSockClientAddr, &uiClientAddrLen) == -1) {
-        perror("getpeername 실패");
-        pthread_exit(NULL);
+    if (pu8Frame == NULL) {
+        perror("공유 메모리 버퍼 할당 실패");
+        closeTcpShm(pstShm);
+        return NULL;
     }
 
-    while (1) {
-        FD_ZERO(&stReadFds);
-        FD_SET(pstClientInfo->iClientSock, &stReadFds);
+    while ((iFrameLen = recvTcpShm(pstShm, pu8Frame, TCP_FRAME_MAX_SIZE, -1)) > 0) {
+        TCP_FRAME_HEADER stHeader;
+        const uint8_t *kpu8Data;
+        const uint8_t *kpu8Reply = pu8Frame;
+        int iReplyLen = iFrameLen;
+        uint64_t u64NowNs = getTcpMonotonicNs();
+        uint64_t u64ThrottleNs;
+
+        addTcpMetric(TCP_METRIC_BYTES_IN, (uint64_t)iFrameLen);
+        /**< 잘못된 레코드도 대역폭을 쓰므로 검사 전에 셉니다. */
+        pthread_mutex_lock(&pstClientInfo->rateMutex);
+        u64ThrottleNs = takeTcpConnRate(&pstClientInfo->stRate, (uint64_t)iFrameLen, 1, u64NowNs);
+        pthread_mutex_unlock(&pstClientInfo->rateMutex);
+        if (decodeTcpFrame(pu8Frame, (size_t)iFrameLen, &stHeader, &kpu8Data) != iFrameLen) {
+            addTcpMetric(TCP_METRIC_FRAME_ERRORS, 1);
+        } else {
+            uint64_t u64IdWaitNs = takeTcpClientIdRate(stHeader.u8ClientId, (uint64_t)iFrameLen, 1, u64NowNs);
+            if (u64IdWaitNs > u64ThrottleNs) {
+                u64ThrottleNs = u64IdWaitNs;
+            }
+            addTcpMetric(TCP_METRIC_MSGS_IN, 1);
+            TCP_PROBE2(tcpServer, frame_parsed, u64ConnId, iFrameLen);
 
-        stTimeout.tv_sec = 0;
-        stTimeout.tv_usec = 500 * 1000; /**< 500ms 타임아웃 설정 */
+            if (getTcpFramePriority(stHeader.u8Instruction) == TCP_FRAME_PRIO_BULK) {
+                TCP_BUSY_REASON eBusy = admitTcpRequest();
+                if (eBusy != TCP_BUSY_NONE) {
+                    addTcpMetric(TCP_METRIC_SHED, 1);
+                    iReplyLen = encodeClientBusy(au8Busy, sizeof(au8Busy), &stHeader, kpu8Data, eBusy);
+                    kpu8Reply = au8Busy;
+                }
+            }
 
-        int activity = select(pstClientInfo->iClientSock + 1, &stReadFds, NULL, NULL, &stTimeout);
-        if (activity < 0) {
-            perror("select 실패");
+            if (sendTcpShm(pstShm, kpu8Reply, (uint32_t)iReplyLen, -1) < 0) {
+                break;
+            }
+            addTcpMetric(TCP_METRIC_MSGS_OUT, 1);
+            addTcpMetric(TCP_METRIC_BYTES_OUT, (uint64_t)iReplyLen);
+        }
+        if (u64ThrottleNs > 0) {
+            throttleClientShm(pstClientInfo, u64ThrottleNs);
+        }
+    }
+    if (errno == EPROTO) {
+        fprintf(stderr, "공유 메모리 링이 손상되어 전송을 닫습니다: 소켓 FD %d\n", pstClientInfo->iClientSock);
+    }
+
+    free(pu8Frame);
+    return NULL;
+}
+
+/**
+ * @brief 공유 메모리 전송 제안을 처리하고 결과를 응답 프레임으로 보냅니다.
+ * @param pstClientInfo CLIENT_INFO 구조체 포인터
+ * @param u8ClientId 응답 프레임 Client ID
+ * @return 응답을 큐에 넣었으면 true, 연결이 종료 중이면 false
+ *
+ * @details 제안 프레임과 함께 SCM_RIGHTS로 넘어온 memfd에 붙고 처리 스레드를 시작합니다.
+ *          fd가 없으면(TCP 연결 등) EOPNOTSUPP, 이미 수락했으면 EALREADY로 거절합니다.
+ */
+static bool startClientShm(CLIENT_INFO *pstClientInfo, uint8_t u8ClientId) {
+    uint8_t au8Reply[TCP_FRAME_HEADER_SIZE + 1 + TCP_FRAME_CRC_SIZE];
+    uint8_t u8Status = 0;
+    int iReplyLen;
+
+    if (pstClientInfo->pstShm != NULL) {
+        u8Status = EALREADY;
+        if (pstClientInfo->iShmFd >= 0) {
+            close(pstClientInfo->iShmFd);
+        }
+    } else if (pstClientInfo->iShmFd < 0) {
+        u8Status = EOPNOTSUPP;
+    } else if ((pstClientInfo->pstShm = attachTcpShm(pstClientInfo->iShmFd)) == NULL) {
+        u8Status = (uint8_t)errno;
+        close(pstClientInfo->iShmFd);
+    } else if (pthread_create(&pstClientInfo->shmThreadId, NULL, shmThread, pstClientInfo) != 0) {
+        perror("공유 메모리 스레드 생성 실패");
+        u8Status = EAGAIN;
+        destroyTcpShm(pstClientInfo->pstShm);
+        pstClientInfo->pstShm = NULL;
+    }
+    pstClientInfo->iShmFd = -1; /**< 전송이 소유했거나 닫았습니다. */
+    fprintf(stdout, "공유 메모리 전송 %s: 소켓 FD %d\n", u8Status == 0 ? "수락" : strerror(u8Status), pstClientInfo->iClientSock);
+
+    iReplyLen = encodeTcpFrame(au8Reply, sizeof(au8Reply), u8ClientId, TCP_INST_SHM_OFFER, &u8Status, 1);
+    return enqueueClientFrame(pstClientInfo, au8Reply, (size_t)iReplyLen);
+}
+
+/**
+ * @brief 연결 기능 협상 요청에 이 서버가 지원하는 기능만 남겨 응답합니다.
+ * @param pstClientInfo CLIENT_INFO 구조체 포인터
+ * @param kpstHeader 요청 프레임 헤더
+ * @param kpu8Data 요청 DATA (기능 비트 1바이트)
+ * @return 응답을 큐에 넣었으면 true, 연결이 종료 중이면 false
+ *
+ * @details 서버는 압축 프레임을 풀지 않고 그대로 되돌려 보내므로, 보낸 쪽과 받는 쪽(같은 연결)이
+ *          LZ4에 합의하면 압축을 푸는 비용 없이 중계합니다.
+ */
+static bool negotiateClientCaps(CLIENT_INFO *pstClientInfo, const TCP_FRAME_HEADER *kpstHeader, const uint8_t *kpu8Data) {
+    uint8_t au8Reply[TCP_FRAME_HEADER_SIZE + 1 + TCP_FRAME_CRC_SIZE];
+    int iReplyLen;
+
+    pstClientInfo->u8Caps = kpstHeader->u16DataLen >= 1 ? (uint8_t)(kpu8Data[0] & TCP_FRAME_CAP_LZ4) : 0;
+    fprintf(stdout, "연결 기능 협상: 소켓 FD %d, LZ4 압축 %s\n", pstClientInfo->iClientSock,
+            (pstClientInfo->u8Caps & TCP_FRAME_CAP_LZ4) ? "사용" : "사용 안 함");
+
+    iReplyLen = encodeTcpFrame(au8Reply, sizeof(au8Reply), kpstHeader->u8ClientId, TCP_INST_CAPS, &pstClientInfo->u8Caps, 1);
+    return enqueueClientFrame(pstClientInfo, au8Reply, (size_t)iReplyLen);
+}
+
+/**
+ * @brief 과부하로 처리하지 않은 요청에 BUSY 프레임으로 응답합니다.
+ * @param pstClientInfo CLIENT_INFO 구조체 포인터
+ * @param kpstHeader 요청 프레임 헤더
+ * @param kpu8Data 요청 DATA
+ * @param eReason 거절 이유
+ * @return 응답을 큐에 넣었으면 true, 연결이 종료 중이면 false
+ *
+ * @details BUSY는 제어 등급이므로 밀려 있는 대량 응답보다 먼저 나갑니다.
+ */
+static bool replyClientBusy(CLIENT_INFO *pstClientInfo, const TCP_FRAME_HEADER *kpstHeader, const uint8_t *kpu8Data,
+                            TCP_BUSY_REASON eReason) {
+    uint8_t au8Reply[TCP_FRAME_HEADER_SIZE + TCP_FRAME_CORR_ID_SIZE + 1 + TCP_FRAME_CRC_SIZE];
+    int iReplyLen = encodeClientBusy(au8Reply, sizeof(au8Reply), kpstHeader, kpu8Data, eReason);
+
+    addTcpConnMetric(&pstClientInfo->stMetrics, TCP_METRIC_SHED, 1);
+    return enqueueClientFrame(pstClientInfo, au8Reply, (size_t)iReplyLen);
+}
+
+/**
+ * @brief 클라이언트 소켓에서 읽고, 함께 넘어온 fd가 있으면 보관합니다.
+ * @return read()와 같음
+ *
+ * @details Unix 도메인 연결은 공유 메모리 제안과 함께 memfd를 SCM_RIGHTS로 보냅니다.
+ *          read()는 이런 제어 메시지를 버리므로 recvmsg()로 읽습니다. 이전에 받은 fd는 닫고 마지막 것만 남깁니다.
+ *          커널 TLS 연결은 제어 버퍼가 있으면 레코드 형식을 알려 주며, 데이터가 아닌 레코드는
+ *          경고(close_notify 등)면 연결 종료(0)로, 그 밖의 레코드는 EPROTO로 처리합니다.
+ */
+static ssize_t readClientSocket(CLIENT_INFO *pstClientInfo, uint8_t *pu8Buf, size_t uiLen) {
+    union {
+        struct cmsghdr stAlign;
+        char achBuf[CMSG_SPACE(sizeof(int))];
+    } uCtrl;
+    struct iovec stIov;
+    struct msghdr stMsg;
+    ssize_t iReadSize;
+
+    memset(&stMsg, 0x0, sizeof(stMsg));
+    stIov.iov_base = pu8Buf;
+    stIov.iov_len = uiLen;
+    stMsg.msg_iov = &stIov;
+    stMsg.msg_iovlen = 1;
+    stMsg.msg_control = uCtrl.achBuf;
+    stMsg.msg_controllen = sizeof(uCtrl.achBuf);
+
+    iReadSize = recvmsg(pstClientInfo->iClientSock, &stMsg, MSG_CMSG_CLOEXEC);
+    if (iReadSize >= 0 && stMsg.msg_controllen > 0) {
+        for (struct cmsghdr *pstCmsg = CMSG_FIRSTHDR(&stMsg); pstCmsg != NULL; pstCmsg = CMSG_NXTHDR(&stMsg, pstCmsg)) {
+            if (pstCmsg->cmsg_level == SOL_SOCKET && pstCmsg->cmsg_type == SCM_RIGHTS
+                && pstCmsg->cmsg_len >= CMSG_LEN(sizeof(int))) {
+                if (pstClientInfo->iShmFd >= 0) {
+                    close(pstClientInfo->iShmFd);
+                }
+                memcpy(&pstClientInfo->iShmFd, CMSG_DATA(pstCmsg), sizeof(int));
+            } else if (pstCmsg->cmsg_level == SOL_TLS && pstCmsg->cmsg_type == TLS_GET_RECORD_TYPE) {
+                uint8_t u8RecordType = *CMSG_DATA(pstCmsg);
+
+                if (u8RecordType == TCP_TLS_RECORD_ALERT) {
+                    return 0;
+                } else if (u8RecordType != TCP_TLS_RECORD_APP_DATA) {
+                    errno = EPROTO;
+                    return -1;
+                }
+            }
+        }
+    }
+    return iReadSize;
+}
+
+/**
+ * @brief 한 번의 수신 처리에서 모은 전송률 집계
+ */
+typedef struct {
+    uint64_t u64NowNs;              /**< 처리 시작 시각 */
+    uint64_t u64ThrottleNs;         /**< Client ID별 전송률 제한으로 기다려야 할 시간 (ns) */
+    uint64_t u64Frames;             /**< 처리한 프레임 수 */
+    size_t uiBytes;                 /**< 처리한 바이트 수 (건너뛴 잘못된 데이터 포함) */
+} FRAME_BATCH;
+
+/**
+ * @brief 검증된 프레임 하나를 처리합니다.
+ * @param pstClientInfo CLIENT_INFO 구조체 포인터
+ * @param kpu8Frame 프레임
+ * @param iFrameLen 프레임 길이
+ * @param kpstHeader 디코딩된 헤더
+ * @param kpu8Data DATA 시작 위치
+ * @param pstBatch 전송률 집계
+ * @return 계속 수신할 수 있으면 true, 연결이 종료 중이면 false
+ *
+ * @details DATA와 HEARTBEAT 프레임은 보낸 클라이언트에게 그대로 돌려보냅니다.
+ *          LZ4 압축 프레임은 풀지 않고 그대로 돌려보내며, LZ4를 협상하지 않은 연결이 보낸 것은 frame_errors로 버립니다.
+ *          SHM_OFFER 프레임은 공유 메모리 전송을 수락하거나 거절하고 결과를 응답합니다.
+ *          CAPS 프레임은 연결 기능을 협상합니다.
+ *          서버가 과부하(tcpAdmission.h)이면 대량 등급 요청은 처리하지 않고 BUSY로 응답하며, 제어 프레임은 계속 처리합니다.
+ */
+static bool handleClientFrame(CLIENT_INFO *pstClientInfo, const uint8_t *kpu8Frame, int iFrameLen,
+                              const TCP_FRAME_HEADER *kpstHeader, const uint8_t *kpu8Data, FRAME_BATCH *pstBatch) {
+    uint64_t u64ConnId = pstClientInfo->stMetrics.u64ConnId;
+
+    if (kpstHeader->u8Flags & TCP_FRAME_FLAG_LZ4) {
+        if (!(pstClientInfo->u8Caps & TCP_FRAME_CAP_LZ4)) {
+            addTcpConnMetric(&pstClientInfo->stMetrics, TCP_METRIC_FRAME_ERRORS, 1);
+            return true;
+        }
+        addTcpConnMetric(&pstClientInfo->stMetrics, TCP_METRIC_COMPRESSED_IN, 1);
+    }
+
+    uint64_t u64IdWaitNs = takeTcpClientIdRate(kpstHeader->u8ClientId, (uint64_t)iFrameLen, 1, pstBatch->u64NowNs);
+    if (u64IdWaitNs > pstBatch->u64ThrottleNs) {
+        pstBatch->u64ThrottleNs = u64IdWaitNs;
+    }
+    pstBatch->u64Frames++;
+
+    addTcpConnMetric(&pstClientInfo->stMetrics, TCP_METRIC_MSGS_IN, 1);
+    TCP_PROBE2(tcpServer, frame_parsed, u64ConnId, iFrameLen);
+    if (s_bVerbose) {
+        if (kpstHeader->u8Flags & TCP_FRAME_FLAG_LZ4) {
+            fprintf(stdout, "클라이언트 %d로부터 수신: (LZ4 압축 %u바이트)\n", pstClientInfo->iClientSock,
+                    (unsigned)kpstHeader->u16DataLen);
+        } else {
+            fprintf(stdout, "클라이언트 %d로부터 수신: %.*s\n", pstClientInfo->iClientSock,
+                    (int)kpstHeader->u16DataLen, (const char *)kpu8Data);
+        }
+    }
+
+    if (getTcpFramePriority(kpstHeader->u8Instruction) == TCP_FRAME_PRIO_BULK) {
+        TCP_BUSY_REASON eBusy = admitTcpRequest();
+        if (eBusy != TCP_BUSY_NONE) {
+            return replyClientBusy(pstClientInfo, kpstHeader, kpu8Data, eBusy);
+        }
+    }
+
+    switch (kpstHeader->u8Instruction) {
+    case TCP_INST_SHM_OFFER:
+        return startClientShm(pstClientInfo, kpstHeader->u8ClientId);
+    case TCP_INST_CAPS:
+        return negotiateClientCaps(pstClientInfo, kpstHeader, kpu8Data);
+    case TCP_INST_DATA:
+    case TCP_INST_HEARTBEAT:
+    default:
+        /**< 수신 프레임은 같은 클라이언트로 되돌려 보냅니다. */
+        TCP_PROBE2(tcpServer, dispatch, u64ConnId, iFrameLen);
+        return enqueueClientFrame(pstClientInfo, kpu8Frame, (size_t)iFrameLen);
+    }
+}
+
+/**
+ * @brief 수신 버퍼에서 제어 등급 프레임을 먼저 꺼내 처리합니다.
+ * @param pstClientInfo CLIENT_INFO 구조체 포인터
+ * @param pu8Stream 수신 버퍼
+ * @param puiStreamLen 수신 버퍼의 데이터 길이. 처리한 제어 프레임을 뺀 길이로 갱신됩니다.
+ * @param pstBatch 전송률 집계
+ * @return 계속 수신할 수 있으면 true, 연결이 종료 중이면 false
+ *
+ * @details 완성된 프레임들을 헤더만 보고 건너뛰며, 제어 등급(HEARTBEAT 등) 프레임은 검증 후 바로 처리하고
+ *          나머지는 앞으로 당겨 받은 순서대로 남깁니다. 잘못된 데이터나 미완성 프레임을 만나면 멈추고
+ *          그 뒤는 processClientFrames()가 처리합니다. 제어 프레임은 read 예산 크레딧(stBudget)을 쓰지 않으므로,
+ *          같은 연결의 대량 DATA가 이전 차례부터 밀려 있어도 기다리지 않습니다.
+ */
+static bool takeClientControlFrames(CLIENT_INFO *pstClientInfo, uint8_t *pu8Stream, size_t *puiStreamLen,
+                                    FRAME_BATCH *pstBatch) {
+    size_t uiRead = 0;
+    size_t uiWrite = 0;
+    bool bRunning = true;
+
+    while (bRunning && uiRead < *puiStreamLen) {
+        TCP_FRAME_HEADER stHeader;
+        const uint8_t *kpu8Data;
+        int iFrameLen = peekTcpFrame(pu8Stream + uiRead, *puiStreamLen - uiRead, &stHeader);
+
+        if (iFrameLen <= 0) {
+            break;
+        }
+        if (getTcpFramePriority(stHeader.u8Instruction) == TCP_FRAME_PRIO_CONTROL
+            && decodeTcpFrame(pu8Stream + uiRead, (size_t)iFrameLen, &stHeader, &kpu8Data) == iFrameLen) {
+            bRunning = handleClientFrame(pstClientInfo, pu8Stream + uiRead, iFrameLen, &stHeader, kpu8Data, pstBatch);
+            pstBatch->uiBytes += (size_t)iFrameLen;
+        } else {
+            if (uiWrite != uiRead) {
+                memmove(pu8Stream + uiWrite, pu8Stream + uiRead, (size_t)iFrameLen);
+            }
+            uiWrite += (size_t)iFrameLen;
+        }
+        uiRead += (size_t)iFrameLen;
+    }
+
+    if (uiWrite != uiRead) {
+        memmove(pu8Stream + uiWrite, pu8Stream + uiRead, *puiStreamLen - uiRead);
+        *puiStreamLen -= uiRead - uiWrite;
+    }
+    return bRunning;
+}
+
+/**
+ * @brief 수신 버퍼에서 완성된 프레임을 모두 꺼내 처리합니다.
+ * @param pstClientInfo CLIENT_INFO 구조체 포인터
+ * @param pu8Stream 수신 버퍼
+ * @param puiStreamLen 수신 버퍼의 데이터 길이. 처리 후 남은 (미완성 프레임) 길이로 갱신됩니다.
+ * @param pu64ThrottleNs 연결별/Client ID별 전송률 제한을 넘어 다음 읽기까지 기다려야 할 시간 (ns, 0이면 바로 읽음)
+ * @param pbBacklog 이번 차례의 크레딧을 다 써서 완성된 프레임이 남았으면 true
+ * @return 계속 수신할 수 있으면 true, 연결이 종료 중이면 false
+ *
+ * @details 제어 등급 프레임을 먼저 처리한 뒤(takeClientControlFrames()) 나머지를 받은 순서대로 처리합니다.
+ *          매직/CRC가 맞지 않는 데이터는 다음 매직 값까지 건너뛰고 frame_errors로 집계합니다.
+ *          read 예산 크레딧(stBudget)보다 큰 프레임을 만나면 멈추고, 남은 프레임은 다음 차례에 처리합니다.
+ */
+static bool processClientFrames(CLIENT_INFO *pstClientInfo, uint8_t *pu8Stream, size_t *puiStreamLen,
+                                uint64_t *pu64ThrottleNs, bool *pbBacklog) {
+    FRAME_BATCH stBatch = {getTcpMonotonicNs(), 0, 0, 0};
+    size_t uiOffset = 0;
+    bool bRunning = takeClientControlFrames(pstClientInfo, pu8Stream, puiStreamLen, &stBatch);
+
+    *pbBacklog = false;
+    while (bRunning && uiOffset < *puiStreamLen) {
+        TCP_FRAME_HEADER stHeader;
+        const uint8_t *kpu8Data;
+        int iFrameLen = decodeTcpFrame(pu8Stream + uiOffset, *puiStreamLen - uiOffset, &stHeader, &kpu8Data);
+
+        if (iFrameLen == 0) {
+            break;
+        }
+        if (iFrameLen < 0) {
+            addTcpConnMetric(&pstClientInfo->stMetrics, TCP_METRIC_FRAME_ERRORS, 1);
+            uiOffset += findTcpFrameStart(pu8Stream + uiOffset, *puiStreamLen - uiOffset);
+            continue;
+        }
+        if (!takeTcpReadCredit(&pstClientInfo->stBudget, (uint32_t)iFrameLen)) {
+            *pbBacklog = true;
+            break;
+        }
+
+        bRunning = handleClientFrame(pstClientInfo, pu8Stream + uiOffset, iFrameLen, &stHeader, kpu8Data, &stBatch);
+        uiOffset += (size_t)iFrameLen;
+    }
+
+    /**< 잘못된 데이터도 대역폭을 쓰므로 건너뛴 바이트까지 셉니다. */
+    stBatch.uiBytes += uiOffset;
+    pthread_mutex_lock(&pstClientInfo->rateMutex);
+    uint64_t u64ConnWaitNs = takeTcpConnRate(&pstClientInfo->stRate, stBatch.uiBytes, stBatch.u64Frames, stBatch.u64NowNs);
+    pthread_mutex_unlock(&pstClientInfo->rateMutex);
+    *pu64ThrottleNs = u64ConnWaitNs > stBatch.u64ThrottleNs ? u64ConnWaitNs : stBatch.u64ThrottleNs;
+
+    memmove(pu8Stream, pu8Stream + uiOffset, *puiStreamLen - uiOffset);
+    *puiStreamLen -= uiOffset;
+    return bRunning;
+}
+
+/**
+ * @brief 전송률 제한을 넘은 연결의 소켓을 지정한 시간 동안 읽지 않습니다.
+ * @param pstClientInfo CLIENT_INFO 구조체 포인터
+ * @param u64ThrottleNs 기다릴 시간 (ns)
+ *
+ * @details 읽지 않는 동안 커널 수신 버퍼가 차고 TCP 윈도가 닫혀 보내는 쪽이 느려지므로, 서버는 따로 버퍼링하거나 버리지 않습니다.
+ *          events 없이 poll() 하면 데이터가 와도 깨지 않고, 관리 명령 등으로 소켓이 shutdown() 되면(POLLHUP) 바로 깹니다.
+ */
+static void throttleClient(CLIENT_INFO *pstClientInfo, uint64_t u64ThrottleNs) {
+    uint64_t u64EndNs = getTcpMonotonicNs() + u64ThrottleNs;
+    uint64_t u64NowNs;
+
+    addTcpConnMetric(&pstClientInfo->stMetrics, TCP_METRIC_THROTTLES, 1);
+    while (!isClientExiting(pstClientInfo) && !isTcpDraining() && (u64NowNs = getTcpMonotonicNs()) < u64EndNs) {
+        struct pollfd stPoll = {pstClientInfo->iClientSock, 0, 0};
+        uint64_t u64WaitMs = (u64EndNs - u64NowNs + 999999) / 1000000;
+
+        if (poll(&stPoll, 1, u64WaitMs < THROTTLE_POLL_MAX_MS ? (int)u64WaitMs : THROTTLE_POLL_MAX_MS) > 0) {
             break;
-        } else if (activity != 0) {
-            memset(achBuffer, 0x0, BUFFER_SIZE);
-            int iReadSize = read(pstClientInfo->iClientSock, achBuffer, BUFFER_SIZE);
-            if (iReadSize <= 0) {
+        }
+    }
+}
+
+/**
+ * @brief 덜 온 프레임을 완성할 만큼 데이터가 올 때까지 SO_RCVLOWAT으로 기다립니다.
+ * @param pstClientInfo CLIENT_INFO 구조체 포인터
+ * @param kpu8Stream 처리하고 남은 수신 데이터
+ * @param uiStreamLen 남은 데이터 길이
+ *
+ * @details 헤더 전에는 가장 작은 프레임 크기, 헤더 뒤에는 Data Length까지 남은 바이트를 기준으로 하여,
+ *          큰 프레임을 조금씩 보내는 상대에게도 세그먼트마다가 아니라 프레임마다 한 번 깨어납니다.
+ *          기준은 상한(-L)과 수신 버퍼의 빈 공간을 넘지 않으며, 값이 바뀔 때만 setsockopt()를 호출합니다.
+ *          TCP는 아직 복사하지 않은 바이트가 기준에 닿을 때만 읽는 쪽을 깨우므로, 블로킹 read()가 일부를 먼저
+ *          복사하면 나머지가 와도 깨어나지 않습니다. 그래서 poll()로 기다린 뒤 읽습니다.
+ *          연결 종료나 shutdown()이면 기준과 관계없이 깨어납니다.
+ */
+static void waitClientFrameBytes(CLIENT_INFO *pstClientInfo, const uint8_t *kpu8Stream, size_t uiStreamLen) {
+    size_t uiNeeded = getTcpFrameNeededBytes(kpu8Stream, uiStreamLen);
+    int iLowat;
+
+    if (s_iRecvLowatMax <= 0 || pstClientInfo->pstTls != NULL) {
+        return; /**< TLS는 레코드 헤더와 라이브러리 안에 남은 평문 때문에 소켓 바이트와 프레임 바이트가 맞지 않습니다. */
+    }
+    if (uiNeeded > (size_t)s_iRecvLowatMax) {
+        uiNeeded = (size_t)s_iRecvLowatMax;
+    }
+    if (uiNeeded > RECV_STREAM_SIZE - uiStreamLen) {
+        uiNeeded = RECV_STREAM_SIZE - uiStreamLen;
+    }
+    iLowat = uiNeeded > 0 ? (int)uiNeeded : 1;
+    if (iLowat != pstClientInfo->iRecvLowat
+        && setsockopt(pstClientInfo->iClientSock, SOL_SOCKET, SO_RCVLOWAT, &iLowat, sizeof(iLowat)) == 0) {
+        pstClientInfo->iRecvLowat = iLowat;
+    }
+    if (pstClientInfo->iRecvLowat > 1) {
+        struct pollfd stPoll;
+
+        stPoll.fd = pstClientInfo->iClientSock;
+        stPoll.events = POLLIN;
+        while (poll(&stPoll, 1, -1) < 0 && errno == EINTR) {
+        }
+    }
+}
+
+/**
+ * @brief 클라이언트로부터 데이터를 수신하는 스레드 함수
+ * @param arg CLIENT_INFO 구조체 포인터
+ * @return NULL
+ * 
+ * @details 클라이언트 소켓으로부터 데이터를 읽어 프레임 단위로 파싱하고 SHARED_DATA 큐에 저장합니다. 
+ *          데이터를 저장하면 조건 변수를 통해 송신 스레드에 알립니다.
+ *          타임아웃 없이 read()에서 대기하므로 유휴 연결은 CPU를 쓰지 않습니다. 송신 실패나 관리 명령으로
+ *          연결을 끊을 때는 소켓을 shutdown() 하여 read()를 깨웁니다.
+ *          연결이 끊기면 송신 스레드를 기다린 뒤 보내지 못한 프레임을 drops로 집계하고, 소켓을 닫고 슬롯을 비웁니다.
+ *          TLS 연결은 먼저 핸드셰이크를 하고 키를 커널 TLS로 넘기므로, 이후 읽기/쓰기 경로는 평문 연결과 같습니다.
+ *          연결별/Client ID별 전송률 제한(tcpRate.h)을 넘으면 제한 안으로 돌아올 때까지 소켓을 읽지 않아 TCP 흐름 제어로 상대를 늦춥니다.
+ *          한 번 읽은 데이터는 차례당 read 예산(-Q, tcpBudget.h)만큼만 처리하고, 남으면 sched_yield()로 CPU를 내놓은 뒤
+ *          다음 차례에 이어서 처리합니다. 연결 사이의 순서는 보장하지 않으며(커널 스케줄러가 고름), 소켓 버퍼를 가득 채운
+ *          연결의 스레드가 한 번에 붙잡는 CPU 시간만 줄입니다.
+ *          서버가 종료 중이면(isTcpDraining()) 이미 읽은 프레임까지만 처리하고 더 읽지 않으며, 송신 스레드가 큐를 모두 보내고
+ *          SHUTDOWN 프레임을 보낸 뒤 연결을 닫습니다. 메인 스레드가 소켓을 SHUT_RD 하여 read()를 깨웁니다.
+ *          읽기 전에 SO_RCVLOWAT을 덜 온 프레임의 남은 바이트로 맞춰(waitClientFrameBytes()) 프레임마다 한 번 깨어납니다.
+ *          read_complete, frame_parsed, dispatch, enqueue, disconnect USDT 프로브는 연결 ID와 바이트 수를 전달합니다.
+ */
+void *receiveThread(void *arg) {
+    CLIENT_INFO *pstClientInfo = (CLIENT_INFO *)arg;
+    char achPeer[TCP_SOCK_ADDR_STRLEN];
+    uint8_t *pu8Stream = (uint8_t *)malloc(RECV_STREAM_SIZE);
+    size_t uiStreamLen = 0;
+
+    formatTcpPeerName(pstClientInfo->iClientSock, achPeer, sizeof(achPeer));
+    initTcpConnRate(&pstClientInfo->stRate, getTcpMonotonicNs());
+    resetTcpReadCredit(&pstClientInfo->stBudget);
+    pstClientInfo->iRecvLowat = 1; /**< 커널 기본값 */
+    if (pu8Stream == NULL) {
+        perror("수신 버퍼 할당 실패");
+    } else if (pstClientInfo->pstTls != NULL
+               && startTcpTls(pstClientInfo->pstTls, pstClientInfo->iClientSock, NULL, TCP_TLS_HANDSHAKE_TIMEOUT_MS) < 0) {
+        fprintf(stderr, "TLS 연결 실패, 주소 %s: %s\n", achPeer, getTcpTlsError());
+    } else {
+        bool bBacklog = false;
+
+        while (!isClientExiting(pstClientInfo)) {
+            if (bBacklog) {
+                /**< 이번 차례의 예산을 다 썼으므로 CPU를 내놓고(다음에 돌 스레드는 커널이 고름), 읽지 않고 남은 프레임부터 처리합니다. */
+                sched_yield();
+            } else if (isTcpDraining()) {
+                /**< 서버 종료 중에는 새 요청을 읽지 않습니다. */
+                break;
+            } else {
+                resetTcpReadCredit(&pstClientInfo->stBudget);
+                waitClientFrameBytes(pstClientInfo, pu8Stream, uiStreamLen);
+                ssize_t iReadSize = readClientSocket(pstClientInfo, pu8Stream + uiStreamLen, RECV_STREAM_SIZE - uiStreamLen);
                 if (iReadSize == 0) {
                     /**< 클라이언트 연결 종료 */
                     break;
-                } else {
+                } else if (iReadSize < 0) {
+                    if (errno == EINTR || errno == EAGAIN) {
+                        continue;
+                    }
                     perror("read 실패");
+                    break;
                 }
-                handleTcpClientDisconnection(pstClientInfo->iClientSock);
-                pstClientInfo->iClientSock = 0;
-            } else {
+
                 /**< 데이터 수신 성공 */
-                achBuffer[iReadSize] = '\0';
-                pthread_mutex_lock(&pstClientInfo->stSharedData.mutex);
-                pstClientInfo->stSharedData.hasData = true; /**< 데이터 존재 플래그 설정 */
-                memset(pstClientInfo->stSharedData.chData, 0x0, BUFFER_SIZE);
-                memcpy(pstClientInfo->stSharedData.chData, achBuffer, strlen(achBuffer));
-                pthread_cond_signal(&pstClientInfo->stSharedData.cond); /**< 조건 변수 신호 전송 */
-                pthread_mutex_unlock(&pstClientInfo->stSharedData.mutex);
-                fprintf(stdout, "클라이언트 %d로부터 수신: %s\n", pstClientInfo->iClientSock, achBuffer);
-                usleep(100 * 1000); /**< 짧은 대기 시간 */
+                TCP_PROBE2(tcpServer, read_complete, pstClientInfo->stMetrics.u64ConnId, iReadSize);
+                addTcpConnMetric(&pstClientInfo->stMetrics, TCP_METRIC_READS, 1);
+                addTcpConnMetric(&pstClientInfo->stMetrics, TCP_METRIC_BYTES_IN, iReadSize);
+                uiStreamLen += (size_t)iReadSize;
+            }
+
+            uint64_t u64ThrottleNs = 0;
+            startTcpReadTurn(&pstClientInfo->stBudget, &s_stReadBudget);
+            if (!processClientFrames(pstClientInfo, pu8Stream, &uiStreamLen, &u64ThrottleNs, &bBacklog)) {
+                break;
+            }
+            if (u64ThrottleNs > 0) {
+                throttleClient(pstClientInfo, u64ThrottleNs);
             }
         }
     }
 
-    fprintf(stdout, "%s():%d 클라이언트 연결 해제, 소켓 IP: %s, 포트: %d\n", 
-            __func__, __LINE__, 
-            inet_ntoa(stSockClientAddr.sin_addr), 
-            ntohs(stSockClientAddr.sin_port));
+    bool bFlushed = false;
+    if (isTcpDraining() && !isClientExiting(pstClientInfo)) {
+        /**< 송신 스레드가 남은 응답과 SHUTDOWN 프레임을 보내고 끝나기를 기다립니다. 멈춘 상대는 메인 스레드가 기한에 끊습니다. */
+        requestClientFlush(pstClientInfo);
+        pthread_join(pstClientInfo->sendThreadId, NULL);
+        bFlushed = true;
+        /**< 읽지 않은 데이터가 남은 채 닫으면 RST가 나가므로, 이미 도착한 데이터는 버립니다. */
+        if (pu8Stream != NULL) {
+            while (recv(pstClientInfo->iClientSock, pu8Stream, RECV_STREAM_SIZE, MSG_DONTWAIT) > 0) {
+            }
+        }
+    }
 
-    pthread_mutex_lock(&pstClientInfo->exitFlagMutex);
-    pstClientInfo->bExitFlag = true;
-    pthread_mutex_unlock(&pstClientInfo->exitFlagMutex);
-    pthread_exit(NULL);
+    fprintf(stdout, "%s():%d 클라이언트 연결 해제, 주소: %s\n", __func__, __LINE__, achPeer);
+
+    /**< 공유 메모리 전송을 닫아 처리 스레드를 끝냅니다. */
+    if (pstClientInfo->pstShm != NULL) {
+        closeTcpShm(pstClientInfo->pstShm);
+        pthread_join(pstClientInfo->shmThreadId, NULL);
+        destroyTcpShm(pstClientInfo->pstShm);
+        pstClientInfo->pstShm = NULL;
+    }
+    if (pstClientInfo->iShmFd >= 0) {
+        close(pstClientInfo->iShmFd);
+        pstClientInfo->iShmFd = -1;
+    }
+
+    /**< 송신 스레드를 깨워 종료시키고, 소켓을 닫은 뒤 슬롯을 비웁니다. */
+    setClientExiting(pstClientInfo);
+    shutdown(pstClientInfo->iClientSock, SHUT_RDWR);
+    if (!bFlushed) {
+        pthread_join(pstClientInfo->sendThreadId, NULL);
+    }
+
+    /**< 보내지 못한 프레임은 연결별/전체 drops로 집계합니다. */
+    uint64_t u64Dropped = dropSharedQueues(&pstClientInfo->stSharedData);
+    if (u64Dropped > 0) {
+        addTcpConnMetric(&pstClientInfo->stMetrics, TCP_METRIC_DROPS, u64Dropped);
+    }
+
+    TCP_PROBE3(tcpServer, disconnect, pstClientInfo->stMetrics.u64ConnId,
+               getTcpConnMetric(&pstClientInfo->stMetrics, TCP_METRIC_BYTES_IN),
+               getTcpConnMetric(&pstClientInfo->stMetrics, TCP_METRIC_BYTES_OUT));
+    unregisterTcpConnMetrics(&pstClientInfo->stMetrics);
+    addTcpMetric(TCP_METRIC_DISCONNECTS, 1);
+
+    handleTcpClientDisconnection(pstClientInfo->iClientSock);
+    addTcpQueuedBytes(-(int64_t)pstClientInfo->stSharedData.u64QueuedBytes); /**< 보내지 못한 프레임 */
+    addTcpAdmittedConns(-1);
+    destroySharedQueues(&pstClientInfo->stSharedData);
+    pthread_cond_destroy(&pstClientInfo->stSharedData.cond);
+    pthread_cond_destroy(&pstClientInfo->stSharedData.spaceCond);
+    pthread_mutex_destroy(&pstClientInfo->stSharedData.mutex);
+    free(pu8Stream);
+
+    __atomic_store_n(&pstClientInfo->iClientSock, 0, __ATOMIC_RELEASE); /**< 슬롯 반환 */
+    return NULL;
+}
+
+/**
+ * @brief 데이터를 모두 송신합니다.
+ * @param iSock 소켓 파일 디스크립터
+ * @param kpu8Data 송신할 데이터
+ * @param uiLen 데이터 길이
+ * @return 모두 송신하면 true, 연결 오류 시 false
+ */
+static bool sendAll(int iSock, const uint8_t *kpu8Data, size_t uiLen) {
+    while (uiLen > 0) {
+        ssize_t iWriteSize = send(iSock, kpu8Data, uiLen, MSG_NOSIGNAL);
+        if (iWriteSize < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        kpu8Data += iWriteSize;
+        uiLen -= (size_t)iWriteSize;
+    }
+    return true;
+}
+
+/**
+ * @brief 등급별 송신 큐가 모두 비었는지 확인합니다.
+ * @param pstShared SHARED_DATA 구조체 포인터
+ * @return 모두 비었으면 true
+ */
+static bool isSharedQueueEmpty(SHARED_DATA *pstShared) {
+    for (int i = 0; i < TCP_FRAME_PRIO_COUNT; i++) {
+        if (!isTcpRingEmpty(pstShared->apstQueue[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 우선순위가 가장 높은, 비어 있지 않은 등급 큐에서 레코드 하나를 꺼냅니다.
+ * @param pstShared SHARED_DATA 구조체 포인터
+ * @param pu8Record 레코드를 저장할 버퍼 (QUEUE_RECORD_SIZE 바이트)
+ * @return 레코드 길이. 모두 비었으면 0
+ *
+ * @details 레코드마다 제어 등급부터 다시 확인하므로, 대량 DATA를 보내는 중에 들어온 제어 프레임은 다음 차례에 바로 나갑니다.
+ */
+static int popSharedQueue(SHARED_DATA *pstShared, uint8_t *pu8Record) {
+    for (int i = 0; i < TCP_FRAME_PRIO_COUNT; i++) {
+        int iRecordLen = popTcpRing(pstShared->apstQueue[i], pu8Record, QUEUE_RECORD_SIZE);
+        if (iRecordLen > 0) {
+            return iRecordLen;
+        }
+    }
+    return 0;
 }
 
 /**
@@ -127,132 +949,879 @@ void *receiveThread(void *arg) {
  * @param arg CLIENT_INFO 구조체 포인터
  * @return NULL
  * 
- * @details SHARED_DATA 구조체에 저장된 데이터를 클라이언트 소켓으로 전송합니다. 
- *          수신 스레드에서 데이터가 준비되면 조건 변수를 통해 알림을 받습니다.
+ * @details SHARED_DATA 큐에 저장된 프레임을 우선순위 등급 순서로, 등급 안에서는 들어온 순서대로 클라이언트 소켓으로 전송합니다. 
+ *          소켓에 TCP_NOTSENT_LOWAT(-N)을 설정했으면 기준의 절반만큼 보낼 때마다 소켓이 쓰기 가능해질 때까지 기다린 뒤
+ *          다음 프레임을 꺼냅니다. 커널에는 보내지 않은 바이트가 기준 남짓만 쌓이고 나머지는 등급별 큐에 남으므로,
+ *          느린 상대에게 대량 DATA를 보내는 중에 들어온 제어 프레임이 커널 버퍼 뒤에서 기다리지 않습니다.
+ *          수신 스레드에서 데이터가 준비되면 조건 변수를 통해 알림을 받고,
+ *          큐에서 프레임을 꺼낸 뒤에는 공간을 기다리는 수신 스레드를 깨웁니다.
+ *          송신에 실패하면 소켓을 shutdown() 하여 read()에서 대기 중인 수신 스레드를 깨웁니다.
+ *          서버 종료 중 수신 스레드가 요청하면(requestClientFlush()) 큐를 모두 보낸 뒤 SHUTDOWN 프레임을 보내고 끝납니다.
  */
 void *sendThread(void *arg) {
     CLIENT_INFO *pstClientInfo = (CLIENT_INFO *)arg;
-    struct sockaddr_in stSockClientAddr;
-    socklen_t uiClientAddrLen = sizeof(stSockClientAddr);
-    char achBuffer[BUFFER_SIZE];
-    bool bSendFlag = false;
-    bool bExitFlag = false;
-    struct timeval stNow;
-    struct timespec stTimeout;
+    SHARED_DATA *pstShared = &pstClientInfo->stSharedData;
+    uint8_t *pu8Record = (uint8_t *)malloc(QUEUE_RECORD_SIZE);
+    size_t uiUncheckedBytes = 0; /**< 마지막으로 쓰기 가능을 확인한 뒤 보낸 바이트 */
 
-    if (getpeername(pstClientInfo->iClientSock, (struct sockaddr *)&stSockClientAddr, &uiClientAddrLen) == -1) {
-        perror("getpeername 실패");
-        pthread_exit(NULL);
+    if (pu8Record == NULL) {
+        perror("송신 버퍼 할당 실패");
+        setClientExiting(pstClientInfo);
+        shutdown(pstClientInfo->iClientSock, SHUT_RDWR);
+        return NULL;
     }
 
     while (1) {
-        gettimeofday(&stNow, NULL);
-        stTimeout.tv_sec = stNow.tv_sec + 1; /**< 1초 타임아웃 설정 */
-        stTimeout.tv_nsec = stNow.tv_usec * 1000;
+        /**< 데이터 준비 상태 대기 */
+        bool bExiting = false;
+        bool bFlushed = false;
+        pthread_mutex_lock(&pstShared->mutex);
+        while (isSharedQueueEmpty(pstShared) && !(bExiting = isClientExiting(pstClientInfo))
+               && !(bFlushed = isClientFlushing(pstClientInfo))) {
+            pthread_cond_wait(&pstShared->cond, &pstShared->mutex);
+        }
+        pthread_mutex_unlock(&pstShared->mutex);
+        if (bExiting) {
+            break;
+        }
+        if (bFlushed) {
+            /**< 큐가 비었으므로 앞선 응답은 모두 나갔습니다. */
+            uint8_t au8Frame[TCP_FRAME_HEADER_SIZE + TCP_FRAME_CRC_SIZE];
+            int iFrameLen = encodeTcpFrame(au8Frame, sizeof(au8Frame), 0, TCP_INST_SHUTDOWN, NULL, 0);
+
+            if (sendAll(pstClientInfo->iClientSock, au8Frame, (size_t)iFrameLen)) {
+                addTcpConnMetric(&pstClientInfo->stMetrics, TCP_METRIC_SHUTDOWNS, 1);
+            }
+            break;
+        }
+
+        bool bPopped = false;
+        bool bSendFailed = false;
+        int iRecordLen;
+        while (!isSharedQueueEmpty(pstShared)) {
+            if (s_iNotSentLowat > 0 && uiUncheckedBytes >= (size_t)s_iNotSentLowat / 2) {
+                /**< 기다리는 동안 들어온 더 높은 등급의 프레임을 꺼내도록, 쓰기 가능해진 뒤에 꺼냅니다. */
+                if (waitTcpSocketWritable(pstClientInfo->iClientSock, 0) == 0) {
+                    addTcpConnMetric(&pstClientInfo->stMetrics, TCP_METRIC_SEND_WAITS, 1);
+                    waitTcpSocketWritable(pstClientInfo->iClientSock, -1);
+                }
+                uiUncheckedBytes = 0;
+            }
+            if ((iRecordLen = popSharedQueue(pstShared, pu8Record)) <= 0) {
+                break;
+            }
+            uint64_t u64StoredNs;
+            size_t uiFrameLen = (size_t)iRecordLen - sizeof(uint64_t);
+
+            bPopped = true;
+            memcpy(&u64StoredNs, pu8Record, sizeof(uint64_t));
+            __atomic_sub_fetch(&pstShared->u64QueuedBytes, uiFrameLen, __ATOMIC_RELAXED);
+            addTcpQueuedBytes(-(int64_t)uiFrameLen);
+            addTcpConnMetric(&pstClientInfo->stMetrics, TCP_METRIC_DEQUEUED, 1);
 
-        pthread_mutex_lock(&pstClientInfo->exitFlagMutex);
-        bExitFlag = pstClientInfo->bExitFlag;
-        pthread_mutex_unlock(&pstClientInfo->exitFlagMutex);
+            if (!sendAll(pstClientInfo->iClientSock, pu8Record + sizeof(uint64_t), uiFrameLen)) { /**< 데이터 송신 */
+                bSendFailed = true;
+                break;
+            }
+            uiUncheckedBytes += uiFrameLen;
+            TCP_PROBE2(tcpServer, write_complete, pstClientInfo->stMetrics.u64ConnId, uiFrameLen);
+            addTcpConnMetric(&pstClientInfo->stMetrics, TCP_METRIC_BYTES_OUT, uiFrameLen);
+            addTcpConnMetric(&pstClientInfo->stMetrics, TCP_METRIC_MSGS_OUT, 1);
+            recordTcpHistogram(TCP_HIST_RECV_TO_SEND, getTcpMonotonicNs() - u64StoredNs);
+        }
 
-        if (bExitFlag) {
+        if (bPopped) {
+            pthread_mutex_lock(&pstShared->mutex);
+            pthread_cond_signal(&pstShared->spaceCond);
+            pthread_mutex_unlock(&pstShared->mutex);
+        }
+        if (bSendFailed) {
+            perror("send 실패");
+            setClientExiting(pstClientInfo);
+            shutdown(pstClientInfo->iClientSock, SHUT_RDWR);
             break;
         }
+    }
 
-        /**< 데이터 준비 상태 대기 */
-        int ret = pthread_cond_timedwait(&pstClientInfo->stSharedData.cond, &pstClientInfo->stSharedData.mutex, &stTimeout);
-        if (ret == ETIMEDOUT) {
-            fprintf(stderr, ".");
-        } else {
-            memset(achBuffer, 0x0, BUFFER_SIZE);
-            pstClientInfo->stSharedData.hasData = false; /**< 데이터 사용 완료 플래그 초기화 */
-            memcpy(achBuffer, pstClientInfo->stSharedData.chData, strlen(pstClientInfo->stSharedData.chData));
-            pthread_mutex_unlock(&pstClientInfo->stSharedData.mutex);
-            bSendFlag = true;
+    free(pu8Record);
+    return NULL;
+}
+
+/**
+ * @brief 전체 메트릭 요약을 출력합니다.
+ * @param pstPrev 이전 출력 시점의 스냅샷. 출력 후 현재 스냅샷으로 갱신됩니다.
+ *
+ * @details 누적 카운터, 큐 깊이, 활성 연결 수, 수락률과 수신-송신 지연 백분위를 한 줄로 출력합니다.
+ */
+static void reportServerMetrics(TCP_METRICS_SNAPSHOT *pstPrev) {
+    static TCP_METRICS_SNAPSHOT stCur; /**< 히스토그램이 커서 스택 대신 정적 영역 사용 */
+    const TCP_HISTOGRAM *kpstLatency = &stCur.astHist[TCP_HIST_RECV_TO_SEND];
+
+    getTcpMetricsSnapshot(&stCur);
+    fprintf(stdout, "[metrics] 연결 %llu (수락 %.1f/s), 수신 %llu건/%llu바이트, 송신 %llu건/%llu바이트, "
+            "큐 %llu, 버림 %llu, 지연(us) p50 %.1f p99 %.1f p99.9 %.1f max %.1f\n",
+            (unsigned long long)getTcpActiveConnections(&stCur),
+            getTcpMetricRate(pstPrev, &stCur, TCP_METRIC_ACCEPTS),
+            (unsigned long long)stCur.au64Counter[TCP_METRIC_MSGS_IN],
+            (unsigned long long)stCur.au64Counter[TCP_METRIC_BYTES_IN],
+            (unsigned long long)stCur.au64Counter[TCP_METRIC_MSGS_OUT],
+            (unsigned long long)stCur.au64Counter[TCP_METRIC_BYTES_OUT],
+            (unsigned long long)getTcpQueueDepth(&stCur),
+            (unsigned long long)stCur.au64Counter[TCP_METRIC_DROPS],
+            getTcpHistogramPercentile(kpstLatency, 50.0) / 1000.0,
+            getTcpHistogramPercentile(kpstLatency, 99.0) / 1000.0,
+            getTcpHistogramPercentile(kpstLatency, 99.9) / 1000.0,
+            kpstLatency->u64Max / 1000.0);
+    memcpy(pstPrev, &stCur, sizeof(TCP_METRICS_SNAPSHOT));
+}
+
+/**
+ * @brief 받은 연결을 BUSY 프레임과 함께 바로 닫습니다.
+ * @param iClientSock 받은 소켓
+ * @param pstTls 이 대기 소켓의 TLS 설정 (NULL이 아니면 핸드셰이크 전이므로 프레임 없이 닫음)
+ * @param eReason 거절 이유
+ *
+ * @details 스레드를 만들지 않고, 소켓 버퍼에 들어가지 않으면 기다리지 않으므로 과부하 중에도 비용이 작습니다.
+ *          클라이언트는 응답 시간 초과까지 기다리지 않고 바로 다른 서버로 가거나 나중에 다시 시도할 수 있습니다.
+ */
+static void rejectClient(int iClientSock, TCP_TLS *pstTls, TCP_BUSY_REASON eReason) {
+    uint8_t au8Frame[TCP_FRAME_HEADER_SIZE + 1 + TCP_FRAME_CRC_SIZE];
+    uint8_t u8Reason = (uint8_t)eReason;
+    int iFrameLen = encodeTcpFrame(au8Frame, sizeof(au8Frame), 0, TCP_INST_BUSY, &u8Reason, 1);
+
+    if (pstTls == NULL) {
+        (void)send(iClientSock, au8Frame, (size_t)iFrameLen, MSG_DONTWAIT | MSG_NOSIGNAL);
+    }
+    addTcpMetric(TCP_METRIC_REJECTS, 1);
+    if (s_bVerbose) {
+        fprintf(stderr, "연결 거절 (%s): 소켓 FD %d\n", getTcpBusyReasonName(eReason), iClientSock);
+    }
+    close(iClientSock);
+}
+
+/**
+ * @brief 대기 소켓에서 연결 하나를 받아 빈 슬롯에 등록하고 송수신 스레드를 시작합니다.
+ * @param iListenSock 읽기 가능한 대기 소켓 (TCP 또는 Unix 도메인)
+ * @param pstTls 이 대기 소켓의 연결에 쓸 TLS 설정 (NULL이면 평문)
+ * @param pstClientGroup 클라이언트 정보 배열
+ * @param iMaxClients 배열 크기
+ * @param pstThreadAttr 연결별 스레드 속성
+ *
+ * @return accept()가 실패하여 잠시 연결 받기를 멈춰야 하면 false
+ *
+ * @details 주소 체계와 관계없이 같은 프레임 처리 경로를 사용합니다.
+ *          과부하(tcpAdmission.h)이거나 빈 슬롯이 없으면 BUSY 프레임을 보내고 바로 닫습니다.
+ *          fd가 모자라면(EMFILE/ENFILE) 예비 fd로 대기열 맨 앞 연결을 받아 바로 닫고 false를 반환하므로,
+ *          서버는 끝나지 않고 잠시 느리게 받다가 fd가 풀리면 평소대로 돌아옵니다.
+ *          상대가 먼저 끊은 연결(ECONNABORTED) 같은 일시적 오류는 무시합니다.
+ */
+static bool acceptClient(int iListenSock, TCP_TLS *pstTls, CLIENT_INFO *pstClientGroup, int iMaxClients, pthread_attr_t *pstThreadAttr) {
+    int iClientSock;
+    char achPeer[TCP_SOCK_ADDR_STRLEN];
+
+    if (s_iReserveFd < 0) {
+        s_iReserveFd = openTcpReserveFd();
+    }
+    if ((iClientSock = acceptTcpClientSocket(iListenSock, &s_iReserveFd)) < 0) {
+        if (errno == EINTR || errno == EAGAIN || errno == ECONNABORTED || errno == EPROTO) {
+            return true;
+        }
+        addTcpMetric(TCP_METRIC_ACCEPT_ERRORS, 1);
+        return false;
+    }
+
+    TCP_BUSY_REASON eBusy = admitTcpConnection();
+    if (eBusy != TCP_BUSY_NONE) {
+        rejectClient(iClientSock, pstTls, eBusy);
+        return true;
+    }
+
+    formatTcpPeerName(iClientSock, achPeer, sizeof(achPeer));
+    fprintf(stdout, "새 연결: 소켓 FD %d, 주소 %s\n", iClientSock, achPeer);
+    if (s_iNotSentLowat > 0) {
+        setTcpNotSentLowat(iClientSock, s_iNotSentLowat); /**< Unix 도메인 연결은 지원하지 않아 실패하며 그대로 둡니다. */
+    }
+
+    bool bAdded = false;
+    for (int i = 0; i < iMaxClients; i++) {
+        if (__atomic_load_n(&pstClientGroup[i].iClientSock, __ATOMIC_ACQUIRE) == 0) {
+            /**< 빈 슬롯에 클라이언트 추가 */
+            SHARED_DATA *pstShared = &pstClientGroup[i].stSharedData;
+
+            if (!createSharedQueues(pstShared)) {
+                perror("송신 큐 생성 실패");
+                break;
+            }
+            if (pthread_mutex_init(&pstShared->mutex, NULL) != 0) {
+                perror("pthread_mutex_init 실패");
+            }
+            pthread_cond_init(&pstShared->cond, NULL);
+            pthread_cond_init(&pstShared->spaceCond, NULL);
+            pthread_mutex_init(&pstClientGroup[i].exitFlagMutex, NULL);
+            pthread_mutex_init(&pstClientGroup[i].rateMutex, NULL);
+
+            pstClientGroup[i].iClientSock = iClientSock;
+            pstClientGroup[i].iShmFd = -1;
+            pstClientGroup[i].pstShm = NULL;
+            pstClientGroup[i].pstTls = pstTls;
+            pstClientGroup[i].u8Caps = 0;
+            pstShared->u64QueuedBytes = 0;
+            addTcpAdmittedConns(1);
+            uint64_t u64ConnId = registerTcpConnMetrics(&pstClientGroup[i].stMetrics, iClientSock, achPeer);
+            addTcpMetric(TCP_METRIC_ACCEPTS, 1);
+            TCP_PROBE2(tcpServer, accept, u64ConnId, iClientSock);
+
+            pstClientGroup[i].bExitFlag = false;
+            pstClientGroup[i].bFlushFlag = false;
+            fprintf(stdout, "소켓 목록에 추가: %d\n", i);
+
+            /**< 송신 및 수신 스레드 생성. 수신 스레드가 종료 시 송신 스레드를 join 하고 슬롯을 정리합니다. */
+            if (pthread_create(&pstClientGroup[i].sendThreadId, pstThreadAttr, sendThread, &pstClientGroup[i]) != 0) {
+                perror("송신 스레드 생성 실패");
+                unregisterTcpConnMetrics(&pstClientGroup[i].stMetrics);
+                addTcpMetric(TCP_METRIC_DISCONNECTS, 1);
+                destroySharedQueues(pstShared);
+                addTcpAdmittedConns(-1);
+                pstClientGroup[i].iClientSock = 0;
+                break;
+            }
+            if (pthread_create(&pstClientGroup[i].recvThreadId, pstThreadAttr, receiveThread, &pstClientGroup[i]) != 0) {
+                /**< 송신 스레드만 정리하고, 소켓은 아래에서 닫습니다. */
+                perror("수신 스레드 생성 실패");
+                setClientExiting(&pstClientGroup[i]);
+                pthread_join(pstClientGroup[i].sendThreadId, NULL);
+                unregisterTcpConnMetrics(&pstClientGroup[i].stMetrics);
+                addTcpMetric(TCP_METRIC_DISCONNECTS, 1);
+                destroySharedQueues(pstShared);
+                addTcpAdmittedConns(-1);
+                pstClientGroup[i].iClientSock = 0;
+                break;
+            }
+            pthread_detach(pstClientGroup[i].recvThreadId);
+            bAdded = true;
+            break;
         }
+    }
 
-        if (bSendFlag) {
-            write(pstClientInfo->iClientSock, achBuffer, strlen(achBuffer)); /**< 데이터 송신 */
+    if (!bAdded) {
+        rejectClient(iClientSock, pstTls, TCP_BUSY_CONNS);
+    }
+    return true;
+}
+
+/**
+ * @brief 재시작 중인 새 프로세스에 대기 소켓을 넘깁니다. (기존 프로세스 쪽)
+ * @param iUpgradeSock 읽기 가능한 재시작 대기 소켓 (-H)
+ * @param kpiListenSocks 넘길 대기 소켓 (TCP, 선택적 Unix 도메인 순서)
+ * @param iListenCount 대기 소켓 수
+ * @param kpchAdminPath 관리 소켓 경로
+ * @param iAdminHttpPort 관리 HTTP 포트
+ * @return 새 프로세스가 준비를 마쳤으면 true. 이때 호출자는 대기 소켓을 닫고 기존 연결만 마저 처리합니다.
+ *
+ * @details 새 프로세스가 같은 경로와 포트로 관리 인터페이스를 열 수 있도록 먼저 관리 인터페이스를 멈춥니다.
+ *          대기 소켓은 두 프로세스가 함께 가진 채로 넘어가므로, 준비 응답을 기다리는 동안 들어온 연결은
+ *          대기열에 남아 있다가 새 프로세스가 받습니다. 응답이 없으면 관리 인터페이스를 다시 열고 계속 대기합니다.
+ */
+static bool handOffListeners(int iUpgradeSock, const int *kpiListenSocks, int iListenCount,
+                             const char *kpchAdminPath, int iAdminHttpPort) {
+    int iPeerSock;
+    bool bReady = false;
+
+    if ((iPeerSock = accept(iUpgradeSock, NULL, NULL)) < 0) {
+        perror("재시작 연결 accept 실패");
+        return false;
+    }
+
+    stopTcpAdminServer();
+    if (sendTcpSocketFds(iPeerSock, kpiListenSocks, iListenCount) < 0) {
+        perror("대기 소켓 전달 실패");
+    } else {
+        struct pollfd stPoll;
+        char chReply = 0;
+
+        stPoll.fd = iPeerSock;
+        stPoll.events = POLLIN;
+        stPoll.revents = 0;
+        if (poll(&stPoll, 1, UPGRADE_ACK_TIMEOUT_MS) > 0 && read(iPeerSock, &chReply, 1) == 1) {
+            bReady = (chReply == UPGRADE_READY_BYTE);
         }
-        bSendFlag = false;
     }
+    close(iPeerSock);
 
-    fprintf(stdout, "%s():%d 클라이언트 연결 해제, 소켓 IP: %s, 포트: %d\n", 
-            __func__, __LINE__, 
-            inet_ntoa(stSockClientAddr.sin_addr), 
-            ntohs(stSockClientAddr.sin_port));
+    if (!bReady) {
+        fprintf(stderr, "새 프로세스가 준비 응답을 보내지 않았습니다, 계속 대기합니다\n");
+        if (startTcpAdminServer(kpchAdminPath, iAdminHttpPort) < 0) {
+            fprintf(stderr, "관리 인터페이스 재시작 실패, 계속 진행합니다\n");
+        }
+    }
+    return bReady;
+}
 
-    pthread_mutex_lock(&pstClientInfo->exitFlagMutex);
-    pstClientInfo->bExitFlag = true;
-    pthread_mutex_unlock(&pstClientInfo->exitFlagMutex);
-    pthread_exit(NULL);
+/**
+ * @brief 실행 중인 서버에서 대기 소켓을 넘겨받습니다. (새 프로세스 쪽)
+ * @param kpchUpgradePath 기존 서버의 재시작 대기 소켓 경로 (-U)
+ * @param piServerSock 받은 TCP 대기 소켓
+ * @param piUnixSock 받은 Unix 도메인 대기 소켓 (없으면 -1)
+ * @return 기존 서버와 연결된 소켓 (준비가 끝나면 UPGRADE_READY_BYTE를 보내고 닫음). 실패 시 -1
+ *
+ * @details 받은 소켓의 종류는 주소 체계로 구분하므로, 기존 서버의 -u 설정과 관계없이 받을 수 있습니다.
+ */
+static int takeOverListeners(const char *kpchUpgradePath, int *piServerSock, int *piUnixSock) {
+    int aiFds[TCP_SOCK_MAX_PASS_FDS];
+    int iHandoffSock;
+    int iCount;
+
+    *piServerSock = -1;
+    *piUnixSock = -1;
+    if ((iHandoffSock = createTcpUnixClientSocket(kpchUpgradePath)) < 0) {
+        return -1;
+    }
+    if ((iCount = recvTcpSocketFds(iHandoffSock, aiFds, TCP_SOCK_MAX_PASS_FDS, UPGRADE_ACK_TIMEOUT_MS)) < 0) {
+        perror("대기 소켓 받기 실패");
+        close(iHandoffSock);
+        return -1;
+    }
+
+    for (int i = 0; i < iCount; i++) {
+        struct sockaddr_storage stAddr;
+        socklen_t uiAddrLen = sizeof(stAddr);
+        int *piSlot = NULL;
+
+        if (getsockname(aiFds[i], (struct sockaddr *)&stAddr, &uiAddrLen) == 0) {
+            piSlot = (stAddr.ss_family == AF_UNIX) ? piUnixSock : piServerSock;
+        }
+        if (piSlot == NULL || *piSlot >= 0) {
+            close(aiFds[i]); /**< 알 수 없거나 중복된 소켓 */
+            continue;
+        }
+        *piSlot = aiFds[i];
+    }
+    if (*piServerSock < 0) {
+        fprintf(stderr, "넘겨받은 소켓에 TCP 대기 소켓이 없습니다\n");
+        if (*piUnixSock >= 0) {
+            close(*piUnixSock);
+        }
+        close(iHandoffSock);
+        return -1;
+    }
+    return iHandoffSock;
+}
+
+/**
+ * @brief 종료 신호 처리기. 메인 루프가 신호를 확인하여 종료를 시작합니다.
+ * @param iSignal 받은 신호
+ */
+static void handleStopSignal(int iSignal) {
+    s_iStopSignal = iSignal;
+}
+
+/**
+ * @brief 사용 중인 클라이언트 슬롯의 연결 소켓을 shutdown 합니다.
+ * @param pstClientGroup 클라이언트 정보 배열
+ * @param iMaxClients 배열 크기
+ * @param iHow SHUT_RD 또는 SHUT_RDWR
+ * @return shutdown 한 연결 수
+ *
+ * @details 소켓을 닫지 않고 shutdown만 하므로 소유 스레드가 평소처럼 정리합니다.
+ *          연결 테이블(TCP_CONN_TABLE_SIZE)에 들지 못한 연결도 빠지지 않도록 슬롯 배열을 돕니다.
+ *          연결 등록은 메인 스레드만 하므로 순회 중 빈 슬롯에 새 연결이 들어오지 않고, lockTcpConnSock()으로
+ *          소켓을 잠가 수신 스레드가 등록 해제 후 닫은 소켓 번호는 건드리지 않습니다.
+ */
+static uint32_t shutdownClientConns(CLIENT_INFO *pstClientGroup, int iMaxClients, int iHow) {
+    uint32_t u32Count = 0;
+
+    for (int i = 0; i < iMaxClients; i++) {
+        if (__atomic_load_n(&pstClientGroup[i].iClientSock, __ATOMIC_ACQUIRE) == 0) {
+            continue;
+        }
+        int iSock = lockTcpConnSock(&pstClientGroup[i].stMetrics, 0);
+        if (iSock >= 0) {
+            if (shutdown(iSock, iHow) == 0) {
+                u32Count++;
+            }
+            unlockTcpConnSock();
+        }
+    }
+    return u32Count;
+}
+
+/**
+ * @brief 사용 중인 클라이언트 슬롯의 송수신 버퍼를 측정한 대역폭 지연 곱에 맞춥니다.
+ * @param pstClientGroup 클라이언트 정보 배열
+ * @param iMaxClients 배열 크기
+ * @return 바꾼 버퍼 수
+ *
+ * @details shutdownClientConns()처럼 슬롯 배열을 돌며 lockTcpConnSock()으로 잠근 소켓만 바꾸므로,
+ *          수신 스레드가 등록 해제 후 닫은 소켓 번호(다른 연결에 재사용되었을 수 있음)는 건드리지 않습니다.
+ *          Unix 도메인 연결은 TCP_INFO가 없어 실패하므로 그대로 둡니다.
+ */
+static uint32_t tuneClientConns(CLIENT_INFO *pstClientGroup, int iMaxClients) {
+    uint32_t u32Tuned = 0;
+
+    for (int i = 0; i < iMaxClients; i++) {
+        if (__atomic_load_n(&pstClientGroup[i].iClientSock, __ATOMIC_ACQUIRE) == 0) {
+            continue;
+        }
+        int iSock = lockTcpConnSock(&pstClientGroup[i].stMetrics, 0);
+        if (iSock >= 0) {
+            int iTuned = tuneTcpSocketBuffer(iSock, &s_stTuneLimit);
+            unlockTcpConnSock();
+            if (iTuned > 0) {
+                u32Tuned += (uint32_t)iTuned;
+            }
+        }
+    }
+    return u32Tuned;
+}
+
+/**
+ * @brief 클라이언트 슬롯을 iCursor부터 돌며 연결 INFO_SAMPLE_BATCH개의 TCP_INFO 표본을 기록합니다.
+ * @param pstClientGroup 클라이언트 정보 배열
+ * @param iMaxClients 배열 크기
+ * @param iCursor 이번 묶음을 시작할 슬롯
+ * @return 다음 묶음을 시작할 슬롯 (한 바퀴를 다 돌았으면 0)
+ *
+ * @details 연결이 많아도 메인 루프가 한 번에 오래 멈추지 않도록 묶음으로 나누어 뜹니다.
+ *          연결 등록은 메인 스레드만 하므로 같은 스레드에서 쓰는 게이지가 새 연결의 초기화와 겹치지 않습니다.
+ *          iClientSock은 수신 스레드가 소켓을 닫은 뒤에야 0이 되므로, 소켓은 sampleTcpConnInfo()가 잠근 동안에만 씁니다.
+ *          Unix 도메인 연결은 TCP_INFO가 없어 건너뜁니다.
+ */
+static int sampleClientInfo(CLIENT_INFO *pstClientGroup, int iMaxClients, int iCursor) {
+    uint64_t u64NowNs = getTcpMonotonicNs();
+    int iSampled = 0;
+    int i;
+
+    for (i = iCursor; i < iMaxClients && iSampled < INFO_SAMPLE_BATCH; i++) {
+        if (__atomic_load_n(&pstClientGroup[i].iClientSock, __ATOMIC_ACQUIRE) != 0
+            && sampleTcpConnInfo(&pstClientGroup[i].stMetrics, u64NowNs) == 0) {
+            iSampled++;
+        }
+    }
+    return i < iMaxClients ? i : 0;
+}
+
+/**
+ * @brief 아직 반환되지 않은 클라이언트 슬롯 수를 셉니다.
+ * @param pstClientGroup 클라이언트 정보 배열
+ * @param iMaxClients 배열 크기
+ * @return 사용 중인 슬롯 수
+ *
+ * @details 수신 스레드는 정리를 모두 마친 뒤 마지막으로 슬롯을 반환하므로, 0이면 배열을 해제해도 됩니다.
+ */
+static uint32_t countClientSlots(CLIENT_INFO *pstClientGroup, int iMaxClients) {
+    uint32_t u32Count = 0;
+
+    for (int i = 0; i < iMaxClients; i++) {
+        if (__atomic_load_n(&pstClientGroup[i].iClientSock, __ATOMIC_ACQUIRE) != 0) {
+            u32Count++;
+        }
+    }
+    return u32Count;
+}
+
+/**
+ * @brief DRAIN_POLL_MS 동안 잠듭니다.
+ */
+static void sleepDrainPoll(void) {
+    struct timespec stSleep = {0, DRAIN_POLL_MS * 1000000L};
+
+    while (nanosleep(&stSleep, &stSleep) < 0 && errno == EINTR) {
+    }
+}
+
+/**
+ * @brief 종료 신호를 받거나 대기 소켓을 새 프로세스에 넘겨 대기 소켓을 닫은 뒤 불러, 기존 연결을 기한 안에 정리합니다.
+ * @param pstClientGroup 클라이언트 정보 배열
+ * @param iMaxClients 배열 크기
+ * @param u32DrainMs 송신 큐를 보내는 기한 (ms)
+ * @param pstMetricsPrev 메트릭 요약 출력용 이전 스냅샷
+ * @return 모든 연결 스레드가 정리되었으면 true
+ *
+ * @details 종료 기한을 설정하여 새 요청을 거절(TCP_BUSY_DRAINING)하고, 연결 소켓을 SHUT_RD 하여 read()에서 대기 중인
+ *          수신 스레드를 깨웁니다. 각 연결은 송신 큐를 모두 보낸 뒤 SHUTDOWN 프레임을 보내고 닫힙니다.
+ *          기한까지 남은 연결(읽지 않는 상대 등)은 SHUT_RDWR 하여 막혀 있는 send()를 풀고 drain_timeouts로 셉니다.
+ *          진행 상황은 1초마다 메트릭 요약과 관리 인터페이스의 tcp_server_draining, tcp_server_drain_remaining_seconds,
+ *          active_connections, queued_bytes 게이지로 볼 수 있습니다.
+ */
+static bool drainServer(CLIENT_INFO *pstClientGroup, int iMaxClients, uint32_t u32DrainMs, TCP_METRICS_SNAPSHOT *pstMetricsPrev) {
+    uint64_t u64DeadlineNs = getTcpMonotonicNs() + (uint64_t)u32DrainMs * 1000000ULL;
+    uint64_t u64NextReportNs = getTcpMonotonicNs() + 1000000000ULL;
+
+    setTcpDrainDeadline(u64DeadlineNs);
+    shutdownClientConns(pstClientGroup, iMaxClients, SHUT_RD);
+    fprintf(stdout, "종료 시작: 연결 %u개, 송신 큐 %llu바이트, 기한 %u ms\n", getTcpAdmittedConns(),
+            (unsigned long long)getTcpQueuedBytes(), u32DrainMs);
+    fflush(stdout);
+
+    while (countClientSlots(pstClientGroup, iMaxClients) > 0 && getTcpMonotonicNs() < u64DeadlineNs) {
+        sleepDrainPoll();
+        if (getTcpMonotonicNs() >= u64NextReportNs) {
+            reportServerMetrics(pstMetricsPrev);
+            u64NextReportNs += 1000000000ULL;
+        }
+    }
+
+    if (countClientSlots(pstClientGroup, iMaxClients) > 0) {
+        uint32_t u32Forced = shutdownClientConns(pstClientGroup, iMaxClients, SHUT_RDWR);
+        addTcpMetric(TCP_METRIC_DRAIN_TIMEOUTS, u32Forced);
+        fprintf(stdout, "종료 기한 초과: 연결 %u개를 강제로 닫습니다\n", u32Forced);
+        for (int i = 0; i < DRAIN_CLOSE_WAIT_MS / DRAIN_POLL_MS && countClientSlots(pstClientGroup, iMaxClients) > 0; i++) {
+            sleepDrainPoll();
+        }
+    }
+
+    reportServerMetrics(pstMetricsPrev);
+    uint32_t u32Left = countClientSlots(pstClientGroup, iMaxClients);
+    fprintf(stdout, "종료 완료 (남은 연결 %u)\n", u32Left);
+    fflush(stdout);
+    return u32Left == 0;
 }
 
 /**
  * @brief 메인 함수: TCP 서버 소켓을 생성하고 클라이언트 연결을 처리
+ * @param argc 인자 개수
+ * @param argv 인자 목록 (-p 포트(0이면 임시 포트), -b 바인드 주소(기본 :: 이중 스택), -u Unix 도메인 소켓 경로, -c 최대 클라이언트 수, -a 관리 소켓 경로, -w 관리 HTTP 포트, -q 메시지 로그 끄기,
+ *             -t TLS 인증서 PEM 파일(지정하면 TCP 연결에 TLS 사용), -k TLS 개인 키 PEM 파일(기본: 인증서 파일),
+ *             -A 과부하 기준 지연ms[,큐 바이트[,연결 수]] (0은 보지 않음), -H 재시작 대기 소켓 경로, -U 대기 소켓을 넘겨받을 기존 서버의 재시작 경로,
+ *             -D 종료 신호 후 송신 큐를 보내는 기한 ms)
  * @return int 실행 결과
  * 
  * @details 서버 소켓을 생성하고 클라이언트의 연결 요청을 대기합니다. 
  *          연결된 클라이언트별로 송신 및 수신 스레드를 생성하여 데이터를 처리합니다.
+ *          관리 인터페이스(메트릭, 연결 목록, 연결 종료)는 별도 스레드에서 제공합니다.
+ *          실제 대기 포트는 "포트 N에서 서버 대기 중" 으로 출력되므로, 임시 포트 사용 시 이 줄에서 포트를 얻습니다.
+ *          -u 를 주면 같은 호스트 클라이언트를 위한 Unix 도메인 소켓에서도 함께 대기하며, 두 대기 소켓의 연결은 같은 경로로 처리됩니다.
+ *          -t 를 주면 TCP 연결은 TLS 핸드셰이크 후 커널 TLS로 암호화합니다. Unix 도메인 연결은 같은 호스트 안이므로 평문으로 둡니다.
+ *          -H 를 주면 그 경로에서 새 바이너리의 접속을 기다리다가 대기 소켓을 SCM_RIGHTS로 넘기고, 더는 accept하지 않은 채
+ *          SIGTERM과 같이 drainServer()로 기존 연결을 정리한 뒤 종료합니다. 새 바이너리는 -U 로 같은 경로를 주어
+ *          소켓을 새로 만들지 않고 넘겨받으므로, 배포 중에도 연결이 거절되지 않습니다. (-p, -b 와 받은 Unix 소켓의 -u 는 무시)
+ *          SIGTERM 또는 SIGINT를 받으면 더는 accept하지 않고 drainServer()로 연결을 정리한 뒤 종료합니다.
+ *          신호는 모든 스레드에서 막아 두고 메인 스레드의 pselect() 안에서만 받으므로 대기 중에 바로 깨어납니다.
  */
-int main() {
-    int iServerSock, iClientSock;
-    struct sockaddr_in stSockClientAddr;
-    socklen_t uiClientAddrLen = sizeof(stSockClientAddr);
+int main(int argc, char *argv[]) {
+    int iServerSock;
+    int aiListenSocks[2];           /**< 감시할 대기 소켓 (TCP, 선택적 Unix 도메인) */
+    int iListenCount = 0;
     fd_set stReadFds;
-    CLIENT_INFO stClientGroup[MAX_CLIENTS] = {0}; /**< 클라이언트 정보 배열 초기화 */
+    CLIENT_INFO *pstClientGroup; /**< 클라이언트 정보 배열 */
+    int iPort = PORT;
+    int iMaxClients = MAX_CLIENTS;
+    pthread_attr_t stThreadAttr;
+    static TCP_METRICS_SNAPSHOT stMetricsPrev;
+    struct timespec stTimeout;
+    struct sigaction stStopAction;
+    sigset_t stStopSet, stOrigSet;
+    uint32_t u32DrainMs = DRAIN_DEFAULT_MS;
+    uint64_t u64NextReportNs;
+    const char *kpchBindAddr = NULL;
+    const char *kpchUnixPath = NULL;
+    const char *kpchCertFile = NULL;
+    const char *kpchKeyFile = NULL;
+    const char *kpchAdminPath = TCP_ADMIN_DEFAULT_PATH;
+    const char *kpchUpgradePath = NULL;
+    const char *kpchTakeoverPath = NULL;
+    int iAdminHttpPort = 0;
+    int iUpgradeSock = -1;          /**< 재시작 대기 소켓 (-H, -1이면 없음) */
+    int iHandoffSock = -1;          /**< 대기 소켓을 넘겨준 기존 서버와의 연결 (-U) */
+    int iUnixSock = -1;
+    bool bHandedOff = false;        /**< 대기 소켓을 새 프로세스에 넘겼는지 여부 */
+    uint64_t u64AcceptResumeNs = 0; /**< accept() 실패 후 다시 연결을 받기 시작할 시각 (0이면 멈추지 않음) */
+    uint32_t u32AcceptBackoffMs = 0; /**< 지금 멈춤 시간 (ms, 0이면 실패 없음) */
+    uint32_t u32TuneIntervalMs = TCP_TUNE_DEFAULT_INTERVAL_MS;
+    uint64_t u64NextTuneNs = 0;
+    uint32_t u32InfoIntervalMs = TCP_INFO_DEFAULT_INTERVAL_MS; /**< TCP_INFO 표본 주기 (-I 옵션, 0이면 끔) */
+    uint64_t u64NextInfoNs = 0;
+    int iInfoCursor = 0;            /**< 다음 TCP_INFO 묶음을 시작할 슬롯 */
+    int iOpt;
 
-    iServerSock = createTcpServerSocket(PORT, MAX_CLIENTS);
-    fprintf(stdout, "포트 %d에서 서버 대기 중\n", PORT);
+    while ((iOpt = getopt(argc, argv, "p:b:u:c:a:w:qt:k:l:Q:A:H:U:D:B:N:L:I:")) != -1) {
+        switch (iOpt) {
+        case 'p':
+            iPort = atoi(optarg);
+            break;
+        case 'b':
+            kpchBindAddr = optarg;
+            break;
+        case 'u':
+            kpchUnixPath = optarg;
+            break;
+        case 'c':
+            iMaxClients = atoi(optarg);
+            break;
+        case 'a':
+            kpchAdminPath = optarg;
+            break;
+        case 'w':
+            iAdminHttpPort = atoi(optarg);
+            break;
+        case 'q':
+            s_bVerbose = false;
+            break;
+        case 't':
+            kpchCertFile = optarg;
+            break;
+        case 'k':
+            kpchKeyFile = optarg;
+            break;
+        case 'l': {
+            unsigned long ulBytesPerSec = 0, ulMsgsPerSec = 0;
+            if (sscanf(optarg, "%lu,%lu", &ulBytesPerSec, &ulMsgsPerSec) < 1) {
+                fprintf(stderr, "전송률 제한 형식이 잘못되었습니다 (바이트/s[,메시지/s]): %s\n", optarg);
+                return EXIT_FAILURE;
+            }
+            TCP_RATE_LIMIT stLimit = {ulBytesPerSec, ulMsgsPerSec};
+            setTcpConnRateLimit(&stLimit);
+            break;
+        }
+        case 'Q': {
+            unsigned int uiBytes = 0, uiFrames = 0;
+            if (sscanf(optarg, "%u,%u", &uiBytes, &uiFrames) < 1 || uiBytes == 0) {
+                fprintf(stderr, "read 예산 형식이 잘못되었습니다 (바이트[,프레임]): %s\n", optarg);
+                return EXIT_FAILURE;
+            }
+            s_stReadBudget.u32Bytes = uiBytes;
+            s_stReadBudget.u32Frames = uiFrames;
+            break;
+        }
+        case 'A': {
+            unsigned long ulLagMs = 0, ulQueuedBytes = 0;
+            unsigned int uiConns = 0;
+            if (sscanf(optarg, "%lu,%lu,%u", &ulLagMs, &ulQueuedBytes, &uiConns) < 1) {
+                fprintf(stderr, "과부하 기준 형식이 잘못되었습니다 (지연ms[,큐바이트[,연결수]]): %s\n", optarg);
+                return EXIT_FAILURE;
+            }
+            TCP_ADMISSION_LIMIT stAdmission = {(uint64_t)ulLagMs * 1000000ULL, ulQueuedBytes, uiConns};
+            setTcpAdmissionLimit(&stAdmission);
+            break;
+        }
+        case 'H':
+            kpchUpgradePath = optarg;
+            break;
+        case 'U':
+            kpchTakeoverPath = optarg;
+            break;
+        case 'D':
+            u32DrainMs = (uint32_t)strtoul(optarg, NULL, 10);
+            break;
+        case 'N':
+            s_iNotSentLowat = atoi(optarg);
+            break;
+        case 'L':
+            s_iRecvLowatMax = atoi(optarg);
+            break;
+        case 'I':
+            u32InfoIntervalMs = (uint32_t)strtoul(optarg, NULL, 10);
+            break;
+        case 'B': {
+            unsigned int uiMinBytes = 0, uiMaxBytes = 0;
+            if (sscanf(optarg, "%u,%u,%u", &uiMinBytes, &uiMaxBytes, &u32TuneIntervalMs) < 2
+                || uiMaxBytes == 0 || uiMinBytes > uiMaxBytes || uiMaxBytes > INT32_MAX / 2 || u32TuneIntervalMs == 0) {
+                fprintf(stderr, "버퍼 크기 범위 형식이 잘못되었습니다 (최소바이트,최대바이트[,주기ms]): %s\n", optarg);
+                return EXIT_FAILURE;
+            }
+            s_stTuneLimit.u32MinBytes = uiMinBytes;
+            s_stTuneLimit.u32MaxBytes = uiMaxBytes;
+            break;
+        }
+        default:
+            fprintf(stderr, "사용법: %s [-p 포트] [-b 바인드주소] [-u Unix소켓경로] [-c 최대클라이언트수] [-a 관리소켓경로] [-w 관리HTTP포트] [-q]\n"
+                            "          [-t TLS인증서 [-k TLS개인키]] [-l 연결별제한 바이트/s[,메시지/s]] [-Q read예산 바이트[,프레임]]\n"
+                            "          [-A 과부하기준 지연ms[,큐바이트[,연결수]]] [-H 재시작소켓경로] [-U 넘겨받을재시작경로]\n"
+                            "          [-D 종료기한ms] [-B 버퍼 최소바이트,최대바이트[,주기ms]] [-N 미전송바이트기준]\n"
+                            "          [-L 수신대기기준 상한바이트] [-I TCP_INFO주기ms]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (iMaxClients <= 0) {
+        fprintf(stderr, "최대 클라이언트 수가 잘못되었습니다: %d\n", iMaxClients);
+        return EXIT_FAILURE;
+    }
+    /**< 스레드를 만들기 전에 종료 신호를 막아 두어, 모든 스레드가 물려받고 메인 스레드의 pselect() 안에서만 받게 합니다. */
+    memset(&stStopAction, 0x0, sizeof(stStopAction));
+    stStopAction.sa_handler = handleStopSignal;
+    sigemptyset(&stStopAction.sa_mask);
+    sigaction(SIGTERM, &stStopAction, NULL);
+    sigaction(SIGINT, &stStopAction, NULL);
+    sigemptyset(&stStopSet);
+    sigaddset(&stStopSet, SIGTERM);
+    sigaddset(&stStopSet, SIGINT);
+    pthread_sigmask(SIG_BLOCK, &stStopSet, &stOrigSet);
 
-    while (1) {
-        FD_ZERO(&stReadFds);
-        FD_SET(iServerSock, &stReadFds);
-        int iMaxSock = iServerSock;
+    if (kpchCertFile != NULL && (s_pstTls = createTcpTlsServer(kpchCertFile, kpchKeyFile)) == NULL) {
+        fprintf(stderr, "TLS 설정 실패: %s\n", getTcpTlsError());
+        return EXIT_FAILURE;
+    }
 
-        for (int i = 0; i < MAX_CLIENTS; i++) {
-            int iSock = stClientGroup[i].iClientSock;
-            if (iSock > 0)
-                FD_SET(iSock, &stReadFds);
-            if (iSock > iMaxSock)
-                iMaxSock = iSock;
-        }
+    pstClientGroup = (CLIENT_INFO *)calloc((size_t)iMaxClients, sizeof(CLIENT_INFO));
+    if (pstClientGroup == NULL) {
+        perror("클라이언트 배열 할당 실패");
+        return EXIT_FAILURE;
+    }
+    pthread_attr_init(&stThreadAttr);
+    pthread_attr_setstacksize(&stThreadAttr, CLIENT_THREAD_STACK_SIZE);
 
-        int iActivitySock = select(iMaxSock + 1, &stReadFds, NULL, NULL, NULL);
-        if ((iActivitySock < 0) && (errno != EINTR)) {
-            perror("select 실패");
+    if (kpchTakeoverPath != NULL) {
+        if ((iHandoffSock = takeOverListeners(kpchTakeoverPath, &iServerSock, &iUnixSock)) < 0) {
+            fprintf(stderr, "%s에서 대기 소켓을 넘겨받지 못했습니다\n", kpchTakeoverPath);
+            return EXIT_FAILURE;
+        }
+        fprintf(stdout, "%s에서 대기 소켓을 넘겨받음\n", kpchTakeoverPath);
+    } else {
+        if ((iServerSock = createTcpServerSocketOn(kpchBindAddr, iPort, iMaxClients)) < 0) {
+            return EXIT_FAILURE;
+        }
+    }
+    iPort = getTcpSocketPort(iServerSock);
+    fprintf(stdout, "포트 %d에서 서버 대기 중 (바인드 %s, 최대 클라이언트 %d)\n",
+            iPort, kpchBindAddr != NULL ? kpchBindAddr : "::", iMaxClients);
+    if (s_pstTls != NULL) {
+        fprintf(stdout, "TLS 사용 (커널 TLS 오프로드): 인증서 %s\n", kpchCertFile);
+    }
+    aiListenSocks[iListenCount++] = iServerSock;
+    if (iUnixSock >= 0) {
+        aiListenSocks[iListenCount++] = iUnixSock;
+        fprintf(stdout, "넘겨받은 Unix 소켓에서 서버 대기 중\n");
+    } else if (kpchUnixPath != NULL) {
+        if ((iUnixSock = createTcpUnixServerSocket(kpchUnixPath, iMaxClients)) < 0) {
+            return EXIT_FAILURE;
+        }
+        aiListenSocks[iListenCount++] = iUnixSock;
+        fprintf(stdout, "Unix 소켓 %s에서 서버 대기 중\n", kpchUnixPath);
+    }
+    fflush(stdout);
+    if (startTcpAdminServer(kpchAdminPath, iAdminHttpPort) == 0) {
+        fprintf(stdout, "관리 인터페이스: %s%s\n", kpchAdminPath, iAdminHttpPort > 0 ? " (HTTP 127.0.0.1 사용)" : "");
+    } else {
+        fprintf(stderr, "관리 인터페이스 시작 실패, 계속 진행합니다\n");
+    }
+    if (startTcpLagMonitor(TCP_ADMISSION_LAG_INTERVAL_MS) < 0) {
+        fprintf(stderr, "스케줄링 지연 측정 시작 실패, 지연 기준은 동작하지 않습니다\n");
+    }
+    if (iHandoffSock >= 0) {
+        /**< 준비를 마쳤음을 알리면 기존 서버는 더는 accept하지 않습니다. */
+        char chReady = UPGRADE_READY_BYTE;
+        if (write(iHandoffSock, &chReady, 1) != 1) {
+            perror("준비 응답 전송 실패");
         }
+        close(iHandoffSock);
+    }
+    if (kpchUpgradePath != NULL) {
+        if ((iUpgradeSock = createTcpUnixServerSocket(kpchUpgradePath, 1)) < 0) {
+            fprintf(stderr, "재시작 대기 소켓 생성 실패, 재시작 없이 계속 진행합니다\n");
+        } else {
+            fprintf(stdout, "재시작 대기 소켓: %s\n", kpchUpgradePath);
+        }
+    }
+    if ((s_iReserveFd = openTcpReserveFd()) < 0) {
+        perror("예비 fd 열기 실패");
+    }
+    fflush(stdout);
+    getTcpMetricsSnapshot(&stMetricsPrev);
+    u64NextReportNs = getTcpMonotonicNs() + METRICS_REPORT_INTERVAL_SEC * 1000000000ULL;
 
-        if (FD_ISSET(iServerSock, &stReadFds)) {
-            if ((iClientSock = accept(iServerSock, (struct sockaddr *)&stSockClientAddr, &uiClientAddrLen)) < 0) {
-                perror("accept 실패");
-                exit(EXIT_FAILURE);
+    while (s_iStopSignal == 0 && !bHandedOff) {
+        /**< 클라이언트 소켓은 각 수신 스레드가 감시하므로 대기 소켓만 감시합니다.
+             accept()가 실패한 뒤 멈춤 시간 동안은 대기 소켓을 감시하지 않아 바쁜 반복을 막습니다. */
+        FD_ZERO(&stReadFds);
+        int iMaxSock = -1;
+        uint64_t u64NowNs = getTcpMonotonicNs();
+        bool bAcceptPaused = u64AcceptResumeNs != 0 && u64NowNs < u64AcceptResumeNs;
+        for (int i = 0; !bAcceptPaused && i < iListenCount; i++) {
+            FD_SET(aiListenSocks[i], &stReadFds);
+            if (aiListenSocks[i] > iMaxSock) {
+                iMaxSock = aiListenSocks[i];
+            }
+        }
+        if (iUpgradeSock >= 0) {
+            FD_SET(iUpgradeSock, &stReadFds);
+            if (iUpgradeSock > iMaxSock) {
+                iMaxSock = iUpgradeSock;
             }
+        }
 
-            fprintf(stdout, "새 연결: 소켓 FD %d, IP %s, 포트 %d\n", 
-                    iClientSock, 
-                    inet_ntoa(stSockClientAddr.sin_addr), 
-                    ntohs(stSockClientAddr.sin_port));
+        /**< 연결 받기 재개, 버퍼 조정, TCP_INFO 표본 중 가장 이른 일까지만 잠듭니다. */
+        uint64_t u64WakeNs = u64NowNs + METRICS_REPORT_INTERVAL_SEC * 1000000000ULL;
+        if (bAcceptPaused && u64AcceptResumeNs < u64WakeNs) {
+            u64WakeNs = u64AcceptResumeNs;
+        }
+        if (s_stTuneLimit.u32MaxBytes > 0 && u64NextTuneNs < u64WakeNs) {
+            u64WakeNs = u64NextTuneNs;
+        }
+        if (u32InfoIntervalMs > 0 && u64NextInfoNs < u64WakeNs) {
+            u64WakeNs = u64NextInfoNs;
+        }
+        uint64_t u64WaitNs = u64WakeNs > u64NowNs ? u64WakeNs - u64NowNs : 0;
+        stTimeout.tv_sec = (time_t)(u64WaitNs / 1000000000ULL);
+        stTimeout.tv_nsec = (long)(u64WaitNs % 1000000000ULL);
+        int iActivitySock = pselect(iMaxSock + 1, &stReadFds, NULL, NULL, &stTimeout, &stOrigSet);
+        if ((iActivitySock < 0) && (errno != EINTR)) {
+            perror("select 실패");
+        }
 
-            for (int i = 0; i < MAX_CLIENTS; i++) {
-                if (stClientGroup[i].iClientSock == 0) {
-                    /**< 빈 슬롯에 클라이언트 추가 */
-                    stClientGroup[i].iClientSock = iClientSock;
+        if (getTcpMonotonicNs() >= u64NextReportNs) {
+            reportServerMetrics(&stMetricsPrev);
+            u64NextReportNs = getTcpMonotonicNs() + METRICS_REPORT_INTERVAL_SEC * 1000000000ULL;
+        }
+        if (s_stTuneLimit.u32MaxBytes > 0 && getTcpMonotonicNs() >= u64NextTuneNs) {
+            addTcpMetric(TCP_METRIC_BUFFER_TUNES, tuneClientConns(pstClientGroup, iMaxClients));
+            u64NextTuneNs = getTcpMonotonicNs() + (uint64_t)u32TuneIntervalMs * 1000000ULL;
+        }
+        if (u32InfoIntervalMs > 0 && getTcpMonotonicNs() >= u64NextInfoNs) {
+            iInfoCursor = sampleClientInfo(pstClientGroup, iMaxClients, iInfoCursor);
+            u64NextInfoNs = getTcpMonotonicNs() + (uint64_t)(iInfoCursor == 0 ? u32InfoIntervalMs : INFO_SLICE_GAP_MS) * 1000000ULL;
+        }
 
-                    if (pthread_mutex_init(&stClientGroup[i].stSharedData.mutex, NULL) != 0) {
-                        perror("pthread_mutex_init 실패");
-                    }
+        if (iActivitySock <= 0) {
+            continue;
+        }
 
-                    stClientGroup[i].bExitFlag = false;
-                    fprintf(stdout, "소켓 목록에 추가: %d\n", i);
+        if (iUpgradeSock >= 0 && FD_ISSET(iUpgradeSock, &stReadFds)
+            && handOffListeners(iUpgradeSock, aiListenSocks, iListenCount, kpchAdminPath, iAdminHttpPort)) {
+            /**< 새 프로세스가 같은 커널 소켓으로 받으므로 아래에서 이쪽 복사본만 닫고, 기존 연결은 종료 신호와 같이 정리합니다. */
+            bHandedOff = true;
+            break;
+        }
 
-                    /**< 수신 및 송신 스레드 생성 */
-                    pthread_create(&stClientGroup[i].recvThreadId, NULL, receiveThread, &stClientGroup[i]);
-                    pthread_create(&stClientGroup[i].sendThreadId, NULL, sendThread, &stClientGroup[i]);
-                    break;
-                }
+        for (int i = 0; !bAcceptPaused && i < iListenCount; i++) {
+            if (!FD_ISSET(aiListenSocks[i], &stReadFds)) {
+                continue;
+            }
+            if (acceptClient(aiListenSocks[i], aiListenSocks[i] == iServerSock ? s_pstTls : NULL, pstClientGroup, iMaxClients, &stThreadAttr)) {
+                u32AcceptBackoffMs = 0;
+                u64AcceptResumeNs = 0;
+                continue;
             }
+            /**< fd가 풀릴 때까지 멈춤 시간을 두 배씩 늘립니다. */
+            if (u32AcceptBackoffMs == 0) {
+                u32AcceptBackoffMs = ACCEPT_BACKOFF_MIN_MS;
+                fprintf(stderr, "accept 실패 (%s), 잠시 연결 받기를 멈춥니다\n", strerror(errno));
+            } else if ((u32AcceptBackoffMs *= 2) > ACCEPT_BACKOFF_MAX_MS) {
+                u32AcceptBackoffMs = ACCEPT_BACKOFF_MAX_MS;
+            }
+            u64AcceptResumeNs = getTcpMonotonicNs() + (uint64_t)u32AcceptBackoffMs * 1000000ULL;
+            break;
         }
     }
 
+    if (bHandedOff) {
+        fprintf(stdout, "대기 소켓을 새 프로세스에 넘김, 기존 연결 %u개를 정리합니다\n", getTcpAdmittedConns());
+    } else {
+        fprintf(stdout, "종료 신호 %d 받음, 새 연결을 받지 않습니다\n", (int)s_iStopSignal);
+    }
+    for (int i = 0; i < iListenCount; i++) {
+        close(aiListenSocks[i]);
+    }
+    if (iUpgradeSock >= 0) {
+        close(iUpgradeSock);
+    }
+    if (!drainServer(pstClientGroup, iMaxClients, u32DrainMs, &stMetricsPrev)) {
+        /**< 남은 연결 스레드가 아직 자원을 쓰고 있을 수 있으므로 해제하지 않고 종료합니다. */
+        exit(EXIT_FAILURE);
+    }
+
+    stopTcpAdminServer();
+    pthread_attr_destroy(&stThreadAttr);
+    destroyTcpTls(s_pstTls);
+    free(pstClientGroup);
     return 0;
 }